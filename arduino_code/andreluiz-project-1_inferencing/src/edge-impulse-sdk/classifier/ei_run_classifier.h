@@ -675,6 +675,36 @@ extern "C" EI_IMPULSE_ERROR run_classifier_image_quantized(
 
 #endif // #if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI)
 
+#if (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
+/**
+ * Variant of 'run_classifier_image_quantized' where the caller writes the image
+ * directly into the int8 input tensor through `fill_fn` (resize, color conversion
+ * and quantization in a single pass), skipping the signal_t / float DSP stage.
+ * Only valid when 'can_run_classifier_image_quantized' returns EI_IMPULSE_OK.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_image_quantized_direct(
+    ei_image_quantized_fill_fn fill_fn,
+    void *fill_ctx,
+    ei_impulse_result_t *result,
+    bool debug = false)
+{
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+
+    EI_IMPULSE_ERROR res = can_run_classifier_image_quantized(impulse, impulse->learning_blocks[0]);
+    if (res != EI_IMPULSE_OK) {
+        return res;
+    }
+
+    res = run_nn_inference_image_quantized_direct(impulse, fill_fn, fill_ctx, result, impulse->learning_blocks[0].config, debug);
+    if (res != EI_IMPULSE_OK) {
+        return res;
+    }
+
+    return run_postprocessing(&ei_default_impulse, result);
+}
+#endif // (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
+
+
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
 static const float torch_mean[] = { 0.485, 0.456, 0.406 };
 static const float torch_std[] = { 0.229, 0.224, 0.225 };
@@ -887,6 +917,66 @@ __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
 #endif
 }
 
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
+/**
+ * @brief Keep the TFLite Micro runtime resident between calls to `run_classifier()`.
+ *
+ * Allocates the tensor arena, builds the interpreter and allocates the tensors once.
+ * Subsequent calls to `run_classifier()` and `run_classifier_image_quantized()` only
+ * fill the input tensor and invoke the model. Use `ei_tflite_get_last_timing()` to
+ * read the per-phase timings of the last inference.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in]   handle struct with information about model and DSP
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_session_init(ei_impulse_handle_t *handle = &ei_default_impulse)
+{
+    ei_learning_block_t block = handle->impulse->learning_blocks[0];
+    if (block.infer_fn != run_nn_inference) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+    return ei_tflite_session_init((ei_learning_block_config_tflite_graph_t*)block.config);
+}
+
+/**
+ * @brief Switch the resident runtime to another model without a restart.
+ *
+ * `graph` must be a build of the same impulse (same input and output tensors),
+ * e.g. a model memory-mapped from flash. The tensor arena is reused when the
+ * new model fits in it. On failure the current model stays active. If no
+ * session is active yet, one is started on `graph`.
+ *
+ * **Blocking**: yes, and no inference may run meanwhile
+ *
+ * @param[in]   graph  model, model size and arena size (must stay valid)
+ * @param[in]   handle struct with information about model and DSP
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_session_swap(const ei_config_tflite_graph_t *graph,
+                                                                     ei_impulse_handle_t *handle = &ei_default_impulse)
+{
+    ei_learning_block_t block = handle->impulse->learning_blocks[0];
+    if (block.infer_fn != run_nn_inference) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+    return ei_tflite_session_swap((ei_learning_block_config_tflite_graph_t*)block.config, graph);
+}
+
+/**
+ * @brief Release the runtime kept by `run_classifier_session_init()`.
+ *
+ * **Blocking**: yes
+ */
+__attribute__((unused)) void run_classifier_session_deinit(void)
+{
+    ei_tflite_session_deinit();
+}
+#endif // (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
+
 /**
  * @brief Run preprocessing (DSP) on new slice of raw features. Add output features
  *  to rolling matrix and run inference on full sample.
@@ -89,6 +89,72 @@
 #define DEFINE_SECTION(x) __attribute__((section(x)))
 #endif
 
+/**
+ * Per-phase timing of the last pass through the TFLite Micro runtime.
+ *
+ * The setup phases (arena, interpreter, AllocateTensors) are paid on every
+ * inference unless a persistent session is active, in which case they are
+ * only paid once by ei_tflite_session_init() and stay at zero afterwards.
+ */
+typedef struct {
+    uint64_t arena_alloc_us;
+    uint64_t interpreter_us;
+    uint64_t allocate_tensors_us;
+    uint64_t invoke_us;
+    size_t arena_used_bytes;
+    bool reused_session;
+} ei_tflite_timing_t;
+
+/**
+ * Persistent TFLite Micro session: keeps the arena, the interpreter and the
+ * resolved tensors alive between inferences (init once, invoke many times).
+ */
+typedef struct {
+    bool active;
+    const void *graph_config;
+    uint8_t *tensor_arena;
+    size_t arena_capacity;
+    tflite::MicroInterpreter *interpreter;
+    TfLiteTensor *input;
+    TfLiteTensor *output;
+    TfLiteTensor *output_labels;
+    TfLiteTensor *output_scores;
+    void *micro_profiler;
+    ei_tflite_timing_t setup_timing;
+    uint32_t invocations;
+} ei_tflite_session_t;
+
+static ei_tflite_session_t ei_tflite_session = { };
+static ei_tflite_timing_t ei_tflite_last_timing = { };
+
+/**
+ * Delete an interpreter created by inference_tflite_setup, unless it belongs
+ * to the persistent session (which is only released by ei_tflite_session_deinit)
+ */
+static void inference_tflite_release(tflite::MicroInterpreter *interpreter) {
+    if (ei_tflite_session.active && interpreter == ei_tflite_session.interpreter) {
+        return;
+    }
+    delete interpreter;
+}
+
+/**
+ * Op resolver shared by every interpreter. The ops are registered on the
+ * first call only (registering them again is an error in TFLite Micro).
+ */
+static const tflite::MicroOpResolver& inference_tflite_resolver(void) {
+    static const tflite::MicroOpResolver *registered = nullptr;
+    if (!registered) {
+#ifdef EI_TFLITE_RESOLVER
+        EI_TFLITE_RESOLVER
+#else
+        static tflite::AllOpsResolver resolver; // needs static to match the life of the interpreter
+#endif
+        registered = &resolver;
+    }
+    return *registered;
+}
+
 /**
  * Setup the TFLite runtime
  *
@@ -115,6 +181,25 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
 
     ei_config_tflite_graph_t *graph_config = (ei_config_tflite_graph_t*)block_config->graph_config;
 
+    // Persistent session: everything is already built, just hand it out
+    if (ei_tflite_session.active && ei_tflite_session.graph_config == graph_config) {
+        p_tensor_arena = ei_unique_ptr_t(ei_tflite_session.tensor_arena, [](void*){});
+        *micro_interpreter = ei_tflite_session.interpreter;
+        *input = ei_tflite_session.input;
+        *output = ei_tflite_session.output;
+        *output_labels = ei_tflite_session.output_labels;
+        *output_scores = ei_tflite_session.output_scores;
+        *micro_profiler = ei_tflite_session.micro_profiler;
+
+        ei_tflite_last_timing = { };
+        ei_tflite_last_timing.arena_used_bytes = ei_tflite_session.setup_timing.arena_used_bytes;
+        ei_tflite_last_timing.reused_session = true;
+        return EI_IMPULSE_OK;
+    }
+
+    ei_tflite_last_timing = { };
+    uint64_t phase_start_us = ei_read_timer_us();
+
 #ifdef EI_CLASSIFIER_ALLOCATION_STATIC
     // Assign a no-op lambda to the "free" function in case of static arena
     static uint8_t tensor_arena[EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE] ALIGN(16) DEFINE_SECTION(STRINGIZE_VALUE_OF(EI_TENSOR_ARENA_LOCATION));
@@ -129,6 +214,8 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     p_tensor_arena = ei_unique_ptr_t(tensor_arena, ei_aligned_free);
 #endif
 
+    ei_tflite_last_timing.arena_alloc_us = ei_read_timer_us() - phase_start_us;
+
     static bool tflite_first_run = true;
     static uint8_t *model_arr = NULL;
 
@@ -158,11 +245,9 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
         tflite_first_run = false;
     }
 
-#ifdef EI_TFLITE_RESOLVER
-    EI_TFLITE_RESOLVER
-#else
-    static tflite::AllOpsResolver resolver; // needs static to match the life of the interpreter
-#endif
+    const tflite::MicroOpResolver& resolver = inference_tflite_resolver();
+
+    phase_start_us = ei_read_timer_us();
 
     // Build an interpreter to run the model with.
     // only create profiler when enabled
@@ -182,6 +267,9 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
 
     *micro_interpreter = interpreter;
 
+    ei_tflite_last_timing.interpreter_us = ei_read_timer_us() - phase_start_us;
+    phase_start_us = ei_read_timer_us();
+
     // Allocate memory from the tensor_arena for the model's tensors.
     TfLiteStatus allocate_status = interpreter->AllocateTensors(true);
     if (allocate_status != kTfLiteOk) {
@@ -189,6 +277,9 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
+    ei_tflite_last_timing.allocate_tensors_us = ei_read_timer_us() - phase_start_us;
+    ei_tflite_last_timing.arena_used_bytes = interpreter->arena_used_bytes();
+
     // Obtain pointers to the model's input and output tensors.
     *input = interpreter->input(0);
     *output = interpreter->output(block_config->output_data_tensor);
@@ -231,14 +322,19 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     void* micro_profiler) {
 
     // Run inference, and report any error
+    uint64_t invoke_start_us = ei_read_timer_us();
     TfLiteStatus invoke_status = interpreter->Invoke();
     if (invoke_status != kTfLiteOk) {
-        delete interpreter;
+        inference_tflite_release(interpreter);
         ei_printf("Invoke failed (%d)\n", invoke_status);
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
     uint64_t ctx_end_us = ei_read_timer_us();
+    ei_tflite_last_timing.invoke_us = ctx_end_us - invoke_start_us;
+    if (ei_tflite_last_timing.reused_session) {
+        ei_tflite_session.invocations++;
+    }
 
     result->timing.classification_us = ctx_end_us - ctx_start_us;
     result->timing.classification = (int)(result->timing.classification_us / 1000);
@@ -263,7 +359,7 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     EI_IMPULSE_ERROR fill_res = fill_result_struct_from_output_tensor_tflite(
         impulse, block_config, output, labels_tensor, scores_tensor, result, debug);
 
-    delete interpreter;
+    inference_tflite_release(interpreter);
 
     if (fill_res != EI_IMPULSE_OK) {
         return fill_res;
@@ -336,7 +432,7 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         return output_res;
     }
 
-    delete interpreter;
+    inference_tflite_release(interpreter);
 
     return EI_IMPULSE_OK;
 }
@@ -523,8 +619,336 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
 
     return EI_IMPULSE_OK;
 }
+
+/**
+ * Callback that writes an image straight into the quantized input tensor.
+ * `input` holds `input_size` elements (width * height * channels) and
+ * every value must already be quantized with `scale` and `zero_point`.
+ * Returns EIDSP_OK on success.
+ */
+typedef int (*ei_image_quantized_fill_fn)(void *ctx, int8_t *input, size_t input_size, float scale, int32_t zero_point);
+
+/**
+ * Same as run_nn_inference_image_quantized, but instead of pulling float pixels
+ * through a signal_t and the image DSP block, the caller fills the int8 input
+ * tensor itself (e.g. resize + color conversion + quantization in one pass from
+ * a camera frame). No feature buffer is allocated at all.
+ */
+EI_IMPULSE_ERROR run_nn_inference_image_quantized_direct(
+    const ei_impulse_t *impulse,
+    ei_image_quantized_fill_fn fill_fn,
+    void *fill_ctx,
+    ei_impulse_result_t *result,
+    void *config_ptr,
+    bool debug = false)
+{
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
+
+    memset(result, 0, sizeof(ei_impulse_result_t));
+
+    uint64_t ctx_start_us;
+    TfLiteTensor* input;
+    TfLiteTensor* output;
+    TfLiteTensor* output_scores;
+    TfLiteTensor* output_labels;
+    ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+
+    tflite::MicroInterpreter* interpreter;
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    tflite::MicroProfiler* profiler;
+#else
+    void* profiler = nullptr;
+#endif
+
+    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+        block_config,
+        &ctx_start_us,
+        &input, &output,
+        &output_labels,
+        &output_scores,
+        &interpreter,
+        p_tensor_arena,
+        (void**)&profiler);
+
+    if (init_res != EI_IMPULSE_OK) {
+        return init_res;
+    }
+
+    if (input->type != TfLiteType::kTfLiteInt8) {
+        inference_tflite_release(interpreter);
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
+    uint64_t dsp_start_us = ei_read_timer_us();
+
+    int ret = fill_fn(fill_ctx, input->data.int8, impulse->nn_input_frame_size, input->params.scale, input->params.zero_point);
+    if (ret != EIDSP_OK) {
+        inference_tflite_release(interpreter);
+        ei_printf("ERR: Failed to fill input tensor (%d)\n", ret);
+        return EI_IMPULSE_DSP_ERROR;
+    }
+
+    result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
+    result->timing.dsp = (int)(result->timing.dsp_us / 1000);
+
+    ctx_start_us = ei_read_timer_us();
+
+    EI_IMPULSE_ERROR run_res = inference_tflite_run(impulse,
+        block_config,
+        ctx_start_us,
+        output,
+        output_labels,
+        output_scores,
+        interpreter,
+        static_cast<uint8_t*>(p_tensor_arena.get()),
+        result,
+        debug,
+        profiler);
+
+    if (run_res != EI_IMPULSE_OK) {
+        return run_res;
+    }
+
+    return EI_IMPULSE_OK;
+}
 #endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
 
+/**
+ * @brief      Release the arena and interpreter held by the persistent session.
+ *  Later inferences go back to building the runtime on every call.
+ */
+__attribute__((unused)) void ei_tflite_session_deinit(void)
+{
+    if (!ei_tflite_session.active) {
+        return;
+    }
+
+    ei_tflite_session.active = false;
+    delete ei_tflite_session.interpreter;
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    delete (tflite::MicroProfiler*)ei_tflite_session.micro_profiler;
+#endif
+#ifndef EI_CLASSIFIER_ALLOCATION_STATIC
+    ei_aligned_free(ei_tflite_session.tensor_arena);
+#endif
+
+    ei_tflite_session = { };
+}
+
+/**
+ * @brief      Start a persistent session for a TFLite learning block
+ *
+ * Allocates the arena, builds the interpreter and runs AllocateTensors() once.
+ * Every following inference on the same graph reuses them instead of
+ * rebuilding the runtime, until ei_tflite_session_deinit() is called.
+ * Calling it again for the graph that is already active is a no-op.
+ *
+ * @param      block_config  Learning block to keep resident
+ *
+ * @return     EI_IMPULSE_OK if successful
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR ei_tflite_session_init(
+    ei_learning_block_config_tflite_graph_t *block_config)
+{
+    if (ei_tflite_session.active) {
+        if (ei_tflite_session.graph_config == block_config->graph_config) {
+            return EI_IMPULSE_OK;
+        }
+        ei_tflite_session_deinit();
+    }
+
+    uint64_t ctx_start_us;
+    TfLiteTensor* input = nullptr;
+    TfLiteTensor* output = nullptr;
+    TfLiteTensor* output_scores = nullptr;
+    TfLiteTensor* output_labels = nullptr;
+    tflite::MicroInterpreter* interpreter = nullptr;
+    void* profiler = nullptr;
+    ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+
+    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+        block_config,
+        &ctx_start_us,
+        &input, &output,
+        &output_labels,
+        &output_scores,
+        &interpreter,
+        p_tensor_arena,
+        &profiler);
+
+    if (init_res != EI_IMPULSE_OK) {
+        delete interpreter;
+        return init_res;
+    }
+
+    ei_tflite_session.graph_config = block_config->graph_config;
+    ei_tflite_session.tensor_arena = static_cast<uint8_t*>(p_tensor_arena.release());
+#ifdef EI_CLASSIFIER_ALLOCATION_STATIC
+    ei_tflite_session.arena_capacity = EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE;
+#else
+    ei_tflite_session.arena_capacity = ((ei_config_tflite_graph_t*)block_config->graph_config)->arena_size;
+#endif
+    ei_tflite_session.interpreter = interpreter;
+    ei_tflite_session.input = input;
+    ei_tflite_session.output = output;
+    ei_tflite_session.output_labels = output_labels;
+    ei_tflite_session.output_scores = output_scores;
+    ei_tflite_session.micro_profiler = profiler;
+    ei_tflite_session.setup_timing = ei_tflite_last_timing;
+    ei_tflite_session.invocations = 0;
+    ei_tflite_session.active = true;
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Build an interpreter for graph_config on the arena already held by the
+ * persistent session and resolve its tensors into the session.
+ */
+static EI_IMPULSE_ERROR ei_tflite_session_build(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    const ei_config_tflite_graph_t *graph_config)
+{
+    ei_tflite_last_timing = { };
+    uint64_t phase_start_us = ei_read_timer_us();
+
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    tflite::MicroProfiler *profiler = (tflite::MicroProfiler*)ei_tflite_session.micro_profiler;
+#else
+    tflite::MicroProfilerInterface *profiler = nullptr;
+#endif
+
+    const tflite::Model* model = tflite::GetModel(graph_config->model);
+    tflite::MicroInterpreter *interpreter = new tflite::MicroInterpreter(
+        model, inference_tflite_resolver(), ei_tflite_session.tensor_arena,
+        ei_tflite_session.arena_capacity, nullptr, profiler);
+
+    ei_tflite_last_timing.interpreter_us = ei_read_timer_us() - phase_start_us;
+    phase_start_us = ei_read_timer_us();
+
+    if (interpreter->AllocateTensors(true) != kTfLiteOk) {
+        ei_printf("AllocateTensors() failed");
+        delete interpreter;
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    ei_tflite_last_timing.allocate_tensors_us = ei_read_timer_us() - phase_start_us;
+    ei_tflite_last_timing.arena_used_bytes = interpreter->arena_used_bytes();
+
+    ei_tflite_session.graph_config = graph_config;
+    ei_tflite_session.interpreter = interpreter;
+    ei_tflite_session.input = interpreter->input(0);
+    ei_tflite_session.output = interpreter->output(block_config->output_data_tensor);
+    ei_tflite_session.output_labels = nullptr;
+    ei_tflite_session.output_scores = nullptr;
+    if (block_config->object_detection_last_layer == EI_CLASSIFIER_LAST_LAYER_SSD) {
+        ei_tflite_session.output_scores = interpreter->output(block_config->output_score_tensor);
+        ei_tflite_session.output_labels = interpreter->output(block_config->output_labels_tensor);
+    }
+    ei_tflite_session.setup_timing = ei_tflite_last_timing;
+    ei_tflite_session.invocations = 0;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Replace the model of the persistent session without a restart
+ *
+ * The new graph must have the same inputs and outputs as the one it replaces
+ * (same impulse). When its arena fits in the arena already held by the
+ * session, only the interpreter is rebuilt on that arena; otherwise a new
+ * session is built first and the old one is released after it succeeds.
+ * On failure the previous model stays active. On success block_config
+ * points to graph_config, so run_classifier() keeps using it.
+ * Must not run concurrently with an inference.
+ *
+ * @param      block_config  Learning block of the active session
+ * @param      graph_config  Graph to switch to (must outlive the session)
+ *
+ * @return     EI_IMPULSE_OK if successful
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR ei_tflite_session_swap(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    const ei_config_tflite_graph_t *graph_config)
+{
+    const tflite::Model* model = tflite::GetModel(graph_config->model);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        ei_printf(
+            "Model provided is schema version %d not equal "
+            "to supported version %d.",
+            model->version(), TFLITE_SCHEMA_VERSION);
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    void *previous_config = block_config->graph_config;
+    if (ei_tflite_session.active && ei_tflite_session.graph_config == graph_config) {
+        return EI_IMPULSE_OK;
+    }
+
+    // Arena is large enough: rebuild the interpreter in place
+    if (ei_tflite_session.active && graph_config->arena_size <= ei_tflite_session.arena_capacity) {
+        ei_tflite_session_t previous = ei_tflite_session;
+        delete ei_tflite_session.interpreter;
+        ei_tflite_session.interpreter = nullptr;
+
+        EI_IMPULSE_ERROR res = ei_tflite_session_build(block_config, graph_config);
+        if (res != EI_IMPULSE_OK) {
+            // The previous model fitted this arena before, so it fits again
+            ei_tflite_session = previous;
+            ei_tflite_session.interpreter = nullptr;
+            if (ei_tflite_session_build(block_config,
+                    (const ei_config_tflite_graph_t*)previous.graph_config) != EI_IMPULSE_OK) {
+                ei_tflite_session_deinit();
+                return res;
+            }
+            ei_tflite_session.invocations = previous.invocations;
+            return res;
+        }
+        block_config->graph_config = (void*)graph_config;
+        return EI_IMPULSE_OK;
+    }
+
+#ifdef EI_CLASSIFIER_ALLOCATION_STATIC
+    if (ei_tflite_session.active) {
+        ei_printf("Model arena (%zu bytes) does not fit the static arena\n", graph_config->arena_size);
+        return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+    }
+#endif
+
+    // New arena: keep the old session until the new one is complete
+    ei_tflite_session_t previous = ei_tflite_session;
+    ei_tflite_session = { };
+    block_config->graph_config = (void*)graph_config;
+    EI_IMPULSE_ERROR res = ei_tflite_session_init(block_config);
+    if (res != EI_IMPULSE_OK) {
+        block_config->graph_config = previous_config;
+        ei_tflite_session = previous;
+        return res;
+    }
+    if (previous.active) {
+        ei_tflite_session_t current = ei_tflite_session;
+        ei_tflite_session = previous;
+        ei_tflite_session_deinit();
+        ei_tflite_session = current;
+    }
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Timing of the last inference, split per phase
+ */
+__attribute__((unused)) const ei_tflite_timing_t* ei_tflite_get_last_timing(void)
+{
+    return &ei_tflite_last_timing;
+}
+
+/**
+ * @brief      State of the persistent session (setup timing, invocation count)
+ */
+__attribute__((unused)) const ei_tflite_session_t* ei_tflite_get_session(void)
+{
+    return &ei_tflite_session;
+}
+
 __attribute__((unused)) int extract_tflite_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_tflite_t *dsp_config = (ei_dsp_config_tflite_t*)config_ptr;
 
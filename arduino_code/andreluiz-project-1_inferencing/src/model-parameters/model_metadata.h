@@ -86,7 +86,15 @@
 #define EI_CLASSIFIER_PROJECT_OWNER              "andreluiz"
 #define EI_CLASSIFIER_PROJECT_NAME               "andreluiz-project-1"
 #define EI_CLASSIFIER_PROJECT_DEPLOY_VERSION     1
+// Variante de 1 canal (tools/fold_grayscale_model.py): definir antes de incluir a biblioteca
+#ifndef EI_CLASSIFIER_GRAYSCALE_MODEL
+#define EI_CLASSIFIER_GRAYSCALE_MODEL            0
+#endif
+#if EI_CLASSIFIER_GRAYSCALE_MODEL
+#define EI_CLASSIFIER_NN_INPUT_FRAME_SIZE        9216
+#else
 #define EI_CLASSIFIER_NN_INPUT_FRAME_SIZE        27648
+#endif
 #define EI_CLASSIFIER_RAW_SAMPLE_COUNT           9216
 #define EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME      1
 #define EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE       (EI_CLASSIFIER_RAW_SAMPLE_COUNT * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME)
@@ -42,7 +42,19 @@
 #include <stdint.h>
 #include "model_metadata.h"
 
+#if EI_CLASSIFIER_GRAYSCALE_MODEL
+#include "tflite-model/tflite_learn_3_gray.h"
+#define ei_tflite_learn_3_model         tflite_learn_3_gray
+#define ei_tflite_learn_3_model_len     tflite_learn_3_gray_len
+#define ei_tflite_learn_3_arena_size    tflite_learn_3_gray_arena_size
+#define EI_DSP_CONFIG_2_CHANNELS        "Grayscale"
+#else
 #include "tflite-model/tflite_learn_3.h"
+#define ei_tflite_learn_3_model         tflite_learn_3
+#define ei_tflite_learn_3_model_len     tflite_learn_3_len
+#define ei_tflite_learn_3_arena_size    tflite_learn_3_arena_size
+#define EI_DSP_CONFIG_2_CHANNELS        "RGB"
+#endif
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/engines.h"
 
@@ -60,14 +72,14 @@ ei_dsp_config_image_t ei_dsp_config_2 = {
     1, // int length of axes
     ei_dsp_config_2_named_axes, // named axes
     ei_dsp_config_2_named_axes_size, // size of the named axes array
-    "RGB" // select channels
+    EI_DSP_CONFIG_2_CHANNELS // select channels
 };
 
 const uint8_t ei_dsp_blocks_size = 1;
 ei_model_dsp_t ei_dsp_blocks[ei_dsp_blocks_size] = {
     { // DSP block 2
         2,
-        27648, // output size
+        EI_CLASSIFIER_NN_INPUT_FRAME_SIZE, // output size
         &extract_image_features, // DSP function pointer
         (void*)&ei_dsp_config_2, // pointer to config struct
         ei_dsp_config_2_axes, // array of offsets into the input stream, one for each axis
@@ -79,9 +91,9 @@ ei_model_dsp_t ei_dsp_blocks[ei_dsp_blocks_size] = {
 };
 const ei_config_tflite_graph_t ei_config_tflite_graph_3 = {
     .implementation_version = 1,
-    .model = tflite_learn_3,
-    .model_size = tflite_learn_3_len,
-    .arena_size = tflite_learn_3_arena_size
+    .model = ei_tflite_learn_3_model,
+    .model_size = ei_tflite_learn_3_model_len,
+    .arena_size = ei_tflite_learn_3_arena_size
 };
 
 ei_learning_block_config_tflite_graph_t ei_learning_block_config_3 = {
@@ -131,7 +143,7 @@ const ei_impulse_t impulse_749110_0 = {
     .impulse_name = "Impulse #1",
     .deploy_version = 1,
 
-    .nn_input_frame_size = 27648,
+    .nn_input_frame_size = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE,
     .raw_sample_count = 9216,
     .raw_samples_per_frame = 1,
     .dsp_input_frame_size = 9216 * 1,
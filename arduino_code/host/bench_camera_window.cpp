@@ -0,0 +1,330 @@
+// =================== bench_camera_window.cpp ===================
+// Host: janela do sensor (camera_window.h) contra um OV2640 simulado. O mock
+// aplica as mesmas restrições do set_res_raw do esp32-camera e do driver
+// (tamanhos múltiplos de 4, janela dentro do modo, DSP só reduz, saída igual
+// ao frame_size do init) e renderiza uma cena com o painel de LEDs por média
+// de área. Confere o planejamento, o mapeamento referência <-> frame e que os
+// LEDs lidos pela janela 96x96 batem com a leitura no QVGA inteiro; mede
+// memória e tempo da conversão para a entrada do modelo.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -Iwashing_machine_monitor host/bench_camera_window.cpp -o bench_camera_window
+//
+// Uso: ./bench_camera_window [rois_aleatorios]
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "bench_check.h"
+#include "camera_window.h"
+#include "image_resize.h"
+#include "led_features.h"
+
+static const int MODEL_WIDTH = 96;
+static const int MODEL_HEIGHT = 96;
+static const int FB_COUNT = 2;              // config.fb_count do camera_manager.h
+static const int ITERATIONS = 500;
+
+// Cena em coordenadas UXGA (sensor inteiro): painel escuro com LEDs redondos
+static const int SCENE_WIDTH = 1600;
+static const int SCENE_HEIGHT = 1200;
+static const int LED_COUNT = 6;
+static const int LED_RADIUS = 30;           // 6 px de referência
+static const int LED_REF[LED_COUNT][2] = {
+    { 120, 100 }, { 150, 100 }, { 180, 100 }, { 120, 140 }, { 150, 140 }, { 180, 140 }
+};
+static uint16_t sceneMask = 0;
+
+static void scenePixel(int x, int y, int& r, int& g, int& b) {
+    r = 30 + x * 30 / SCENE_WIDTH;
+    g = 30 + y * 30 / SCENE_HEIGHT;
+    b = 35;
+    // Moldura do painel
+    if (x > 450 && x < 1150 && y > 380 && y < 820) {
+        r = g = b = 15;
+    }
+    for (int i = 0; i < LED_COUNT; i++) {
+        int dx = x - (LED_REF[i][0] * SCENE_WIDTH / CAMERA_REFERENCE_WIDTH);
+        int dy = y - (LED_REF[i][1] * SCENE_HEIGHT / CAMERA_REFERENCE_HEIGHT);
+        if (dx * dx + dy * dy <= LED_RADIUS * LED_RADIUS) {
+            bool on = sceneMask & (1 << i);
+            r = on ? 90 : 25;
+            g = on ? 250 : 35;
+            b = on ? 90 : 25;
+        }
+    }
+}
+
+// OV2640 simulado: registradores da janela e frame RGB565 da saída do DSP
+struct MockOv2640 {
+    int initWidth, initHeight;              // frame_size do esp_camera_init
+    bool windowed = false;
+    int mode = CAMERA_SENSOR_SVGA;
+    int offsetX = 0, offsetY = 0, width = 0, height = 0, outputWidth = 0, outputHeight = 0;
+    unsigned long rejected = 0;
+
+    int setResRaw(int startX, int startY, int endX, int endY, int offX, int offY,
+                  int totalX, int totalY, int outX, int outY, bool scale, bool binning) {
+        (void)startY; (void)endX; (void)endY; (void)scale; (void)binning;
+        bool valid = startX >= 0 && startX < CAMERA_SENSOR_MODES &&
+                     offX >= 0 && offY >= 0 && totalX > 0 && totalY > 0 &&
+                     totalX % 4 == 0 && totalY % 4 == 0 && outX % 4 == 0 && outY % 4 == 0 &&
+                     offX + totalX <= CAMERA_SENSOR_SIZE[startX][0] &&
+                     offY + totalY <= CAMERA_SENSOR_SIZE[startX][1] &&
+                     outX <= totalX && outY <= totalY &&
+                     // Driver: frame RGB565 com outro tamanho é descartado
+                     outX == initWidth && outY == initHeight;
+        if (!valid) {
+            rejected++;
+            return -1;
+        }
+        windowed = true;
+        mode = startX;
+        offsetX = offX;
+        offsetY = offY;
+        width = totalX;
+        height = totalY;
+        outputWidth = outX;
+        outputHeight = outY;
+        return 0;
+    }
+
+    // Média de área de cada pixel de saída, amostrada 4x4
+    void capture(std::vector<uint8_t>& frame) const {
+        int modeWidth = windowed ? CAMERA_SENSOR_SIZE[mode][0] : SCENE_WIDTH;
+        int modeHeight = windowed ? CAMERA_SENSOR_SIZE[mode][1] : SCENE_HEIGHT;
+        int wx = windowed ? offsetX : 0, wy = windowed ? offsetY : 0;
+        int ww = windowed ? width : SCENE_WIDTH, wh = windowed ? height : SCENE_HEIGHT;
+        int ow = windowed ? outputWidth : initWidth, oh = windowed ? outputHeight : initHeight;
+        frame.assign(ow * oh * 2, 0);
+        for (int y = 0; y < oh; y++) {
+            for (int x = 0; x < ow; x++) {
+                int sr = 0, sg = 0, sb = 0;
+                for (int sy = 0; sy < 4; sy++) {
+                    for (int sx = 0; sx < 4; sx++) {
+                        double mx = wx + (x + (sx + 0.5) / 4) * ww / ow;
+                        double my = wy + (y + (sy + 0.5) / 4) * wh / oh;
+                        int r, g, b;
+                        scenePixel((int)(mx * SCENE_WIDTH / modeWidth), (int)(my * SCENE_HEIGHT / modeHeight), r, g, b);
+                        sr += r; sg += g; sb += b;
+                    }
+                }
+                uint16_t pixel = (((sr / 16) >> 3) << 11) | (((sg / 16) >> 2) << 5) | ((sb / 16) >> 3);
+                frame[(y * ow + x) * 2] = pixel & 0xFF;
+                frame[(y * ow + x) * 2 + 1] = pixel >> 8;
+            }
+        }
+    }
+};
+
+static bool applyWindow(MockOv2640& sensor, const CameraWindow& w) {
+    return sensor.setResRaw(w.mode, 0, 0, 0, w.offsetX, w.offsetY, w.width, w.height,
+                            w.outputWidth, w.outputHeight, false, false) == 0;
+}
+
+static bool contains(const CameraRect& outer, const CameraRect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+// Mesmo mapeamento de readLedsFromFrame (led_calibration.h)
+static bool readLedsThroughWindow(const LedCalibration& cal, const CameraWindow& w,
+                                  const std::vector<uint8_t>& frame, LedReading& reading) {
+    LedCalibration windowed = cal;
+    if (cameraWindowScale(w) > LED_MAX_WINDOW_SCALE) {
+        reading.valid = false;
+        return false;
+    }
+    for (int i = 0; i < cal.spotCount; i++) {
+        int x, y;
+        if (!cameraReferenceToOutput(w, cal.spots[i].x, cal.spots[i].y, x, y)) {
+            reading.valid = false;
+            return false;
+        }
+        windowed.spots[i].x = (int16_t)x;
+        windowed.spots[i].y = (int16_t)y;
+    }
+    readLeds(windowed, frame.data(), w.outputWidth, w.outputHeight, reading);
+    return true;
+}
+
+static void checkPlanning(int randomRois) {
+    printf("\nPlanejamento (%d regioes aleatorias por modo, com e sem proporcao):\n", randomRois);
+    srand(4321);
+    MockOv2640 sensor = { MODEL_WIDTH, MODEL_HEIGHT };
+    unsigned long planned = 0, applied = 0, contained = 0, aspectOk = 0, aspectTotal = 0;
+    unsigned long roundTrips = 0, roundTripOk = 0;
+    for (int mode = 0; mode < CAMERA_SENSOR_MODES; mode++) {
+        for (int i = 0; i < randomRois; i++) {
+            CameraRect roi;
+            roi.width = CAMERA_WINDOW_MIN + rand() % (CAMERA_REFERENCE_WIDTH - CAMERA_WINDOW_MIN + 1);
+            roi.height = CAMERA_WINDOW_MIN + rand() % (CAMERA_REFERENCE_HEIGHT - CAMERA_WINDOW_MIN + 1);
+            roi.x = rand() % (CAMERA_REFERENCE_WIDTH - roi.width + 1);
+            roi.y = rand() % (CAMERA_REFERENCE_HEIGHT - roi.height + 1);
+            for (int keep = 0; keep < 2; keep++) {
+                CameraWindow w;
+                if (!planCameraWindow(roi, mode, MODEL_WIDTH, MODEL_HEIGHT, keep, w)) {
+                    continue;
+                }
+                planned++;
+                applied += applyWindow(sensor, w);
+                contained += contains(w.region, roi);
+                // Proporção só pode fugir de 1:1 quando o modo cortou a janela
+                if (keep && w.width < CAMERA_SENSOR_SIZE[mode][0] && w.height < CAMERA_SENSOR_SIZE[mode][1]) {
+                    aspectTotal++;
+                    aspectOk += abs(w.width - w.height) < CAMERA_WINDOW_ALIGN;
+                }
+                // Ida e volta de pontos da região: erro de até um pixel de saída
+                int tolerance = 1 + (w.region.width + w.outputWidth - 1) / w.outputWidth;
+                for (int p = 0; p < 8; p++) {
+                    int rx = roi.x + rand() % roi.width, ry = roi.y + rand() % roi.height;
+                    int ox, oy, bx, by;
+                    roundTrips++;
+                    if (cameraReferenceToOutput(w, rx, ry, ox, oy)) {
+                        cameraOutputToReference(w, ox, oy, bx, by);
+                        roundTripOk += abs(bx - rx) <= tolerance && abs(by - ry) <= tolerance &&
+                                       ox >= 0 && oy >= 0 && ox < w.outputWidth && oy < w.outputHeight;
+                    }
+                }
+            }
+        }
+    }
+    unsigned long total = (unsigned long)randomRois * CAMERA_SENSOR_MODES * 2;
+    printf("  planejadas %lu/%lu, aceitas pelo sensor %lu, rejeitadas %lu\n", planned, total, applied, sensor.rejected);
+    check(planned == total, "toda regiao valida gera uma janela");
+    check(applied == planned, "sensor aceita todas as janelas planejadas");
+    check(contained == planned, "regiao efetiva contem a regiao pedida");
+    check(aspectOk == aspectTotal, "proporcao da saida mantida quando cabe no modo");
+    check(roundTripOk == roundTrips, "ida e volta referencia -> frame -> referencia");
+
+    // Casos de borda
+    CameraWindow w;
+    check(planCameraWindow({ 304, 224, 16, 16 }, CAMERA_SENSOR_UXGA, MODEL_WIDTH, MODEL_HEIGHT, true, w) &&
+          w.offsetX + w.width == 1600 && w.offsetY + w.height == 1200 && applyWindow(sensor, w),
+          "regiao no canto inferior direito encosta na borda");
+    check(planCameraWindow({ 0, 0, 16, 16 }, CAMERA_SENSOR_CIF, MODEL_WIDTH, MODEL_HEIGHT, true, w) &&
+          w.width == MODEL_WIDTH && w.height == MODEL_HEIGHT && applyWindow(sensor, w),
+          "regiao pequena no CIF cresce ate a saida (sem ampliar)");
+    check(planCameraWindow({ 0, 0, 320, 240 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, false, w) &&
+          w.width == 800 && w.height == 600 && applyWindow(sensor, w),
+          "vista inteira sem proporcao usa o modo todo");
+    check(!planCameraWindow({ -1, 0, 100, 100 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, true, w) &&
+          !planCameraWindow({ 0, 0, 8, 100 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, true, w) &&
+          !planCameraWindow({ 300, 0, 40, 100 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, true, w) &&
+          !planCameraWindow({ 0, 0, 100, 100 }, CAMERA_SENSOR_MODES, MODEL_WIDTH, MODEL_HEIGHT, true, w),
+          "regioes e modos invalidos recusados");
+    MockOv2640 qvga = { 320, 240 };
+    planCameraWindow({ 100, 80, 100, 80 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, true, w);
+    check(!applyWindow(qvga, w), "mock recusa saida diferente do frame_size do init");
+}
+
+static void checkLeds() {
+    printf("\nLEDs pela janela contra o QVGA inteiro:\n");
+    LedCalibration cal;
+    resetLedCalibration(cal);
+    cal.spotCount = LED_COUNT;
+    for (int i = 0; i < LED_COUNT; i++) {
+        cal.spots[i].x = LED_REF[i][0];
+        cal.spots[i].y = LED_REF[i][1];
+    }
+
+    MockOv2640 full = { CAMERA_REFERENCE_WIDTH, CAMERA_REFERENCE_HEIGHT };
+    MockOv2640 roi = { MODEL_WIDTH, MODEL_HEIGHT };
+    CameraWindow windows[3];
+    const CameraRect regions[3] = { { 100, 80, 100, 80 }, { 90, 70, 140, 100 }, { 0, 0, 320, 240 } };
+    const int modes[3] = { CAMERA_SENSOR_SVGA, CAMERA_SENSOR_UXGA, CAMERA_SENSOR_CIF };
+    for (int i = 0; i < 3; i++) {
+        planCameraWindow(regions[i], modes[i], MODEL_WIDTH, MODEL_HEIGHT, false, windows[i]);
+    }
+
+    // A terceira (vista inteira em 96x96) deixa os LEDs com ~3 px: fica para a CNN
+    int patterns = 0, matches = 0, sure = 0, coarse = 0;
+    std::vector<uint8_t> qvgaFrame, roiFrame;
+    for (int mask = 0; mask < (1 << LED_COUNT); mask += 5) {
+        sceneMask = mask;
+        full.capture(qvgaFrame);
+        LedReading reference;
+        readLeds(cal, qvgaFrame.data(), CAMERA_REFERENCE_WIDTH, CAMERA_REFERENCE_HEIGHT, reference);
+        for (int i = 0; i < 3; i++) {
+            applyWindow(roi, windows[i]);
+            roi.capture(roiFrame);
+            LedReading reading;
+            if (i == 2) {
+                coarse += !readLedsThroughWindow(cal, windows[i], roiFrame, reading) && !reading.valid;
+                continue;
+            }
+            patterns++;
+            if (readLedsThroughWindow(cal, windows[i], roiFrame, reading)) {
+                matches += reading.mask == reference.mask && reference.mask == mask;
+                sure += reading.sure;
+            }
+        }
+    }
+    printf("  %d leituras, %d mascaras iguais, %d com certeza\n", patterns, matches, sure);
+    check(matches == patterns, "mascara pela janela = mascara no QVGA = cena");
+    check(sure == patterns, "leituras pela janela fora da faixa de duvida");
+    check(coarse == patterns / 2, "vista inteira em 96x96 nao usa o caminho rapido");
+
+    // LED fora da janela: leitura invalida (a CNN decide)
+    CameraWindow narrow;
+    planCameraWindow({ 100, 80, 60, 40 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, true, narrow);
+    applyWindow(roi, narrow);
+    roi.capture(roiFrame);
+    LedReading reading;
+    check(!readLedsThroughWindow(cal, narrow, roiFrame, reading) && !reading.valid,
+          "LED fora da janela invalida a leitura");
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point start, int iterations) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+static void measureConversion() {
+    printf("\nMemoria e conversao para a entrada do modelo (%dx%d RGB888):\n", MODEL_WIDTH, MODEL_HEIGHT);
+    MockOv2640 full = { CAMERA_REFERENCE_WIDTH, CAMERA_REFERENCE_HEIGHT };
+    MockOv2640 roi = { MODEL_WIDTH, MODEL_HEIGHT };
+    CameraWindow w;
+    planCameraWindow({ 100, 80, 100, 80 }, CAMERA_SENSOR_SVGA, MODEL_WIDTH, MODEL_HEIGHT, false, w);
+    applyWindow(roi, w);
+    sceneMask = 0x15;
+    std::vector<uint8_t> qvgaFrame, roiFrame;
+    full.capture(qvgaFrame);
+    roi.capture(roiFrame);
+    std::vector<uint8_t> out(MODEL_WIDTH * MODEL_HEIGHT * 3);
+    static ResizeScratch scratch;
+
+    double us[2];
+    const std::vector<uint8_t>* frames[2] = { &qvgaFrame, &roiFrame };
+    const int widths[2] = { CAMERA_REFERENCE_WIDTH, MODEL_WIDTH };
+    const int heights[2] = { CAMERA_REFERENCE_HEIGHT, MODEL_HEIGHT };
+    for (int i = 0; i < 2; i++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int it = 0; it < ITERATIONS; it++) {
+            Rgb888Sink sink = { out.data() };
+            resizeRgb565(frames[i]->data(), widths[i], heights[i], MODEL_WIDTH, MODEL_HEIGHT,
+                         IMAGE_RESIZE_SQUASH, scratch, sink);
+        }
+        us[i] = elapsedUs(start, ITERATIONS);
+    }
+    size_t qvgaBytes = qvgaFrame.size(), roiBytes = roiFrame.size();
+    printf("  %-22s %7zu bytes/frame  %7zu bytes de fb  %8.1f us\n", "QVGA inteiro",
+           qvgaBytes, qvgaBytes * FB_COUNT, us[0]);
+    printf("  %-22s %7zu bytes/frame  %7zu bytes de fb  %8.1f us\n", "janela 96x96",
+           roiBytes, roiBytes * FB_COUNT, us[1]);
+    printf("  DMA/fb %.1fx menor, conversao %.1fx mais rapida\n", (double)qvgaBytes / roiBytes, us[0] / us[1]);
+    check(roiBytes * 8 < qvgaBytes, "frame da janela ao menos 8x menor");
+}
+
+int main(int argc, char** argv) {
+    int randomRois = argc > 1 ? atoi(argv[1]) : 2000;
+    printf("Janela do sensor OV2640 (camera_window.h) contra sensor simulado\n");
+    checkPlanning(randomRois);
+    checkLeds();
+    measureConversion();
+    return checkSummary();
+}
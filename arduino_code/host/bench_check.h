@@ -0,0 +1,26 @@
+// =================== bench_check.h ===================
+// Conferências dos programas de host/: cada check() imprime uma linha
+// "ok"/"FALHOU" e checkSummary() fecha com OK ou FALHA e o código de saída
+// (1 se alguma conferência não bateu).
+//
+//   check(stats.dropped == 0, "nenhum frame descartado");
+//   return checkSummary();
+
+#ifndef BENCH_CHECK_H
+#define BENCH_CHECK_H
+
+#include <stdio.h>
+
+static bool checksOk = true;
+
+static void check(bool condition, const char* what) {
+    printf("  %-58s %s\n", what, condition ? "ok" : "FALHOU");
+    if (!condition) checksOk = false;
+}
+
+static int checkSummary() {
+    printf("\n%s\n", checksOk ? "OK" : "FALHA");
+    return checksOk ? 0 : 1;
+}
+
+#endif // BENCH_CHECK_H
@@ -0,0 +1,255 @@
+// =================== bench_grayscale.cpp ===================
+// Host: modelo RGB (entrada 96x96x3) contra a variante de 1 canal gerada por
+// tools/fold_grayscale_model.py (96x96x1), nas imagens de data_collection/.
+// Cada JPEG vira o frame que a câmera entregaria (QVGA RGB565 ou QVGA em
+// escala de cinza), passa pelo mesmo resizeFrame + QuantizedSink do
+// dispositivo e roda no TFLite Micro do SDK. Compara latência, arena usada,
+// memória de frame e acerto por etapa; confere que a variante de 1 canal
+// concorda com o modelo RGB alimentado com a luma replicada (Y, Y, Y).
+//
+// Compilar a partir de arduino_code/ (o SDK leva alguns minutos):
+//   EI=andreluiz-project-1_inferencing/src
+//   g++ -O2 -std=c++17 -w -Iwashing_machine_monitor -I$EI -DTF_LITE_STATIC_MEMORY \
+//       -DEI_PORTING_CLIB=1 -DEIDSP_USE_CMSIS_DSP=0 host/bench_grayscale.cpp \
+//       $(find $EI/edge-impulse-sdk/tensorflow $EI/edge-impulse-sdk/porting/clib \
+//              $EI/edge-impulse-sdk/dsp/kissfft -name '*.cpp' -o -name '*.c') \
+//       -ljpeg -o bench_grayscale
+//
+// Uso: ./bench_grayscale [pasta_data_collection]
+
+#include <chrono>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <jpeglib.h>
+
+#include "bench_check.h"
+#include "image_resize.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_interpreter.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
+#include "tflite-model/tflite_learn_3.h"
+#include "tflite-model/tflite_learn_3_gray.h"
+#include "tflite-model/tflite-resolver.h"
+
+static const int FRAME_WIDTH = 320;             // FRAMESIZE_QVGA
+static const int FRAME_HEIGHT = 240;
+static const int MODEL_WIDTH = 96;
+static const int MODEL_HEIGHT = 96;
+static const int LABELS = 6;
+static const int FB_COUNT = 2;
+static const int TIMING_RUNS = 20;
+
+// Pastas de data_collection/ na ordem das classes do modelo
+static const char* const FOLDERS[LABELS] = {
+    "centrifugacao", "desligado", "enxague", "molho_curto", "molho_longo", "molho_normal"
+};
+
+struct Sample {
+    std::string path;
+    int label;
+    std::vector<uint8_t> rgb565;        // frame QVGA como PIXFORMAT_RGB565
+    std::vector<uint8_t> gray;          // frame QVGA como PIXFORMAT_GRAYSCALE
+};
+
+// JPEG -> QVGA por média de área (a câmera reduz no DSP do sensor)
+static bool loadFrame(const std::string& path, Sample& sample) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, f);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    int w = cinfo.output_width, h = cinfo.output_height;
+    std::vector<uint8_t> rgb((size_t)w * h * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = &rgb[(size_t)cinfo.output_scanline * w * 3];
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(f);
+
+    sample.rgb565.resize(FRAME_WIDTH * FRAME_HEIGHT * 2);
+    sample.gray.resize(FRAME_WIDTH * FRAME_HEIGHT);
+    for (int y = 0; y < FRAME_HEIGHT; y++) {
+        int y0 = y * h / FRAME_HEIGHT, y1 = std::max(y0 + 1, (y + 1) * h / FRAME_HEIGHT);
+        for (int x = 0; x < FRAME_WIDTH; x++) {
+            int x0 = x * w / FRAME_WIDTH, x1 = std::max(x0 + 1, (x + 1) * w / FRAME_WIDTH);
+            int sum[3] = { 0, 0, 0 }, n = 0;
+            for (int sy = y0; sy < y1; sy++) {
+                for (int sx = x0; sx < x1; sx++, n++) {
+                    for (int c = 0; c < 3; c++) sum[c] += rgb[((size_t)sy * w + sx) * 3 + c];
+                }
+            }
+            int r = sum[0] / n, g = sum[1] / n, b = sum[2] / n;
+            uint16_t pixel = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+            sample.rgb565[(y * FRAME_WIDTH + x) * 2] = pixel & 0xFF;
+            sample.rgb565[(y * FRAME_WIDTH + x) * 2 + 1] = pixel >> 8;
+            // Y do YUV422 do OV2640 (BT.601)
+            sample.gray[y * FRAME_WIDTH + x] = (uint8_t)((r * 19595 + g * 38470 + b * 7471 + 32768) >> 16);
+        }
+    }
+    return true;
+}
+
+static std::vector<Sample> loadDataset(const std::string& root) {
+    std::vector<Sample> samples;
+    for (int label = 0; label < LABELS; label++) {
+        std::string dir = root + "/" + FOLDERS[label];
+        DIR* d = opendir(dir.c_str());
+        if (!d) continue;
+        std::vector<std::string> names;
+        while (dirent* e = readdir(d)) {
+            std::string name = e->d_name;
+            if (name.size() > 4 && name.substr(name.size() - 4) == ".jpg") names.push_back(name);
+        }
+        closedir(d);
+        std::sort(names.begin(), names.end());
+        for (const std::string& name : names) {
+            Sample s;
+            s.path = dir + "/" + name;
+            s.label = label;
+            if (loadFrame(s.path, s)) samples.push_back(std::move(s));
+        }
+    }
+    return samples;
+}
+
+// Interpretador persistente como o da sessão do SDK (ei_tflite_session)
+struct Runner {
+    const char* name;
+    tflite::MicroInterpreter* interpreter = nullptr;
+    std::vector<uint8_t> arena;
+    size_t arenaSize = 0;
+    size_t inputElements = 0;
+
+    bool begin(const char* label, const unsigned char* model, size_t declaredArena) {
+        // Mesmos operadores do SDK (tflite-resolver.h), nas duas variantes
+        EI_TFLITE_RESOLVER
+        name = label;
+        arenaSize = declaredArena;
+        arena.assign(declaredArena + 16, 0);
+        uint8_t* aligned = (uint8_t*)(((uintptr_t)arena.data() + 15) & ~(uintptr_t)15);
+        interpreter = new tflite::MicroInterpreter(tflite::GetModel(model), resolver, aligned, declaredArena);
+        if (interpreter->AllocateTensors(true) != kTfLiteOk) return false;
+        inputElements = interpreter->input(0)->bytes;
+        return true;
+    }
+
+    size_t used() const { return interpreter->arena_used_bytes(); }
+
+    // Frame -> tensor (resize + quantização numa passada) -> classe
+    int classify(const uint8_t* frame, int format, float* probs, double* convertUs, double* invokeUs) {
+        static ResizeScratch scratch;
+        TfLiteTensor* input = interpreter->input(0);
+        int8_t quant[256];
+        buildQuantizationTable(input->params.scale, input->params.zero_point, quant);
+        QuantizedSink sink = { input->data.int8, quant, inputElements == (size_t)(MODEL_WIDTH * MODEL_HEIGHT) };
+
+        auto t0 = std::chrono::steady_clock::now();
+        resizeFrame(frame, FRAME_WIDTH, FRAME_HEIGHT, format, MODEL_WIDTH, MODEL_HEIGHT,
+                    IMAGE_RESIZE_SQUASH, scratch, sink);
+        auto t1 = std::chrono::steady_clock::now();
+        interpreter->Invoke();
+        auto t2 = std::chrono::steady_clock::now();
+        if (convertUs) *convertUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        if (invokeUs) *invokeUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+
+        TfLiteTensor* output = interpreter->output(0);
+        int best = 0;
+        for (int i = 0; i < LABELS; i++) {
+            probs[i] = (output->data.int8[i] - output->params.zero_point) * output->params.scale;
+            if (probs[i] > probs[best]) best = i;
+        }
+        return best;
+    }
+};
+
+struct Score {
+    int correct[LABELS] = {}, total[LABELS] = {};
+    double convertUs = 0, invokeUs = 0;
+    int runs = 0;
+
+    int allCorrect() const { int n = 0; for (int i = 0; i < LABELS; i++) n += correct[i]; return n; }
+    int all() const { int n = 0; for (int i = 0; i < LABELS; i++) n += total[i]; return n; }
+};
+
+int main(int argc, char** argv) {
+    std::string root = argc > 1 ? argv[1] : "../data_collection";
+    printf("Modelo RGB contra variante de 1 canal (data_collection: %s)\n", root.c_str());
+    std::vector<Sample> samples = loadDataset(root);
+    if (samples.empty()) {
+        printf("ERRO: nenhuma imagem em %s\n", root.c_str());
+        return 1;
+    }
+
+    Runner rgb, gray;
+    if (!rgb.begin("RGB", tflite_learn_3, tflite_learn_3_arena_size) ||
+        !gray.begin("cinza", tflite_learn_3_gray, tflite_learn_3_gray_arena_size)) {
+        printf("ERRO: AllocateTensors falhou\n");
+        return 1;
+    }
+
+    Score rgbScore, grayScore, lumaScore;
+    int agree = 0;
+    float maxDiff = 0;
+    for (const Sample& s : samples) {
+        float pr[LABELS], pg[LABELS], pl[LABELS];
+        int a = rgb.classify(s.rgb565.data(), IMAGE_PIXEL_RGB565, pr, nullptr, nullptr);
+        int b = gray.classify(s.gray.data(), IMAGE_PIXEL_GRAY8, pg, nullptr, nullptr);
+        int c = rgb.classify(s.gray.data(), IMAGE_PIXEL_GRAY8, pl, nullptr, nullptr);   // (Y, Y, Y)
+        rgbScore.total[s.label]++;   rgbScore.correct[s.label] += a == s.label;
+        grayScore.total[s.label]++;  grayScore.correct[s.label] += b == s.label;
+        lumaScore.total[s.label]++;  lumaScore.correct[s.label] += c == s.label;
+        agree += b == c;
+        for (int i = 0; i < LABELS; i++) maxDiff = std::max(maxDiff, fabsf(pg[i] - pl[i]));
+    }
+
+    // Latência: mesmas imagens, depois do aquecimento
+    float probs[LABELS];
+    for (int r = 0; r < TIMING_RUNS; r++) {
+        const Sample& s = samples[r % samples.size()];
+        rgb.classify(s.rgb565.data(), IMAGE_PIXEL_RGB565, probs, &rgbScore.convertUs, &rgbScore.invokeUs);
+        gray.classify(s.gray.data(), IMAGE_PIXEL_GRAY8, probs, &grayScore.convertUs, &grayScore.invokeUs);
+    }
+
+    printf("\n%d imagens\n", (int)samples.size());
+    printf("  %-14s %9s %9s %11s %11s %9s %9s\n", "modelo", "entrada", "frame", "arena usada", "declarada",
+           "conv us", "invoke us");
+    const Runner* runners[2] = { &rgb, &gray };
+    const Score* scores[2] = { &rgbScore, &grayScore };
+    const size_t frames[2] = { (size_t)FRAME_WIDTH * FRAME_HEIGHT * 2, (size_t)FRAME_WIDTH * FRAME_HEIGHT };
+    for (int i = 0; i < 2; i++) {
+        printf("  %-14s %9zu %9zu %11zu %11zu %9.1f %9.1f\n", runners[i]->name, runners[i]->inputElements,
+               frames[i] * FB_COUNT, runners[i]->used(), runners[i]->arenaSize,
+               scores[i]->convertUs / TIMING_RUNS, scores[i]->invokeUs / TIMING_RUNS);
+    }
+
+    printf("\n  acerto por etapa      RGB   cinza  RGB(Y,Y,Y)\n");
+    for (int i = 0; i < LABELS; i++) {
+        printf("  %-16s %3d/%-3d %3d/%-3d %3d/%-3d\n", FOLDERS[i],
+               rgbScore.correct[i], rgbScore.total[i], grayScore.correct[i], grayScore.total[i],
+               lumaScore.correct[i], lumaScore.total[i]);
+    }
+    int n = rgbScore.all();
+    printf("  %-16s %5.1f%%  %5.1f%%  %5.1f%%\n", "total", 100.0 * rgbScore.allCorrect() / n,
+           100.0 * grayScore.allCorrect() / n, 100.0 * lumaScore.allCorrect() / n);
+    printf("  cinza x RGB(Y,Y,Y): %d/%d iguais, diferenca max de probabilidade %.3f\n", agree, n, maxDiff);
+
+    printf("\n");
+    check(gray.inputElements == (size_t)MODEL_WIDTH * MODEL_HEIGHT, "variante de 1 canal com entrada 96x96x1");
+    check(gray.used() <= gray.arenaSize && rgb.used() <= rgb.arenaSize, "arenas dentro do tamanho declarado");
+    check(gray.used() <= rgb.used(), "arena da variante de 1 canal nao maior que a RGB");
+    check(grayScore.convertUs < rgbScore.convertUs, "conversao do frame cinza mais rapida");
+    check(agree >= n * 97 / 100, "variante de 1 canal = modelo RGB com (Y, Y, Y) em 97%");
+    return checkSummary();
+}
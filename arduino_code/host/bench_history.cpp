@@ -0,0 +1,277 @@
+// =================== bench_history.cpp ===================
+// Histórico em flash (history_log.h) no host: simula semanas de uso com o
+// decodificador e o agendador reais sobre uma flash NOR emulada em RAM
+// (gravar só zera bits, apagar volta o setor a 0xFF) do tamanho da partição
+// "history". Mede compressão, bytes gravados e setores apagados por dia,
+// confere remontagem após reboot e gravação interrompida, e serve /history
+// pelo HttpServer (chunked) comparando com a consulta direta.
+// Falha (código de saída 1) se alguma conferência não bater.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -pthread -Iwashing_machine_monitor -Ihost host/bench_history.cpp -o bench_history
+//
+// Uso: ./bench_history [dias]
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "bench_check.h"
+#include "wash_cycle_sim.h"
+#include "prediction_scheduler.h"
+#include "history_log.h"
+#include "http_server.h"
+
+static const size_t PARTITION_SIZE = 0xE0000;       // partitions.csv
+static const uint32_t EPOCH_START = 1700000000;
+
+struct NorFlash {
+    std::vector<uint8_t> bytes = std::vector<uint8_t>(PARTITION_SIZE, 0xFF);
+    unsigned long bytesWritten = 0;
+
+    bool read(size_t offset, void* buf, size_t len) const {
+        if (offset + len > bytes.size()) return false;
+        memcpy(buf, &bytes[offset], len);
+        return true;
+    }
+    bool write(size_t offset, const void* buf, size_t len) {
+        if (offset + len > bytes.size()) return false;
+        const uint8_t* src = (const uint8_t*)buf;
+        for (size_t i = 0; i < len; i++) bytes[offset + i] &= src[i];
+        bytesWritten += len;
+        return true;
+    }
+    bool erase(size_t offset) {
+        if (offset % HISTORY_SECTOR_SIZE || offset + HISTORY_SECTOR_SIZE > bytes.size()) return false;
+        memset(&bytes[offset], 0xFF, HISTORY_SECTOR_SIZE);
+        return true;
+    }
+    size_t size() const { return bytes.size(); }
+};
+
+static NorFlash flash;
+static HistoryLog<NorFlash> historyLog;
+// Consulta completa em pedaços de "chunk" bytes, como o servidor faria
+static std::string queryJson(uint32_t from, uint32_t to, size_t chunk) {
+    HistoryCursor cursor;
+    historyQuery(historyLog, cursor, from, to);
+    std::string out;
+    std::vector<char> buf(chunk);
+    size_t n;
+    while ((n = historyWriteJson(historyLog, cursor, STAGE_NAMES, STAGES, buf.data(), buf.size())) > 0) {
+        out.append(buf.data(), n);
+    }
+    return out;
+}
+
+static size_t countRecords(const std::string& json) {
+    size_t count = 0;
+    for (size_t p = json.find("\"seq\""); p != std::string::npos; p = json.find("\"seq\"", p + 1)) count++;
+    return count;
+}
+
+// Registros em [from, to] lidos um a um, sem o cursor
+static size_t directCount(uint32_t from, uint32_t to) {
+    size_t count = 0;
+    for (uint32_t s = historyLog.oldestSequence(); s < historyLog.nextSequence; s++) {
+        HistoryRecord r;
+        if (historyLog.read(s, r) && r.time <= to && r.time + r.span >= from) count++;
+    }
+    return count;
+}
+
+// Simula "days" dias: 1 ou 2 ciclos por dia, o resto desligada
+static void simulate(int days, const StageDecoderConfig& cfg) {
+    FakeCnn cnn;
+    StageDecoder decoder;
+    decoder.begin(&cfg, DESLIGADO);
+    PredictionScheduler scheduler;
+    scheduler.begin();
+
+    double t = 0, lastFlush = 0, previousT = 0;
+    int previousStage = -1;
+    for (int day = 0; day < days; day++) {
+        std::vector<Segment> timeline;
+        float busy = 0;
+        int cycles = 1 + (int)(rng() % 2);
+        for (int c = 0; c < cycles; c++) {
+            for (const Segment& s : randomCycle(cfg)) {
+                timeline.push_back(s);
+                busy += s.seconds;
+            }
+        }
+        timeline.push_back({ DESLIGADO, 86400.0f - busy });
+
+        double dayStart = day * 86400.0;
+        double segmentStart = dayStart;
+        for (const Segment& segment : timeline) {
+            double segmentEnd = segmentStart + segment.seconds;
+            while (t < segmentEnd) {
+                float probs[STAGES];
+                cnn.classify(segment.stage, probs);
+                bool panelChanged = segment.stage != previousStage || uniform(0, 1) < 0.03f;
+                previousStage = segment.stage;
+                bool changed = decoder.update(probs, (float)(t - previousT));
+                historyLog.append(EPOCH_START + (uint32_t)t, (uint8_t)decoder.label, decoder.belief, STAGES);
+                if (changed) {
+                    historyLog.flush();
+                    lastFlush = t;
+                } else if (t - lastFlush >= 300) {
+                    historyLog.closeRun();
+                    historyLog.flush();
+                    lastFlush = t;
+                }
+                previousT = t;
+                t += scheduler.update(decoder, panelChanged) / 1000.0;
+            }
+            segmentStart = segmentEnd;
+        }
+    }
+    historyLog.closeRun();
+    historyLog.flush();
+}
+
+// =================== SERVIDOR ===================
+
+static size_t producer(void* state, char* buf, size_t size) {
+    return historyWriteJson(historyLog, *(HistoryCursor*)state, STAGE_NAMES, STAGES, buf, size);
+}
+
+static void handleHistory(HttpConnection& conn, const HttpRequest& req) {
+    uint32_t from = (uint32_t)req.argInt("from", 0);
+    uint32_t to = req.hasArg("to") ? (uint32_t)req.argInt("to", 0) : 0xFFFFFFFFu;
+    HistoryCursor* cursor = (HistoryCursor*)conn.sendChunked(200, "application/json", producer, sizeof(HistoryCursor));
+    historyQuery(historyLog, *cursor, from, to);
+}
+
+// GET com keep-alive; devolve o corpo decodificado (chunked)
+static std::string httpGet(int fd, const char* path, bool* chunkedOk) {
+    char request[256];
+    int n = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: lavadora\r\n\r\n", path);
+    send(fd, request, n, MSG_NOSIGNAL);
+
+    std::string raw;
+    char buf[4096];
+    size_t bodyStart = std::string::npos;
+    while (true) {
+        ssize_t r = recv(fd, buf, sizeof(buf), 0);
+        if (r <= 0) break;
+        raw.append(buf, r);
+        if (bodyStart == std::string::npos) bodyStart = raw.find("\r\n\r\n");
+        if (bodyStart != std::string::npos && raw.size() >= 5 && raw.compare(raw.size() - 5, 5, "0\r\n\r\n") == 0) break;
+    }
+    *chunkedOk = raw.find("Transfer-Encoding: chunked") != std::string::npos;
+
+    std::string body;
+    size_t p = bodyStart + 4;
+    while (p < raw.size()) {
+        size_t lineEnd = raw.find("\r\n", p);
+        size_t size = strtoul(raw.c_str() + p, nullptr, 16);
+        if (size == 0 || lineEnd == std::string::npos) break;
+        body.append(raw, lineEnd + 2, size);
+        p = lineEnd + 2 + size + 2;
+    }
+    return body;
+}
+
+int main(int argc, char** argv) {
+    int days = argc > 1 ? atoi(argv[1]) : 90;
+
+    static StageDecoderConfig cfg;
+    configureSimulatedCycle(cfg);
+    historyLog.begin(&flash);
+
+    simulate(days, cfg);
+    uint32_t stored = historyLog.nextSequence - historyLog.oldestSequence();
+    uint32_t sectors = historyLog.capacity / HISTORY_RECORDS_PER_SECTOR;
+    double recordsPerDay = (double)historyLog.recordsWritten / days;
+    double erasesPerDay = (double)historyLog.sectorErases / days;
+
+    printf("%d dias simulados, particao de %u KB (%lu registros, %u setores)\n",
+           days, (unsigned)(PARTITION_SIZE / 1024), (unsigned long)historyLog.capacity, sectors);
+    printf("  amostras: %lu -> registros: %lu (%.1f amostras/registro)\n",
+           (unsigned long)historyLog.samples, (unsigned long)historyLog.recordsWritten,
+           (double)historyLog.samples / historyLog.recordsWritten);
+    printf("  por dia: %.0f registros, %.1f KB gravados, %.0f gravacoes, %.2f setores apagados\n",
+           recordsPerDay, flash.bytesWritten / 1024.0 / days, (double)historyLog.flushes / days, erasesPerDay);
+    printf("  sem compressao seriam %.1f KB/dia\n",
+           (double)historyLog.samples * sizeof(HistoryRecord) / 1024.0 / days);
+    printf("  a particao guarda %.0f dias; cada setor e apagado a cada %.0f dias (%.0f anos ate 100k ciclos)\n",
+           historyLog.capacity / recordsPerDay, sectors / erasesPerDay,
+           100000.0 * sectors / erasesPerDay / 365.0);
+
+    printf("Conferencias:\n");
+    std::string all = queryJson(0, 0xFFFFFFFFu, 2000);
+    check(countRecords(all) == stored && directCount(0, 0xFFFFFFFFu) == stored,
+          "consulta completa devolve todos os registros da flash");
+    check(queryJson(0, 0xFFFFFFFFu, 210) == all, "mesma saida com pedacos de 210 bytes");
+
+    // Intervalo no meio: confere contra varredura direta
+    HistoryRecord middle;
+    historyLog.read((historyLog.oldestSequence() + historyLog.nextSequence) / 2, middle);
+    uint32_t from = middle.time, to = from + 86400;
+    size_t expected = directCount(from, to);
+    std::string day = queryJson(from, to, 2000);
+    check(expected > 0 && countRecords(day) == expected, "consulta de 1 dia bate com a varredura direta");
+
+    // Reboot: remontar acha o mesmo fim do anel
+    uint32_t next = historyLog.nextSequence;
+    static HistoryLog<NorFlash> remounted;
+    remounted.begin(&flash);
+    check(remounted.nextSequence == next, "remontagem acha o proximo numero de sequencia");
+
+    // Gravação interrompida: metade de um registro no próximo slot
+    HistoryRecord torn;
+    memset(&torn, 0, sizeof(torn));
+    torn.sequence = next;
+    flash.write((next % historyLog.capacity) * sizeof(HistoryRecord), &torn, sizeof(torn) / 2);
+    historyLog.begin(&flash);
+    check(historyLog.nextSequence > next, "slot com lixo e pulado na remontagem");
+    float belief[STAGES] = { 0, 1, 0, 0, 0, 0 };
+    historyLog.append(EPOCH_START + days * 86400 + 10, DESLIGADO, belief, STAGES);
+    historyLog.closeRun();
+    historyLog.flush();
+    HistoryRecord r;
+    check(historyLog.read(historyLog.nextSequence - 1, r) && r.stage == DESLIGADO, "registro novo depois do lixo le de volta");
+    check(!historyLog.read(next, r), "slot com lixo nao e lido como registro");
+    all = queryJson(0, 0xFFFFFFFFu, 2000);
+    check(countRecords(all) == directCount(0, 0xFFFFFFFFu), "consulta ignora o slot com lixo");
+
+    // /history pelo servidor: chunked, keep-alive, mesmo conteúdo
+    static HttpServer server;
+    server.on("/history", handleHistory);
+    if (!server.begin(18084)) {
+        printf("Falha ao abrir porta 18084\n");
+        return 1;
+    }
+    std::atomic<bool> running(true);
+    std::thread serverThread([&]() {
+        while (running) server.poll(10);
+    });
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(18084);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+
+    bool chunked = false;
+    std::string body = httpGet(fd, "/history", &chunked);
+    check(chunked && body == all, "/history completo (chunked) igual a consulta direta");
+    char path[96];
+    snprintf(path, sizeof(path), "/history?from=%u&to=%u", from, to);
+    body = httpGet(fd, path, &chunked);
+    check(body == day, "/history?from=&to= na mesma conexao (keep-alive)");
+    printf("  /history completo: %zu bytes com buffer de saida de %d bytes por conexao\n",
+           all.size(), HTTP_OUTPUT_BUFFER);
+    close(fd);
+
+    running = false;
+    serverThread.join();
+    server.stop();
+
+    return checkSummary();
+}
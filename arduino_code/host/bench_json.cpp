@@ -0,0 +1,189 @@
+// =================== bench_json.cpp ===================
+// Micro-benchmark do JSON de /status: concatenação de strings (como o
+// String do Arduino fazia) vs JsonWriter em buffer fixo, com contador de
+// alocações do heap. Também passa requisições reais pelo HttpServer e
+// falha (código de saída 1) se o caminho da requisição alocar.
+//
+// Compilar a partir de arduino_code/ (glibc: malloc é interceptado):
+//   g++ -O2 -std=c++17 -pthread -Iwashing_machine_monitor host/bench_json.cpp -o bench_json
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+#include "json_writer.h"
+#include "http_server.h"
+
+// =================== CONTADOR DE ALOCAÇÕES ===================
+// Por thread: o cliente de teste aloca à vontade sem contaminar o servidor
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+static thread_local unsigned long allocations = 0;
+
+extern "C" void* malloc(size_t size) {
+    allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+// Valores típicos de /status
+static const char* stage = "Molho_normal";
+static float confidence = 0.87f;
+static unsigned long timestampMs = 12345678;
+static unsigned long uptime = 12345;
+static uint32_t heap = 187432;
+static int rssi = -61;
+static uint32_t skipped = 4210, run = 377;
+
+// Como o handleStatus antigo: uma String temporária por campo
+static std::string statusWithStrings() {
+    std::string json = "{";
+    json += "\"stage\":\"" + std::string(stage) + "\",";
+    json += "\"confidence\":" + std::to_string(confidence) + ",";
+    json += "\"timestamp\":" + std::to_string(timestampMs) + ",";
+    json += "\"uptime\":" + std::to_string(uptime) + ",";
+    json += "\"heap\":" + std::to_string(heap) + ",";
+    json += "\"wifi_rssi\":" + std::to_string(rssi) + ",";
+    json += "\"inferences_skipped\":" + std::to_string(skipped) + ",";
+    json += "\"inferences_run\":" + std::to_string(run) + ",";
+    json += "\"mode\":\"demonstration\"";
+    json += "}";
+    return json;
+}
+
+static size_t statusWithWriter(char* body, size_t size) {
+    JsonWriter json(body, size);
+    json.beginObject()
+        .field("stage", stage)
+        .field("confidence", confidence)
+        .field("timestamp", timestampMs)
+        .field("uptime", uptime)
+        .field("heap", heap)
+        .field("wifi_rssi", rssi)
+        .field("inferences_skipped", skipped)
+        .field("inferences_run", run)
+        .field("mode", "demonstration")
+        .endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+// =================== SERVIDOR ===================
+
+static void handleStatus(HttpConnection& conn, const HttpRequest& req) {
+    char body[320];
+    size_t len = statusWithWriter(body, sizeof(body));
+    conn.send(200, "application/json", body, len);
+}
+
+static unsigned long requestPathAllocations(int requests) {
+    static HttpServer server;
+    server.on("/status", handleStatus);
+    if (!server.begin(18083)) {
+        printf("Falha ao abrir porta 18083\n");
+        return ~0UL;
+    }
+
+    std::atomic<bool> running(true);
+    std::atomic<unsigned long> serverAllocations(0);
+    std::atomic<bool> measuring(false);
+
+    std::thread serverThread([&]() {
+        unsigned long start = 0;
+        bool counting = false;
+        while (running) {
+            server.poll(10);
+            if (measuring && !counting) {
+                start = allocations;
+                counting = true;
+            }
+        }
+        serverAllocations = allocations - start;
+    });
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(18083);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    // Nova conexão a cada 50 requisições (abaixo de HTTP_MAX_KEEPALIVE_REQUESTS)
+    static const char request[] = "GET /status HTTP/1.1\r\nHost: lavadora\r\n\r\n";
+    char response[1024];
+    int fd = -1;
+    for (int i = 0; i < requests + 10; i++) {
+        if (i == 10) {
+            measuring = true;       // 10 primeiras: aquecimento
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        }
+        if (i % 50 == 0) {
+            if (fd >= 0) close(fd);
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+        }
+        send(fd, request, sizeof(request) - 1, MSG_NOSIGNAL);
+        recv(fd, response, sizeof(response), 0);
+    }
+    close(fd);
+
+    running = false;
+    serverThread.join();
+    server.stop();
+    return serverAllocations;
+}
+
+int main() {
+    const int iterations = 200000;
+    char body[320];
+
+    // Mesma saída nos dois caminhos (exceto casas decimais do float)
+    printf("JsonWriter: %.*s\n", (int)statusWithWriter(body, sizeof(body)), body);
+
+    unsigned long before = allocations;
+    Clock::time_point start = Clock::now();
+    size_t total = 0;
+    for (int i = 0; i < iterations; i++) {
+        uptime++;
+        total += statusWithStrings().size();
+    }
+    double stringsNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    double stringsAllocs = (double)(allocations - before) / iterations;
+
+    before = allocations;
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        uptime++;
+        total += statusWithWriter(body, sizeof(body));
+    }
+    double writerNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    double writerAllocs = (double)(allocations - before) / iterations;
+
+    printf("Strings concatenadas: %7.1f ns/req  %5.1f alocacoes/req\n", stringsNs, stringsAllocs);
+    printf("JsonWriter:           %7.1f ns/req  %5.1f alocacoes/req  (%.1fx)\n",
+           writerNs, writerAllocs, stringsNs / writerNs);
+
+    const int requests = 1000;
+    unsigned long serverAllocs = requestPathAllocations(requests);
+    printf("HttpServer + JsonWriter: %lu alocacoes em %d requisicoes keep-alive\n", serverAllocs, requests);
+
+    (void)total;
+    bool ok = writerAllocs == 0 && serverAllocs == 0;
+    printf("%s\n", ok ? "OK: nenhuma alocacao por requisicao" : "FALHA: caminho da requisicao alocou");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+// =================== bench_metrics.cpp ===================
+// Histogramas do /metrics (metrics.h): um escritor atualiza sem locks
+// enquanto outro thread lê sem parar, e nenhuma cópia aceita pode sair
+// rasgada (soma e faixas de escritas diferentes). Mede o custo de
+// observe() contra a mesma atualização sob mutex, confere o texto do
+// Prometheus e passa requisições reais pelo HttpServer para ver o
+// observador de rotas. Falha (código de saída 1) se alguma conferência falhar.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -pthread -Iwashing_machine_monitor host/bench_metrics.cpp -o bench_metrics
+//
+// Uso: ./bench_metrics [segundos_de_concorrencia]
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "bench_check.h"
+#include "metrics.h"
+#include "http_server.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// A mesma atualização de um histograma, protegida por mutex
+struct LockedHistogram {
+    std::mutex lock;
+    uint32_t buckets[METRICS_BUCKET_COUNT + 1] = {};
+    uint64_t sumUs = 0;
+
+    void observe(uint32_t us) {
+        std::lock_guard<std::mutex> guard(lock);
+        buckets[LatencyHistogram::bucketFor(us)]++;
+        sumUs += us;
+    }
+};
+
+// =================== CONCORRÊNCIA ===================
+
+// O escritor alterna 1000 us e 3000 us: em toda cópia consistente,
+// soma == 1000 * faixa(1 ms) + 3000 * faixa(5 ms)
+static void concurrency(double seconds) {
+    static LatencyHistogram histogram;
+    const int low = LatencyHistogram::bucketFor(1000);
+    const int high = LatencyHistogram::bucketFor(3000);
+    std::atomic<bool> running(true);
+    uint64_t writes = 0;
+
+    std::thread writer([&]() {
+        while (running.load(std::memory_order_relaxed)) {
+            histogram.observe((writes & 1) ? 3000 : 1000);
+            writes++;
+        }
+    });
+
+    unsigned long snapshots = 0, retried = 0, torn = 0, backwards = 0;
+    uint32_t lastCount = 0;
+    Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(seconds));
+    while (Clock::now() < end) {
+        HistogramSnapshot s;
+        if (!histogram.snapshot(s)) {
+            retried++;
+            continue;
+        }
+        snapshots++;
+        uint64_t expected = 1000ULL * s.buckets[low] + 3000ULL * s.buckets[high];
+        if (s.sumUs != expected || s.count != s.buckets[low] + s.buckets[high]) {
+            torn++;
+        }
+        if (s.count < lastCount) {
+            backwards++;
+        }
+        lastCount = s.count;
+    }
+    running = false;
+    writer.join();
+
+    HistogramSnapshot final;
+    histogram.snapshot(final);
+    printf("Concorrencia (%.1f s): %llu escritas, %lu copias, %lu sem consistencia apos %d tentativas\n",
+           seconds, (unsigned long long)writes, snapshots, retried, METRICS_SNAPSHOT_RETRIES);
+    check(snapshots > 1000, "leitor conseguiu copias durante as escritas");
+    check(torn == 0, "nenhuma copia aceita com soma e faixas rasgadas");
+    check(backwards == 0, "contagem nunca volta entre copias");
+    check(final.count == writes, "contagem final igual ao numero de escritas");
+}
+
+// =================== CUSTO ===================
+
+static void cost() {
+    const int iterations = 20000000;
+    static LatencyHistogram lockFree;
+    static LockedHistogram locked;
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        lockFree.observe((uint32_t)(i & 0x3FFFF));
+    }
+    double lockFreeNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        locked.observe((uint32_t)(i & 0x3FFFF));
+    }
+    double lockedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+    printf("observe(): seqlock %.1f ns, mutex %.1f ns (%.1fx)\n", lockFreeNs, lockedNs, lockedNs / lockFreeNs);
+    HistogramSnapshot s;
+    lockFree.snapshot(s);
+    check(s.count == (uint32_t)iterations && s.sumUs == locked.sumUs, "seqlock e mutex contam o mesmo");
+}
+
+// =================== TEXTO ===================
+
+static void text() {
+    LatencyHistogram histogram;
+    const uint32_t values[] = { 50, 100, 101, 900, 4000, 180000, 2500000, 9000000 };
+    for (uint32_t v : values) {
+        histogram.observe(v);
+    }
+    // Soma passando de 32 bits
+    for (int i = 0; i < 2000; i++) {
+        histogram.observe(2500000);
+    }
+    HistogramSnapshot s;
+    histogram.snapshot(s);
+
+    char body[2048];
+    MetricsWriter out(body, sizeof(body));
+    writeMetricHeader(out, "washer_stage_duration_seconds", "histogram", "Latencia de cada etapa");
+    writeHistogram(out, "washer_stage_duration_seconds", "stage=\"invoke\"", s);
+    writeMetricSample(out, "washer_frames_total", nullptr, 42);
+    printf("Texto (%u bytes):\n%s", (unsigned)out.length(), body);
+
+    // Faixas cumulativas, +Inf igual a _count, soma em segundos com 6 casas
+    int bucketLines = 0;
+    unsigned long previous = 0, inf = 0, count = 0;
+    bool monotonic = true;
+    for (char* line = strtok(body, "\n"); line; line = strtok(nullptr, "\n")) {
+        const char* value = strrchr(line, ' ');
+        if (strstr(line, "_bucket{")) {
+            unsigned long v = strtoul(value + 1, nullptr, 10);
+            monotonic = monotonic && v >= previous;
+            previous = v;
+            bucketLines++;
+            if (strstr(line, "le=\"+Inf\"")) inf = v;
+        } else if (strstr(line, "_count{")) {
+            count = strtoul(value + 1, nullptr, 10);
+        }
+    }
+    char expectedSum[64];
+    snprintf(expectedSum, sizeof(expectedSum), "%llu.%06llu",
+             (unsigned long long)(s.sumUs / 1000000), (unsigned long long)(s.sumUs % 1000000));
+
+    check(out.ok(), "histograma cabe em 2 KB");
+    check(bucketLines == METRICS_BUCKET_COUNT + 1 && monotonic, "15 faixas cumulativas");
+    check(inf == count && count == 2008, "+Inf igual a _count");
+    check(s.buckets[0] == 2 && s.buckets[1] == 1, "limite da faixa inclusivo (le)");
+    check(s.sumUs == 5000000000ULL + 50 + 100 + 101 + 900 + 4000 + 180000 + 2500000 + 9000000,
+          "soma de 64 bits passa de 2^32 us");
+    check(strcmp(expectedSum, "5011.685151") == 0, "soma em segundos");
+
+    char small[300];
+    MetricsWriter tiny(small, sizeof(small));
+    writeHistogram(tiny, "washer_stage_duration_seconds", "stage=\"invoke\"", s);
+    check(!tiny.ok() && strlen(small) < sizeof(small), "buffer pequeno: estouro sinalizado, nada alem do limite");
+}
+
+// =================== OBSERVADOR HTTP ===================
+
+static std::atomic<int> observedRoutes[3];      // rota 0, rota 1, não encontrada
+
+static void observeRoute(int route, uint32_t us) {
+    observedRoutes[route < 0 ? 2 : route]++;
+}
+
+static void handleStatus(HttpConnection& conn, const HttpRequest& req) {
+    conn.send(200, "application/json", "{}");
+}
+
+static void handleSlow(HttpConnection& conn, const HttpRequest& req) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    conn.send(200, "text/plain", "ok");
+}
+
+static void httpObserver() {
+    static HttpServer server;
+    server.on("/status", handleStatus);
+    server.on("/slow", handleSlow);
+    server.observer = observeRoute;
+    if (!server.begin(18084)) {
+        check(false, "porta 18084 aberta");
+        return;
+    }
+
+    std::atomic<bool> running(true);
+    std::thread serverThread([&]() {
+        while (running) {
+            server.poll(10);
+        }
+    });
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(18084);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    static const char* paths[] = { "/status", "/slow", "/nada" };
+    static const int counts[] = { 20, 5, 3 };
+    char request[128], response[1024];
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+    for (int p = 0; p < 3; p++) {
+        int n = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: lavadora\r\n\r\n", paths[p]);
+        for (int i = 0; i < counts[p]; i++) {
+            send(fd, request, n, MSG_NOSIGNAL);
+            recv(fd, response, sizeof(response), 0);
+        }
+    }
+    close(fd);
+
+    running = false;
+    serverThread.join();
+    server.stop();
+
+    printf("Observador HTTP: /status %d, /slow %d, nao encontrada %d\n",
+           observedRoutes[0].load(), observedRoutes[1].load(), observedRoutes[2].load());
+    check(observedRoutes[0] == 20 && observedRoutes[1] == 5 && observedRoutes[2] == 3,
+          "um tempo por handler, 404 como rota -1");
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+
+    concurrency(seconds);
+    cost();
+    text();
+    httpObserver();
+
+    return checkSummary();
+}
@@ -0,0 +1,216 @@
+// =================== bench_publish_queue.cpp ===================
+// PublishQueue (publish_queue.h) no host, com a tarefa "sinric" simulada em
+// passos de 50 ms: rajadas de mudanças de etapa, envios recusados e uma
+// conexão que cai e volta. Confere que só o estado mais novo sai, que o
+// limite de taxa vale, que a espera entre tentativas dobra até o teto e zera
+// ao reconectar, e mede o custo de post() numa thread concorrente com o
+// consumidor (o caminho ML nunca espera pela nuvem).
+// Falha (código de saída 1) se alguma conferência não bater.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -pthread -Iwashing_machine_monitor host/bench_publish_queue.cpp -o bench_publish_queue
+//
+// Uso: ./bench_publish_queue
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "bench_check.h"
+#include "publish_queue.h"
+
+#define EVENT_PULSE     0
+#define EVENT_POWER     1
+
+static const uint32_t TICK_MS = 50;         // SINRIC_TASK_PERIOD
+
+struct Sent {
+    uint32_t at;
+    int kind;
+    uint32_t value;
+};
+
+// Rede simulada: conexão e aceitação de envios controladas pelo roteiro
+struct Network {
+    bool connected = true;
+    bool accept = true;
+    std::vector<Sent> sent;
+    std::vector<uint32_t> attempts;     // instantes de tentativa (aceita, recusada ou desconectada)
+};
+
+// Um passo da tarefa de rede, como sinricTask()
+static void step(PublishQueue<2>& q, Network& net, uint32_t now) {
+    int kind;
+    uint32_t value;
+    bool wasWaiting = q.waiting(now);
+    bool anyPending = q.pending(EVENT_PULSE) || q.pending(EVENT_POWER);
+    if (q.nextDue(now, net.connected, kind, value)) {
+        net.attempts.push_back(now);
+        if (net.accept) {
+            net.sent.push_back({ now, kind, value });
+            q.sent(now);
+        } else {
+            q.failed(now, kind, value);
+        }
+    } else if (!wasWaiting && anyPending && !net.connected) {
+        net.attempts.push_back(now);
+    }
+}
+
+// =================== ROTEIROS ===================
+
+static void coalescing() {
+    printf("Agrupamento e limite de taxa:\n");
+    PublishQueue<2> q;
+    q.configure(1000, 1000, 60000);
+    Network net;
+
+    // Rajada de 5 mudanças no mesmo instante: só a última sai
+    for (uint32_t stage = 0; stage < 5; stage++) {
+        q.post(EVENT_POWER, stage);
+    }
+    step(q, net, 0);
+    check(net.sent.size() == 1 && net.sent[0].value == 4, "rajada: um envio, com o estado mais novo");
+    check(q.posted == 5 && q.coalesced == 4, "rajada: 4 eventos agrupados");
+
+    // Mudanças a cada 100 ms por 5 s: no máximo um envio por segundo, o último vale
+    uint32_t now = 0;
+    for (uint32_t i = 1; i <= 50; i++) {
+        q.post(EVENT_POWER, i % 6);
+        for (int t = 0; t < 2; t++) {
+            now += TICK_MS;
+            step(q, net, now);
+        }
+    }
+    for (int t = 0; t < 40; t++) {
+        now += TICK_MS;
+        step(q, net, now);
+    }
+    bool spaced = true;
+    for (size_t i = 1; i < net.sent.size(); i++) {
+        spaced = spaced && net.sent[i].at - net.sent[i - 1].at >= 1000;
+    }
+    check(spaced, "eventos espacados de pelo menos 1 s");
+    check(net.sent.size() >= 5 && net.sent.size() <= 7, "5 s de mudancas: 5 a 7 envios");
+    check(net.sent.back().value == 50 % 6 && !q.pending(EVENT_POWER), "ultimo estado publicado foi enviado");
+    check(q.posted == q.coalesced + q.sentCount, "publicados = agrupados + enviados");
+
+    // Pulso de fim de ciclo sai antes do estado pendente
+    q.post(EVENT_POWER, 3);
+    q.post(EVENT_PULSE, 0);
+    size_t before = net.sent.size();
+    for (int t = 0; t < 60; t++) {
+        now += TICK_MS;
+        step(q, net, now);
+    }
+    check(net.sent.size() == before + 2 && net.sent[before].kind == EVENT_PULSE &&
+          net.sent[before + 1].kind == EVENT_POWER, "pulso sai antes do estado, 1 s depois o estado");
+}
+
+static void backoff() {
+    printf("Backoff desconectado e com envio recusado:\n");
+    PublishQueue<2> q;
+    q.configure(1000, 1000, 8000);
+    Network net;
+    net.connected = false;
+
+    // Desconectado por 60 s com estado pendente: esperas 1, 2, 4, 8, 8... s
+    q.post(EVENT_POWER, 2);
+    uint32_t now = 0;
+    for (; now < 60000; now += TICK_MS) {
+        step(q, net, now);
+    }
+    bool doubling = net.attempts.size() >= 6;
+    uint32_t expected = 1000;
+    for (size_t i = 1; doubling && i < net.attempts.size(); i++) {
+        uint32_t gap = net.attempts[i] - net.attempts[i - 1];
+        doubling = gap == expected;
+        expected = expected * 2 > 8000 ? 8000 : expected * 2;
+    }
+    check(doubling, "espera dobra de 1 s ate o teto de 8 s");
+    check(net.sent.empty() && q.pending(EVENT_POWER), "desconectado: nada enviado, estado mantido");
+
+    // Estado muda enquanto desconectado: ao reconectar sai só o mais novo, já
+    q.post(EVENT_POWER, 5);
+    net.connected = true;
+    q.resume();
+    step(q, net, now);
+    check(net.sent.size() == 1 && net.sent[0].value == 5 && net.sent[0].at == now,
+          "reconectado: estado mais novo enviado na hora");
+    check(q.backoffMs == 0, "backoff zerado apos envio aceito");
+
+    // Envio recusado: o valor volta para a fila e a espera cresce
+    net.accept = false;
+    q.post(EVENT_POWER, 1);
+    size_t attempts = net.attempts.size();
+    uint32_t start = now;
+    for (now += TICK_MS; now < start + 10000; now += TICK_MS) {
+        step(q, net, now);
+    }
+    check(q.failedCount >= 3 && q.pending(EVENT_POWER), "recusado: valor devolvido a fila");
+    check(net.attempts.size() - attempts <= 5, "recusado: tentativas espacadas pelo backoff");
+
+    // Um mais novo publicado durante a falha não é sobrescrito pela devolução
+    int kind = -1;
+    uint32_t value = 0;
+    net.accept = true;
+    q.resume();
+    bool due = q.nextDue(now, true, kind, value);
+    q.post(EVENT_POWER, 4);
+    q.failed(now, kind, value);
+    check(due && value == 1 && (q.slots[EVENT_POWER].load() & ~PUBLISH_PENDING) == 4,
+          "devolucao nao sobrescreve estado mais novo");
+}
+
+// =================== CONCORRÊNCIA ===================
+
+// Produtor (caminho ML) publicando sem parar enquanto o consumidor drena:
+// post() não espera e o último valor publicado é o último entregue
+static void concurrency() {
+    printf("Produtor concorrente:\n");
+    PublishQueue<2> q;
+    q.configure(0, 0, 0);
+    const uint32_t POSTS = 2000000;
+    std::atomic<bool> done{false};
+    uint32_t last = 0;
+    uint64_t received = 0;
+
+    std::thread consumer([&]() {
+        uint32_t now = 0;
+        while (!done.load() || q.pending(EVENT_POWER)) {
+            int kind;
+            uint32_t value;
+            if (q.nextDue(now, true, kind, value)) {
+                if (value < last) {
+                    last = 0xFFFFFFFF;  // fora de ordem
+                    break;
+                }
+                last = value;
+                received++;
+                q.sent(now);
+            }
+        }
+    });
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= POSTS; i++) {
+        q.post(EVENT_POWER, i);
+    }
+    double totalNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    done.store(true);
+    consumer.join();
+
+    printf("  %u posts: %.1f ns em media, %llu entregues\n",
+           POSTS, totalNs / POSTS, (unsigned long long)received);
+    check(last == POSTS, "ultimo valor publicado e o ultimo entregue, em ordem");
+    check(q.posted == POSTS && q.coalesced + received == POSTS, "cada post agrupado ou entregue");
+}
+
+int main() {
+    coalescing();
+    backoff();
+    concurrency();
+    return checkSummary();
+}
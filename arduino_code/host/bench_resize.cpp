@@ -0,0 +1,100 @@
+// =================== bench_resize.cpp ===================
+// Benchmark no host: resizeRgb565 (image_resize.h) contra o caminho do SDK
+// (RGB565 -> RGB888 do quadro inteiro + resize_image_using_mode).
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -Iwashing_machine_monitor \
+//       -Iandreluiz-project-1_inferencing/src -DEI_PORTING_CLIB=1 \
+//       host/bench_resize.cpp \
+//       andreluiz-project-1_inferencing/src/edge-impulse-sdk/dsp/image/processing.cpp \
+//       andreluiz-project-1_inferencing/src/edge-impulse-sdk/porting/clib/ei_classifier_porting.cpp \
+//       -o bench_resize
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "image_resize.h"
+#include "edge-impulse-sdk/dsp/image/processing.hpp"
+#include "edge-impulse-sdk/classifier/ei_constants.h"
+
+static const int SRC_WIDTH = 320;
+static const int SRC_HEIGHT = 240;
+static const int DST_WIDTH = 96;
+static const int DST_HEIGHT = 96;
+static const int ITERATIONS = 500;
+
+// Quadro sintético: fundo escuro, "LEDs" claros e ruído do sensor
+static void generateFrame(std::vector<uint8_t>& frame) {
+    srand(1234);
+    for (int y = 0; y < SRC_HEIGHT; y++) {
+        for (int x = 0; x < SRC_WIDTH; x++) {
+            int r = 20 + (x * 40) / SRC_WIDTH + rand() % 8;
+            int g = 20 + (y * 40) / SRC_HEIGHT + rand() % 8;
+            int b = 25 + rand() % 8;
+            if (((x / 24) % 3 == 1) && ((y / 24) % 3 == 1)) {
+                g = 230 + rand() % 20;
+                r = 80;
+            }
+            uint16_t pixel = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+            frame[(y * SRC_WIDTH + x) * 2] = pixel & 0xFF;
+            frame[(y * SRC_WIDTH + x) * 2 + 1] = pixel >> 8;
+        }
+    }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point start, int iterations) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+static void runMode(const char* name, int mode, const std::vector<uint8_t>& frame) {
+    std::vector<uint8_t> rgb888(SRC_WIDTH * SRC_HEIGHT * 3);
+    std::vector<uint8_t> sdkOut(SRC_WIDTH * SRC_HEIGHT * 3);
+    std::vector<uint8_t> nativeOut(DST_WIDTH * DST_HEIGHT * 3);
+    static ResizeScratch scratch;
+
+    // SDK: expande o quadro inteiro e redimensiona em RGB888
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (int p = 0; p < SRC_WIDTH * SRC_HEIGHT; p++) {
+            expandRgb565(&frame[p * 2], rgb888[p * 3], rgb888[p * 3 + 1], rgb888[p * 3 + 2]);
+        }
+        ei::image::processing::resize_image_using_mode(rgb888.data(), SRC_WIDTH, SRC_HEIGHT,
+            sdkOut.data(), DST_WIDTH, DST_HEIGHT, 3, mode);
+    }
+    double sdkUs = elapsedUs(start, ITERATIONS);
+
+    // Nativo: direto do RGB565, uma passada
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        Rgb888Sink sink = { nativeOut.data() };
+        resizeRgb565(frame.data(), SRC_WIDTH, SRC_HEIGHT, DST_WIDTH, DST_HEIGHT, mode, scratch, sink);
+    }
+    double nativeUs = elapsedUs(start, ITERATIONS);
+
+    int maxDiff = 0;
+    long differing = 0;
+    for (int i = 0; i < DST_WIDTH * DST_HEIGHT * 3; i++) {
+        int d = abs((int)sdkOut[i] - (int)nativeOut[i]);
+        if (d > maxDiff) maxDiff = d;
+        if (d) differing++;
+    }
+
+    printf("%-13s sdk %8.1f us | nativo %8.1f us | %5.2fx | dif max %d (%ld valores)\n",
+           name, sdkUs, nativeUs, sdkUs / nativeUs, maxDiff, differing);
+}
+
+int main() {
+    std::vector<uint8_t> frame(SRC_WIDTH * SRC_HEIGHT * 2);
+    generateFrame(frame);
+
+    printf("Redimensionamento %dx%d RGB565 -> %dx%d RGB888 (%d iteracoes)\n",
+           SRC_WIDTH, SRC_HEIGHT, DST_WIDTH, DST_HEIGHT, ITERATIONS);
+    runMode("SQUASH", EI_CLASSIFIER_RESIZE_SQUASH, frame);
+    runMode("FIT_SHORTEST", EI_CLASSIFIER_RESIZE_FIT_SHORTEST, frame);
+    runMode("FIT_LONGEST", EI_CLASSIFIER_RESIZE_FIT_LONGEST, frame);
+    return 0;
+}
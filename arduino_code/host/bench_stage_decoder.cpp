@@ -0,0 +1,124 @@
+// =================== bench_stage_decoder.cpp ===================
+// Replay no host de ciclos de lavagem simulados: compara a confirmação antiga
+// (duas predições iguais acima de MIN_CONFIDENCE) com o StageDecoder (HMM).
+// Ciclos e CNN simulados em wash_cycle_sim.h.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -Iwashing_machine_monitor -Ihost host/bench_stage_decoder.cpp -o bench_stage_decoder
+//
+// Uso: ./bench_stage_decoder [ciclos] [min_confidence]
+
+#include "wash_cycle_sim.h"
+
+// Confirmação antiga de processMLResult, fiel inclusive no pendingStage
+// que não é zerado quando volta a etapa atual
+struct TwoVote {
+    float minConfidence;
+    int label = DESLIGADO;
+    int pending = -1;
+    int pendingCount = 0;
+
+    void update(const float* probs) {
+        int best = 0;
+        for (int i = 1; i < STAGES; i++) {
+            if (probs[i] > probs[best]) best = i;
+        }
+        if (probs[best] < minConfidence || best == label) {
+            return;
+        }
+        if (best == pending) {
+            if (++pendingCount >= 2) {
+                label = best;
+                pendingCount = 0;
+            }
+        } else {
+            pending = best;
+            pendingCount = 1;
+        }
+    }
+};
+
+struct Score {
+    unsigned long steps = 0, correct = 0;
+    unsigned long wrongSwitches = 0;        // trocas para uma etapa que não é a real
+    unsigned long transitions = 0, detected = 0;
+    unsigned long latencySum = 0;           // inferências até acertar a etapa nova
+
+    void print(const char* name) const {
+        printf("  %-10s acerto %5.1f%%  trocas erradas %5lu  latencia %4.2f inferencias (%lu/%lu detectadas)\n",
+               name, 100.0 * correct / steps, wrongSwitches,
+               detected ? (double)latencySum / detected : 0.0, detected, transitions);
+    }
+};
+
+struct Tracker {
+    Score score;
+    int previous = DESLIGADO;
+    long sinceTransition = -1;              // -1: etapa atual já detectada
+
+    void step(int label, int truth, bool transition) {
+        score.steps++;
+        if (transition) {
+            score.transitions++;
+            sinceTransition = 0;
+        }
+        if (sinceTransition >= 0) {
+            sinceTransition++;
+            if (label == truth) {
+                score.detected++;
+                score.latencySum += sinceTransition;
+                sinceTransition = -1;
+            }
+        }
+        if (label == truth) score.correct++;
+        if (label != previous && label != truth) score.wrongSwitches++;
+        previous = label;
+    }
+};
+
+int main(int argc, char** argv) {
+    int cycles = argc > 1 ? atoi(argv[1]) : 200;
+    float minConfidence = argc > 2 ? atof(argv[2]) : 0.7f;
+
+    static StageDecoderConfig cfg;
+    configureSimulatedCycle(cfg);
+
+    printf("%d ciclos simulados, MIN_CONFIDENCE %.2f, etapas:", cycles, minConfidence);
+    for (int i = 0; i < STAGES; i++) printf(" %s", STAGE_NAMES[i]);
+    printf("\n");
+
+    const float intervals[] = { 2.0f, 5.0f, 10.0f, 20.0f };
+    for (float interval : intervals) {
+        rng.seed(12345);
+        Tracker twoVoteTrack, decoderTrack;
+        for (int c = 0; c < cycles; c++) {
+            std::vector<Segment> cycle = randomCycle(cfg);
+            FakeCnn cnn;
+            TwoVote twoVote;
+            twoVote.minConfidence = minConfidence;
+            StageDecoder decoder;
+            decoder.begin(&cfg, DESLIGADO);
+            twoVoteTrack.previous = decoderTrack.previous = DESLIGADO;
+            twoVoteTrack.sinceTransition = decoderTrack.sinceTransition = -1;
+
+            int previousTruth = DESLIGADO;
+            for (const Segment& segment : cycle) {
+                for (float t = 0; t < segment.seconds; t += interval) {
+                    float probs[STAGES];
+                    cnn.classify(segment.stage, probs);
+                    twoVote.update(probs);
+                    decoder.update(probs, interval);
+
+                    bool transition = segment.stage != previousTruth;
+                    previousTruth = segment.stage;
+                    twoVoteTrack.step(twoVote.label, segment.stage, transition);
+                    decoderTrack.step(decoder.label, segment.stage, transition);
+                }
+            }
+        }
+        printf("Inferencia a cada %.0f s:\n", interval);
+        twoVoteTrack.score.print("2 votos");
+        decoderTrack.score.print("HMM");
+    }
+    return 0;
+}
@@ -0,0 +1,349 @@
+// =================== firmware_bench.cpp ===================
+// Caminho ML do firmware inteiro no host: camera_manager.h, ml_inference.h,
+// ml_pipeline.h e o SDK do Edge Impulse compilados sem mudanças contra os
+// stubs de host/stubs/ (Arduino, FreeRTOS em pthreads, esp_camera, NVS,
+// partição do histórico), com a câmera virtual entregando as fotos de
+// data_collection/ em RGB565 (virtual_camera.h). Três fases:
+//   sessao    a sessão gravada no ritmo do agendador, com o relógio
+//             adiantado a cada predição (performMLPrediction no loop):
+//             acerto da etapa decodificada e inferências evitadas
+//   serial    performMLPrediction() sem pausa, fotos em sequência
+//   pipeline  tarefas de captura e inferência (PIPELINE_CONTINUOUS) com o
+//             loop() consumindo os resultados
+// Cada fase mede vazão, latência (p50/p95/máx), tempo médio de cada etapa
+// pelos histogramas do /metrics e alocações do heap por frame (malloc,
+// calloc, realloc interceptados). Falha (código de saída 1) se alguma
+// conferência falhar.
+//
+// Compilar a partir de arduino_code/ (o SDK leva alguns minutos):
+//   cmake -S host -B host/build -DCMAKE_BUILD_TYPE=Release
+//   cmake --build host/build --target firmware_bench
+//
+// Uso: ./host/build/firmware_bench [pasta_data_collection] [frames] [-v]
+//   -v  mostra o Serial do firmware durante as fases
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <andreluiz-project-1_inferencing.h>
+#include "bench_check.h"
+#include "WiFi.h"
+#include "config.h"
+#include "camera_manager.h"
+#include "mjpeg_stream.h"
+#include "frame_recorder.h"
+#include "ml_inference.h"
+#include "ml_pipeline.h"
+#include "virtual_camera.h"
+
+// Globais e ganchos que o firmware espera do .ino
+HttpServer httpServer;
+WashStage currentWashingStage = STAGE_OFF;
+WashStage lastWashingStage = STAGE_OFF;
+float lastConfidence = 0.0;
+
+void updateSinricProStatus(WashStage stage, float confidence) {}
+void publishWebStatus() {}
+void indicateStageChange() {}
+
+// =================== ALOCAÇÕES ===================
+
+// Contagem só entre allocStart() e allocStop(); liberações de blocos
+// anteriores também descontam, por isso o pico é relativo ao início da fase
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+static std::atomic<bool> allocTracking(false);
+static std::atomic<uint64_t> allocCount(0);
+static std::atomic<uint64_t> allocBytes(0);
+static std::atomic<int64_t> allocLive(0);
+static std::atomic<int64_t> allocPeak(0);
+
+static void allocTrack(void* ptr) {
+    if (!ptr || !allocTracking.load(std::memory_order_relaxed)) return;
+    int64_t size = (int64_t)malloc_usable_size(ptr);
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t live = allocLive.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = allocPeak.load(std::memory_order_relaxed);
+    while (live > peak && !allocPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+static void allocUntrack(void* ptr) {
+    if (!ptr || !allocTracking.load(std::memory_order_relaxed)) return;
+    allocLive.fetch_sub((int64_t)malloc_usable_size(ptr), std::memory_order_relaxed);
+}
+
+extern "C" void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    allocTrack(ptr);
+    return ptr;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    allocTrack(ptr);
+    return ptr;
+}
+
+extern "C" void* realloc(void* old, size_t size) {
+    allocUntrack(old);
+    void* ptr = __libc_realloc(old, size);
+    allocTrack(ptr);
+    return ptr;
+}
+
+extern "C" void free(void* ptr) {
+    allocUntrack(ptr);
+    __libc_free(ptr);
+}
+
+static void allocStart() {
+    allocCount = 0;
+    allocBytes = 0;
+    allocLive = 0;
+    allocPeak = 0;
+    allocTracking = true;
+}
+
+static void allocStop() {
+    allocTracking = false;
+}
+
+// =================== MEDIDAS ===================
+
+struct PhaseReport {
+    const char* name;
+    unsigned long frames = 0;
+    double seconds = 0;
+    std::vector<uint32_t> latenciesUs;
+    HistogramSnapshot before[METRICS_STAGE_COUNT];
+    uint32_t skippedBefore[METRICS_SKIP_COUNT];
+    uint32_t errorsBefore[METRICS_ERROR_COUNT];
+    uint32_t inferences = 0;
+    uint32_t skipped = 0;
+    uint32_t errors = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    int64_t peakBytes = 0;
+
+    void begin(const char* phase) {
+        name = phase;
+        for (int s = 0; s < METRICS_STAGE_COUNT; s++) metricsStages[s].snapshot(before[s]);
+        for (int s = 0; s < METRICS_SKIP_COUNT; s++) skippedBefore[s] = metricsSkipped[s].load();
+        for (int e = 0; e < METRICS_ERROR_COUNT; e++) errorsBefore[e] = metricsErrors[e].load();
+        allocStart();
+    }
+
+    void end() {
+        allocStop();
+        allocations = allocCount;
+        allocatedBytes = allocBytes;
+        peakBytes = allocPeak;
+        HistogramSnapshot invoke;
+        metricsStages[METRICS_INVOKE].snapshot(invoke);
+        inferences = invoke.count - before[METRICS_INVOKE].count;
+        for (int s = 0; s < METRICS_SKIP_COUNT; s++) skipped += metricsSkipped[s].load() - skippedBefore[s];
+        for (int e = 0; e < METRICS_ERROR_COUNT; e++) errors += metricsErrors[e].load() - errorsBefore[e];
+    }
+
+    uint32_t percentile(double p) const {
+        if (latenciesUs.empty()) return 0;
+        std::vector<uint32_t> sorted = latenciesUs;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * p))];
+    }
+
+    void print() const {
+        printf("\n[%s] %lu frames em %.2f s: %.1f frames/s, %u inferencias, %u evitadas, %u erros\n",
+               name, frames, seconds, frames / seconds, inferences, skipped, errors);
+        if (!latenciesUs.empty()) {
+            printf("  latencia por frame: p50 %.2f ms, p95 %.2f ms, max %.2f ms\n",
+                   percentile(0.5) / 1000.0, percentile(0.95) / 1000.0,
+                   *std::max_element(latenciesUs.begin(), latenciesUs.end()) / 1000.0);
+        }
+        printf("  etapas (media por ocorrencia):");
+        for (int s = 0; s < METRICS_STAGE_COUNT; s++) {
+            HistogramSnapshot after;
+            metricsStages[s].snapshot(after);
+            uint32_t count = after.count - before[s].count;
+            uint64_t sum = after.sumUs - before[s].sumUs;
+            const char* label = strchr(METRICS_STAGE_LABELS[s], '"') + 1;
+            printf(" %.*s %.3f ms (%u)", (int)(strlen(label) - 1), label,
+                   count ? sum / 1000.0 / count : 0.0, count);
+        }
+        printf("\n  heap: %.2f alocacoes/frame, %.0f bytes/frame, pico %+lld bytes\n",
+               frames ? (double)allocations / frames : 0.0, frames ? (double)allocatedBytes / frames : 0.0,
+               (long long)peakBytes);
+    }
+};
+
+// Tempo real: o micros() do firmware inclui o relógio adiantado da sessão
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// =================== FASES ===================
+
+// Sessão gravada: cada predição adianta o relógio pelo intervalo do
+// agendador, e o tempo até a próxima conta como acerto se a etapa
+// decodificada for a da foto
+static void sessionPhase(PhaseReport& report, double& accuracy, int& stagesSeen) {
+    virtualCameraSetMode(VIRTUAL_CAMERA_SESSION);
+    unsigned long length = virtualCameraStartSession();
+    unsigned long elapsed = 0;
+    double correctMs = 0, totalMs = 0;
+    bool seen[EI_CLASSIFIER_LABEL_COUNT] = {};
+
+    report.begin("sessao");
+    Clock::time_point start = Clock::now();
+    while (elapsed < length) {
+        unsigned long frameStart = micros();
+        performMLPrediction();
+        report.latenciesUs.push_back(micros() - frameStart);
+        report.frames++;
+
+        int truth = virtualCameraLabel();
+        uint32_t interval = predictionIntervalMs;
+        if (truth >= 0 && currentWashingStage == truth) {
+            correctMs += interval;
+        }
+        totalMs += interval;
+        seen[currentWashingStage] = true;
+        hostAdvanceClock(interval);
+        elapsed += interval;
+    }
+    report.seconds = secondsSince(start);
+    report.end();
+
+    accuracy = totalMs > 0 ? correctMs / totalMs : 0;
+    stagesSeen = 0;
+    for (bool s : seen) stagesSeen += s;
+    report.print();
+    printf("  sessao de %.1f min simulados: etapa decodificada certa em %.1f%% do tempo, %d etapas vistas\n",
+           length / 60000.0, accuracy * 100, stagesSeen);
+}
+
+static void serialPhase(PhaseReport& report, unsigned long frames) {
+    virtualCameraSetMode(VIRTUAL_CAMERA_ROUND_ROBIN);
+    // Aquecimento fora da medida (primeiro Invoke, caches)
+    for (int i = 0; i < 5; i++) performMLPrediction();
+
+    report.begin("serial");
+    Clock::time_point start = Clock::now();
+    for (unsigned long i = 0; i < frames; i++) {
+        unsigned long frameStart = micros();
+        performMLPrediction();
+        report.latenciesUs.push_back(micros() - frameStart);
+        report.frames++;
+    }
+    report.seconds = secondsSince(start);
+    report.end();
+    report.print();
+}
+
+// Latência do pipeline: da captura até o loop() aplicar o resultado
+static void pipelinePhase(PhaseReport& report, unsigned long frames, bool& started) {
+    virtualCameraSetMode(VIRTUAL_CAMERA_ROUND_ROBIN);
+    report.begin("pipeline");
+    Clock::time_point start = Clock::now();
+    started = startMLPipeline();
+    while (started && report.frames < frames && secondsSince(start) < 120) {
+        int processed = processPipelineResults();
+        if (processed > 0) {
+            report.frames += processed;
+            report.latenciesUs.push_back(pipelineLastLatency * 1000);
+        } else {
+            delay(1);
+        }
+    }
+    stopMLPipeline();
+    report.seconds = secondsSince(start);
+    report.end();
+    report.print();
+}
+
+int main(int argc, char** argv) {
+    const char* dataDir = "../data_collection";
+    unsigned long frames = 200;
+    bool verbose = false;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if (positional++ == 0) {
+            dataDir = argv[i];
+        } else {
+            frames = strtoul(argv[i], nullptr, 10);
+        }
+    }
+
+    int loaded = virtualCameraLoad(dataDir);
+    printf("Camera virtual: %d fotos de %s\n", loaded, dataDir);
+    if (loaded == 0) {
+        check(false, "fotos de data_collection carregadas");
+        printf("\nFALHA\n");
+        return 1;
+    }
+
+    // Mesma ordem do setup() do .ino, sem rede
+    hostSerialOutput = verbose ? stdout : nullptr;
+    bool cameraReady = initializeCamera();
+    if (cameraReady) {
+        metricsMarkBoot(METRICS_BOOT_CAMERA);
+    }
+    bool modelReady = cameraReady && initializeMLModel();
+    if (modelReady) {
+        metricsMarkBoot(METRICS_BOOT_MODEL);
+        initializeLedCalibration();
+        initializeHistory();
+    }
+    printf("Modelo %dx%d, %d classes, arena %u de %u bytes\n",
+           EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT, EI_CLASSIFIER_LABEL_COUNT,
+           (unsigned)metricsArenaHighWater.load(), (unsigned)EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE);
+    check(cameraReady, "esp_camera_init na camera virtual");
+    check(modelReady, "sessao TFLite iniciada");
+    if (!modelReady) {
+        printf("\nFALHA\n");
+        return 1;
+    }
+
+    PhaseReport session, serial, pipeline;
+    double accuracy = 0;
+    int stagesSeen = 0;
+    bool pipelineStarted = false;
+    sessionPhase(session, accuracy, stagesSeen);
+    serialPhase(serial, frames);
+    pipelinePhase(pipeline, frames, pipelineStarted);
+    hostSerialOutput = stdout;
+
+    printf("\nCamera virtual: %lu frames entregues, %lu sem buffer livre\n",
+           (unsigned long)virtualCameraFramesServed(), (unsigned long)virtualCameraFramesRefused());
+    printf("\n");
+    check(session.errors == 0 && serial.errors == 0 && pipeline.errors == 0, "nenhum erro de captura/conversao/inferencia");
+    check(accuracy >= 0.8, "sessao: etapa decodificada certa em >= 80% do tempo");
+    check(stagesSeen >= 5, "sessao: ao menos 5 etapas decodificadas");
+    check(session.skipped > 0, "sessao: detector de mudanca evita inferencias");
+    check(serial.inferences > 0 && serial.frames == frames, "serial: todos os frames processados");
+    check(pipelineStarted && pipeline.frames >= frames, "pipeline: todos os frames processados");
+    check(serial.frames > 0 && serial.allocations / serial.frames < 1, "serial: caminho quente sem alocar no heap");
+    check(pipeline.frames > 0 && pipeline.allocations / pipeline.frames < 1,
+          "pipeline: regime sem alocar no heap (fora o inicio)");
+    check(metricsBoot[METRICS_BOOT_FIRST_PREDICTION] >= metricsBoot[METRICS_BOOT_MODEL] &&
+          metricsBoot[METRICS_BOOT_MODEL] >= metricsBoot[METRICS_BOOT_CAMERA] &&
+          metricsBoot[METRICS_BOOT_CAMERA] > 0 && metricsBoot[METRICS_BOOT_WIFI] == 0,
+          "marcos do boot: camera, modelo, 1a predicao, sem rede");
+
+    return checkSummary();
+}
@@ -0,0 +1,228 @@
+// =================== http_load_test.cpp ===================
+// Teste de carga no host do servidor HTTP (http_server.h) com latência p50/p99.
+// Compara o servidor em tarefa própria com o modelo antigo, em que o loop()
+// atendia a web entre uma inferência e outra.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -pthread -Iwashing_machine_monitor host/http_load_test.cpp -o http_load_test
+//
+// Uso: ./http_load_test [clientes] [requisicoes_por_cliente] [inferencia_ms]
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http_server.h"
+
+static const uint16_t PORT = 18080;
+
+typedef std::chrono::steady_clock Clock;
+
+// Estado publicado pelo "loop()" simulado
+static std::mutex statusLock;
+static char statusStage[32] = "Desligado";
+static float statusConfidence = 0.0f;
+static std::atomic<bool> predictionRequested(false);
+static std::atomic<bool> running(true);
+static int inferenceMs = 150;
+
+static void handleStatus(HttpConnection& conn, const HttpRequest& req) {
+    char json[256];
+    {
+        std::lock_guard<std::mutex> lock(statusLock);
+        snprintf(json, sizeof(json),
+                 "{\"stage\":\"%s\",\"confidence\":%.2f,\"timestamp\":%lu,\"mode\":\"demonstration\"}",
+                 statusStage, statusConfidence, httpMillis());
+    }
+    conn.send(200, "application/json", json);
+}
+
+static void handlePredict(HttpConnection& conn, const HttpRequest& req) {
+    predictionRequested = true;
+    conn.send(200, "application/json", "{\"message\":\"Predicao solicitada\"}");
+}
+
+static std::string page(8192, 'x');
+
+static void handleRoot(HttpConnection& conn, const HttpRequest& req) {
+    conn.sendStatic(200, "text/html", (const uint8_t*)page.data(), page.size());
+}
+
+// Inferência simulada: ocupa a CPU pelo tempo de um run_classifier
+static void simulateInference() {
+    Clock::time_point end = Clock::now() + std::chrono::milliseconds(inferenceMs);
+    while (Clock::now() < end) {
+    }
+    std::lock_guard<std::mutex> lock(statusLock);
+    statusConfidence = statusConfidence > 0.9f ? 0.6f : statusConfidence + 0.01f;
+}
+
+// =================== CLIENTE DE CARGA ===================
+
+static int connectClient() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    return fd;
+}
+
+// Lê uma resposta completa (cabeçalhos + Content-Length)
+static bool readResponse(int fd, std::string& buffer, bool& serverClosed) {
+    size_t headerEnd = std::string::npos;
+    size_t total = 0;
+    char chunk[4096];
+    while (true) {
+        if (headerEnd == std::string::npos) {
+            headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                size_t cl = buffer.find("Content-Length: ");
+                size_t length = cl != std::string::npos ? strtoul(buffer.c_str() + cl + 16, nullptr, 10) : 0;
+                total = headerEnd + 4 + length;
+                serverClosed = buffer.find("Connection: close") < headerEnd;
+            }
+        }
+        if (headerEnd != std::string::npos && buffer.size() >= total) {
+            buffer.erase(0, total);
+            return true;
+        }
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, n);
+    }
+}
+
+static void runClient(int requests, bool keepAlive, std::vector<double>& latencies, std::atomic<int>& errors) {
+    static const char* paths[] = { "/status", "/status", "/status", "/", "/predict" };
+    int fd = -1;
+    std::string buffer;
+
+    for (int i = 0; i < requests; i++) {
+        if (fd < 0) {
+            fd = connectClient();
+            buffer.clear();
+            if (fd < 0) {
+                errors++;
+                continue;
+            }
+        }
+
+        char request[128];
+        int len = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: lavadora\r\nConnection: %s\r\n\r\n",
+                           paths[i % 5], keepAlive ? "keep-alive" : "close");
+
+        bool serverClosed = false;
+        Clock::time_point start = Clock::now();
+        if (::send(fd, request, len, MSG_NOSIGNAL) != len || !readResponse(fd, buffer, serverClosed)) {
+            errors++;
+            close(fd);
+            fd = -1;
+            continue;
+        }
+        latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+        if (!keepAlive || serverClosed) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd >= 0) close(fd);
+}
+
+static void report(const char* name, std::vector<double>& all, double seconds, int errors) {
+    std::sort(all.begin(), all.end());
+    if (all.empty()) {
+        printf("%-28s sem respostas (%d erros)\n", name, errors);
+        return;
+    }
+    printf("%-28s %6zu req  %8.1f req/s  p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms  erros %d\n",
+           name, all.size(), all.size() / seconds,
+           all[all.size() / 2], all[(all.size() * 99) / 100], all.back(), errors);
+}
+
+static void runLoad(const char* name, int clients, int requests, bool keepAlive) {
+    std::vector<std::vector<double>> latencies(clients);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threads;
+
+    Clock::time_point start = Clock::now();
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back(runClient, requests, keepAlive, std::ref(latencies[c]), std::ref(errors));
+    }
+    for (auto& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    report(name, all, seconds, errors);
+}
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? atoi(argv[1]) : 4;
+    int requests = argc > 2 ? atoi(argv[2]) : 200;
+    if (argc > 3) inferenceMs = atoi(argv[3]);
+
+    static HttpServer server;
+    server.on("/", handleRoot);
+    server.on("/status", handleStatus);
+    server.on("/predict", handlePredict);
+    if (!server.begin(PORT)) {
+        printf("Falha ao abrir porta %d\n", PORT);
+        return 1;
+    }
+
+    printf("Carga: %d clientes x %d requisicoes, inferencia simulada de %d ms\n", clients, requests, inferenceMs);
+
+    // Novo: servidor em tarefa própria, inferência contínua em paralelo
+    std::thread serverThread([&]() {
+        while (running) server.poll(100);
+    });
+    std::thread mlThread([&]() {
+        while (running) {
+            simulateInference();
+            predictionRequested = false;
+        }
+    });
+
+    runLoad("tarefa propria, keep-alive", clients, requests, true);
+    runLoad("tarefa propria, sem keep-alive", clients, requests, false);
+
+    running = false;
+    serverThread.join();
+    mlThread.join();
+
+    // Antigo: loop() com um poll por iteração entre inferências (delay(50))
+    printf("Modelo antigo (loop com poll entre inferencias), %d requisicoes por cliente:\n", requests / 10);
+    running = true;
+    std::thread loopThread([&]() {
+        while (running) {
+            server.poll(0);
+            simulateInference();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+    runLoad("loop() sequencial, keep-alive", clients, requests / 10, true);
+    running = false;
+    loopThread.join();
+
+    printf("Servidor: %u conexoes, %u requisicoes, %u recusadas, %u timeouts\n",
+           server.accepted, server.requests, server.rejected, server.timeouts);
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,295 @@
+// =================== model_swap.cpp ===================
+// Modelo da partição "model" (model_store.h) no host, com a partição em RAM
+// dos stubs e o SDK de verdade: instala o modelo compilado empacotado como
+// tools/pack_model.py faz, troca a sessão TFLite sem reiniciar, "reinicia"
+// (sessão, slots e bloco do impulso voltam ao estado de boot) e confere:
+//   - as predições do modelo mapeado são as mesmas do compilado
+//   - o TFLite lê o modelo do mapeamento, sem cópia
+//   - a arena é reaproveitada quando o modelo novo cabe nela
+//   - o download (outra tarefa, com o pipeline rodando) não mexe na sessão;
+//     só a troca, depois, para o pipeline
+//   - slots alternam (A/B) e o boot escolhe o mais novo válido
+//   - download cortado, CRC errado, classes ou entrada diferentes e modelo
+//     recusado pelo TFLite deixam o modelo anterior ativo (refeito na
+//     mesma arena)
+//   - slot corrompido na flash cai para o outro slot, e depois para o compilado
+// Falha (código de saída 1) se alguma conferência não bater.
+//
+// Compilar a partir de arduino_code/ (o SDK leva alguns minutos):
+//   cmake -S host -B host/build -DCMAKE_BUILD_TYPE=Release
+//   cmake --build host/build --target model_swap
+//
+// Uso: ./host/build/model_swap [pasta_data_collection] [-v]
+//   -v  mostra o Serial do firmware
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include <andreluiz-project-1_inferencing.h>
+#include "bench_check.h"
+#include "WiFi.h"
+#include "config.h"
+#include "camera_manager.h"
+#include "mjpeg_stream.h"
+#include "frame_recorder.h"
+#include "ml_inference.h"
+#include "ml_pipeline.h"
+#include "model_store.h"
+#include "virtual_camera.h"
+
+// Globais e ganchos que o firmware espera do .ino
+HttpServer httpServer;
+WashStage currentWashingStage = STAGE_OFF;
+WashStage lastWashingStage = STAGE_OFF;
+float lastConfidence = 0.0;
+
+void updateSinricProStatus(WashStage stage, float confidence) {}
+void publishWebStatus() {}
+void indicateStageChange() {}
+
+static const int FRAMES = 8;
+
+// Bloco do impulso e o modelo compilado, como o firmware sobe
+static ei_learning_block_config_tflite_graph_t* blockConfig() {
+    return (ei_learning_block_config_tflite_graph_t*)ei_default_impulse.impulse->learning_blocks[0].config;
+}
+
+static const ei_config_tflite_graph_t* compiledGraph = nullptr;
+
+// =================== ARQUIVOS DE MODELO ===================
+
+// Como tools/pack_model.py: cabeçalho de model_blob.h + o .tflite
+static std::vector<uint8_t> packModel(uint32_t version, uint32_t arena, const ModelBlobShape& shape,
+                                      const std::vector<uint8_t>& model) {
+    ModelBlobHeader header;
+    modelBlobHeaderInit(header, shape, model.size(), arena, version);
+    header.modelCrc = modelBlobCrc(model.data(), model.size());
+    modelBlobSeal(header, 0);
+    std::vector<uint8_t> blob(MODEL_BLOB_HEADER_SIZE + model.size(), 0);
+    memcpy(blob.data(), &header, sizeof(header));
+    memcpy(blob.data() + MODEL_BLOB_HEADER_SIZE, model.data(), model.size());
+    return blob;
+}
+
+// Campo de uma tabela do flatbuffer, ou nullptr se ficou no valor padrão
+static uint8_t* flatField(uint8_t* table, int field) {
+    int32_t vtableOffset;
+    uint16_t vtableSize, offset;
+    memcpy(&vtableOffset, table, 4);
+    uint8_t* vtable = table - vtableOffset;
+    memcpy(&vtableSize, vtable, 2);
+    if (4 + 2 * field >= vtableSize) return nullptr;
+    memcpy(&offset, vtable + 4 + 2 * field, 2);
+    return offset ? table + offset : nullptr;
+}
+
+static uint8_t* flatRef(uint8_t* at) {
+    uint32_t offset;
+    memcpy(&offset, at, 4);
+    return at + offset;
+}
+
+// Mesmo modelo com o primeiro operador trocado por TANH, que o resolver do
+// firmware não tem: passa nos CRCs e só o AllocateTensors() recusa
+static std::vector<uint8_t> unsupportedModel(const std::vector<uint8_t>& model) {
+    std::vector<uint8_t> copy = model;
+    uint8_t* root = flatRef(copy.data());
+    uint8_t* codes = flatRef(flatField(root, 1));                 // Model.operator_codes
+    uint8_t* code = flatRef(codes + 4);
+    uint8_t* deprecated = flatField(code, 0);                      // deprecated_builtin_code (int8)
+    uint8_t* builtin = flatField(code, 3);                         // builtin_code (int32)
+    int32_t tanh = tflite::BuiltinOperator_TANH;
+    if (deprecated) *deprecated = (uint8_t)tanh;
+    if (builtin) memcpy(builtin, &tanh, 4);
+    return copy;
+}
+
+struct MemoryRead {
+    const std::vector<uint8_t>* data;
+    size_t pos;
+    size_t limit;                   // download cortado aqui
+};
+
+static size_t memoryRead(void* ctx, uint8_t* buf, size_t len) {
+    MemoryRead* src = (MemoryRead*)ctx;
+    size_t end = src->limit < src->data->size() ? src->limit : src->data->size();
+    size_t n = src->pos + len > end ? end - src->pos : len;
+    memcpy(buf, src->data->data() + src->pos, n);
+    src->pos += n;
+    return n;
+}
+
+static bool install(const std::vector<uint8_t>& blob, ModelUpdateStats& stats, size_t limit = SIZE_MAX) {
+    MemoryRead src = { &blob, 0, limit };
+    memset(&stats, 0, sizeof(stats));
+    stats.slot = -1;
+    return installModel(memoryRead, &src, stats);
+}
+
+// =================== PREDIÇÕES ===================
+
+// As mesmas FRAMES fotos, inferidas de novo (sem o detector de mudança)
+static std::vector<float> predict() {
+    std::vector<float> scores;
+    virtualCameraSetMode(VIRTUAL_CAMERA_ROUND_ROBIN);
+    for (int i = 0; i < FRAMES; i++) {
+        changeDetector.reset();
+        lastMLResultValid = false;
+        if (performMLPrediction() == WASH_STAGE_ERROR) {
+            scores.clear();
+            return scores;
+        }
+        for (int c = 0; c < EI_CLASSIFIER_LABEL_COUNT; c++) {
+            scores.push_back(lastMLResult.classification[c].value);
+        }
+    }
+    return scores;
+}
+
+// Sessão, slots e bloco do impulso como no boot; depois o setup() de novo
+static bool reboot() {
+    run_classifier_session_deinit();
+    blockConfig()->graph_config = (void*)compiledGraph;
+    for (int i = 0; i < MODEL_SLOTS; i++) {
+        unmapModelSlot(i);
+    }
+    modelActiveSlot = -1;
+    initializeModelStore();
+    return initializeMLModel();
+}
+
+// Cabeçalho na flash (não no que o firmware guardou na RAM)
+static uint32_t slotMagic(int slot) {
+    uint32_t magic = 0;
+    modelStorage.read(slot * modelStorage.slotSize(), &magic, sizeof(magic));
+    return magic;
+}
+
+static bool sessionOnSlot(int slot) {
+    const ei_tflite_session_t* session = ei_tflite_get_session();
+    return slot >= 0 && session->active && session->graph_config == &modelSlotGraphs[slot] &&
+           blockConfig()->graph_config == &modelSlotGraphs[slot] &&
+           modelSlotGraphs[slot].model == modelSlots[slot].mapped + MODEL_BLOB_HEADER_SIZE;
+}
+
+static void printUpdate(const char* name, const ModelUpdateStats& stats) {
+    printf("  [%s] slot %d, instalacao %u: download %u ms, conferencia %u ms, troca %u us, arena %s\n",
+           name, stats.slot, stats.sequence, stats.downloadMs, stats.verifyMs, stats.swapUs,
+           stats.arenaReused ? "reaproveitada" : "nova");
+}
+
+// =================== ROTEIROS ===================
+
+int main(int argc, char** argv) {
+    const char* dataDir = argc > 1 && argv[1][0] != '-' ? argv[1] : "../data_collection";
+    bool verbose = argc > 1 && strcmp(argv[argc - 1], "-v") == 0;
+    hostSerialOutput = verbose ? stdout : nullptr;
+
+    compiledGraph = (const ei_config_tflite_graph_t*)blockConfig()->graph_config;
+    ModelBlobShape shape = modelFirmwareShape();
+    uint32_t arena = compiledGraph->arena_size;
+    std::vector<uint8_t> model(compiledGraph->model, compiledGraph->model + compiledGraph->model_size);
+
+    printf("Boot sem modelo na flash:\n");
+    int loaded = virtualCameraLoad(dataDir);
+    bool cameraReady = loaded > 0 && initializeCamera();
+    check(cameraReady, "camera virtual com as fotos de data_collection");
+    if (!cameraReady) {
+        printf("\nFALHA\n");
+        return 1;
+    }
+    initializeModelStore();
+    bool modelReady = initializeMLModel();
+    check(modelReady && modelActiveSlot == -1 && blockConfig()->graph_config == compiledGraph,
+          "modelo compilado ativo");
+    std::vector<float> baseline = predict();
+    check((int)baseline.size() == FRAMES * EI_CLASSIFIER_LABEL_COUNT, "predicoes do modelo compilado");
+
+    printf("Instalacao sem reboot:\n");
+    startMLPipeline();
+    ModelUpdateStats stats;
+    bool installed = install(packModel(2, arena, shape, model), stats);
+    printUpdate("v2", stats);
+    int firstSlot = stats.slot;
+    check(installed && stats.swapped && modelActiveSlot == firstSlot, "modelo v2 instalado e ativo");
+    check(sessionOnSlot(firstSlot), "interpretador le o modelo do mapeamento");
+    check(stats.arenaReused, "mesma arena: so o interpretador refeito");
+    check(isMLPipelineRunning(), "pipeline reiniciado depois da troca");
+    stopMLPipeline();
+    check(predict() == baseline, "predicoes iguais as do modelo compilado");
+
+    printf("Reboot:\n");
+    bool rebooted = reboot();
+    check(rebooted && modelActiveSlot == firstSlot && sessionOnSlot(firstSlot), "boot sobe no modelo v2 da flash");
+    check(predict() == baseline, "predicoes iguais depois do reboot");
+
+    printf("Segunda versao e arena maior (download em outra tarefa):\n");
+    startMLPipeline();
+    std::vector<uint8_t> v3 = packModel(3, arena + 64 * 1024, shape, model);
+    MemoryRead v3Source = { &v3, 0, SIZE_MAX };
+    memset(&stats, 0, sizeof(stats));
+    stats.slot = -1;
+    int ready = -1;
+    std::thread downloader([&] { ready = downloadModel(memoryRead, &v3Source, stats); });
+    downloader.join();
+    check(ready >= 0 && modelActiveSlot == firstSlot && sessionOnSlot(firstSlot) && isMLPipelineRunning(),
+          "download gravado e conferido sem tocar na sessao");
+    installed = ready >= 0 && activateDownloadedModel(ready, stats);
+    stopMLPipeline();
+    printUpdate("v3", stats);
+    int secondSlot = stats.slot;
+    check(installed && secondSlot != firstSlot && modelSlots[firstSlot].valid, "v3 no outro slot, v2 mantido");
+    check(!stats.arenaReused && ei_tflite_get_session()->arena_capacity == arena + 64 * 1024,
+          "arena maior: sessao nova antes de soltar a antiga");
+    check(predict() == baseline, "predicoes iguais com a arena nova");
+    installed = install(packModel(4, arena, shape, model), stats);
+    printUpdate("v4", stats);
+    check(installed && stats.slot == firstSlot && stats.arenaReused, "v4 sobre o mais antigo, arena reaproveitada");
+    check(modelSlots[secondSlot].header.sequence + 1 == modelSlots[firstSlot].header.sequence,
+          "instalacao numerada pelo firmware");
+
+    printf("Modelos recusados:\n");
+    int active = modelActiveSlot;
+    std::vector<uint8_t> corrupt = packModel(5, arena, shape, model);
+    corrupt[MODEL_BLOB_HEADER_SIZE + corrupt.size() / 2] ^= 0x10;
+    check(!install(corrupt, stats) && strstr(stats.error, "CRC"), "CRC do modelo errado");
+    check(slotMagic(stats.slot) == 0xFFFFFFFFu && modelActiveSlot == active, "slot sem cabecalho, modelo anterior ativo");
+    std::vector<uint8_t> blob = packModel(5, arena, shape, model);
+    check(!install(blob, stats, blob.size() / 2) && strstr(stats.error, "incompleto"), "download cortado");
+    const char* swappedLabels[EI_CLASSIFIER_LABEL_COUNT];
+    for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        swappedLabels[i] = shape.labels[EI_CLASSIFIER_LABEL_COUNT - 1 - i];
+    }
+    ModelBlobShape other = shape;
+    other.labels = swappedLabels;
+    check(!install(packModel(5, arena, other, model), stats) && strstr(stats.error, "classes"), "classes em outra ordem");
+    other = shape;
+    other.inputChannels = 4 - shape.inputChannels;
+    check(!install(packModel(5, arena, other, model), stats) && strstr(stats.error, "entrada"), "entrada diferente");
+    check(!install(packModel(5, arena, shape, unsupportedModel(model)), stats) && strstr(stats.error, "TFLite"),
+          "operador sem kernel: TFLite recusa, anterior refeito");
+    check(modelActiveSlot == active && sessionOnSlot(active) && slotMagic(stats.slot) == 0,
+          "slot recusado invalidado na flash");
+    check(predict() == baseline, "predicoes intactas depois das recusas");
+
+    printf("Flash corrompida:\n");
+    install(packModel(6, arena, shape, model), stats);
+    int newest = modelActiveSlot;
+    int older = 1 - newest;
+    uint8_t cleared = 0;
+    esp_partition_write(modelStorage.partition, newest * modelStorage.slotSize() + MODEL_BLOB_HEADER_SIZE + 1000,
+                        &cleared, 1);
+    rebooted = reboot();
+    check(rebooted && modelActiveSlot == older && sessionOnSlot(older), "modelo mais novo corrompido: sobe o outro");
+    esp_partition_write(modelStorage.partition, older * modelStorage.slotSize(), &cleared, 1);
+    rebooted = reboot();
+    check(rebooted && modelActiveSlot == -1 && blockConfig()->graph_config == compiledGraph,
+          "nenhum slot valido: sobe o compilado");
+    check(predict() == baseline, "predicoes do compilado");
+
+    hostSerialOutput = stdout;
+    return checkSummary();
+}
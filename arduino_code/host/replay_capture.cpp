@@ -0,0 +1,190 @@
+// =================== replay_capture.cpp ===================
+// Replay de gravações .wmfc (frame_capture.h) no host pelo mesmo driver do
+// /replay do dispositivo (frame_replay.h): os frames crus entram em
+// performMLPrediction() um atrás do outro, sem câmera e sem pausa, e saem a
+// vazão máxima, o tempo médio de cada etapa (histogramas do /metrics) e a
+// etapa decodificada no relógio da gravação. O replay roda duas vezes e as
+// duas têm de decodificar igual (frames reproduzíveis).
+//
+// Sem um /record do dispositivo à mão, "gravar" gera a gravação com o
+// gravador do firmware (frame_recorder.h) e a sessão de data_collection/ na
+// câmera virtual, um frame a cada intervalo.
+//
+// Compilar a partir de arduino_code/ (o SDK leva alguns minutos):
+//   cmake -S host -B host/build -DCMAKE_BUILD_TYPE=Release
+//   cmake --build host/build --target replay_capture
+//
+// Uso:
+//   ./host/build/replay_capture gravar [pasta_data_collection] [saida.wmfc] [intervalo_ms]
+//   ./host/build/replay_capture lavagem.wmfc [-v]
+//   ./host/build/replay_capture http://localhost:8000/lavagem.wmfc [-v]
+//     -v  mostra o Serial do firmware durante o replay
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <andreluiz-project-1_inferencing.h>
+#include "bench_check.h"
+#include "WiFi.h"
+#include "config.h"
+#include "camera_manager.h"
+#include "mjpeg_stream.h"
+#include "frame_recorder.h"
+#include "ml_inference.h"
+#include "ml_pipeline.h"
+#include "frame_replay.h"
+#include "virtual_camera.h"
+
+// Globais e ganchos que o firmware espera do .ino
+HttpServer httpServer;
+WashStage currentWashingStage = STAGE_OFF;
+WashStage lastWashingStage = STAGE_OFF;
+float lastConfidence = 0.0;
+
+void updateSinricProStatus(WashStage stage, float confidence) {}
+void publishWebStatus() {}
+void indicateStageChange() {}
+
+// =================== GRAVAR ===================
+
+// A sessão de data_collection/ pelo caminho de captura do firmware, com um
+// cliente de /record fingido: o que offerRecordFrame() enfileira vai para o arquivo
+static int recordSession(const char* dataDir, const char* path, unsigned long intervalMs) {
+    int loaded = virtualCameraLoad(dataDir);
+    printf("Camera virtual: %d fotos de %s\n", loaded, dataDir);
+    hostSerialOutput = nullptr;
+    bool cameraReady = loaded > 0 && initializeCamera();
+    check(cameraReady, "esp_camera_init na camera virtual");
+    FILE* out = cameraReady ? fopen(path, "wb") : nullptr;
+    check(out != nullptr, "arquivo de saida aberto");
+    if (!out) {
+        printf("\nFALHA\n");
+        return 1;
+    }
+
+    CaptureHeader header;
+    recordCaptureHeader(header);
+    fwrite(&header, sizeof(header), 1, out);
+
+    virtualCameraSetMode(VIRTUAL_CAMERA_SESSION);
+    unsigned long length = virtualCameraStartSession();
+    recordClients = 1;
+    unsigned long frames = 0;
+    for (unsigned long elapsed = 0; elapsed < length; elapsed += intervalMs) {
+        camera_fb_t* fb = captureImage();
+        if (fb) {
+            offerRecordFrame(fb);
+            releaseCameraBuffer(fb);
+        }
+        HttpSharedBody* frame = takeRecordFrame();
+        if (frame) {
+            fwrite(frame->data, frame->length, 1, out);
+            httpSharedBodyRelease(frame);
+            frames++;
+        }
+        hostAdvanceClock(intervalMs);
+    }
+    recordClients = 0;
+    bool written = fclose(out) == 0;
+
+    printf("%s: %lu frames %ux%u (%lu bytes cada), sessao de %.1f min a cada %lu ms\n\n",
+           path, frames, header.width, header.height, (unsigned long)header.frameBytes,
+           length / 60000.0, intervalMs);
+    check(written, "arquivo gravado");
+    check(frames > 0 && recordFramesDropped == 0, "todos os frames gravados");
+    return checkSummary();
+}
+
+// =================== REPLAY ===================
+
+// Arquivo local, ou http://... pelo mesmo cliente do /replay do dispositivo
+static bool replayFile(const char* path, ReplayStats& stats) {
+    if (strncmp(path, "http://", 7) == 0) {
+        char error[sizeof(stats.error)];
+        int fd = replayOpenUrl(path, error, sizeof(error));
+        if (fd < 0) {
+            memset(&stats, 0, sizeof(stats));
+            snprintf(stats.error, sizeof(stats.error), "%s", error);
+            return false;
+        }
+        bool done = runFrameReplay(replaySocketRead, &fd, stats);
+        close(fd);
+        return done;
+    }
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        snprintf(stats.error, sizeof(stats.error), "arquivo nao encontrado");
+        return false;
+    }
+    bool done = runFrameReplay(captureReadFile, in, stats);
+    fclose(in);
+    return done;
+}
+
+static void printReplay(const char* name, const ReplayStats& stats) {
+    printf("\n[%s] %u frames em %.2f s: %.1f frames/s, %u inferencias, %u evitadas, %u erros\n",
+           name, stats.frames, stats.elapsedUs / 1e6, stats.elapsedUs ? stats.frames * 1e6 / stats.elapsedUs : 0.0,
+           stats.inferences, stats.skipped, stats.errors);
+    printf("  leitura da gravacao %.3f ms/frame; etapas (media por ocorrencia):",
+           stats.frames ? stats.sourceUs / 1000.0 / stats.frames : 0.0);
+    for (int s = 0; s < METRICS_STAGE_COUNT; s++) {
+        const char* label = strchr(METRICS_STAGE_LABELS[s], '"') + 1;
+        printf(" %.*s %.3f ms", (int)(strlen(label) - 1), label, stats.stageMeanUs[s] / 1000.0);
+    }
+    printf("\n  gravacao de %.1f min: %u mudancas de etapa, termina em %s\n",
+           stats.recordedMs / 60000.0, stats.stageChanges,
+           stats.stage >= 0 ? washStageLabel(stats.stage) : "-");
+    if (stats.error[0]) {
+        printf("  erro: %s\n", stats.error);
+    }
+}
+
+static int replayCapture(const char* path, bool verbose) {
+    hostSerialOutput = verbose ? stdout : nullptr;
+    bool modelReady = initializeMLModel();
+    if (modelReady) {
+        initializeLedCalibration();
+    }
+    check(modelReady, "sessao TFLite iniciada");
+    if (!modelReady) {
+        printf("\nFALHA\n");
+        return 1;
+    }
+
+    // Segunda passada: mesmo arquivo, mesmo resultado
+    ReplayStats first = {}, second = {};
+    bool firstDone = replayFile(path, first);
+    bool secondDone = firstDone && replayFile(path, second);
+    hostSerialOutput = stdout;
+    printReplay("replay", first);
+    if (firstDone) {
+        printReplay("repeticao", second);
+    }
+
+    printf("\n");
+    check(firstDone && secondDone, "gravacao lida ate o fim sem erro de formato");
+    check(first.frames > 0 && first.errors == 0, "frames processados sem erro de conversao/inferencia");
+    check(first.inferences + first.skipped == first.frames, "cada frame inferido ou evitado");
+    check(second.frames == first.frames && second.stageChanges == first.stageChanges &&
+          second.stage == first.stage && second.inferences == first.inferences,
+          "repeticao decodifica igual a primeira passada");
+    check(currentWashingStage == STAGE_OFF && !mlReplayActive, "estado do caminho ML restaurado");
+
+    return checkSummary();
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "gravar") == 0) {
+        const char* dataDir = argc > 2 ? argv[2] : "../data_collection";
+        const char* path = argc > 3 ? argv[3] : "lavagem.wmfc";
+        unsigned long intervalMs = argc > 4 ? strtoul(argv[4], nullptr, 10) : 10000;
+        return recordSession(dataDir, path, intervalMs ? intervalMs : 10000);
+    }
+    if (argc < 2) {
+        printf("Uso: %s gravar [pasta_data_collection] [saida.wmfc] [intervalo_ms]\n"
+               "     %s <gravacao.wmfc | http://...> [-v]\n", argv[0], argv[0]);
+        return 1;
+    }
+    return replayCapture(argv[1], argc > 2 && strcmp(argv[2], "-v") == 0);
+}
@@ -0,0 +1,249 @@
+// =================== replay_power.cpp ===================
+// PowerPolicy (power_policy.h) no host, dirigido por linhas do tempo de
+// eventos: primeiro roteiros curtos com o resultado conferido à mão (estados,
+// espera do loop(), contabilidade de energia, volta do millis()), depois um
+// dia simulado com o agendador e o decodificador reais, pedidos web e uma
+// sessão de /stream, comparando a corrente média com o sistema sem
+// gerenciamento (240 MHz o tempo todo).
+// Falha (código de saída 1) se alguma conferência não bater.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -Iwashing_machine_monitor -Ihost host/replay_power.cpp -o replay_power
+//
+// Uso: ./replay_power [dias]
+
+#include "bench_check.h"
+#include "wash_cycle_sim.h"
+#include "prediction_scheduler.h"
+#include "power_policy.h"
+
+static const uint32_t CAPTURE_MS = 180;             // captura + conversão (núcleo 0)
+static const uint32_t INFERENCE_MS = 650;           // inferência (núcleo 1)
+static const float BASELINE_IDLE_MA = 100.0f;       // 240 MHz ocioso, loop() a cada 50 ms
+
+static bool near(double a, double b) {
+    return fabs(a - b) < 0.01 * fabs(b) + 1e-6;
+}
+
+// =================== ROTEIROS ===================
+
+static void scriptedTimelines() {
+    printf("Roteiros:\n");
+    PowerPolicy p;
+
+    // Captura, pedido web, ociosa: contabilidade conferida à mão
+    p.begin(0, true);
+    PowerDecision d = p.beginWork(0);
+    check(d.state == POWER_BOOST && d.cpuMhz == POWER_BOOST_MHZ && !d.lightSleep, "captura em andamento: 240 MHz sem light sleep");
+    d = p.endWork(1000, true);
+    check(d.state == POWER_SLEEP && d.cpuMhz == POWER_IDLE_MHZ && d.lightSleep, "fim da inferencia: 80 MHz com light sleep");
+    d = p.webRequest(1000);
+    check(d.state == POWER_AWAKE && !d.lightSleep, "pedido web segura o light sleep");
+    d = p.decide(1000 + POWER_WEB_HOLD - 1);
+    check(d.state == POWER_AWAKE, "ainda acordado ate POWER_WEB_HOLD");
+    d = p.decide(1000 + POWER_WEB_HOLD);
+    check(d.state == POWER_SLEEP, "volta ao light sleep depois de POWER_WEB_HOLD");
+    uint32_t end = 10000;
+    double expectedMa = (POWER_MA_BOOST * 1000 + POWER_MA_AWAKE * POWER_WEB_HOLD +
+                         POWER_MA_SLEEP * (end - 1000 - POWER_WEB_HOLD)) / end;
+    check(near(p.averageCurrentMa(end), expectedMa), "corrente media = tempo ponderado por estado");
+    check(near(p.energyPerPredictionMj(end), 1000 * POWER_MA_BOOST * POWER_SUPPLY_VOLTS / 1000.0),
+          "energia por predicao = boost x corrente x tensao");
+
+    // Captura do próximo frame (núcleo 0) durante a inferência (núcleo 1)
+    p.begin(0, true);
+    p.beginWork(0);
+    p.beginWork(400);
+    d = p.endWork(650, true);
+    check(d.state == POWER_BOOST, "trabalho sobreposto nos dois nucleos continua em boost");
+    d = p.endWork(1300, true);
+    check(d.state == POWER_SLEEP && p.predictions == 2, "so dorme quando os dois terminam");
+
+    // Espera do loop(): acorda a tempo do boost antes da captura
+    p.begin(0, true);
+    d = p.update(0, 10000);
+    check(d.state == POWER_SLEEP && d.loopDelayMs == POWER_LOOP_SLEEP_DELAY, "captura distante: loop() espera POWER_LOOP_SLEEP_DELAY");
+    d = p.update(0, POWER_WAKE_AHEAD + 100);
+    check(d.loopDelayMs == 100, "captura proxima: loop() volta no inicio do wake-ahead");
+    d = p.update(100, POWER_WAKE_AHEAD);
+    check(d.state == POWER_BOOST && d.loopDelayMs == POWER_LOOP_DELAY, "dentro do wake-ahead: boost antes da captura");
+    d = p.update(200, -1);
+    check(d.state == POWER_SLEEP, "sem captura agendada: light sleep");
+
+    // /stream aberto: nunca light sleep; sem esp_pm: nunca light sleep
+    p.begin(0, true);
+    d = p.setStreamClients(0, 1);
+    check(d.state == POWER_AWAKE, "/stream aberto segura o light sleep");
+    d = p.setStreamClients(5000, 0);
+    check(d.state == POWER_SLEEP, "/stream fechado libera o light sleep");
+    p.begin(0, false);
+    d = p.update(0, 60000);
+    check(d.state == POWER_AWAKE && d.cpuMhz == POWER_IDLE_MHZ && !d.lightSleep, "sem esp_pm: 80 MHz acordado, nunca light sleep");
+
+    // millis() dando a volta no meio da espera
+    uint32_t t0 = 0xFFFFFFFFu - 1000;
+    p.begin(t0, true);
+    p.webRequest(t0);
+    d = p.decide(t0 + 2000);
+    check(d.state == POWER_AWAKE, "pedido web antes da volta do millis() ainda vale");
+    d = p.update(t0 + POWER_WEB_HOLD, 5000);
+    check(d.state == POWER_SLEEP && d.loopDelayMs == POWER_LOOP_SLEEP_DELAY, "volta do millis(): light sleep e espera normais");
+    check(p.timeIn(POWER_AWAKE, t0 + POWER_WEB_HOLD) == POWER_WEB_HOLD, "volta do millis(): tempo acordado contado certo");
+}
+
+// =================== DIA SIMULADO ===================
+
+struct DayResult {
+    unsigned long captures = 0, lateCaptures = 0, sleepWhileStream = 0, sleepAfterWeb = 0, sleepWithoutPm = 0;
+    uint64_t boostMs = 0, totalMs = 0;
+    float averageMa = 0, mjPerPrediction = 0, baselineMa = 0;
+    uint64_t stateMs[POWER_STATES] = { 0, 0, 0 };
+};
+
+// Um evento por vez, no menor dos próximos instantes: volta do loop(),
+// captura agendada, fim da inferência, pedido web, /stream abrindo/fechando
+static DayResult simulateDays(int days, bool lightSleep, const StageDecoderConfig& cfg) {
+    DayResult out;
+    PowerPolicy policy;
+    PredictionScheduler scheduler;
+    StageDecoder decoder;
+    FakeCnn cnn;
+    scheduler.begin();
+    decoder.begin(&cfg, DESLIGADO);
+
+    // Linha do tempo real das etapas (ms), 1 ou 2 ciclos por dia
+    std::vector<double> starts;
+    std::vector<int> stages;
+    double t = 0;
+    for (int day = 0; day < days; day++) {
+        double busy = 0;
+        int cycles = 1 + (int)(rng() % 2);
+        for (int c = 0; c < cycles; c++) {
+            for (const Segment& s : randomCycle(cfg)) {
+                starts.push_back(t + busy * 1000);
+                stages.push_back(s.stage);
+                busy += s.seconds;
+            }
+        }
+        starts.push_back(t + busy * 1000);
+        stages.push_back(DESLIGADO);
+        t += 86400000.0;
+    }
+    uint64_t duration = (uint64_t)days * 86400000ull;
+
+    // Pedidos web: 30 visitas por dia com 5 pedidos em 10 s; /stream: 5 min por dia
+    std::vector<uint64_t> web;
+    for (int day = 0; day < days; day++) {
+        for (int v = 0; v < 30; v++) {
+            uint64_t visit = (uint64_t)day * 86400000ull + rng() % 86000000;
+            for (int r = 0; r < 5; r++) web.push_back(visit + r * 2000);
+        }
+    }
+    std::sort(web.begin(), web.end());
+    uint64_t streamOpen = 43200000, streamClose = streamOpen + 300000;
+
+    uint64_t now = 0, nextLoop = 0, nextCapture = 1000, workEnd = UINT64_MAX, lastWeb = 0;
+    uint64_t captureStart = 0;
+    bool webSeen = false;
+    size_t webIndex = 0;
+    int previousStage = -1;
+    float previousT = 0;
+    policy.begin(0, lightSleep);
+
+    while (now < duration) {
+        uint64_t nextWeb = webIndex < web.size() ? web[webIndex] : UINT64_MAX;
+        uint64_t nextStream = now < streamOpen ? streamOpen : (now < streamClose ? streamClose : UINT64_MAX);
+        now = std::min({ nextLoop, nextCapture, workEnd, nextWeb, nextStream });
+        uint32_t ms = (uint32_t)now;
+        int clients = now >= streamOpen && now < streamClose ? 1 : 0;
+
+        if (now == workEnd) {
+            // Fim da inferência: decodificador e agendador como no loop()
+            policy.endWork(ms, true);
+            size_t segment = std::upper_bound(starts.begin(), starts.end(), (double)captureStart) - starts.begin() - 1;
+            int truth = stages[segment];
+            float probs[STAGES];
+            cnn.classify(truth, probs);
+            bool panelChanged = truth != previousStage || uniform(0, 1) < 0.03f;
+            previousStage = truth;
+            decoder.update(probs, captureStart / 1000.0f - previousT);
+            previousT = captureStart / 1000.0f;
+            nextCapture = std::max(captureStart + scheduler.update(decoder, panelChanged), now);
+            workEnd = UINT64_MAX;
+        } else if (now == nextCapture) {
+            out.captures++;
+            if (policy.state != POWER_BOOST) out.lateCaptures++;
+            policy.beginWork(ms);
+            captureStart = now;
+            workEnd = now + CAPTURE_MS + INFERENCE_MS;
+            nextCapture = UINT64_MAX;
+        } else if (now == nextWeb) {
+            policy.webRequest(ms);
+            lastWeb = now;
+            webSeen = true;
+            webIndex++;
+        } else if (now == nextLoop) {
+            policy.setStreamClients(ms, clients);
+            int32_t until = nextCapture == UINT64_MAX ? -1 : (int32_t)(nextCapture - now);
+            nextLoop = now + policy.update(ms, until).loopDelayMs;
+        } else {
+            policy.setStreamClients(ms, clients);
+        }
+
+        if (policy.state == POWER_SLEEP) {
+            if (clients > 0) out.sleepWhileStream++;
+            if (webSeen && now - lastWeb < POWER_WEB_HOLD) out.sleepAfterWeb++;
+            if (!lightSleep) out.sleepWithoutPm++;
+        }
+    }
+
+    uint32_t end = (uint32_t)now;
+    for (int i = 0; i < POWER_STATES; i++) {
+        out.stateMs[i] = policy.timeIn((PowerState)i, end);
+        out.totalMs += out.stateMs[i];
+    }
+    out.boostMs = out.stateMs[POWER_BOOST];
+    out.averageMa = policy.averageCurrentMa(end);
+    out.mjPerPrediction = policy.energyPerPredictionMj(end);
+    uint64_t workMs = (uint64_t)out.captures * (CAPTURE_MS + INFERENCE_MS);
+    out.baselineMa = (float)((workMs * POWER_MA_BOOST + (out.totalMs - workMs) * BASELINE_IDLE_MA) / out.totalMs);
+    return out;
+}
+
+static void report(const char* name, const DayResult& r, int days) {
+    printf("%s\n", name);
+    printf("  %.0f predicoes/dia | boost %.2f%% awake %.2f%% sleep %.2f%%\n",
+           (double)r.captures / days, 100.0 * r.stateMs[POWER_BOOST] / r.totalMs,
+           100.0 * r.stateMs[POWER_AWAKE] / r.totalMs, 100.0 * r.stateMs[POWER_SLEEP] / r.totalMs);
+    printf("  %.1f mA medios (sem gerenciamento: %.1f mA), %.1f mJ/predicao, %.1f Wh/dia\n",
+           r.averageMa, r.baselineMa, r.mjPerPrediction, r.averageMa * POWER_SUPPLY_VOLTS * 24 / 1000.0);
+}
+
+int main(int argc, char** argv) {
+    int days = argc > 1 ? atoi(argv[1]) : 7;
+
+    scriptedTimelines();
+
+    static StageDecoderConfig cfg;
+    configureSimulatedCycle(cfg);
+    printf("\n%d dias simulados (captura %lu ms + inferencia %lu ms):\n", days,
+           (unsigned long)CAPTURE_MS, (unsigned long)INFERENCE_MS);
+
+    rng.seed(2024);
+    DayResult pm = simulateDays(days, true, cfg);
+    report("com esp_pm (light sleep automatico):", pm, days);
+    rng.seed(2024);
+    DayResult dfs = simulateDays(days, false, cfg);
+    report("sem esp_pm (so troca de clock):", dfs, days);
+
+    printf("Conferencias:\n");
+    check(pm.lateCaptures == 0 && dfs.lateCaptures == 0, "toda captura encontra a CPU ja em boost (wake-ahead)");
+    check(pm.boostMs <= pm.captures * (uint64_t)(CAPTURE_MS + INFERENCE_MS + POWER_WAKE_AHEAD + POWER_LOOP_DELAY),
+          "240 MHz so na captura/inferencia e no wake-ahead");
+    check(pm.sleepWhileStream == 0, "nunca light sleep com /stream aberto");
+    check(pm.sleepAfterWeb == 0, "nunca light sleep logo depois de pedido web");
+    check(dfs.sleepWithoutPm == 0, "sem esp_pm nunca entra em light sleep");
+    check(pm.averageMa < dfs.averageMa && dfs.averageMa < dfs.baselineMa, "light sleep < so clock < sem gerenciamento");
+
+    return checkSummary();
+}
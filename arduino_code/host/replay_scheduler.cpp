@@ -0,0 +1,153 @@
+// =================== replay_scheduler.cpp ===================
+// Replay de ciclos de lavagem comparando políticas de amostragem: intervalo
+// fixo (PREDICTION_INTERVAL) vs PredictionScheduler. Em todas, o resultado
+// passa pelo StageDecoder, como no dispositivo. Ciclos: a sessão gravada em
+// data_collection/ (instantes dos nomes das fotos) e ciclos sintéticos;
+// CNN e detector de mudança simulados (wash_cycle_sim.h).
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -Iwashing_machine_monitor -Ihost host/replay_scheduler.cpp -o replay_scheduler
+//
+// Uso: ./replay_scheduler [ciclos_sinteticos] [pasta_data_collection]
+
+#include "wash_cycle_sim.h"
+#include "prediction_scheduler.h"
+
+struct PolicyScore {
+    unsigned long cycles = 0, inferences = 0;
+    unsigned long transitions = 0, detected = 0, wrongSwitches = 0;
+    double correctSeconds = 0, totalSeconds = 0;
+    std::vector<float> latencies;           // s entre a transição real e o acerto
+
+    void print(const char* name) const {
+        std::vector<float> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = 0;
+        for (float l : sorted) mean += l;
+        mean = sorted.empty() ? 0 : mean / sorted.size();
+        float p95 = sorted.empty() ? 0 : sorted[(size_t)(sorted.size() * 0.95)];
+        printf("  %-12s %7.1f  %8.1f s  %6.1f s  %5.1f%%  %6.2f  %lu/%lu\n",
+               name, (double)inferences / cycles, mean, p95,
+               100.0 * correctSeconds / totalSeconds, (double)wrongSwitches / cycles,
+               detected, transitions);
+    }
+};
+
+// Tempo em [t0, t1) em que a etapa real é "label"
+static double correctTime(const std::vector<Segment>& cycle, int label, double t0, double t1) {
+    double start = 0, total = 0;
+    for (const Segment& s : cycle) {
+        double end = start + s.seconds;
+        if (s.stage == label) {
+            double a = std::max(start, t0), b = std::min(end, t1);
+            if (b > a) total += b - a;
+        }
+        start = end;
+    }
+    return total;
+}
+
+// fixedMs = 0: agendador adaptativo
+static void replay(const std::vector<Segment>& cycle, uint32_t fixedMs, const StageDecoderConfig& cfg,
+                   PolicyScore& score) {
+    std::vector<double> starts;
+    double duration = 0;
+    for (const Segment& s : cycle) {
+        starts.push_back(duration);
+        duration += s.seconds;
+    }
+
+    FakeCnn cnn;
+    StageDecoder decoder;
+    decoder.begin(&cfg, DESLIGADO);
+    PredictionScheduler scheduler;
+    scheduler.begin();
+
+    size_t detectedSegment = 0;             // segmento 0 = Desligado inicial, já "detectado"
+    int previousTruth = DESLIGADO;
+    double t = 0, previousT = 0;
+    while (t < duration) {
+        size_t segment = std::upper_bound(starts.begin(), starts.end(), t) - starts.begin() - 1;
+        int truth = cycle[segment].stage;
+
+        float probs[STAGES];
+        cnn.classify(truth, probs);
+        bool panelChanged = truth != previousTruth || uniform(0, 1) < 0.03f;
+        previousTruth = truth;
+
+        int before = decoder.label;
+        decoder.update(probs, (float)(t - previousT));
+        score.inferences++;
+        if (decoder.label != before && decoder.label != truth) score.wrongSwitches++;
+        if (segment > detectedSegment && decoder.label == truth) {
+            score.latencies.push_back((float)(t - starts[segment]));
+            detectedSegment = segment;
+        }
+
+        uint32_t interval = fixedMs ? fixedMs : scheduler.update(decoder, panelChanged);
+        double next = std::min(t + interval / 1000.0, duration);
+        score.correctSeconds += correctTime(cycle, decoder.label, t, next);
+        previousT = t;
+        t = next;
+    }
+
+    score.cycles++;
+    score.totalSeconds += duration;
+    score.transitions += cycle.size() - 1;
+    score.detected = score.latencies.size();
+}
+
+static void report(const char* title, const std::vector<std::vector<Segment>>& cycles, const StageDecoderConfig& cfg) {
+    static const uint32_t fixed[] = { 2000, 5000, 10000, 20000 };
+    printf("%s\n", title);
+    printf("  %-12s %7s  %10s  %8s  %6s  %6s  %s\n",
+           "politica", "inf/cic", "latencia", "p95", "acerto", "err/cic", "detectadas");
+    for (int p = 0; p <= 4; p++) {
+        PolicyScore score;
+        rng.seed(777);
+        for (const auto& cycle : cycles) {
+            replay(cycle, p < 4 ? fixed[p] : 0, cfg, score);
+        }
+        char name[32];
+        if (p < 4) {
+            snprintf(name, sizeof(name), "fixo %lus", (unsigned long)fixed[p] / 1000);
+        } else {
+            snprintf(name, sizeof(name), "adaptativo");
+        }
+        score.print(name);
+    }
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 200;
+    const char* dir = argc > 2 ? argv[2] : "../data_collection";
+
+    static StageDecoderConfig cfg;
+    configureSimulatedCycle(cfg);
+
+    std::vector<Segment> session = loadRecordedSession(dir);
+    if (session.empty()) {
+        printf("AVISO: sessao gravada nao encontrada em %s\n", dir);
+    } else {
+        double total = 0;
+        printf("Sessao gravada (%s):", dir);
+        for (const Segment& s : session) {
+            printf(" %s %.0fs", STAGE_NAMES[s.stage], s.seconds);
+            total += s.seconds;
+        }
+        printf(" = %.0f s\n\n", total);
+        // A mesma sessão repetida com ruído diferente na CNN simulada
+        report("Sessao gravada x50:", std::vector<std::vector<Segment>>(50, session), cfg);
+        printf("\n");
+    }
+
+    rng.seed(12345);
+    std::vector<std::vector<Segment>> cycles;
+    for (int i = 0; i < count; i++) {
+        cycles.push_back(randomCycle(cfg));
+    }
+    char title[64];
+    snprintf(title, sizeof(title), "%d ciclos sinteticos:", count);
+    report(title, cycles, cfg);
+    return 0;
+}
@@ -0,0 +1,429 @@
+// =================== replay_wifi.cpp ===================
+// WifiReconnect (wifi_reconnect.h) no host, sobre uma pilha WiFi simulada
+// pelo mesmo WifiDriver do dispositivo: um AP que pode cair, voltar e trocar
+// de canal, com tempos de varredura, associação e DHCP típicos do ESP32.
+// Roteiros: boot sem lease, volta do deep sleep com o lease da RTC, quedas
+// curtas do roteador, AP em outro canal, roteador reiniciando, tentativa
+// que não responde, lease vencido ou sem relógio (IP só com DHCP) e DHCP em
+// segundo plano sem resposta. Compara o tempo de reconexão com o caminho
+// antigo (varredura completa + DHCP a cada queda).
+// Falha (código de saída 1) se alguma conferência não bater.
+//
+// Compilar a partir de arduino_code/:
+//   g++ -O2 -std=c++17 -Iwashing_machine_monitor host/replay_wifi.cpp -o replay_wifi
+//
+// Uso: ./replay_wifi
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_check.h"
+#include "wifi_reconnect.h"
+
+// Tempos da pilha simulada (ms)
+static const uint32_t SCAN_MS = 2200;           // varredura de todos os canais
+static const uint32_t PROBE_MS = 300;           // AP ausente no canal pedido
+static const uint32_t ASSOC_MS = 150;           // autenticação + associação + 4-way
+static const uint32_t DHCP_MS = 800;
+static const uint32_t LEAVE_MS = 5;             // evento da desconexão pedida
+
+static const uint32_t DHCP_IP = 0x3200A8C0;     // 192.168.0.50 (ordem de rede)
+static const uint32_t LEASE_S = 3600;           // lease dado pelo roteador
+static const uint32_t EPOCH_START = 1700000000; // relógio de parede no primeiro boot
+static const uint32_t GATEWAY = 0x0100A8C0;
+static const uint32_t SUBNET = 0x00FFFFFF;
+
+// =================== PILHA SIMULADA ===================
+
+#define SIM_NONE        0
+#define SIM_GOT_IP      1
+#define SIM_LOST        2       // falha ou queda vinda do AP
+#define SIM_LEFT        3       // desconexão pedida pelo driver
+
+struct SimWifi {
+    // AP
+    uint8_t bssid[6] = { 0x24, 0x0A, 0xC4, 0x11, 0x22, 0x33 };
+    uint8_t channel = 6;
+    bool apUp = true;
+    bool hang = false;          // próxima tentativa não responde (sem evento)
+    bool dhcpDown = false;      // associa, mas o DHCP não responde
+    uint32_t leaseSecs = LEASE_S;
+
+    // Relógio de parede em now = 0 (0 = não acertado: boot sem NTP)
+    uint32_t epoch = EPOCH_START;
+
+    // Pedido em andamento: um evento agendado
+    int event = SIM_NONE;
+    uint32_t eventAt = 0;
+    uint32_t eventIp = 0;
+    int leftPending = 0;        // desconexões pedidas a entregar
+    uint32_t leftAt = 0;
+
+    bool associated = false;
+    uint32_t now = 0;
+
+    // Estatísticas
+    int scans = 0;
+    int directs = 0;
+    int dhcps = 0;
+};
+
+static uint32_t simClock(void* ctx) {
+    SimWifi* sim = (SimWifi*)ctx;
+    return sim->epoch ? sim->epoch + sim->now / 1000 : 0;
+}
+
+// IP do DHCP depois de "after" ms, ou nenhum evento se o DHCP não responde
+static void simDhcp(SimWifi* sim, uint32_t after) {
+    sim->dhcps++;
+    sim->event = sim->dhcpDown ? SIM_NONE : SIM_GOT_IP;
+    sim->eventAt = sim->now + after + DHCP_MS;
+    sim->eventIp = DHCP_IP;
+}
+
+static void simConnect(void* ctx, const WifiLease* lease) {
+    SimWifi* sim = (SimWifi*)ctx;
+    sim->associated = false;
+    if (sim->hang) {
+        sim->hang = false;
+        sim->event = SIM_NONE;
+        return;
+    }
+    if (lease) {
+        sim->directs++;
+        bool found = sim->apUp && lease->channel == sim->channel &&
+                     memcmp(lease->bssid, sim->bssid, sizeof(sim->bssid)) == 0;
+        if (!found) {
+            sim->event = SIM_LOST;
+            sim->eventAt = sim->now + PROBE_MS;
+            return;
+        }
+        if (lease->ip) {
+            sim->event = SIM_GOT_IP;
+            sim->eventAt = sim->now + ASSOC_MS;
+            sim->eventIp = lease->ip;
+        } else {
+            simDhcp(sim, ASSOC_MS);
+        }
+        return;
+    }
+    // Varredura: o AP precisa estar no ar quando ela termina
+    sim->scans++;
+    simDhcp(sim, SCAN_MS + ASSOC_MS);
+}
+
+// DHCP com a estação associada (sem nova associação)
+static void simRenewDhcp(void* ctx) {
+    simDhcp((SimWifi*)ctx, 0);
+}
+
+static void simDisconnect(void* ctx) {
+    SimWifi* sim = (SimWifi*)ctx;
+    sim->event = SIM_NONE;
+    sim->associated = false;
+    sim->leftPending++;
+    sim->leftAt = sim->now + LEAVE_MS;
+}
+
+// Avança 1 ms: entrega eventos agendados à máquina e chama update()
+static void simStep(SimWifi& sim, WifiReconnect& link) {
+    sim.now++;
+    if (sim.leftPending > 0 && sim.now >= sim.leftAt) {
+        sim.leftPending--;
+        link.onDisconnected(sim.now, true);
+    }
+    if (sim.event != SIM_NONE && sim.now >= sim.eventAt) {
+        int event = sim.event;
+        sim.event = SIM_NONE;
+        if (event == SIM_GOT_IP && !sim.apUp) {
+            event = SIM_LOST;
+        }
+        if (event == SIM_GOT_IP) {
+            sim.associated = true;
+            WifiLease current = {};
+            memcpy(current.bssid, sim.bssid, sizeof(current.bssid));
+            current.channel = sim.channel;
+            current.ip = sim.eventIp;
+            current.gateway = GATEWAY;
+            current.subnet = SUBNET;
+            current.dns = GATEWAY;
+            current.obtainedAt = simClock(&sim);
+            current.leaseSecs = sim.leaseSecs;
+            link.onConnected(sim.now, current);
+        } else {
+            link.onDisconnected(sim.now, false);
+        }
+    }
+    link.update(sim.now);
+}
+
+static void simRun(SimWifi& sim, WifiReconnect& link, uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        simStep(sim, link);
+    }
+}
+
+// Queda do AP com a estação conectada: evento na hora
+static void simDrop(SimWifi& sim, WifiReconnect& link) {
+    sim.associated = false;
+    link.onDisconnected(sim.now, false);
+}
+
+// Roda até conectar (ou limite); ms gastos
+static uint32_t simUntilUp(SimWifi& sim, WifiReconnect& link, uint32_t limit) {
+    uint32_t start = sim.now;
+    while (!link.connected() && sim.now - start < limit) {
+        simStep(sim, link);
+    }
+    return sim.now - start;
+}
+
+static WifiDriver simDriver(SimWifi& sim) {
+    WifiDriver driver = { simConnect, simDisconnect, simRenewDhcp, simClock, &sim };
+    return driver;
+}
+
+// =================== ROTEIROS ===================
+
+static WifiLease rtcLease;      // "RTC" entre os roteiros
+
+// Volta do deep sleep "seconds" depois do lease da RTC (o relógio segue na RTC)
+static void wakeAfter(SimWifi& sim, uint32_t seconds) {
+    sim.epoch = rtcLease.obtainedAt + seconds;
+}
+
+static void coldBoot() {
+    printf("Boot sem lease:\n");
+    SimWifi sim;
+    WifiReconnect link;
+    link.begin(sim.now, simDriver(sim), nullptr);
+    uint32_t took = simUntilUp(sim, link, 20000);
+    printf("  conectado em %lu ms (%d varreduras, %d DHCP)\n", (unsigned long)took, sim.scans, sim.dhcps);
+    check(link.connected() && sim.scans == 1 && link.scanConnects == 1, "varredura completa + DHCP");
+    check(link.leaseKnown && wifiLeaseValid(link.lease) && link.lease.channel == 6 &&
+          link.lease.ip == DHCP_IP, "lease selado com BSSID, canal e IP");
+    check(link.lease.obtainedAt == EPOCH_START + took / 1000 && link.lease.leaseSecs == LEASE_S,
+          "lease com a data e a duracao do DHCP");
+    rtcLease = link.lease;
+}
+
+static void rtcWake() {
+    printf("Volta do deep sleep com o lease da RTC:\n");
+    SimWifi sim;
+    WifiReconnect link;
+    wakeAfter(sim, 600);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    uint32_t took = simUntilUp(sim, link, 20000);
+    printf("  conectado em %lu ms\n", (unsigned long)took);
+    check(link.connected() && sim.scans == 0 && link.staticConnects == 1,
+          "direta com o IP do lease, sem varredura nem esperar o DHCP");
+    check(took < 500, "conectado em menos de 500 ms");
+    check(link.renewing && link.msUntilDue(sim.now) != UINT32_MAX, "DHCP em segundo plano logo depois");
+    uint32_t renewedAt = sim.now + DHCP_MS;
+    simRun(sim, link, 2000);
+    check(sim.dhcps == 1 && link.dhcpRenewals == 1 && !link.renewing && link.connected(),
+          "DHCP em segundo plano sem derrubar a conexao");
+    check(link.lease.obtainedAt == sim.epoch + renewedAt / 1000, "lease renovado com a data do DHCP");
+
+    // RTC corrompida (boot a frio sem RTC_NOINIT válido): varredura
+    WifiLease corrupt = rtcLease;
+    corrupt.channel = 11;
+    SimWifi sim2;
+    WifiReconnect link2;
+    link2.begin(sim2.now, simDriver(sim2), &corrupt);
+    simUntilUp(sim2, link2, 20000);
+    check(link2.connected() && sim2.directs == 0 && sim2.scans == 1, "lease com checksum errado ignorado");
+}
+
+static void routerBlips() {
+    printf("Quedas curtas do roteador (AP continua no ar):\n");
+    SimWifi sim;
+    WifiReconnect link;
+    wakeAfter(sim, 60);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    simUntilUp(sim, link, 20000);
+
+    uint32_t worst = 0, total = 0;
+    const int BLIPS = 20;
+    for (int i = 0; i < BLIPS; i++) {
+        simRun(sim, link, 60000);
+        simDrop(sim, link);
+        uint32_t took = simUntilUp(sim, link, 60000);
+        total += took;
+        if (took > worst) worst = took;
+    }
+    // Caminho antigo: varredura completa + DHCP a cada queda, depois de
+    // esperar a manutenção (WiFi.reconnect() a cada minuto, 30 s em média)
+    uint32_t oldPath = SCAN_MS + ASSOC_MS + DHCP_MS;
+    printf("  %d quedas: media %lu ms, pior %lu ms (antes: %lu ms + ate 60 s da manutencao)\n",
+           BLIPS, (unsigned long)(total / BLIPS), (unsigned long)worst, (unsigned long)oldPath);
+    check(link.drops == BLIPS && link.fastConnects == BLIPS + 1, "todas as quedas pela direta");
+    check(worst < 500 && sim.scans == 0, "reconexao em menos de 500 ms, sem varredura");
+    check(link.worstReconnectMs == worst && link.lastReconnectMs <= worst, "tempos de reconexao medidos pela maquina");
+}
+
+static void channelChange() {
+    printf("AP reiniciou em outro canal:\n");
+    SimWifi sim;
+    WifiReconnect link;
+    wakeAfter(sim, 60);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    simUntilUp(sim, link, 20000);
+
+    sim.channel = 11;
+    simDrop(sim, link);
+    uint32_t took = simUntilUp(sim, link, 20000);
+    printf("  reconectado em %lu ms pela varredura\n", (unsigned long)took);
+    check(link.connected() && link.fastFallbacks == 1 && link.scanConnects == 1, "direta falha, varredura conecta");
+    check(link.lease.channel == 11 && wifiLeaseValid(link.lease), "lease atualizado com o canal novo");
+
+    simRun(sim, link, 10000);
+    simDrop(sim, link);
+    took = simUntilUp(sim, link, 20000);
+    check(took < 500 && link.fastConnects == 2, "proxima queda ja pela direta no canal novo");
+}
+
+static void routerReboot() {
+    printf("Roteador reiniciando (60 s fora do ar):\n");
+    SimWifi sim;
+    WifiReconnect link;
+    link.retryMinMs = 500;
+    link.retryMaxMs = 8000;
+    wakeAfter(sim, 60);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    simUntilUp(sim, link, 20000);
+
+    sim.apUp = false;
+    simDrop(sim, link);
+    uint32_t waits[32];
+    int rounds = 0;
+    uint32_t downStart = sim.now;
+    WifiLinkState previous = link.state;
+    while (sim.now - downStart < 60000) {
+        simStep(sim, link);
+        if (link.state == WIFI_LINK_WAIT && previous != WIFI_LINK_WAIT && rounds < 32) {
+            waits[rounds++] = link.retryMs;
+        }
+        previous = link.state;
+    }
+    bool doubling = rounds >= 4;
+    uint32_t expected = 500;
+    for (int i = 0; doubling && i < rounds; i++) {
+        doubling = waits[i] == expected;
+        expected = expected * 2 > 8000 ? 8000 : expected * 2;
+    }
+    printf("  %d rodadas em 60 s, esperas de %lu a %lu ms\n", rounds,
+           (unsigned long)waits[0], (unsigned long)waits[rounds - 1]);
+    check(doubling, "espera entre rodadas dobra ate o teto");
+    check(!link.connected() && link.leaseKnown, "fora do ar: lease mantido");
+
+    sim.apUp = true;
+    uint32_t took = simUntilUp(sim, link, 30000);
+    printf("  AP de volta: conectado em %lu ms\n", (unsigned long)took);
+    check(link.connected() && took <= 8000 + SCAN_MS + ASSOC_MS + DHCP_MS, "conecta no maximo uma espera depois da volta");
+    check(link.retryMs == 0, "espera zerada ao conectar");
+}
+
+static void hungAttempt() {
+    printf("Tentativa sem resposta:\n");
+    SimWifi sim;
+    WifiReconnect link;
+    sim.hang = true;
+    wakeAfter(sim, 60);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    uint32_t took = simUntilUp(sim, link, 30000);
+    printf("  conectado em %lu ms\n", (unsigned long)took);
+    check(link.connected() && link.fastFallbacks == 1 && sim.scans == 1,
+          "tempo da direta esgotado, varredura conecta");
+    check(sim.leftPending == 0, "desconexao pedida pelo driver ignorada");
+    check(link.msUntilDue(sim.now) == UINT32_MAX, "conectado: nada agendado");
+}
+
+static void staleLease() {
+    printf("Lease vencido ou relogio desconhecido (IP so com DHCP):\n");
+
+    // Deep sleep longo: passou da metade do lease, o roteador pode ter
+    // liberado o IP. Direta no canal, mas com DHCP
+    SimWifi sim;
+    WifiReconnect link;
+    wakeAfter(sim, LEASE_S / 2);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    uint32_t took = simUntilUp(sim, link, 20000);
+    printf("  metade do lease: conectado em %lu ms pela direta com DHCP\n", (unsigned long)took);
+    check(link.connected() && sim.scans == 0 && sim.dhcps == 1 && link.staticConnects == 0,
+          "lease na metade: direta com DHCP, IP antigo nao usado");
+    check(link.lease.obtainedAt == sim.epoch + took / 1000 && !link.renewing, "lease novo, sem DHCP extra");
+
+    // Falta de energia: lease da NVS, relógio ainda sem NTP
+    SimWifi cold;
+    WifiReconnect link2;
+    cold.epoch = 0;
+    link2.begin(cold.now, simDriver(cold), &rtcLease);
+    simUntilUp(cold, link2, 20000);
+    check(link2.connected() && cold.dhcps == 1 && link2.staticConnects == 0,
+          "sem relogio: lease da NVS so da o canal");
+    check(link2.lease.obtainedAt == 0 && link2.stampPending, "lease sem data ate o NTP");
+    simRun(cold, link2, 5000);
+    cold.epoch = EPOCH_START + 86400;          // NTP acerta o relógio
+    bool stamped = link2.update(cold.now);
+    check(stamped && !link2.stampPending && wifiLeaseValid(link2.lease) &&
+          link2.lease.obtainedAt == simClock(&cold) - (cold.now - link2.obtainedMs) / 1000,
+          "NTP: data do lease calculada para tras");
+
+    // Lease curto do roteador: passou da metade com a estação conectada
+    SimWifi shortSim;
+    WifiReconnect link3;
+    shortSim.leaseSecs = 600;
+    link3.begin(shortSim.now, simDriver(shortSim), nullptr);
+    simUntilUp(shortSim, link3, 20000);
+    simRun(shortSim, link3, 200000);
+    simDrop(shortSim, link3);
+    simUntilUp(shortSim, link3, 20000);
+    check(link3.staticConnects == 1, "queda antes da metade do lease: IP do lease");
+    simRun(shortSim, link3, 400000);
+    simDrop(shortSim, link3);
+    simUntilUp(shortSim, link3, 20000);
+    check(link3.staticConnects == 1 && link3.fastConnects == 2 && shortSim.scans == 1,
+          "queda depois da metade do lease renovado: DHCP");
+}
+
+static void renewalTimeout() {
+    printf("DHCP em segundo plano sem resposta:\n");
+    SimWifi sim;
+    WifiReconnect link;
+    link.retryMaxMs = 8000;
+    wakeAfter(sim, 60);
+    link.begin(sim.now, simDriver(sim), &rtcLease);
+    sim.dhcpDown = true;
+    simUntilUp(sim, link, 20000);
+    check(link.connected() && link.staticConnects == 1 && link.renewing, "IP do lease, DHCP sem resposta");
+
+    uint32_t start = sim.now;
+    while (link.renewing && sim.now - start < 30000) {
+        simStep(sim, link);
+    }
+    uint32_t gaveUp = sim.now - start;
+    printf("  renovacao abandonada em %lu ms\n", (unsigned long)gaveUp);
+    check(gaveUp == link.scanTimeoutMs && link.drops == 1 && link.lease.obtainedAt == 0 &&
+          wifiLeaseValid(link.lease), "sem renovacao: lease deixa de valer e reconecta");
+
+    simRun(sim, link, 20000);
+    check(!link.connected() && link.staticConnects == 1, "IP nao renovado nunca volta sem DHCP");
+    sim.dhcpDown = false;
+    uint32_t took = simUntilUp(sim, link, 30000);
+    printf("  DHCP de volta: conectado em %lu ms\n", (unsigned long)took);
+    check(link.connected() && link.lease.obtainedAt >= EPOCH_START && !link.renewing,
+          "DHCP de volta: lease novo");
+}
+
+int main() {
+    coldBoot();
+    rtcWake();
+    routerBlips();
+    channelChange();
+    routerReboot();
+    hungAttempt();
+    staleLease();
+    renewalTimeout();
+    return checkSummary();
+}
@@ -0,0 +1,189 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Arduino-ESP32 mínimo para compilar o firmware no Linux (host/CMakeLists.txt):
+// String, Serial, relógio, ESP.* e o pedaço do FreeRTOS usado pelo sketch
+// (tarefas com notificação e mutexes, em pthreads). Só o que os módulos do
+// caminho ML chamam; o resto falha na compilação de propósito.
+// O relógio é o monotônico do host mais um avanço manual (hostAdvanceClock),
+// para os programas simularem horas de ciclo sem esperar.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+
+// =================== STRING ===================
+
+class String {
+public:
+    String() {}
+    String(const char* text) : s(text ? text : "") {}
+    String(const std::string& text) : s(text) {}
+    String(char c) : s(1, c) {}
+    String(int v) : s(std::to_string(v)) {}
+    String(unsigned int v) : s(std::to_string(v)) {}
+    String(long v) : s(std::to_string(v)) {}
+    String(unsigned long v) : s(std::to_string(v)) {}
+    String(float v, int decimals = 2) { format(v, decimals); }
+    String(double v, int decimals = 2) { format(v, decimals); }
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.size(); }
+    bool equals(const String& other) const { return s == other.s; }
+    int indexOf(const String& text) const {
+        size_t i = s.find(text.s);
+        return i == std::string::npos ? -1 : (int)i;
+    }
+    String substring(unsigned int from, unsigned int to = ~0u) const {
+        if (to > s.size()) to = s.size();
+        return from < to ? String(s.substr(from, to - from)) : String();
+    }
+    void toLowerCase() {
+        for (char& c : s) c = (char)tolower((unsigned char)c);
+    }
+    long toInt() const { return atol(s.c_str()); }
+
+    String& operator+=(const String& other) { s += other.s; return *this; }
+    String& operator+=(const char* other) { s += other; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator!=(const String& other) const { return s != other.s; }
+    bool operator==(const char* other) const { return s == other; }
+    bool operator!=(const char* other) const { return s != other; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.s); }
+
+private:
+    std::string s;
+
+    void format(double v, int decimals) {
+        char text[64];
+        snprintf(text, sizeof(text), "%.*f", decimals, v);
+        s = text;
+    }
+};
+
+// =================== SERIAL ===================
+
+// Saída do Serial no host: stdout por padrão, nullptr = silencioso
+extern FILE* hostSerialOutput;
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) {}
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(const char* text) { return write(text); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int decimals = 2) { return printf("%.*f", decimals, v); }
+    size_t println() { return write("\n"); }
+    size_t println(const String& text) { return print(text) + println(); }
+    size_t println(const char* text) { return print(text) + println(); }
+    size_t println(int v) { return print(v) + println(); }
+    size_t println(unsigned long v) { return print(v) + println(); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (!hostSerialOutput) return 0;
+        va_list args;
+        va_start(args, format);
+        int n = vfprintf(hostSerialOutput, format, args);
+        va_end(args);
+        return n > 0 ? n : 0;
+    }
+    size_t write(const char* text) {
+        if (!hostSerialOutput) return 0;
+        fputs(text, hostSerialOutput);
+        return strlen(text);
+    }
+    size_t write(char c) {
+        if (!hostSerialOutput) return 0;
+        fputc(c, hostSerialOutput);
+        return 1;
+    }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+// =================== RELÓGIO E PINOS ===================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Só no host: adianta millis()/micros() sem esperar
+void hostAdvanceClock(unsigned long ms);
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+inline void pinMode(int pin, int mode) {}
+inline void digitalWrite(int pin, int value) {}
+inline int digitalRead(int pin) { return LOW; }
+
+// =================== ESP ===================
+
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getHeapSize();
+    uint32_t getFreePsram();
+    uint32_t getPsramSize();
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart() { exit(0); }
+};
+
+extern EspClass ESP;
+
+bool psramFound();
+void* ps_malloc(size_t size);
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+// =================== FREERTOS ===================
+
+typedef struct HostTask* TaskHandle_t;
+typedef struct HostMutex* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void* param);
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+#define pdFAIL                  0
+#define portMAX_DELAY           0xFFFFFFFFu
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+
+// Tarefa em pthread própria; núcleo e prioridade são ignorados
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+void vTaskDelete(TaskHandle_t task);        // só vTaskDelete(NULL), de dentro da tarefa
+void vTaskDelay(TickType_t ticks);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+#endif // HOST_ARDUINO_H
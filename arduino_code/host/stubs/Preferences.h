@@ -0,0 +1,50 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// NVS em memória: some no fim do processo
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        space = name;
+        return true;
+    }
+    void end() {}
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        const uint8_t* bytes = (const uint8_t*)value;
+        store()[space + "/" + key].assign(bytes, bytes + len);
+        return len;
+    }
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto it = store().find(space + "/" + key);
+        if (it == store().end() || it->second.size() > maxLen) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+    size_t getBytesLength(const char* key) {
+        auto it = store().find(space + "/" + key);
+        return it == store().end() ? 0 : it->second.size();
+    }
+    bool isKey(const char* key) {
+        return store().count(space + "/" + key) > 0;
+    }
+    bool remove(const char* key) {
+        return store().erase(space + "/" + key) > 0;
+    }
+
+private:
+    std::string space;
+
+    static std::map<std::string, std::vector<uint8_t>>& store() {
+        static std::map<std::string, std::vector<uint8_t>> values;
+        return values;
+    }
+};
+
+#endif // HOST_PREFERENCES_H
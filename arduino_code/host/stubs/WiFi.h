@@ -0,0 +1,25 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// WiFi sempre conectado, sinal fixo
+
+#include "Arduino.h"
+
+typedef enum {
+    WIFI_POWER_19_5dBm = 78,
+    WIFI_POWER_8_5dBm = 34
+} wifi_power_t;
+
+#define WL_CONNECTED    3
+
+class WiFiClass {
+public:
+    int status() { return WL_CONNECTED; }
+    int RSSI() { return -60; }
+    bool setSleep(bool enabled) { return true; }
+    bool setTxPower(wifi_power_t power) { return true; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,356 @@
+// =================== arduino_host.cpp ===================
+// Implementação dos stubs do host (Arduino.h, esp_pm.h, esp_partition.h,
+// WiFi.h): relógio monotônico com avanço manual, tarefas do FreeRTOS em
+// pthreads com notificação por contador, mutexes com timeout, heap medido
+// pelo malloc do glibc e as partições "history" e "model" em RAM.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <malloc.h>
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+
+#include "Arduino.h"
+#include "WiFi.h"
+#include "esp_partition.h"
+#include "esp_pm.h"
+
+// =================== SERIAL E RELÓGIO ===================
+
+FILE* hostSerialOutput = stdout;
+HardwareSerial Serial;
+WiFiClass WiFi;
+EspClass ESP;
+
+static const std::chrono::steady_clock::time_point hostBoot = std::chrono::steady_clock::now();
+static std::atomic<unsigned long> hostClockOffsetUs{0};
+
+unsigned long micros() {
+    auto elapsed = std::chrono::steady_clock::now() - hostBoot;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() +
+           hostClockOffsetUs.load(std::memory_order_relaxed);
+}
+
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+void hostAdvanceClock(unsigned long ms) {
+    hostClockOffsetUs.fetch_add(ms * 1000UL, std::memory_order_relaxed);
+}
+
+// =================== ESP ===================
+
+// O "heap" do host é a arena do glibc; a PSRAM é só um número fixo
+#define HOST_HEAP_SIZE      (320 * 1024)
+#define HOST_PSRAM_SIZE     (4 * 1024 * 1024)
+
+static uint32_t hostHeapUsed() {
+    struct mallinfo2 info = mallinfo2();
+    return (uint32_t)(info.uordblks + info.hblkhd);
+}
+
+uint32_t EspClass::getFreeHeap() {
+    uint32_t used = hostHeapUsed();
+    return used < HOST_HEAP_SIZE ? HOST_HEAP_SIZE - used : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    return getFreeHeap();
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return getFreeHeap();
+}
+
+uint32_t EspClass::getHeapSize() {
+    return HOST_HEAP_SIZE;
+}
+
+uint32_t EspClass::getFreePsram() {
+    return HOST_PSRAM_SIZE;
+}
+
+uint32_t EspClass::getPsramSize() {
+    return HOST_PSRAM_SIZE;
+}
+
+bool psramFound() {
+    return true;
+}
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+static uint32_t hostCpuMhz = 240;
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    hostCpuMhz = mhz;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return hostCpuMhz;
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2, const char* server3) {
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+// =================== FREERTOS ===================
+
+// Notificação de tarefa como contador (xTaskNotifyGive/ulTaskNotifyTake)
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+    TaskFunction_t function = nullptr;
+    void* param = nullptr;
+};
+
+struct HostMutex {
+    std::timed_mutex lock;
+};
+
+// O main() e threads que não vieram de xTaskCreatePinnedToCore ganham uma
+// HostTask na primeira vez que precisam de uma
+static thread_local HostTask* currentTask = nullptr;
+
+static HostTask* selfTask() {
+    if (!currentTask) {
+        currentTask = new HostTask();
+    }
+    return currentTask;
+}
+
+static void* hostTaskEntry(void* arg) {
+    HostTask* task = (HostTask*)arg;
+    currentTask = task;
+    task->function(task->param);
+    return nullptr;
+}
+
+// As HostTask nunca são liberadas: no dispositivo o handle ainda pode
+// receber um xTaskNotifyGive logo depois de a tarefa terminar
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    HostTask* task = new HostTask();
+    task->function = function;
+    task->param = param;
+    if (handle) {
+        *handle = task;
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int error = pthread_create(&thread, &attr, hostTaskEntry, task);
+    pthread_attr_destroy(&attr);
+    if (error != 0) {
+        if (handle) {
+            *handle = nullptr;
+        }
+        delete task;
+        return pdFAIL;
+    }
+    pthread_setname_np(thread, name);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr) {
+        pthread_exit(nullptr);
+    }
+    fprintf(stderr, "vTaskDelete: so vTaskDelete(NULL) no host\n");
+    abort();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask* task = selfTask();
+    std::unique_lock<std::mutex> guard(task->lock);
+    if (ticks == portMAX_DELAY) {
+        task->wake.wait(guard, [task]() { return task->notifications > 0; });
+    } else {
+        task->wake.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS),
+                            [task]() { return task->notifications > 0; });
+    }
+    uint32_t value = task->notifications;
+    if (value > 0) {
+        task->notifications = clearOnExit ? 0 : value - 1;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (!task) {
+        return pdFAIL;
+    }
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+BaseType_t xPortGetCoreID() {
+    return 0;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostMutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        mutex->lock.lock();
+        return pdTRUE;
+    }
+    if (ticks == 0) {
+        return mutex->lock.try_lock() ? pdTRUE : pdFALSE;
+    }
+    return mutex->lock.try_lock_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    mutex->lock.unlock();
+    return pdTRUE;
+}
+
+// =================== ESP_PM ===================
+
+esp_err_t esp_pm_configure(const void* config) {
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t type, int arg, const char* name, esp_pm_lock_handle_t* handle) {
+    static int locks[3];
+    *handle = (esp_pm_lock_handle_t)&locks[type];
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle) {
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle) {
+    return ESP_OK;
+}
+
+// =================== PARTIÇÕES ===================
+
+// Mesmos tamanhos de partitions.csv
+#define HOST_HISTORY_SIZE       0xE0000
+#define HOST_MODEL_SIZE         0x80000
+#define HOST_FLASH_SECTOR       4096
+#define HOST_PARTITIONS         2
+
+static const esp_partition_t hostPartitions[HOST_PARTITIONS] = {
+    { ESP_PARTITION_TYPE_DATA, 0x40, 0x310000, HOST_HISTORY_SIZE, HOST_FLASH_SECTOR, "history", false },
+    { ESP_PARTITION_TYPE_DATA, 0x41, 0x290000, HOST_MODEL_SIZE, HOST_FLASH_SECTOR, "model", false },
+};
+
+// Conteúdo de cada partição, apagado (0xFF) no primeiro acesso
+static uint8_t* hostFlash(const esp_partition_t* partition) {
+    static uint8_t* flash[HOST_PARTITIONS] = {};
+    int index = partition - hostPartitions;
+    if (!flash[index]) {
+        flash[index] = (uint8_t*)malloc(partition->size);
+        memset(flash[index], 0xFF, partition->size);
+    }
+    return flash[index];
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    if (type != ESP_PARTITION_TYPE_DATA || !label) {
+        return nullptr;
+    }
+    for (int i = 0; i < HOST_PARTITIONS; i++) {
+        if (strcmp(label, hostPartitions[i].label) == 0) {
+            return &hostPartitions[i];
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+    if (offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(dst, hostFlash(partition) + offset, size);
+    return ESP_OK;
+}
+
+// Como na NOR flash, gravar só leva bits de 1 para 0
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+    if (offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t* flash = hostFlash(partition) + offset;
+    const uint8_t* bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) {
+        flash[i] &= bytes[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    if (offset % HOST_FLASH_SECTOR || size % HOST_FLASH_SECTOR || offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(hostFlash(partition) + offset, 0xFF, size);
+    return ESP_OK;
+}
+
+// Sem cache de flash no host: o "mapeamento" é a RAM da partição
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out_ptr,
+                             spi_flash_mmap_handle_t* out_handle) {
+    static spi_flash_mmap_handle_t nextHandle = 1;
+    if (offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_ptr = hostFlash(partition) + offset;
+    *out_handle = nextHandle++;
+    return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {
+}
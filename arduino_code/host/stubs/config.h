@@ -0,0 +1,47 @@
+#ifndef HOST_CONFIG_H
+#define HOST_CONFIG_H
+
+// config.h para os programas do host: mesmas chaves do dispositivo, sem
+// credenciais. DEBUG_PREDICTIONS desligado para o Serial não pesar nas medidas.
+
+#define WIFI_SSID           "host"
+#define WIFI_PASSWORD       "host"
+#define MDNS_NAME           "lavadora"
+#define WEB_SERVER_PORT     8080
+#define SERIAL_BAUD_RATE    115200
+#define LED_BUILTIN_PIN     33
+
+#define PREDICTION_INTERVAL 5000
+#define DEBUG_PREDICTIONS   false
+#define DEBUG_SYSTEM        false
+#define MIN_CONFIDENCE      0.6
+
+#define SINRIC_APP_KEY      "SUA_APP_KEY"
+#define SINRIC_APP_SECRET   "SEU_APP_SECRET"
+#define SINRIC_DEVICE_ID    "SEU_DEVICE_ID"
+
+const char* CLASS_NAMES[] = {
+    "Centrifugação", "Desligado", "Enxague", "Molho_curto", "Molho_longo", "Molho_normal"
+};
+const char* DEMO_STATES[] = { "Desligado" };
+#define NUM_DEMO_STATES     1
+
+// Pinos do AI-Thinker (sem efeito na câmera virtual)
+#define PWDN_GPIO_NUM       32
+#define RESET_GPIO_NUM      -1
+#define XCLK_GPIO_NUM       0
+#define SIOD_GPIO_NUM       26
+#define SIOC_GPIO_NUM       27
+#define Y9_GPIO_NUM         35
+#define Y8_GPIO_NUM         34
+#define Y7_GPIO_NUM         39
+#define Y6_GPIO_NUM         36
+#define Y5_GPIO_NUM         21
+#define Y4_GPIO_NUM         19
+#define Y3_GPIO_NUM         18
+#define Y2_GPIO_NUM         5
+#define VSYNC_GPIO_NUM      25
+#define HREF_GPIO_NUM       23
+#define PCLK_GPIO_NUM       22
+
+#endif // HOST_CONFIG_H
@@ -0,0 +1,17 @@
+#ifndef HOST_IMG_CONVERTERS_H
+#define HOST_IMG_CONVERTERS_H
+
+// Sem codificador JPEG no host: o /stream não roda nos programas de bancada
+
+#include "esp_camera.h"
+
+inline bool fmt2jpg(uint8_t* src, size_t srcLen, uint16_t width, uint16_t height, pixformat_t format,
+                    uint8_t quality, uint8_t** out, size_t* outLen) {
+    return false;
+}
+
+inline bool frame2jpg(camera_fb_t* fb, uint8_t quality, uint8_t** out, size_t* outLen) {
+    return false;
+}
+
+#endif // HOST_IMG_CONVERTERS_H
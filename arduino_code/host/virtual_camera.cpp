@@ -0,0 +1,361 @@
+// =================== virtual_camera.cpp ===================
+// Implementação do esp_camera.h do host sobre as fotos de data_collection/
+// (ver virtual_camera.h).
+
+#include <algorithm>
+#include <atomic>
+#include <dirent.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <jpeglib.h>
+
+#include "Arduino.h"
+#include "esp_camera.h"
+#include "virtual_camera.h"
+
+static const char* const FOLDERS[VIRTUAL_CAMERA_LABELS] = {
+    "centrifugacao", "desligado", "enxague", "molho_curto", "molho_longo", "molho_normal"
+};
+static const int DESLIGADO = 1;
+
+// Antes da primeira foto: o dispositivo ligado com a máquina parada
+static const long SESSION_LEAD_MS = 300000;
+static const long SESSION_TAIL_MS = 60000;
+
+struct VirtualShot {
+    int label;
+    long takenAt;                   // millis do nome etapa_N_millis.jpg
+    bool original;                  // false = cópia aumentada (*_jpg.rf.*)
+    int width;
+    int height;
+    std::vector<uint8_t> rgb;       // JPEG decodificado (RGB888)
+    std::vector<uint8_t> frame;     // no frame_size/formato do esp_camera_init()
+};
+
+struct VirtualFrameBuffer {
+    camera_fb_t fb;
+    bool inUse;
+};
+
+static std::vector<VirtualShot> shots;
+static std::vector<int> sessionOrder;           // originais por instante
+static std::vector<VirtualFrameBuffer> buffers;
+static std::mutex cameraLock;
+static sensor_t sensor;
+static bool initialized = false;
+static pixformat_t pixelFormat = PIXFORMAT_RGB565;
+static int frameWidth = 0;
+static int frameHeight = 0;
+static VirtualCameraMode mode = VIRTUAL_CAMERA_ROUND_ROBIN;
+static uint32_t captureDelayUs = 0;
+static size_t nextShot = 0;
+static unsigned long sessionZero = 0;
+static std::atomic<int> lastLabel{-1};
+static std::atomic<uint32_t> served{0};
+static std::atomic<uint32_t> refused{0};
+
+// =================== FOTOS ===================
+
+static bool decodeJpeg(const std::string& path, VirtualShot& shot) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, f);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    shot.width = cinfo.output_width;
+    shot.height = cinfo.output_height;
+    shot.rgb.resize((size_t)shot.width * shot.height * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = &shot.rgb[(size_t)cinfo.output_scanline * shot.width * 3];
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(f);
+    return true;
+}
+
+int virtualCameraLoad(const char* dataDir) {
+    shots.clear();
+    for (int label = 0; label < VIRTUAL_CAMERA_LABELS; label++) {
+        std::string dir = std::string(dataDir) + "/" + FOLDERS[label];
+        DIR* d = opendir(dir.c_str());
+        if (!d) {
+            continue;
+        }
+        std::vector<std::string> names;
+        while (dirent* entry = readdir(d)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.substr(name.size() - 4) == ".jpg") {
+                names.push_back(name);
+            }
+        }
+        closedir(d);
+        std::sort(names.begin(), names.end());
+
+        for (const std::string& name : names) {
+            VirtualShot shot;
+            shot.label = label;
+            shot.original = name.find(".rf.") == std::string::npos;
+            // etapa_N_millis.jpg ou etapa_N_millis_jpg.rf.<hash>.jpg
+            std::string stem = name.substr(0, name.find(shot.original ? ".jpg" : "_jpg.rf."));
+            size_t underscore = stem.rfind('_');
+            shot.takenAt = underscore == std::string::npos ? 0 : atol(stem.c_str() + underscore + 1);
+            if (decodeJpeg(dir + "/" + name, shot)) {
+                shots.push_back(std::move(shot));
+            }
+        }
+    }
+
+    sessionOrder.clear();
+    for (size_t i = 0; i < shots.size(); i++) {
+        if (shots[i].original) {
+            sessionOrder.push_back((int)i);
+        }
+    }
+    std::stable_sort(sessionOrder.begin(), sessionOrder.end(),
+                     [](int a, int b) { return shots[a].takenAt < shots[b].takenAt; });
+    return (int)shots.size();
+}
+
+int virtualCameraFrameCount() {
+    return (int)shots.size();
+}
+
+// Média de área até o frame do sensor (o OV2640 reduz no DSP)
+static void convertShot(VirtualShot& shot) {
+    int bytesPerPixel = pixelFormat == PIXFORMAT_GRAYSCALE ? 1 : 2;
+    shot.frame.resize((size_t)frameWidth * frameHeight * bytesPerPixel);
+    int w = shot.width, h = shot.height;
+    for (int y = 0; y < frameHeight; y++) {
+        int y0 = y * h / frameHeight, y1 = std::max(y0 + 1, (y + 1) * h / frameHeight);
+        for (int x = 0; x < frameWidth; x++) {
+            int x0 = x * w / frameWidth, x1 = std::max(x0 + 1, (x + 1) * w / frameWidth);
+            int sum[3] = { 0, 0, 0 }, n = 0;
+            for (int sy = y0; sy < y1; sy++) {
+                for (int sx = x0; sx < x1; sx++, n++) {
+                    for (int c = 0; c < 3; c++) sum[c] += shot.rgb[((size_t)sy * w + sx) * 3 + c];
+                }
+            }
+            int r = sum[0] / n, g = sum[1] / n, b = sum[2] / n;
+            size_t i = (size_t)y * frameWidth + x;
+            if (pixelFormat == PIXFORMAT_GRAYSCALE) {
+                // Y do YUV422 do OV2640 (BT.601)
+                shot.frame[i] = (uint8_t)((r * 19595 + g * 38470 + b * 7471 + 32768) >> 16);
+            } else {
+                uint16_t pixel = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+                shot.frame[i * 2] = pixel & 0xFF;
+                shot.frame[i * 2 + 1] = pixel >> 8;
+            }
+        }
+    }
+}
+
+// =================== MODOS ===================
+
+void virtualCameraSetMode(VirtualCameraMode newMode) {
+    std::lock_guard<std::mutex> guard(cameraLock);
+    mode = newMode;
+    nextShot = 0;
+}
+
+void virtualCameraSetCaptureDelay(uint32_t us) {
+    captureDelayUs = us;
+}
+
+unsigned long virtualCameraStartSession() {
+    std::lock_guard<std::mutex> guard(cameraLock);
+    sessionZero = millis();
+    if (sessionOrder.empty()) {
+        return 0;
+    }
+    return shots[sessionOrder.back()].takenAt - shots[sessionOrder.front()].takenAt +
+           SESSION_LEAD_MS + SESSION_TAIL_MS;
+}
+
+// Foto da sessão no instante atual; antes da primeira, uma foto de Desligado
+static int sessionShot() {
+    if (sessionOrder.empty()) {
+        return -1;
+    }
+    long t = (long)(millis() - sessionZero) + shots[sessionOrder.front()].takenAt - SESSION_LEAD_MS;
+    auto after = std::upper_bound(sessionOrder.begin(), sessionOrder.end(), t,
+                                  [](long value, int shot) { return value < shots[shot].takenAt; });
+    if (after != sessionOrder.begin()) {
+        return *(after - 1);
+    }
+    for (int shot : sessionOrder) {
+        if (shots[shot].label == DESLIGADO) {
+            return shot;
+        }
+    }
+    return sessionOrder.front();
+}
+
+int virtualCameraLabel() {
+    return lastLabel.load();
+}
+
+int virtualCameraSessionLabel() {
+    std::lock_guard<std::mutex> guard(cameraLock);
+    int shot = sessionShot();
+    return shot < 0 ? -1 : shots[shot].label;
+}
+
+uint32_t virtualCameraFramesServed() {
+    return served.load();
+}
+
+uint32_t virtualCameraFramesRefused() {
+    return refused.load();
+}
+
+// =================== ESP_CAMERA ===================
+
+static int acceptSetting(sensor_t* s, int value) {
+    return 0;
+}
+
+static int acceptPixformat(sensor_t* s, pixformat_t format) {
+    return 0;
+}
+
+static int acceptFramesize(sensor_t* s, framesize_t size) {
+    return 0;
+}
+
+static int acceptGainceiling(sensor_t* s, gainceiling_t ceiling) {
+    return 0;
+}
+
+static int acceptWindow(sensor_t* s, int startX, int startY, int endX, int endY, int offsetX, int offsetY,
+                        int totalX, int totalY, int outputX, int outputY, bool scale, bool binning) {
+    return 0;
+}
+
+static bool frameSize(framesize_t size, int& width, int& height) {
+    static const int SIZES[][2] = {
+        { 96, 96 }, { 160, 120 }, { 176, 144 }, { 240, 176 }, { 240, 240 },
+        { 320, 240 }, { 400, 296 }, { 640, 480 }, { 800, 600 }, { 1600, 1200 }
+    };
+    if (size < FRAMESIZE_96X96 || size > FRAMESIZE_UXGA) {
+        return false;
+    }
+    width = SIZES[size][0];
+    height = SIZES[size][1];
+    return true;
+}
+
+esp_err_t esp_camera_init(const camera_config_t* config) {
+    if (shots.empty()) {
+        fprintf(stderr, "camera virtual: nenhuma foto (virtualCameraLoad)\n");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if ((config->pixel_format != PIXFORMAT_RGB565 && config->pixel_format != PIXFORMAT_GRAYSCALE) ||
+        !frameSize(config->frame_size, frameWidth, frameHeight) || config->fb_count == 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    pixelFormat = config->pixel_format;
+    for (VirtualShot& shot : shots) {
+        convertShot(shot);
+    }
+
+    size_t frameBytes = shots[0].frame.size();
+    buffers.assign(config->fb_count, VirtualFrameBuffer());
+    for (VirtualFrameBuffer& b : buffers) {
+        b.fb.buf = (uint8_t*)ps_malloc(frameBytes);
+        b.fb.len = frameBytes;
+        b.fb.width = frameWidth;
+        b.fb.height = frameHeight;
+        b.fb.format = pixelFormat;
+        b.inUse = false;
+    }
+
+    sensor = sensor_t();
+    sensor.id.PID = 0x26;                       // OV2640
+    sensor.pixformat = pixelFormat;
+    sensor.status.pixformat = pixelFormat;
+    sensor.status.framesize = config->frame_size;
+    sensor.set_pixformat = acceptPixformat;
+    sensor.set_framesize = acceptFramesize;
+    sensor.set_brightness = sensor.set_contrast = sensor.set_saturation = acceptSetting;
+    sensor.set_special_effect = sensor.set_whitebal = sensor.set_awb_gain = acceptSetting;
+    sensor.set_wb_mode = sensor.set_exposure_ctrl = sensor.set_aec2 = acceptSetting;
+    sensor.set_ae_level = sensor.set_aec_value = sensor.set_gain_ctrl = acceptSetting;
+    sensor.set_agc_gain = sensor.set_bpc = sensor.set_wpc = sensor.set_raw_gma = acceptSetting;
+    sensor.set_lenc = sensor.set_hmirror = sensor.set_vflip = sensor.set_dcw = acceptSetting;
+    sensor.set_colorbar = acceptSetting;
+    sensor.set_gainceiling = acceptGainceiling;
+    sensor.set_res_raw = acceptWindow;
+
+    initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_camera_deinit() {
+    std::lock_guard<std::mutex> guard(cameraLock);
+    for (VirtualFrameBuffer& b : buffers) {
+        free(b.fb.buf);
+    }
+    buffers.clear();
+    initialized = false;
+    return ESP_OK;
+}
+
+camera_fb_t* esp_camera_fb_get() {
+    if (captureDelayUs) {
+        delayMicroseconds(captureDelayUs);
+    }
+
+    std::lock_guard<std::mutex> guard(cameraLock);
+    if (!initialized) {
+        return nullptr;
+    }
+    VirtualFrameBuffer* slot = nullptr;
+    for (VirtualFrameBuffer& b : buffers) {
+        if (!b.inUse) {
+            slot = &b;
+            break;
+        }
+    }
+    if (!slot) {
+        refused++;
+        return nullptr;
+    }
+
+    int shot;
+    if (mode == VIRTUAL_CAMERA_SESSION) {
+        shot = sessionShot();
+    } else {
+        shot = (int)(nextShot++ % shots.size());
+    }
+    memcpy(slot->fb.buf, shots[shot].frame.data(), slot->fb.len);
+    unsigned long now = micros();
+    slot->fb.timestamp.tv_sec = now / 1000000;
+    slot->fb.timestamp.tv_usec = now % 1000000;
+    slot->inUse = true;
+    lastLabel = shots[shot].label;
+    served++;
+    return &slot->fb;
+}
+
+void esp_camera_fb_return(camera_fb_t* fb) {
+    std::lock_guard<std::mutex> guard(cameraLock);
+    for (VirtualFrameBuffer& b : buffers) {
+        if (&b.fb == fb) {
+            b.inUse = false;
+        }
+    }
+}
+
+sensor_t* esp_camera_sensor_get() {
+    return initialized ? &sensor : nullptr;
+}
@@ -0,0 +1,54 @@
+// =================== virtual_camera.h ===================
+// Câmera virtual do host: implementa o esp_camera.h (stubs/) com as fotos
+// de data_collection/. Cada JPEG é decodificado uma vez, reduzido por média
+// de área para o frame_size do esp_camera_init() e guardado no formato
+// pedido (RGB565 little-endian como o driver entrega, ou a luma BT.601 em
+// PIXFORMAT_GRAYSCALE). esp_camera_fb_get() copia o frame escolhido para um
+// dos fb_count buffers, como o DMA do driver, e devolve NULL se todos
+// estiverem com o firmware.
+//
+// Dois modos de escolha do frame:
+//   VIRTUAL_CAMERA_ROUND_ROBIN  todas as fotos (também as cópias aumentadas
+//                               *_jpg.rf.*), uma depois da outra
+//   VIRTUAL_CAMERA_SESSION      a sessão gravada: em millis() desde
+//                               virtualCameraStartSession(), a última foto
+//                               original tirada até aquele instante; os
+//                               5 min antes da primeira são Desligado
+//
+// A janela do sensor (set_res_raw, CAMERA_ROI_CAPTURE) é aceita e ignorada:
+// o frame é sempre a foto inteira no tamanho pedido.
+
+#ifndef VIRTUAL_CAMERA_H
+#define VIRTUAL_CAMERA_H
+
+#include <stdint.h>
+
+enum VirtualCameraMode {
+    VIRTUAL_CAMERA_ROUND_ROBIN,
+    VIRTUAL_CAMERA_SESSION
+};
+
+// Pastas de data_collection/ na ordem das classes do modelo
+#define VIRTUAL_CAMERA_LABELS       6
+
+// Lê as fotos antes do esp_camera_init() (que as converte). Devolve quantas
+int virtualCameraLoad(const char* dataDir);
+int virtualCameraFrameCount();
+
+void virtualCameraSetMode(VirtualCameraMode mode);
+void virtualCameraSetCaptureDelay(uint32_t us);     // leitura do sensor simulada em cada fb_get
+
+// Modo sessão: zera o instante da sessão em millis() e devolve a duração (ms)
+// da primeira foto simulada (5 min antes da primeira original) até 1 min
+// depois da última
+unsigned long virtualCameraStartSession();
+
+// Classe (índice do modelo) do último frame entregue, -1 se nenhum
+int virtualCameraLabel();
+// Classe da sessão no instante atual, sem capturar
+int virtualCameraSessionLabel();
+
+uint32_t virtualCameraFramesServed();
+uint32_t virtualCameraFramesRefused();              // fb_get sem buffer livre
+
+#endif // VIRTUAL_CAMERA_H
@@ -0,0 +1,119 @@
+// =================== wash_cycle_sim.h ===================
+// Simulação de ciclos de lavagem para os programas do host: linha do tempo
+// das etapas (sintética ou a sessão gravada em data_collection/) e uma CNN
+// simulada que erra em rajadas (reflexo, pessoa na frente), confunde mais os
+// três molhos entre si e sai quantizada em 1/256 como o modelo int8.
+
+#ifndef WASH_CYCLE_SIM_H
+#define WASH_CYCLE_SIM_H
+
+#include <algorithm>
+#include <dirent.h>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "wash_cycle.h"
+
+// Mesma ordem e mesmos rótulos do modelo (ei_classifier_inferencing_categories)
+enum { CENTRIFUGACAO, DESLIGADO, ENXAGUE, MOLHO_CURTO, MOLHO_LONGO, MOLHO_NORMAL, STAGES };
+static const char* const STAGE_NAMES[STAGES] = {
+    "Centrifugação", "Desligado", "Enxague", "Molho_curto", "Molho_longo", "Molho_normal"
+};
+
+struct Segment {
+    int stage;
+    float seconds;
+};
+
+static std::mt19937 rng(12345);
+
+inline float uniform(float a, float b) {
+    return std::uniform_real_distribution<float>(a, b)(rng);
+}
+
+inline void configureSimulatedCycle(StageDecoderConfig& cfg) {
+    configureWashCycle(cfg, STAGE_NAMES, STAGES);
+}
+
+// Ciclo completo com durações +-40% em torno das usadas como prior
+inline std::vector<Segment> randomCycle(const StageDecoderConfig& cfg) {
+    int soak = MOLHO_CURTO + (int)(rng() % 3);
+    int order[] = { DESLIGADO, soak, ENXAGUE, CENTRIFUGACAO, DESLIGADO };
+    std::vector<Segment> cycle;
+    for (int stage : order) {
+        cycle.push_back({ stage, cfg.typicalDwell[stage] * uniform(0.6f, 1.4f) });
+    }
+    return cycle;
+}
+
+// Sessão de data_collection/: pasta = etapa, nome = etapa_N_millis.jpg.
+// As cópias aumentadas (*_jpg.rf.*) têm o mesmo instante e são ignoradas.
+// Cada etapa dura da sua primeira foto até a primeira foto da etapa seguinte
+// (a última, até 1 min depois da sua última foto); a sessão começa com 5 min de Desligado, como o dispositivo ao ligar
+inline std::vector<Segment> loadRecordedSession(const char* dir) {
+    static const char* folders[STAGES] = {
+        "centrifugacao", "desligado", "enxague", "molho_curto", "molho_longo", "molho_normal"
+    };
+    std::vector<std::pair<long, int>> shots;
+    for (int stage = 0; stage < STAGES; stage++) {
+        std::string path = std::string(dir) + "/" + folders[stage];
+        DIR* d = opendir(path.c_str());
+        if (!d) continue;
+        while (struct dirent* entry = readdir(d)) {
+            const char* name = entry->d_name;
+            if (strstr(name, ".rf.") || !strstr(name, ".jpg")) continue;
+            const char* underscore = strrchr(name, '_');
+            if (underscore) shots.push_back({ atol(underscore + 1), stage });
+        }
+        closedir(d);
+    }
+    std::sort(shots.begin(), shots.end());
+
+    std::vector<Segment> session;
+    if (shots.empty()) return session;
+    std::vector<std::pair<long, int>> starts;
+    starts.push_back({ shots.front().first - 300000, DESLIGADO });
+    for (const auto& shot : shots) {
+        if (shot.second != starts.back().second) starts.push_back(shot);
+    }
+    long end = shots.back().first + 60000;
+    for (size_t i = 0; i < starts.size(); i++) {
+        long next = i + 1 < starts.size() ? starts[i + 1].first : end;
+        session.push_back({ starts[i].second, (next - starts[i].first) / 1000.0f });
+    }
+    return session;
+}
+
+// CNN simulada: certa com confiança variável, ou errada (em rajada)
+struct FakeCnn {
+    bool inError = false;
+
+    void classify(int truth, float* probs) {
+        inError = uniform(0, 1) < (inError ? 0.45f : 0.12f);
+        int top = truth;
+        if (inError) {
+            bool soak = truth >= MOLHO_CURTO;
+            do {
+                top = soak && uniform(0, 1) < 0.5f ? MOLHO_CURTO + (int)(rng() % 3) : (int)(rng() % STAGES);
+            } while (top == truth);
+        }
+        float topValue = inError ? uniform(0.45f, 0.95f) : uniform(0.40f, 1.0f);
+        float rest[STAGES];
+        float restSum = 0;
+        for (int i = 0; i < STAGES; i++) {
+            rest[i] = i == top ? 0 : uniform(0, 1) * (i == truth ? 3.0f : 1.0f);
+            restSum += rest[i];
+        }
+        for (int i = 0; i < STAGES; i++) {
+            float p = i == top ? topValue : (1.0f - topValue) * rest[i] / restSum;
+            probs[i] = roundf(p * 256.0f) / 256.0f;   // saída int8 desquantizada
+        }
+    }
+};
+
+#endif // WASH_CYCLE_SIM_H
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Gera washing_machine_monitor/web_assets.h a partir das páginas em web/.
+
+Cada página é comprimida com gzip (nível 9, sem data no cabeçalho, saída
+reprodutível) e vira um array const em flash, servido sem cópia e sem
+alocação com Content-Encoding: gzip. O ETag forte é o hash do conteúdo
+comprimido: muda só quando a página muda.
+
+Uso (a partir de arduino_code/):
+    python3 tools/embed_web_assets.py           # regenera o header
+    python3 tools/embed_web_assets.py --check   # falha se o header estiver desatualizado
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUTPUT = os.path.join(ROOT, "washing_machine_monitor", "web_assets.h")
+
+# (arquivo em web/, rota, Content-Type)
+ASSETS = [
+    ("index.html", "/", "text/html; charset=utf-8"),
+    ("calibration.html", "/calibration", "text/html; charset=utf-8"),
+]
+
+
+def symbol_for(filename):
+    return "WEB_" + re.sub(r"[^A-Za-z0-9]", "_", filename).upper() + "_GZ"
+
+
+def compress(data):
+    # mtime=0: o mesmo HTML gera sempre os mesmos bytes (e o mesmo ETag)
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def c_array(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def generate():
+    out = []
+    out.append("#ifndef WEB_ASSETS_H")
+    out.append("#define WEB_ASSETS_H")
+    out.append("")
+    out.append("// GERADO por tools/embed_web_assets.py a partir de web/ - NAO EDITAR.")
+    out.append("// Para alterar o dashboard, edite web/*.html e rode:")
+    out.append("//   python3 tools/embed_web_assets.py")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("#include <stddef.h>")
+    out.append("")
+    out.append("struct WebAsset {")
+    out.append("    const char* path;")
+    out.append("    const char* contentType;")
+    out.append("    const uint8_t* data;            // gzip")
+    out.append("    size_t length;")
+    out.append("    size_t originalLength;")
+    out.append("    const char* etag;               // ETag forte, já entre aspas")
+    out.append("};")
+    out.append("")
+
+    entries = []
+    for filename, path, content_type in ASSETS:
+        with open(os.path.join(WEB_DIR, filename), "rb") as f:
+            raw = f.read()
+        packed = compress(raw)
+        etag = '"%s"' % hashlib.sha256(packed).hexdigest()[:16]
+        symbol = symbol_for(filename)
+
+        out.append("// %s: %d -> %d bytes" % (filename, len(raw), len(packed)))
+        out.append("static const uint8_t %s[] = {" % symbol)
+        out.append(c_array(packed))
+        out.append("};")
+        out.append("")
+        entries.append('    { "%s", "%s", %s, sizeof(%s), %d, "\\"%s\\"" },'
+                       % (path, content_type, symbol, symbol, len(raw), etag.strip('"')))
+
+    out.append("static const WebAsset WEB_ASSETS[] = {")
+    out.extend(entries)
+    out.append("};")
+    out.append("")
+    out.append("static const int WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_H")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    content = generate()
+
+    if "--check" in sys.argv[1:]:
+        current = open(OUTPUT).read() if os.path.exists(OUTPUT) else ""
+        if current != content:
+            print("web_assets.h desatualizado: rode python3 tools/embed_web_assets.py")
+            return 1
+        print("web_assets.h atualizado")
+        return 0
+
+    with open(OUTPUT, "w") as f:
+        f.write(content)
+    print("Gerado %s" % os.path.relpath(OUTPUT, ROOT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""Gera a variante de 1 canal (escala de cinza) do modelo TFLite int8.
+
+Com a imagem em cinza o bloco DSP entrega o mesmo valor nos três canais, e a
+primeira convolução só vê a soma dos pesos de cada canal:
+    conv(Y, Y, Y) = sum_c w[o, ky, kx, c] * Y = conv'(Y)
+A ferramenta soma os pesos da primeira CONV_2D por canal de saída (int8,
+reescalando o canal quando a soma passa de 127 e ajustando o bias) e troca a
+entrada [1, 96, 96, 3] por [1, 96, 96, 1]. O resultado é o modelo RGB
+aplicado à imagem em cinza, com entrada de 9216 elementos.
+
+A edição é feita no lugar sobre o flatbuffer (só encolhe vetores), sem
+dependências além da biblioteca padrão.
+
+Uso (a partir de arduino_code/):
+    python3 tools/fold_grayscale_model.py           # regenera tflite_learn_3_gray.h
+    python3 tools/fold_grayscale_model.py --check   # falha se o header estiver desatualizado
+"""
+
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+MODEL_DIR = os.path.join(ROOT, "andreluiz-project-1_inferencing", "src", "tflite-model")
+SOURCE = os.path.join(MODEL_DIR, "tflite_learn_3.h")
+OUTPUT = os.path.join(MODEL_DIR, "tflite_learn_3_gray.h")
+
+NAME = "tflite_learn_3"
+GRAY_NAME = NAME + "_gray"
+BUILTIN_CONV_2D = 3
+TENSOR_INT8 = 9
+TENSOR_INT32 = 2
+
+
+class FlatBuffer:
+    """Leitura/escrita mínima de tabelas e vetores de um flatbuffer."""
+
+    def __init__(self, data):
+        self.data = data
+
+    def u32(self, offset):
+        return struct.unpack_from("<I", self.data, offset)[0]
+
+    def i32(self, offset):
+        return struct.unpack_from("<i", self.data, offset)[0]
+
+    def ref(self, offset):
+        return offset + self.u32(offset)
+
+    def field(self, table, index):
+        """Offset absoluto do campo "index" da tabela, ou None se ausente."""
+        vtable = table - self.i32(table)
+        vtable_len = struct.unpack_from("<H", self.data, vtable)[0]
+        if 4 + 2 * index >= vtable_len:
+            return None
+        rel = struct.unpack_from("<H", self.data, vtable + 4 + 2 * index)[0]
+        return table + rel if rel else None
+
+    def table(self, table, index):
+        offset = self.field(table, index)
+        return self.ref(offset) if offset is not None else None
+
+    def vector(self, table, index):
+        """(offset do tamanho, offset do primeiro elemento, tamanho)."""
+        offset = self.field(table, index)
+        if offset is None:
+            return None
+        start = self.ref(offset)
+        return start, start + 4, self.u32(start)
+
+    def int_vector(self, table, index):
+        vec = self.vector(table, index)
+        if vec is None:
+            return None
+        return [self.i32(vec[1] + 4 * i) for i in range(vec[2])]
+
+    def tables(self, table, index):
+        _, first, count = self.vector(table, index)
+        return [self.ref(first + 4 * i) for i in range(count)]
+
+
+def read_model(path):
+    text = open(path).read()
+    start = text.index(NAME + "[] = {")
+    end = text.index("};", start)
+    data = bytearray(int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", text[start:end]))
+    length = int(re.search(NAME + r"_len = (\d+);", text).group(1))
+    arena = int(re.search(NAME + r"_arena_size = (\d+);", text).group(1))
+    if len(data) != length:
+        raise SystemExit("ERRO: %s tem %d bytes, esperado %d" % (path, len(data), length))
+    return text, data, arena
+
+
+def set_last_dim(fb, tensor, value):
+    """Troca a última dimensão de shape (0) e shape_signature (7) no lugar."""
+    for index in (0, 7):
+        vec = fb.vector(tensor, index)
+        if vec is not None:
+            struct.pack_into("<i", fb.data, vec[1] + 4 * (vec[2] - 1), value)
+
+
+def fold(data):
+    fb = FlatBuffer(data)
+    model = fb.ref(0)
+    opcodes = []
+    for code in fb.tables(model, 1):
+        builtin = fb.field(code, 3)
+        deprecated = fb.field(code, 0)
+        value = fb.i32(builtin) if builtin is not None else 0
+        if deprecated is not None:
+            value = max(value, struct.unpack_from("<b", fb.data, deprecated)[0])
+        opcodes.append(value)
+    buffers = fb.tables(model, 4)
+    subgraph = fb.tables(model, 2)[0]
+    tensors = fb.tables(subgraph, 0)
+
+    inputs = fb.int_vector(subgraph, 1)
+    if len(inputs) != 1:
+        raise SystemExit("ERRO: modelo com %d entradas" % len(inputs))
+    input_index = inputs[0]
+    input_tensor = tensors[input_index]
+    shape = fb.int_vector(input_tensor, 0)
+    if len(shape) != 4 or shape[3] != 3:
+        raise SystemExit("ERRO: entrada %s nao e uma imagem RGB" % shape)
+
+    consumers = []
+    for op in fb.tables(subgraph, 3):
+        op_inputs = fb.int_vector(op, 1)
+        if input_index in op_inputs:
+            consumers.append((op, op_inputs))
+    if len(consumers) != 1:
+        raise SystemExit("ERRO: entrada usada por %d operadores" % len(consumers))
+    op, op_inputs = consumers[0]
+    opcode = fb.field(op, 0)
+    if opcodes[fb.u32(opcode) if opcode is not None else 0] != BUILTIN_CONV_2D or op_inputs[0] != input_index:
+        raise SystemExit("ERRO: primeira camada nao e CONV_2D sobre a entrada")
+
+    weights = tensors[op_inputs[1]]
+    bias = tensors[op_inputs[2]] if len(op_inputs) > 2 and op_inputs[2] >= 0 else None
+    out_ch, kh, kw, in_ch = fb.int_vector(weights, 0)
+    if in_ch != 3 or data[fb.field(weights, 1)] != TENSOR_INT8:
+        raise SystemExit("ERRO: pesos da primeira convolucao nao sao int8 [O, H, W, 3]")
+
+    # Pesos: [O, H, W, 3] -> [O, H, W, 1], soma reescalada por canal de saída
+    weight_quant = fb.table(weights, 4)
+    _, scale_at, scale_count = fb.vector(weight_quant, 2)
+    weight_buffer = buffers[fb.u32(fb.field(weights, 2))]
+    size_at, values_at, size = fb.vector(weight_buffer, 0)
+    if size != out_ch * kh * kw * in_ch or scale_count not in (1, out_ch):
+        raise SystemExit("ERRO: buffer de pesos inesperado")
+    raw = struct.unpack_from("<%db" % size, fb.data, values_at)
+    taps = kh * kw
+    folded = []
+    factors = []
+    for o in range(out_ch):
+        sums = [sum(raw[(o * taps + t) * 3 + c] for c in range(3)) for t in range(taps)]
+        peak = max(abs(s) for s in sums)
+        factor = peak / 127.0 if peak > 127 else 1.0
+        factors.append(factor)
+        folded.extend(max(-127, min(127, int(round(s / factor)))) for s in sums)
+    if scale_count == 1 and any(f != 1.0 for f in factors):
+        raise SystemExit("ERRO: quantizacao por tensor nao comporta reescala por canal")
+    struct.pack_into("<%db" % len(folded), fb.data, values_at, *folded)
+    struct.pack_into("<I", fb.data, size_at, len(folded))
+    for o in range(scale_count):
+        scale = struct.unpack_from("<f", fb.data, scale_at + 4 * o)[0]
+        struct.pack_into("<f", fb.data, scale_at + 4 * o, scale * factors[o])
+    set_last_dim(fb, weights, 1)
+
+    # Bias int32 na escala entrada * peso: acompanha a reescala dos pesos
+    if bias is not None and any(f != 1.0 for f in factors):
+        if data[fb.field(bias, 1)] != TENSOR_INT32:
+            raise SystemExit("ERRO: bias da primeira convolucao nao e int32")
+        bias_buffer = buffers[fb.u32(fb.field(bias, 2))]
+        _, bias_at, bias_bytes = fb.vector(bias_buffer, 0)
+        for o in range(out_ch):
+            value = struct.unpack_from("<i", fb.data, bias_at + 4 * o)[0]
+            struct.pack_into("<i", fb.data, bias_at + 4 * o, int(round(value / factors[o])))
+        bias_quant = fb.table(bias, 4)
+        _, bias_scale_at, bias_scale_count = fb.vector(bias_quant, 2)
+        for o in range(bias_scale_count):
+            scale = struct.unpack_from("<f", fb.data, bias_scale_at + 4 * o)[0]
+            struct.pack_into("<f", fb.data, bias_scale_at + 4 * o, scale * factors[o])
+
+    set_last_dim(fb, input_tensor, 1)
+    rescaled = sum(1 for f in factors if f != 1.0)
+    return shape[1] * shape[2], shape[1] * shape[2] * 3, rescaled, out_ch
+
+
+def generate():
+    text, data, arena = read_model(SOURCE)
+    gray_inputs, _, rescaled, channels = fold(data)
+    # Mesma arena do modelo RGB: o pico do planejador é a saída da primeira
+    # convolução junto com a do pooling, não a entrada (host/bench_grayscale.cpp
+    # mostra a arena usada pelas duas variantes)
+    gray_arena = arena
+
+    header = text[:text.index("MODEL_SECTION(EI_MODEL_SECTION)")]
+    header = header.replace("_EI_CLASSIFIER_TFLITE_LEARN_3_H_", "_EI_CLASSIFIER_TFLITE_LEARN_3_GRAY_H_")
+    header = header.replace("EI_CLASSIFIER_TFLITE_LEARN_3_ARENA_SIZE     %d" % arena,
+                            "EI_CLASSIFIER_TFLITE_LEARN_3_GRAY_ARENA_SIZE %d" % gray_arena)
+    header = header.replace("const size_t %s_arena_size = %d;" % (NAME, arena),
+                            "const size_t %s_arena_size = %d;" % (GRAY_NAME, gray_arena))
+
+    # A origem vem antes da licença copiada de tflite_learn_3.h: o arquivo não
+    # foi exportado pelo Edge Impulse, só deriva do modelo que foi
+    origin = ("// GERADO por tools/fold_grayscale_model.py a partir de %s.h - NAO EDITAR.\n"
+              "// Nao e um modelo exportado pelo Edge Impulse nem treinado em cinza: e o\n"
+              "// modelo RGB com a primeira CONV_2D somada por canal (%d de %d canais de\n"
+              "// saida reescalados), aplicado a (Y, Y, Y). Acerta menos que o RGB\n"
+              "// (host/bench_grayscale.cpp: 81%% contra 94%% em data_collection/).\n"
+              "// Para regenerar (a partir de arduino_code/):\n"
+              "//     python3 tools/fold_grayscale_model.py\n"
+              "// Um impulso \"Grayscale\" treinado no Edge Impulse pode substituir este arquivo.\n"
+              "// A licenca abaixo e a do modelo de origem.\n"
+              "\n" % (NAME, rescaled, channels))
+    header = origin + header
+    out = [header.rstrip("\n"), ""]
+    out.append("MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) const unsigned char %s[] = {" % GRAY_NAME)
+    for i in range(0, len(data), 12):
+        out.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 12]) + ("," if i + 12 < len(data) else ""))
+    out.append("};")
+    out.append("unsigned int %s_len = %d;" % (GRAY_NAME, len(data)))
+    out.append("#endif // _EI_CLASSIFIER_TFLITE_LEARN_3_GRAY_H_")
+    return "\n".join(out) + "\n", gray_inputs, gray_arena, rescaled
+
+
+def main():
+    content, inputs, arena, rescaled = generate()
+    if "--check" in sys.argv:
+        current = open(OUTPUT).read() if os.path.exists(OUTPUT) else ""
+        if current != content:
+            print("ERRO: %s desatualizado - rode tools/fold_grayscale_model.py" % os.path.relpath(OUTPUT, ROOT))
+            sys.exit(1)
+        print("%s em dia" % os.path.relpath(OUTPUT, ROOT))
+        return
+    with open(OUTPUT, "w") as f:
+        f.write(content)
+    print("Gerado %s: entrada %d, arena %d bytes, %d canais reescalados"
+          % (os.path.relpath(OUTPUT, ROOT), inputs, arena, rescaled))
+
+
+if __name__ == "__main__":
+    main()
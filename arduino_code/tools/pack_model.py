@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Empacota um modelo TFLite para a partição "model" (washing_machine_monitor/model_blob.h).
+
+O arquivo gerado tem o cabeçalho de model_blob.h (versão, arena, classes,
+forma da entrada e CRCs) seguido do .tflite, e é instalado sem reboot:
+    python3 -m http.server 8000                                  (na pasta do arquivo)
+    curl "http://<ip>/model?url=http://<pc>:8000/modelo.wmml"
+    curl http://<ip>/model                                       (modelo ativo)
+
+Classes e entrada vêm do modelo compilado (model_variables.h e
+model_metadata.h): o firmware recusa um modelo com outras classes ou outra
+entrada. A entrada pode ser um .tflite exportado do Edge Impulse ou um header
+de tflite-model/ (o modelo compilado, ou a variante em cinza com --gray).
+
+Uso (a partir de arduino_code/):
+    python3 tools/pack_model.py modelo.tflite modelo.wmml --version 2 [--arena BYTES] [--gray]
+    python3 tools/pack_model.py - modelo.wmml --version 2 [--gray]   # modelo compilado
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC_DIR = os.path.join(ROOT, "andreluiz-project-1_inferencing", "src")
+MODEL_DIR = os.path.join(SRC_DIR, "tflite-model")
+METADATA = os.path.join(SRC_DIR, "model-parameters", "model_metadata.h")
+VARIABLES = os.path.join(SRC_DIR, "model-parameters", "model_variables.h")
+
+# model_blob.h
+MAGIC = 0x4C4D4D57
+FORMAT = 1
+HEADER_SIZE = 256
+LABELS = 8
+LABEL_SIZE = 24
+
+
+def read_header_model(path):
+    """Bytes e arena de um header gerado (tflite_learn_3.h e variantes)."""
+    text = open(path).read()
+    name = re.search(r"const unsigned char (\w+)\[\] = \{", text).group(1)
+    start = text.index(name + "[] = {")
+    end = text.index("};", start)
+    data = bytes(int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", text[start:end]))
+    length = int(re.search(name + r"_len = (\d+);", text).group(1))
+    arena = int(re.search(name + r"_arena_size = (\d+);", text).group(1))
+    if len(data) != length:
+        raise SystemExit("ERRO: %s tem %d bytes, esperado %d" % (path, len(data), length))
+    return data, arena
+
+
+def firmware_shape(gray):
+    """Entrada e classes do modelo compilado."""
+    metadata = open(METADATA).read()
+    width = int(re.search(r"#define EI_CLASSIFIER_INPUT_WIDTH\s+(\d+)", metadata).group(1))
+    height = int(re.search(r"#define EI_CLASSIFIER_INPUT_HEIGHT\s+(\d+)", metadata).group(1))
+    variables = open(VARIABLES, encoding="utf-8").read()
+    categories = re.search(r"ei_classifier_inferencing_categories\[\] = \{([^}]*)\}", variables).group(1)
+    labels = re.findall(r'"([^"]*)"', categories)
+    return width, height, 1 if gray else 3, labels
+
+
+def pack(model, arena, version, width, height, channels, labels):
+    if len(labels) > LABELS:
+        raise SystemExit("ERRO: %d classes, o formato guarda ate %d" % (len(labels), LABELS))
+    header = struct.pack("<IHHIIIIIHHBB2x", MAGIC, FORMAT, HEADER_SIZE, 0, version, len(model),
+                         zlib.crc32(model), arena, width, height, channels, len(labels))
+    for label in labels:
+        encoded = label.encode("utf-8")
+        if len(encoded) >= LABEL_SIZE:
+            raise SystemExit("ERRO: classe '%s' passa de %d bytes" % (label, LABEL_SIZE - 1))
+        header += encoded.ljust(LABEL_SIZE, b"\0")
+    header += b"\0" * LABEL_SIZE * (LABELS - len(labels))
+    header += struct.pack("<I", zlib.crc32(header))
+    return header.ljust(HEADER_SIZE, b"\0") + model
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Empacota um modelo TFLite para a particao 'model'")
+    parser.add_argument("model", help=".tflite, header de tflite-model/ ou - para o modelo compilado")
+    parser.add_argument("output", help="arquivo .wmml")
+    parser.add_argument("--version", type=int, default=1, help="versao exibida em /model")
+    parser.add_argument("--arena", type=int, help="arena do TFLite (padrao: a do modelo compilado)")
+    parser.add_argument("--gray", action="store_true", help="modelo de 1 canal (EI_CLASSIFIER_GRAYSCALE_MODEL)")
+    args = parser.parse_args()
+
+    compiled = os.path.join(MODEL_DIR, "tflite_learn_3_gray.h" if args.gray else "tflite_learn_3.h")
+    _, compiled_arena = read_header_model(compiled)
+    if args.model == "-":
+        model, arena = read_header_model(compiled)
+    elif args.model.endswith(".h"):
+        model, arena = read_header_model(args.model)
+    else:
+        model = open(args.model, "rb").read()
+        arena = compiled_arena
+    if args.arena:
+        arena = args.arena
+    if model[4:8] != b"TFL3":
+        raise SystemExit("ERRO: %s nao e um modelo TFLite" % args.model)
+
+    width, height, channels, labels = firmware_shape(args.gray)
+    blob = pack(model, arena, args.version, width, height, channels, labels)
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("Gerado %s: modelo de %d bytes, versao %d, arena %d bytes, entrada %dx%dx%d, %d classes"
+          % (args.output, len(model), args.version, arena, width, height, channels, len(labels)))
+
+
+if __name__ == "__main__":
+    main()
@@ -2,19 +2,93 @@
 #define CAMERA_MANAGER_H
 
 #include "esp_camera.h"
+#include <Preferences.h>
 #include "config.h"
+#include "image_resize.h"
+#include "change_detector.h"
+#include "camera_window.h"
+#include "json_writer.h"
+
+// Quadro de referência (vista inteira, FRAMESIZE_QVGA): posições dos LEDs,
+// região do sensor e interface web usam estas coordenadas
+#define CAMERA_FRAME_WIDTH      CAMERA_REFERENCE_WIDTH
+#define CAMERA_FRAME_HEIGHT     CAMERA_REFERENCE_HEIGHT
+
+#ifndef CAMERA_ROI_CAPTURE
+#define CAMERA_ROI_CAPTURE      0       // 1 = janela do sensor (camera_window.h) com saída na entrada do modelo
+#endif
+
+#ifndef CAMERA_ROI_MODE
+#define CAMERA_ROI_MODE         CAMERA_SENSOR_SVGA  // Modo nativo lido pela janela (UXGA = mais lento)
+#endif
+
+#ifndef CAMERA_GRAYSCALE
+#define CAMERA_GRAYSCALE        EI_CLASSIFIER_GRAYSCALE_MODEL  // 1 = PIXFORMAT_GRAYSCALE (1 byte por pixel)
+#endif
+
+// Em RGB565 o driver só aceita frames do frame_size do init (FRAMESIZE_96X96)
+static_assert(!CAMERA_ROI_CAPTURE || (EI_CLASSIFIER_INPUT_WIDTH == 96 && EI_CLASSIFIER_INPUT_HEIGHT == 96),
+              "CAMERA_ROI_CAPTURE precisa de um frame_size igual a entrada do modelo");
+
+// Frame RGB565 (ou cinza) da câmera usado como origem da conversão direta para o tensor int8
+struct CameraFrameSource {
+    const uint8_t* buf;
+    size_t len;
+    int width;
+    int height;
+    bool grayscale;                 // PIXFORMAT_GRAYSCALE: 1 byte por pixel
+    CameraWindow window;            // janela que gerou o frame (mapeia posições de referência)
+};
+
+// Modo de redimensionamento do frame para a entrada do modelo (IMAGE_RESIZE_*),
+// por padrão o mesmo usado no treinamento
+int cameraResizeMode = EI_CLASSIFIER_RESIZE_MODE;
+ResizeScratch cameraResizeScratch;
+
+// Região do painel usada na assinatura do detector de mudança
+ChangeRegion changeDetectRegion = { 0, 0, EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT };
+
+// Janela atual do sensor: escrita pela tarefa web, lida a cada frame
+CameraWindow cameraWindow = cameraFullFrame();
+SemaphoreHandle_t cameraWindowLock = NULL;
+
+// Fonte de frames no lugar do sensor (replay de uma gravação, frame_replay.h):
+// captureImage() pede o próximo frame à fonte (nullptr no fim) e
+// releaseCameraBuffer() o devolve a ela. Só trocar com a captura parada
+struct CameraFrameFeed {
+    camera_fb_t* (*get)(void* ctx);
+    void (*release)(void* ctx, camera_fb_t* fb);
+    void* ctx;
+};
+CameraFrameFeed* volatile cameraFrameFeed = nullptr;
 
 // =================== FUNÇÕES PÚBLICAS ===================
 bool initializeCamera();
 camera_fb_t* captureImage();
 void releaseCameraBuffer(camera_fb_t* fb);
-bool resizeImageForML(uint8_t* input_buf, size_t input_len, uint8_t* output_buf);
+bool resizeImageForML(const CameraFrameSource* frame, uint8_t* output_buf);
+int fillQuantizedInputFromFrame(void* ctx, int8_t* input, size_t input_size, float scale, int32_t zero_point);
+int quantizeFrame(const CameraFrameSource* frame, int8_t* input, size_t input_size,
+                  float scale, int32_t zero_point, FrameSignature* signature);
+bool computeFrameSignature(const CameraFrameSource* frame, FrameSignature& signature);
+bool setChangeDetectRegion(int x, int y, int width, int height);
+bool setCameraResizeMode(int mode);
 void optimizeCameraSettings();
+void makeCameraFrame(camera_fb_t* fb, CameraFrameSource& frame);
+int cameraPixelFormat(const CameraFrameSource* frame);
+CameraWindow readCameraWindow();
+bool setCameraWindow(const CameraRect& region);
+bool applyCameraWindow(const CameraWindow& window);
+void writeCameraWindowJSON(JsonWriter& json, const CameraWindow& window);
+void setCameraFrameFeed(CameraFrameFeed* feed);
 
 // =================== IMPLEMENTAÇÃO ===================
 
 bool initializeCamera() {
     Serial.println("Inicializando camera ESP32-CAM...");
+    if (!cameraWindowLock) {
+        cameraWindowLock = xSemaphoreCreateMutex();
+    }
     
     camera_config_t config;
     config.ledc_channel = LEDC_CHANNEL_0;
@@ -36,8 +110,12 @@ bool initializeCamera() {
     config.pin_pwdn = PWDN_GPIO_NUM;
     config.pin_reset = RESET_GPIO_NUM;
     config.xclk_freq_hz = 20000000;
-    config.pixel_format = PIXFORMAT_RGB565; // RGB para o modelo ML
+    config.pixel_format = CAMERA_GRAYSCALE ? PIXFORMAT_GRAYSCALE : PIXFORMAT_RGB565; // Formato do modelo ML
     config.frame_size = FRAMESIZE_QVGA;     // 320x240 - bom compromisso
+    if (CAMERA_ROI_CAPTURE) {
+        // Buffers do tamanho da entrada do modelo: a janela do sensor entrega 96x96
+        config.frame_size = FRAMESIZE_96X96;
+    }
     config.jpeg_quality = 4;                // Alta qualidade
     config.fb_count = 2;                    // Double buffering
     
@@ -53,10 +131,31 @@ bool initializeCamera() {
     // Aplicar configurações otimizadas
     optimizeCameraSettings();
     
+    // Janela do sensor gravada pela interface web (ou a vista inteira)
+    if (CAMERA_ROI_CAPTURE) {
+        CameraRect region = { 0, 0, CAMERA_REFERENCE_WIDTH, CAMERA_REFERENCE_HEIGHT };
+        Preferences prefs;
+        if (prefs.begin("camera", true)) {
+            CameraRect stored;
+            if (prefs.getBytes("roi", &stored, sizeof(stored)) == sizeof(stored)) {
+                region = stored;
+            }
+            prefs.end();
+        }
+        if (!setCameraWindow(region)) {
+            Serial.println("AVISO: Janela do sensor gravada invalida, usando a vista inteira");
+            setCameraWindow({ 0, 0, CAMERA_REFERENCE_WIDTH, CAMERA_REFERENCE_HEIGHT });
+        }
+    }
+    
     return true;
 }
 
 camera_fb_t* captureImage() {
+    CameraFrameFeed* feed = cameraFrameFeed;
+    if (feed) {
+        return feed->get(feed->ctx);
+    }
     camera_fb_t* fb = esp_camera_fb_get();
     if (!fb) {
         Serial.println("ERRO: Falha ao capturar imagem da camera");
@@ -74,11 +173,115 @@ camera_fb_t* captureImage() {
 }
 
 void releaseCameraBuffer(camera_fb_t* fb) {
-    if (fb) {
+    if (!fb) {
+        return;
+    }
+    CameraFrameFeed* feed = cameraFrameFeed;
+    if (feed) {
+        feed->release(feed->ctx, fb);
+    } else {
         esp_camera_fb_return(fb);
     }
 }
 
+void setCameraFrameFeed(CameraFrameFeed* feed) {
+    cameraFrameFeed = feed;
+}
+
+// Frame do driver + janela atual. Durante uma troca de janela o frame pode ser
+// da anterior: no pior caso um frame com os LEDs lidos no lugar errado
+void makeCameraFrame(camera_fb_t* fb, CameraFrameSource& frame) {
+    frame.buf = fb->buf;
+    frame.len = fb->len;
+    frame.width = (int)fb->width;
+    frame.height = (int)fb->height;
+    frame.grayscale = fb->format == PIXFORMAT_GRAYSCALE;
+    frame.window = readCameraWindow();
+}
+
+int cameraPixelFormat(const CameraFrameSource* frame) {
+    return frame->grayscale ? IMAGE_PIXEL_GRAY8 : IMAGE_PIXEL_RGB565;
+}
+
+CameraWindow readCameraWindow() {
+    if (!cameraWindowLock) {
+        return cameraWindow;
+    }
+    xSemaphoreTake(cameraWindowLock, portMAX_DELAY);
+    CameraWindow window = cameraWindow;
+    xSemaphoreGive(cameraWindowLock);
+    return window;
+}
+
+// Região em coordenadas de referência -> janela no sensor; grava para o boot
+bool setCameraWindow(const CameraRect& region) {
+    if (!CAMERA_ROI_CAPTURE) {
+        Serial.println("ERRO: Janela do sensor requer CAMERA_ROI_CAPTURE 1");
+        return false;
+    }
+    CameraWindow window;
+    if (!planCameraWindow(region, CAMERA_ROI_MODE, EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT,
+                          cameraResizeMode != IMAGE_RESIZE_SQUASH, window)) {
+        Serial.printf("ERRO: Janela do sensor invalida: %d,%d %dx%d\n",
+                     region.x, region.y, region.width, region.height);
+        return false;
+    }
+    if (!applyCameraWindow(window)) {
+        return false;
+    }
+    
+    Preferences prefs;
+    if (prefs.begin("camera", false)) {
+        prefs.putBytes("roi", &region, sizeof(region));
+        prefs.end();
+    }
+    return true;
+}
+
+bool applyCameraWindow(const CameraWindow& window) {
+    sensor_t* s = esp_camera_sensor_get();
+    if (!s || !s->set_res_raw) {
+        Serial.println("ERRO: Sensor sem suporte a janela (set_res_raw)");
+        return false;
+    }
+    // OV2640: startX = modo; offset, tamanho da janela e saída do DSP
+    if (s->set_res_raw(s, window.mode, 0, 0, 0, window.offsetX, window.offsetY,
+                       window.width, window.height, window.outputWidth, window.outputHeight, false, false) != 0) {
+        Serial.println("ERRO: Sensor recusou a janela");
+        return false;
+    }
+    
+    xSemaphoreTake(cameraWindowLock, portMAX_DELAY);
+    cameraWindow = window;
+    xSemaphoreGive(cameraWindowLock);
+    Serial.printf("Janela do sensor: %d,%d %dx%d (modo %d) -> %dx%d, regiao %d,%d %dx%d\n",
+                 window.offsetX, window.offsetY, window.width, window.height, window.mode,
+                 window.outputWidth, window.outputHeight,
+                 window.region.x, window.region.y, window.region.width, window.region.height);
+    return true;
+}
+
+// Objeto "window": a interface web mapeia o /snapshot de volta para a referência
+void writeCameraWindowJSON(JsonWriter& json, const CameraWindow& window) {
+    json.beginObject()
+        .field("roi_capture", (bool)CAMERA_ROI_CAPTURE)
+        .field("sensor", window.sensor)
+        .field("x", window.region.x)
+        .field("y", window.region.y)
+        .field("w", window.region.width)
+        .field("h", window.region.height)
+        .field("output_w", window.outputWidth)
+        .field("output_h", window.outputHeight);
+    if (window.sensor) {
+        json.field("mode", window.mode)
+            .field("sensor_x", window.offsetX)
+            .field("sensor_y", window.offsetY)
+            .field("sensor_w", window.width)
+            .field("sensor_h", window.height);
+    }
+    json.endObject();
+}
+
 void optimizeCameraSettings() {
     Serial.println("Aplicando configuracoes otimizadas da camera...");
     
@@ -113,75 +316,121 @@ void optimizeCameraSettings() {
     s->set_colorbar(s, 0);          // Sem barra de cores
     
     Serial.println("Configuracoes da camera aplicadas!");
-    Serial.printf("Resolucao: %dx%d\n", 320, 240);
-    Serial.printf("Formato: RGB565\n");
+    Serial.printf("Resolucao: %dx%d\n", CAMERA_ROI_CAPTURE ? EI_CLASSIFIER_INPUT_WIDTH : CAMERA_FRAME_WIDTH,
+                 CAMERA_ROI_CAPTURE ? EI_CLASSIFIER_INPUT_HEIGHT : CAMERA_FRAME_HEIGHT);
+    Serial.printf("Formato: %s\n", CAMERA_GRAYSCALE ? "escala de cinza" : "RGB565");
     Serial.printf("Qualidade: Otimizada para LEDs\n");
 }
 
-bool resizeImageForML(uint8_t* input_buf, size_t input_len, uint8_t* output_buf) {
-    // Configurações de entrada e saída
-    const int input_width = 320;
-    const int input_height = 240;
-    const int output_width = EI_CLASSIFIER_INPUT_WIDTH;
-    const int output_height = EI_CLASSIFIER_INPUT_HEIGHT;
-    const int bytes_per_pixel_input = 2;   // RGB565 = 2 bytes
-    const int bytes_per_pixel_output = 3;  // RGB888 = 3 bytes
+bool resizeImageForML(const CameraFrameSource* frame, uint8_t* output_buf) {
+    const int bytes_per_pixel_input = frame->grayscale ? 1 : 2;   // RGB565 = 2 bytes
     
     // Verificar se o buffer de entrada tem tamanho suficiente
-    size_t expected_input_size = input_width * input_height * bytes_per_pixel_input;
-    if (input_len < expected_input_size) {
-        Serial.printf("ERRO: Buffer de entrada muito pequeno. Esperado: %d, Recebido: %d\n", 
-                     expected_input_size, input_len);
+    size_t expected_input_size = frame->width * frame->height * bytes_per_pixel_input;
+    if (frame->len < expected_input_size) {
+        Serial.printf("ERRO: Buffer de entrada muito pequeno. Esperado: %lu, Recebido: %lu\n", 
+                     (unsigned long)expected_input_size, (unsigned long)frame->len);
         return false;
     }
     
-    // Calcular região central para crop
-    int start_x = (input_width - output_width) / 2;
-    int start_y = (input_height - output_height) / 2;
-    
-    // Garantir que não saia dos limites
-    if (start_x < 0) start_x = 0;
-    if (start_y < 0) start_y = 0;
-    if (start_x + output_width > input_width) start_x = input_width - output_width;
-    if (start_y + output_height > input_height) start_y = input_height - output_height;
-    
-    // Fazer crop e conversão RGB565 -> RGB888
-    for (int y = 0; y < output_height; y++) {
-        for (int x = 0; x < output_width; x++) {
-            // Calcular índices
-            int src_x = start_x + x;
-            int src_y = start_y + y;
-            int input_idx = (src_y * input_width + src_x) * bytes_per_pixel_input;
-            int output_idx = (y * output_width + x) * bytes_per_pixel_output;
-            
-            // Verificar limites
-            if (input_idx + 1 < input_len) {
-                // Ler pixel RGB565 (little endian)
-                uint16_t pixel = (input_buf[input_idx + 1] << 8) | input_buf[input_idx];
-                
-                // Converter RGB565 para RGB888
-                uint8_t r = ((pixel >> 11) & 0x1F) << 3;  // 5 bits -> 8 bits
-                uint8_t g = ((pixel >> 5) & 0x3F) << 2;   // 6 bits -> 8 bits  
-                uint8_t b = (pixel & 0x1F) << 3;          // 5 bits -> 8 bits
-                
-                // Aplicar dithering para melhor qualidade
-                r |= (r >> 5);
-                g |= (g >> 6);
-                b |= (b >> 5);
-                
-                // Armazenar no buffer de saída
-                output_buf[output_idx] = r;
-                output_buf[output_idx + 1] = g;
-                output_buf[output_idx + 2] = b;
-            } else {
-                // Pixel fora dos limites - preencher com preto
-                output_buf[output_idx] = 0;
-                output_buf[output_idx + 1] = 0;
-                output_buf[output_idx + 2] = 0;
-            }
-        }
+    // Redimensionar o quadro inteiro e converter para RGB888 (cinza: R = G = B)
+    Rgb888Sink sink = { output_buf };
+    if (!resizeFrame(frame->buf, frame->width, frame->height, cameraPixelFormat(frame),
+                     EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT,
+                     cameraResizeMode, cameraResizeScratch, sink)) {
+        Serial.println("ERRO: Falha ao redimensionar imagem");
+        return false;
+    }
+    
+    return true;
+}
+
+bool setCameraResizeMode(int mode) {
+    if (mode != IMAGE_RESIZE_SQUASH && mode != IMAGE_RESIZE_FIT_SHORTEST && mode != IMAGE_RESIZE_FIT_LONGEST) {
+        Serial.printf("ERRO: Modo de redimensionamento invalido: %d\n", mode);
+        return false;
+    }
+    cameraResizeMode = mode;
+    return true;
+}
+
+// Redimensiona, converte RGB565 (ou cinza) e quantiza direto no tensor de entrada
+// do modelo, em uma única passada sobre o frame (sem buffers intermediários)
+int fillQuantizedInputFromFrame(void* ctx, int8_t* input, size_t input_size, float scale, int32_t zero_point) {
+    return quantizeFrame((const CameraFrameSource*)ctx, input, input_size, scale, zero_point, nullptr);
+}
+
+// Igual a fillQuantizedInputFromFrame, calculando na mesma passada a assinatura
+// do painel para o detector de mudança (signature pode ser nullptr)
+int quantizeFrame(const CameraFrameSource* frame, int8_t* input, size_t input_size,
+                  float scale, int32_t zero_point, FrameSignature* signature) {
+    const int output_width = EI_CLASSIFIER_INPUT_WIDTH;
+    const int output_height = EI_CLASSIFIER_INPUT_HEIGHT;
+    const int output_pixels = output_width * output_height;
+    
+    // 3 canais (RGB) ou 1 canal (modelo em escala de cinza)
+    int channels = input_size / output_pixels;
+    if ((channels != 3 && channels != 1) || (size_t)(channels * output_pixels) != input_size) {
+        Serial.printf("ERRO: Tensor de entrada inesperado: %u elementos\n", (unsigned)input_size);
+        return -1;
+    }
+    
+    if (frame->width < output_width || frame->height < output_height ||
+        frame->len < (size_t)(frame->width * frame->height * (frame->grayscale ? 1 : 2))) {
+        Serial.println("ERRO: Frame da camera menor que a entrada do modelo");
+        return -1;
+    }
+    
+    // Tabela de quantização: valor 0-255 do canal -> int8 do tensor
+    int8_t quant[256];
+    buildQuantizationTable(scale, zero_point, quant);
+    
+    QuantizedSink sink = { input, quant, channels == 1 };
+    bool resized;
+    if (signature) {
+        static SignatureSink<QuantizedSink> signatureSink;
+        signatureSink.begin(&sink, changeDetectRegion, output_width);
+        resized = resizeFrame(frame->buf, frame->width, frame->height, cameraPixelFormat(frame),
+                              output_width, output_height, cameraResizeMode,
+                              cameraResizeScratch, signatureSink);
+        signatureSink.finish(*signature);
+    } else {
+        resized = resizeFrame(frame->buf, frame->width, frame->height, cameraPixelFormat(frame),
+                              output_width, output_height, cameraResizeMode,
+                              cameraResizeScratch, sink);
+    }
+    
+    if (!resized) {
+        Serial.println("ERRO: Falha ao redimensionar frame para o tensor");
+        return -1;
     }
     
+    return 0;
+}
+
+// Só a assinatura do painel, sem gravar o tensor (predição fora do pipeline)
+bool computeFrameSignature(const CameraFrameSource* frame, FrameSignature& signature) {
+    static SignatureSink<NullSink> signatureSink;
+    NullSink sink;
+    
+    signature.valid = false;
+    signatureSink.begin(&sink, changeDetectRegion, EI_CLASSIFIER_INPUT_WIDTH);
+    if (!resizeFrame(frame->buf, frame->width, frame->height, cameraPixelFormat(frame),
+                     EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT, cameraResizeMode,
+                     cameraResizeScratch, signatureSink)) {
+        return false;
+    }
+    signatureSink.finish(signature);
+    return true;
+}
+
+bool setChangeDetectRegion(int x, int y, int width, int height) {
+    if (x < 0 || y < 0 || width < CHANGE_GRID || height < CHANGE_GRID ||
+        x + width > EI_CLASSIFIER_INPUT_WIDTH || y + height > EI_CLASSIFIER_INPUT_HEIGHT) {
+        Serial.printf("ERRO: Regiao do painel invalida: %d,%d %dx%d\n", x, y, width, height);
+        return false;
+    }
+    changeDetectRegion = { x, y, width, height };
     return true;
 }
 
@@ -190,8 +439,13 @@ void printCameraInfo() {
     if (s) {
         Serial.println("=== INFORMACOES DA CAMERA ===");
         Serial.printf("ID do sensor: 0x%02X\n", s->id.PID);
-        Serial.printf("Resolucao: %dx%d\n", 320, 240);
-        Serial.printf("Formato: RGB565\n");
+        CameraWindow window = readCameraWindow();
+        Serial.printf("Resolucao: %dx%d\n", window.outputWidth, window.outputHeight);
+        if (window.sensor) {
+            Serial.printf("Janela do sensor: %d,%d %dx%d (modo %d)\n",
+                         window.offsetX, window.offsetY, window.width, window.height, window.mode);
+        }
+        Serial.printf("Formato: %s\n", CAMERA_GRAYSCALE ? "escala de cinza" : "RGB565");
         Serial.printf("Buffers: 2 (double buffering)\n");
         Serial.println("============================");
     }
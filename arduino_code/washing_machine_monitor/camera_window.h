@@ -0,0 +1,178 @@
+#ifndef CAMERA_WINDOW_H
+#define CAMERA_WINDOW_H
+
+// Janela do sensor (ROI) do OV2640: em vez de ler o quadro QVGA inteiro e
+// descartar quase tudo, o sensor lê só a região do painel no modo nativo
+// (UXGA/SVGA/CIF) e o DSP dele já entrega a entrada do modelo.
+//
+// A região é dada no quadro de referência (a vista inteira em QVGA, 320x240,
+// o mesmo das posições dos LEDs e da interface web) e vira a janela do
+// set_res_raw do esp32-camera: offset e tamanho em pixels do modo, tamanhos
+// múltiplos de 4 (os registradores HSIZE/VSIZE/ZMOW/ZMOH guardam /4), janela
+// dentro do modo e saída nunca maior que a janela (o DSP só reduz).
+// Não depende do Arduino (usado no host).
+
+#include <stdint.h>
+
+#define CAMERA_REFERENCE_WIDTH      320     // Vista inteira (QVGA)
+#define CAMERA_REFERENCE_HEIGHT     240
+
+// Modos do OV2640 (mesma numeração de ov2640_sensor_mode_t)
+#define CAMERA_SENSOR_UXGA          0
+#define CAMERA_SENSOR_SVGA          1
+#define CAMERA_SENSOR_CIF           2
+#define CAMERA_SENSOR_MODES         3
+
+#define CAMERA_WINDOW_ALIGN         4
+#define CAMERA_WINDOW_MIN           16      // Lado mínimo da região (px de referência)
+
+// Área lida em cada modo (o CIF corta 4 linhas no pé do sensor)
+static const int CAMERA_SENSOR_SIZE[CAMERA_SENSOR_MODES][2] = {
+    { 1600, 1200 }, { 800, 600 }, { 400, 296 }
+};
+
+struct CameraRect {
+    int x, y, width, height;
+};
+
+struct CameraWindow {
+    bool sensor;                    // false: quadro inteiro, sem janela (saída = referência)
+    int mode;                       // CAMERA_SENSOR_*
+    int offsetX, offsetY;           // janela no modo
+    int width, height;
+    int outputWidth, outputHeight;  // saída do DSP (pixels do frame)
+    CameraRect region;              // região efetiva, em referência (contém a pedida)
+};
+
+inline int cameraAlignUp(int v) {
+    return (v + CAMERA_WINDOW_ALIGN - 1) / CAMERA_WINDOW_ALIGN * CAMERA_WINDOW_ALIGN;
+}
+
+// Quadro inteiro em QVGA, sem janela no sensor (captura original)
+inline CameraWindow cameraFullFrame() {
+    CameraWindow w;
+    w.sensor = false;
+    w.mode = -1;
+    w.offsetX = 0;
+    w.offsetY = 0;
+    w.width = CAMERA_REFERENCE_WIDTH;
+    w.height = CAMERA_REFERENCE_HEIGHT;
+    w.outputWidth = CAMERA_REFERENCE_WIDTH;
+    w.outputHeight = CAMERA_REFERENCE_HEIGHT;
+    w.region = { 0, 0, CAMERA_REFERENCE_WIDTH, CAMERA_REFERENCE_HEIGHT };
+    return w;
+}
+
+// Encaixa [start, start + size) em [0, limit), deslocando sem encolher
+inline void cameraFitSpan(int& start, int& size, int limit) {
+    if (size > limit) {
+        size = limit / CAMERA_WINDOW_ALIGN * CAMERA_WINDOW_ALIGN;
+    }
+    if (start + size > limit) {
+        start = limit - size;
+    }
+    if (start < 0) {
+        start = 0;
+    }
+}
+
+// Região (referência) -> janela no modo. A saída do DSP é fixa (outputWidth x
+// outputHeight, o frame_size do esp_camera_init: em RGB565 o driver descarta
+// frames de outro tamanho). Com keepAspect a janela cresce até a proporção da
+// saída; sem, o DSP distorce como o resize "squash" faria. A janela também
+// cresce em volta da região quando é menor que a saída.
+inline bool planCameraWindow(const CameraRect& roi, int mode, int outputWidth, int outputHeight, bool keepAspect,
+                             CameraWindow& w) {
+    if (mode < 0 || mode >= CAMERA_SENSOR_MODES || outputWidth % CAMERA_WINDOW_ALIGN || outputHeight % CAMERA_WINDOW_ALIGN ||
+        roi.width < CAMERA_WINDOW_MIN || roi.height < CAMERA_WINDOW_MIN || roi.x < 0 || roi.y < 0 ||
+        roi.x + roi.width > CAMERA_REFERENCE_WIDTH || roi.y + roi.height > CAMERA_REFERENCE_HEIGHT) {
+        return false;
+    }
+    const int modeWidth = CAMERA_SENSOR_SIZE[mode][0];
+    const int modeHeight = CAMERA_SENSOR_SIZE[mode][1];
+
+    // Referência -> modo, arredondando para fora
+    int x0 = roi.x * modeWidth / CAMERA_REFERENCE_WIDTH;
+    int y0 = roi.y * modeHeight / CAMERA_REFERENCE_HEIGHT;
+    int x1 = ((roi.x + roi.width) * modeWidth + CAMERA_REFERENCE_WIDTH - 1) / CAMERA_REFERENCE_WIDTH;
+    int y1 = ((roi.y + roi.height) * modeHeight + CAMERA_REFERENCE_HEIGHT - 1) / CAMERA_REFERENCE_HEIGHT;
+    if (x1 > modeWidth) x1 = modeWidth;
+    if (y1 > modeHeight) y1 = modeHeight;
+
+    int needWidth = x1 - x0, needHeight = y1 - y0;
+    if (keepAspect) {
+        if (needWidth * outputHeight > needHeight * outputWidth) {
+            needHeight = (needWidth * outputHeight + outputWidth - 1) / outputWidth;
+        } else {
+            needWidth = (needHeight * outputWidth + outputHeight - 1) / outputHeight;
+        }
+    }
+    if (needWidth < outputWidth) needWidth = outputWidth;
+    if (needHeight < outputHeight) needHeight = outputHeight;
+    int width = cameraAlignUp(needWidth);
+    int height = cameraAlignUp(needHeight);
+
+    // Cresce centrado na região e desloca para dentro do modo se passou da borda
+    int offsetX = x0 - (width - (x1 - x0)) / 2;
+    int offsetY = y0 - (height - (y1 - y0)) / 2;
+    cameraFitSpan(offsetX, width, modeWidth);
+    cameraFitSpan(offsetY, height, modeHeight);
+    if (width < outputWidth || height < outputHeight) {
+        return false;
+    }
+
+    w.sensor = true;
+    w.mode = mode;
+    w.offsetX = offsetX;
+    w.offsetY = offsetY;
+    w.width = width;
+    w.height = height;
+    w.outputWidth = outputWidth;
+    w.outputHeight = outputHeight;
+    // Janela de volta à referência, arredondando para dentro
+    w.region.x = (offsetX * CAMERA_REFERENCE_WIDTH + modeWidth - 1) / modeWidth;
+    w.region.y = (offsetY * CAMERA_REFERENCE_HEIGHT + modeHeight - 1) / modeHeight;
+    w.region.width = (offsetX + width) * CAMERA_REFERENCE_WIDTH / modeWidth - w.region.x;
+    w.region.height = (offsetY + height) * CAMERA_REFERENCE_HEIGHT / modeHeight - w.region.y;
+    return true;
+}
+
+// Pixels de referência por pixel do frame (o maior dos dois eixos)
+inline float cameraWindowScale(const CameraWindow& w) {
+    float sx = (float)w.region.width / w.outputWidth;
+    float sy = (float)w.region.height / w.outputHeight;
+    return sx > sy ? sx : sy;
+}
+
+// Ponto da referência -> pixel do frame entregue; false se fora da janela
+inline bool cameraReferenceToOutput(const CameraWindow& w, int refX, int refY, int& outX, int& outY) {
+    float sx, sy;
+    if (w.sensor) {
+        sx = ((refX + 0.5f) * CAMERA_SENSOR_SIZE[w.mode][0] / CAMERA_REFERENCE_WIDTH - w.offsetX) / w.width;
+        sy = ((refY + 0.5f) * CAMERA_SENSOR_SIZE[w.mode][1] / CAMERA_REFERENCE_HEIGHT - w.offsetY) / w.height;
+    } else {
+        sx = (refX + 0.5f) / CAMERA_REFERENCE_WIDTH;
+        sy = (refY + 0.5f) / CAMERA_REFERENCE_HEIGHT;
+    }
+    if (sx < 0.0f || sy < 0.0f || sx >= 1.0f || sy >= 1.0f) {
+        return false;
+    }
+    outX = (int)(sx * w.outputWidth);
+    outY = (int)(sy * w.outputHeight);
+    return true;
+}
+
+// Pixel do frame -> ponto da referência (centro do pixel)
+inline void cameraOutputToReference(const CameraWindow& w, int outX, int outY, int& refX, int& refY) {
+    float sx = (outX + 0.5f) / w.outputWidth;
+    float sy = (outY + 0.5f) / w.outputHeight;
+    if (w.sensor) {
+        refX = (int)((w.offsetX + sx * w.width) * CAMERA_REFERENCE_WIDTH / CAMERA_SENSOR_SIZE[w.mode][0]);
+        refY = (int)((w.offsetY + sy * w.height) * CAMERA_REFERENCE_HEIGHT / CAMERA_SENSOR_SIZE[w.mode][1]);
+    } else {
+        refX = (int)(sx * CAMERA_REFERENCE_WIDTH);
+        refY = (int)(sy * CAMERA_REFERENCE_HEIGHT);
+    }
+}
+
+#endif // CAMERA_WINDOW_H
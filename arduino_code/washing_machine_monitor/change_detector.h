@@ -0,0 +1,167 @@
+#ifndef CHANGE_DETECTOR_H
+#define CHANGE_DETECTOR_H
+
+// Detector de mudança do painel: assinatura de luma em grade reduzida,
+// calculada durante a conversão RGB565 -> tensor. Se a assinatura do frame
+// novo está perto da do último frame classificado, o resultado anterior é
+// reaproveitado e a CNN não roda. Não depende do Arduino (usado no host).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+#ifndef CHANGE_GRID
+#define CHANGE_GRID                 8     // Células por eixo na assinatura
+#endif
+
+#ifndef CHANGE_THRESHOLD
+#define CHANGE_THRESHOLD            12    // Maior diferença de luma aceita por célula (0-255)
+#endif
+
+#ifndef CHANGE_MAX_REUSE
+#define CHANGE_MAX_REUSE            12    // Força inferência após N reaproveitamentos seguidos
+#endif
+
+#define CHANGE_CELLS                (CHANGE_GRID * CHANGE_GRID)
+
+// Região do painel em coordenadas da imagem de entrada do modelo
+struct ChangeRegion {
+    int x, y, width, height;
+};
+
+struct FrameSignature {
+    uint8_t cells[CHANGE_CELLS];
+    bool valid;
+};
+
+// Sink que não grava nada (só assinatura)
+struct NullSink {
+    inline void pixel(uint8_t r, uint8_t g, uint8_t b) {}
+};
+
+// Repassa os pixels para outro sink e acumula a luma por célula da região
+template <typename Inner>
+struct SignatureSink {
+    Inner* inner;
+    ChangeRegion region;
+    int imageWidth;
+    int x, y;
+    uint32_t sums[CHANGE_CELLS];
+    uint32_t counts[CHANGE_CELLS];
+
+    void begin(Inner* target, const ChangeRegion& panel, int width) {
+        inner = target;
+        region = panel;
+        imageWidth = width;
+        x = 0;
+        y = 0;
+        for (int i = 0; i < CHANGE_CELLS; i++) {
+            sums[i] = 0;
+            counts[i] = 0;
+        }
+    }
+
+    inline void pixel(uint8_t r, uint8_t g, uint8_t b) {
+        inner->pixel(r, g, b);
+
+        int rx = x - region.x;
+        int ry = y - region.y;
+        if (rx >= 0 && ry >= 0 && rx < region.width && ry < region.height) {
+            int cell = (ry * CHANGE_GRID / region.height) * CHANGE_GRID + (rx * CHANGE_GRID / region.width);
+            sums[cell] += (r * 19595 + g * 38470 + b * 7471) >> 16;
+            counts[cell]++;
+        }
+
+        if (++x == imageWidth) {
+            x = 0;
+            y++;
+        }
+    }
+
+    void finish(FrameSignature& signature) {
+        for (int i = 0; i < CHANGE_CELLS; i++) {
+            signature.cells[i] = counts[i] ? sums[i] / counts[i] : 0;
+        }
+        signature.valid = true;
+    }
+};
+
+// Maior diferença de luma entre células das duas assinaturas (0-255).
+// Usa o máximo e não a média: um único LED que acende muda só uma célula.
+inline int signatureDistance(const FrameSignature& a, const FrameSignature& b) {
+    int maxDiff = 0;
+    for (int i = 0; i < CHANGE_CELLS; i++) {
+        int d = (int)a.cells[i] - (int)b.cells[i];
+        if (d < 0) d = -d;
+        if (d > maxDiff) maxDiff = d;
+    }
+    return maxDiff;
+}
+
+struct ChangeDetector {
+    FrameSignature reference;       // assinatura do último frame classificado
+    int threshold;
+    int lastDistance;
+    uint32_t consecutiveHits;
+    // Contadores lidos por outras tarefas (/status, relatório do loop()) enquanto
+    // a tarefa de inferência escreve: atômicos, ordem relaxed como em metrics.h
+    std::atomic<uint32_t> hits;     // inferências evitadas
+    std::atomic<uint32_t> misses;   // inferências executadas
+
+    ChangeDetector() = default;
+
+    // Cópia (salvar/restaurar em torno do replay, com o pipeline parado)
+    ChangeDetector(const ChangeDetector& other) {
+        *this = other;
+    }
+
+    ChangeDetector& operator=(const ChangeDetector& other) {
+        reference = other.reference;
+        threshold = other.threshold;
+        lastDistance = other.lastDistance;
+        consecutiveHits = other.consecutiveHits;
+        hits.store(other.hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        misses.store(other.misses.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void reset() {
+        reference.valid = false;
+        threshold = CHANGE_THRESHOLD;
+        lastDistance = -1;
+        consecutiveHits = 0;
+        hits.store(0, std::memory_order_relaxed);
+        misses.store(0, std::memory_order_relaxed);
+    }
+
+    // true = painel igual ao último frame classificado, pode reaproveitar o resultado.
+    // forceRun: a CNN roda de qualquer jeito (conferência dos LEDs); só mede a distância
+    bool shouldReuse(const FrameSignature& current, bool forceRun = false) {
+        bool reuse = false;
+        if (reference.valid && current.valid) {
+            lastDistance = signatureDistance(reference, current);
+            reuse = !forceRun && lastDistance <= threshold && consecutiveHits < CHANGE_MAX_REUSE;
+        }
+
+        if (reuse) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            consecutiveHits++;
+        } else {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            consecutiveHits = 0;
+        }
+        return reuse;
+    }
+
+    // Último shouldReuse() viu o painel diferente da referência
+    bool panelChanged() const {
+        return lastDistance > threshold;
+    }
+
+    // Frame classificado com sucesso: passa a ser a referência
+    void accept(const FrameSignature& current) {
+        reference = current;
+    }
+};
+
+#endif // CHANGE_DETECTOR_H
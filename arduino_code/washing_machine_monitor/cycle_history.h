@@ -0,0 +1,137 @@
+#ifndef CYCLE_HISTORY_H
+#define CYCLE_HISTORY_H
+
+// Histórico persistente das etapas (history_log.h) na partição "history"
+// de partitions.csv. O loop() grava uma amostra por predição; o lote vai
+// para a flash a cada troca de etapa ou HISTORY_FLUSH_INTERVAL. A tarefa
+// web só lê a flash, em pedaços, para responder /history.
+// Apagar um setor trava os dois núcleos por dezenas de ms: por isso o lote.
+
+#include <time.h>
+#include "esp_partition.h"
+#include <andreluiz-project-1_inferencing.h>
+#include "config.h"
+#include "http_server.h"
+#include "history_log.h"
+
+#ifndef HISTORY_PARTITION
+#define HISTORY_PARTITION           "history"
+#endif
+
+#ifndef HISTORY_FLUSH_INTERVAL
+#define HISTORY_FLUSH_INTERVAL      300000  // ms máximos com registros só na RAM
+#endif
+
+#ifndef HISTORY_NTP_SERVER
+#define HISTORY_NTP_SERVER          "pool.ntp.org"
+#endif
+
+#define HISTORY_EPOCH_VALID         1600000000  // Antes disso o relógio não foi acertado
+
+// Partição de dados acessada direto (sem sistema de arquivos)
+struct PartitionStorage {
+    const esp_partition_t* partition = nullptr;
+
+    bool read(size_t offset, void* buf, size_t len) const {
+        return esp_partition_read(partition, offset, buf, len) == ESP_OK;
+    }
+    bool write(size_t offset, const void* buf, size_t len) {
+        return esp_partition_write(partition, offset, buf, len) == ESP_OK;
+    }
+    bool erase(size_t offset) {
+        return esp_partition_erase_range(partition, offset, HISTORY_SECTOR_SIZE) == ESP_OK;
+    }
+    size_t size() const {
+        return partition ? partition->size : 0;
+    }
+};
+
+// =================== VARIÁVEIS GLOBAIS ===================
+PartitionStorage historyStorage;
+HistoryLog<PartitionStorage> historyLog;
+bool historyReady = false;
+unsigned long historyLastFlush = 0;
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool initializeHistory();
+void recordHistorySample(int stage, const float* belief, int stages, bool stageChanged);
+void flushHistory();
+size_t historyProducer(void* state, char* buf, size_t size);
+void printHistoryStatistics();
+
+// =================== IMPLEMENTAÇÃO ===================
+
+bool initializeHistory() {
+    static_assert(EI_CLASSIFIER_LABEL_COUNT <= HISTORY_STAGES, "historico guarda ate HISTORY_STAGES etapas");
+
+    // Relógio para os registros; até sincronizar, eles levam o uptime
+    configTime(0, 0, HISTORY_NTP_SERVER);
+
+    historyStorage.partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                        HISTORY_PARTITION);
+    if (!historyStorage.partition) {
+        Serial.println("AVISO: Particao 'history' nao encontrada (partitions.csv) - historico desativado");
+        return false;
+    }
+
+    unsigned long start = millis();
+    if (!historyLog.begin(&historyStorage)) {
+        Serial.println("ERRO: Particao do historico muito pequena");
+        return false;
+    }
+    historyReady = true;
+    historyLastFlush = millis();
+    Serial.printf("Historico: %lu registros de %lu, montado em %lu ms\n",
+                 (unsigned long)(historyLog.nextSequence - historyLog.oldestSequence()),
+                 (unsigned long)historyLog.capacity, millis() - start);
+    return true;
+}
+
+// Uma amostra por predição (crença do decodificador); na troca de etapa o
+// lote vai para a flash, para a transição sobreviver a um reboot
+void recordHistorySample(int stage, const float* belief, int stages, bool stageChanged) {
+    if (!historyReady) {
+        return;
+    }
+    time_t now = time(nullptr);
+    if (now >= HISTORY_EPOCH_VALID) {
+        historyLog.append((uint32_t)now, (uint8_t)stage, belief, stages);
+    } else {
+        historyLog.append(millis() / 1000, (uint8_t)stage | HISTORY_FLAG_UPTIME, belief, stages);
+    }
+
+    if (stageChanged) {
+        historyLog.flush();
+        historyLastFlush = millis();
+    }
+}
+
+// Chamado pelo loop(): grava o lote pendente a cada HISTORY_FLUSH_INTERVAL
+void flushHistory() {
+    if (!historyReady || millis() - historyLastFlush < HISTORY_FLUSH_INTERVAL) {
+        return;
+    }
+    historyLog.closeRun();
+    historyLog.flush();
+    historyLastFlush = millis();
+}
+
+// Produtor do corpo chunked de /history (tarefa web)
+size_t historyProducer(void* state, char* buf, size_t size) {
+    return historyWriteJson(historyLog, *(HistoryCursor*)state,
+                            ei_classifier_inferencing_categories, EI_CLASSIFIER_LABEL_COUNT, buf, size);
+}
+
+void printHistoryStatistics() {
+    if (!historyReady) {
+        return;
+    }
+    Serial.printf("Historico: %lu amostras -> %lu registros gravados (%lu lotes, %lu setores apagados, %lu erros), "
+                 "%lu na flash\n",
+                 (unsigned long)historyLog.samples, (unsigned long)historyLog.recordsWritten,
+                 (unsigned long)historyLog.flushes, (unsigned long)historyLog.sectorErases,
+                 (unsigned long)historyLog.writeErrors,
+                 (unsigned long)(historyLog.nextSequence - historyLog.oldestSequence()));
+}
+
+#endif // CYCLE_HISTORY_H
@@ -0,0 +1,151 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+// Formato de gravação de frames crus da câmera (.wmfc), gerado pelo /record
+// (frame_recorder.h) e lido pelo replay (frame_replay.h, host/replay_capture).
+// Little-endian, como o ESP32 e o host:
+//   CaptureHeader                   20 bytes (headerSize permite crescer)
+//   repetido até o fim do arquivo:
+//     CaptureFrameHeader            16 bytes
+//     frame                         frameBytes bytes (RGB565 como o driver
+//                                   entrega, ou 1 byte de luma por pixel)
+// A sequência é a do gravador: um salto indica frames perdidos no caminho.
+// Não depende do Arduino (usado no host).
+//
+//   CaptureReader reader;
+//   if (reader.begin(captureReadFile, f)) {
+//       CaptureFrameHeader frame;
+//       while (reader.next(frame, buf)) { ... }
+//   }
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CAPTURE_MAGIC           0x43464D57u     // "WMFC"
+#define CAPTURE_FRAME_MAGIC     0x4D524657u     // "WFRM"
+#define CAPTURE_VERSION         1
+
+#define CAPTURE_PIXEL_RGB565    0
+#define CAPTURE_PIXEL_GRAY8     1
+
+struct CaptureHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;            // bytes do cabeçalho no arquivo
+    uint16_t width;
+    uint16_t height;
+    uint8_t pixelFormat;            // CAPTURE_PIXEL_*
+    uint8_t reserved[3];
+    uint32_t frameBytes;            // tamanho de cada frame
+};
+
+struct CaptureFrameHeader {
+    uint32_t magic;
+    uint32_t sequence;              // número do frame no gravador
+    uint32_t timestampMs;           // millis() da captura no dispositivo
+    uint32_t length;                // igual a frameBytes
+};
+
+static_assert(sizeof(CaptureHeader) == 20, "cabecalho da captura tem 20 bytes");
+static_assert(sizeof(CaptureFrameHeader) == 16, "cabecalho do frame tem 16 bytes");
+
+inline uint32_t captureFrameBytes(int width, int height, int pixelFormat) {
+    return (uint32_t)width * height * (pixelFormat == CAPTURE_PIXEL_GRAY8 ? 1 : 2);
+}
+
+inline void captureHeaderInit(CaptureHeader& header, int width, int height, int pixelFormat) {
+    memset(&header, 0, sizeof(header));
+    header.magic = CAPTURE_MAGIC;
+    header.version = CAPTURE_VERSION;
+    header.headerSize = sizeof(CaptureHeader);
+    header.width = width;
+    header.height = height;
+    header.pixelFormat = pixelFormat;
+    header.frameBytes = captureFrameBytes(width, height, pixelFormat);
+}
+
+inline void captureFrameHeaderInit(CaptureFrameHeader& frame, uint32_t sequence, uint32_t timestampMs,
+                                   uint32_t length) {
+    frame.magic = CAPTURE_FRAME_MAGIC;
+    frame.sequence = sequence;
+    frame.timestampMs = timestampMs;
+    frame.length = length;
+}
+
+// Lê até len bytes; menos que len só no fim dos dados (ou erro)
+typedef size_t (*CaptureRead)(void* ctx, uint8_t* buf, size_t len);
+
+inline size_t captureReadFile(void* ctx, uint8_t* buf, size_t len) {
+    return fread(buf, 1, len, (FILE*)ctx);
+}
+
+struct CaptureReader {
+    CaptureRead read = nullptr;
+    void* ctx = nullptr;
+    CaptureHeader header;
+    uint32_t frames = 0;
+    const char* error = nullptr;    // nullptr = fim normal
+
+    // Lê e valida o cabeçalho
+    bool begin(CaptureRead reader, void* readerCtx) {
+        read = reader;
+        ctx = readerCtx;
+        frames = 0;
+        error = nullptr;
+        if (!readFully(&header, sizeof(header))) {
+            return fail("cabecalho incompleto");
+        }
+        if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION ||
+            header.headerSize < sizeof(header)) {
+            return fail("nao e uma captura .wmfc v1");
+        }
+        if (header.pixelFormat > CAPTURE_PIXEL_GRAY8 || header.width == 0 || header.height == 0 ||
+            header.frameBytes != captureFrameBytes(header.width, header.height, header.pixelFormat)) {
+            return fail("formato de frame invalido");
+        }
+        // Campos de versões futuras do cabeçalho
+        for (size_t skip = header.headerSize - sizeof(header); skip > 0; skip--) {
+            uint8_t byte;
+            if (!readFully(&byte, 1)) {
+                return fail("cabecalho incompleto");
+            }
+        }
+        return true;
+    }
+
+    // Próximo frame em buf (header.frameBytes bytes). false no fim dos dados
+    // (error == nullptr) ou em dados corrompidos/truncados
+    bool next(CaptureFrameHeader& frame, uint8_t* buf) {
+        if (error) {
+            return false;
+        }
+        size_t n = read(ctx, (uint8_t*)&frame, sizeof(frame));
+        if (n == 0) {
+            return false;
+        }
+        if (n != sizeof(frame) || frame.magic != CAPTURE_FRAME_MAGIC) {
+            return fail("cabecalho de frame invalido");
+        }
+        if (frame.length != header.frameBytes) {
+            return fail("frame com tamanho inesperado");
+        }
+        if (!readFully(buf, frame.length)) {
+            return fail("frame truncado");
+        }
+        frames++;
+        return true;
+    }
+
+    bool readFully(void* dst, size_t len) {
+        return read(ctx, (uint8_t*)dst, len) == len;
+    }
+
+    bool fail(const char* message) {
+        error = message;
+        return false;
+    }
+};
+
+#endif // FRAME_CAPTURE_H
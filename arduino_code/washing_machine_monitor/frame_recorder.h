@@ -0,0 +1,108 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+// Gravação (/record) dos frames crus que a inferência recebe, no formato de
+// frame_capture.h, para repetir no replay (frame_replay.h, host/replay_capture):
+//   captura (ML): copia cabeçalho + frame para a PSRAM se há cliente e a
+//                 tarefa web já pegou o anterior
+//   servidor web: envia o mesmo buffer aos clientes de /record
+// Como o /stream, nunca pede captura extra e nunca faz a captura esperar pela
+// rede: frames sem vez contam em recordFramesDropped e aparecem como saltos
+// na sequência gravada.
+//
+//   curl http://<ip>/record -o lavagem.wmfc
+
+#include <atomic>
+#include "esp_camera.h"
+#include "config.h"
+#include "http_server.h"
+#include "frame_capture.h"
+
+#ifndef RECORD_INTERVAL
+#define RECORD_INTERVAL             0       // ms mínimos entre frames gravados (0 = todos)
+#endif
+
+#ifndef RECORD_MAX_CLIENTS
+#define RECORD_MAX_CLIENTS          1
+#endif
+
+// =================== VARIÁVEIS GLOBAIS ===================
+std::atomic<HttpSharedBody*> recordPending{nullptr};  // frame pronto para a tarefa web
+volatile int recordClients = 0;                 // atualizado pela tarefa web
+unsigned long recordLastOffer = 0;
+uint32_t recordSequence = 0;
+
+// Estatísticas
+volatile uint32_t recordFramesQueued = 0;
+volatile uint32_t recordFramesDropped = 0;      // anterior ainda na fila, sem memória ou tamanho diferente
+
+// =================== FUNÇÕES PÚBLICAS ===================
+void recordCaptureHeader(CaptureHeader& header);
+void offerRecordFrame(const camera_fb_t* fb);
+HttpSharedBody* takeRecordFrame();
+void printRecordStatistics();
+
+// =================== IMPLEMENTAÇÃO ===================
+
+// Cabeçalho do arquivo para o formato que a câmera foi configurada a entregar
+void recordCaptureHeader(CaptureHeader& header) {
+    int width = CAMERA_ROI_CAPTURE ? EI_CLASSIFIER_INPUT_WIDTH : CAMERA_FRAME_WIDTH;
+    int height = CAMERA_ROI_CAPTURE ? EI_CLASSIFIER_INPUT_HEIGHT : CAMERA_FRAME_HEIGHT;
+    captureHeaderInit(header, width, height, CAMERA_GRAYSCALE ? CAPTURE_PIXEL_GRAY8 : CAPTURE_PIXEL_RGB565);
+}
+
+// Chamado no caminho de captura da inferência, antes de devolver o frame.
+// Sem cliente: uma comparação; gravando: um malloc na PSRAM e um memcpy
+void offerRecordFrame(const camera_fb_t* fb) {
+    if (recordClients == 0 || !fb) {
+        return;
+    }
+    uint32_t sequence = ++recordSequence;
+    unsigned long now = millis();
+    if (RECORD_INTERVAL > 0 && now - recordLastOffer < RECORD_INTERVAL) {
+        return;
+    }
+    if (recordPending.load() != nullptr) {
+        recordFramesDropped++;
+        return;
+    }
+
+    CaptureHeader header;
+    recordCaptureHeader(header);
+    if (fb->len != header.frameBytes) {
+        recordFramesDropped++;
+        return;
+    }
+    size_t length = sizeof(CaptureFrameHeader) + fb->len;
+    uint8_t* data = (uint8_t*)(psramFound() ? ps_malloc(length) : malloc(length));
+    if (!data) {
+        recordFramesDropped++;
+        return;
+    }
+    CaptureFrameHeader frameHeader;
+    captureFrameHeaderInit(frameHeader, sequence, (uint32_t)now, fb->len);
+    memcpy(data, &frameHeader, sizeof(frameHeader));
+    memcpy(data + sizeof(frameHeader), fb->buf, fb->len);
+    recordLastOffer = now;
+
+    HttpSharedBody* frame = httpSharedBodyCreate(data, length);
+    HttpSharedBody* expected = nullptr;
+    if (!frame || !recordPending.compare_exchange_strong(expected, frame)) {
+        httpSharedBodyRelease(frame);
+        recordFramesDropped++;
+        return;
+    }
+    recordFramesQueued++;
+}
+
+// Tarefa web: frame novo, ou nullptr. A referência passa para quem chamou
+HttpSharedBody* takeRecordFrame() {
+    return recordPending.exchange(nullptr);
+}
+
+void printRecordStatistics() {
+    Serial.printf("Gravacao /record: %d clientes, %lu frames na fila, %lu perdidos\n",
+                 recordClients, (unsigned long)recordFramesQueued, (unsigned long)recordFramesDropped);
+}
+
+#endif // FRAME_RECORDER_H
@@ -0,0 +1,395 @@
+#ifndef FRAME_REPLAY_H
+#define FRAME_REPLAY_H
+
+// Replay de uma gravação (.wmfc, frame_capture.h) pelo caminho ML real, o
+// mais rápido possível, para medir a vazão máxima e a latência de cada etapa
+// com frames reproduzíveis:
+//   - a câmera é trocada por uma fonte de frames (setCameraFrameFeed) e o
+//     loop chama performMLPrediction() de novo assim que a anterior termina
+//   - o pipeline é parado antes e reiniciado depois
+//   - o decodificador anda no relógio da gravação (mlReplayActive): o
+//     resultado não vai para histórico, Sinric nem dashboard, e o estado do
+//     caminho ML é restaurado no fim
+// No dispositivo a gravação vem por HTTP (o servidor não recebe corpos):
+//   python3 -m http.server 8000          (na pasta da gravação)
+//   curl "http://<ip>/replay?url=http://<pc>:8000/lavagem.wmfc"
+//   curl http://<ip>/replay              (estatísticas do último replay)
+// O loop() fica parado durante o replay. No host: host/replay_capture.cpp.
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "config.h"
+#include "frame_capture.h"
+#include "camera_manager.h"
+#include "system_metrics.h"
+#include "json_writer.h"
+
+#ifndef REPLAY_URL_SIZE
+#define REPLAY_URL_SIZE             160
+#endif
+
+#ifndef REPLAY_SOCKET_TIMEOUT
+#define REPLAY_SOCKET_TIMEOUT       10000   // ms sem dados do servidor da gravação
+#endif
+
+struct ReplayStats {
+    bool running;
+    uint32_t frames;
+    uint32_t inferences;            // interpreter->Invoke() executados
+    uint32_t skipped;               // LEDs ou painel sem mudança
+    uint32_t errors;
+    uint32_t stageChanges;
+    int stage;                      // etapa decodificada no fim
+    uint32_t elapsedUs;
+    uint32_t recordedMs;            // do primeiro ao último frame, no relógio do gravador
+    uint32_t sourceUs;              // leitura dos frames (arquivo ou rede), total
+    uint32_t stageMeanUs[METRICS_STAGE_COUNT];
+    char error[48];
+};
+
+// Frame corrente da gravação, entregue a captureImage() uma vez
+struct ReplaySource {
+    CaptureReader reader;
+    camera_fb_t fb;
+    bool handedOut;
+    uint32_t firstMs;
+    uint32_t lastMs;
+};
+
+// =================== VARIÁVEIS GLOBAIS ===================
+ReplayStats replayStats = {};
+SemaphoreHandle_t replayStatsLock = NULL;
+volatile bool replayRequested = false;
+char replayUrl[REPLAY_URL_SIZE];
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool initializeFrameReplay();
+bool runFrameReplay(CaptureRead read, void* ctx, ReplayStats& stats);
+bool requestFrameReplay(const char* url);
+void runRequestedFrameReplay();
+void writeFrameReplayJSON(JsonWriter& json);
+int replayOpenUrl(const char* url, char* error, size_t errorSize);
+size_t replaySocketRead(void* ctx, uint8_t* buf, size_t len);
+
+// =================== IMPLEMENTAÇÃO ===================
+
+bool initializeFrameReplay() {
+    if (!replayStatsLock) {
+        replayStatsLock = xSemaphoreCreateMutex();
+    }
+    replayStats.stage = -1;
+    return replayStatsLock != NULL;
+}
+
+camera_fb_t* replayFeedGet(void* ctx) {
+    ReplaySource* source = (ReplaySource*)ctx;
+    if (source->handedOut) {
+        return nullptr;
+    }
+    source->handedOut = true;
+    return &source->fb;
+}
+
+void replayFeedRelease(void* ctx, camera_fb_t* fb) {
+}
+
+// Lê o próximo frame para o buffer da fonte e acerta o relógio do decodificador
+bool replayNextFrame(ReplaySource& source) {
+    CaptureFrameHeader frame;
+    if (!source.reader.next(frame, source.fb.buf)) {
+        return false;
+    }
+    if (source.reader.frames == 1) {
+        source.firstMs = frame.timestampMs;
+    }
+    source.lastMs = frame.timestampMs;
+    source.handedOut = false;
+    mlReplayClockMs = frame.timestampMs - source.firstMs;
+    return true;
+}
+
+// Roda a gravação inteira pelo performMLPrediction(). Chamar do loop() (ou da
+// tarefa que faria as predições), nunca junto com outra captura
+bool runFrameReplay(CaptureRead read, void* ctx, ReplayStats& stats) {
+    memset(&stats, 0, sizeof(stats));
+    stats.stage = -1;
+
+    ReplaySource source = {};
+    if (!source.reader.begin(read, ctx)) {
+        snprintf(stats.error, sizeof(stats.error), "%s", source.reader.error);
+        return false;
+    }
+    const CaptureHeader& header = source.reader.header;
+    source.fb.buf = (uint8_t*)(psramFound() ? ps_malloc(header.frameBytes) : malloc(header.frameBytes));
+    if (!source.fb.buf) {
+        snprintf(stats.error, sizeof(stats.error), "sem memoria para o frame (%lu bytes)",
+                 (unsigned long)header.frameBytes);
+        return false;
+    }
+    source.fb.len = header.frameBytes;
+    source.fb.width = header.width;
+    source.fb.height = header.height;
+    source.fb.format = header.pixelFormat == CAPTURE_PIXEL_GRAY8 ? PIXFORMAT_GRAYSCALE : PIXFORMAT_RGB565;
+    source.handedOut = true;
+
+    bool pipeline = isMLPipelineRunning();
+    if (pipeline) {
+        stopMLPipeline();
+    }
+
+    // Estado do caminho ML ao vivo, restaurado no fim; o replay parte do zero
+    StageDecoder savedDecoder = stageDecoder;
+    unsigned long savedDecoderUpdate = lastDecoderUpdate;
+    ChangeDetector savedDetector = changeDetector;
+    ei_impulse_result_t savedResult = lastMLResult;
+    bool savedResultValid = lastMLResultValid;
+    stageDecoder.begin(&stageDecoderConfig, STAGE_OFF);
+    lastDecoderUpdate = 0;
+    changeDetector.reset();
+    lastMLResultValid = false;
+
+    HistogramSnapshot before[METRICS_STAGE_COUNT];
+    for (int i = 0; i < METRICS_STAGE_COUNT; i++) {
+        metricsStages[i].snapshot(before[i]);
+    }
+    uint32_t skippedBefore = metricsSkipped[METRICS_SKIP_LEDS] + metricsSkipped[METRICS_SKIP_UNCHANGED];
+    uint32_t errorsBefore = metricsErrors[METRICS_ERROR_CAPTURE] + metricsErrors[METRICS_ERROR_CONVERT] +
+                            metricsErrors[METRICS_ERROR_INFERENCE];
+
+    mlReplayActive = true;
+    CameraFrameFeed feed = { replayFeedGet, replayFeedRelease, &source };
+    setCameraFrameFeed(&feed);
+    powerBeginWork();
+
+    unsigned long start = micros();
+    while (true) {
+        unsigned long readStart = micros();
+        bool more = replayNextFrame(source);
+        stats.sourceUs += micros() - readStart;
+        if (!more) {
+            break;
+        }
+        int label = stageDecoder.label;
+        performMLPrediction();
+        if (stageDecoder.label != label) {
+            stats.stageChanges++;
+        }
+    }
+    stats.elapsedUs = micros() - start;
+
+    powerEndWork(true);
+    setCameraFrameFeed(nullptr);
+    mlReplayActive = false;
+
+    stats.frames = source.reader.frames;
+    stats.stage = stageDecoder.label;
+    stats.recordedMs = source.lastMs - source.firstMs;
+    stats.skipped = metricsSkipped[METRICS_SKIP_LEDS] + metricsSkipped[METRICS_SKIP_UNCHANGED] - skippedBefore;
+    stats.errors = metricsErrors[METRICS_ERROR_CAPTURE] + metricsErrors[METRICS_ERROR_CONVERT] +
+                   metricsErrors[METRICS_ERROR_INFERENCE] - errorsBefore;
+    for (int i = 0; i < METRICS_STAGE_COUNT; i++) {
+        HistogramSnapshot after;
+        metricsStages[i].snapshot(after);
+        uint32_t count = after.count - before[i].count;
+        stats.stageMeanUs[i] = count ? (uint32_t)((after.sumUs - before[i].sumUs) / count) : 0;
+        if (i == METRICS_INVOKE) {
+            stats.inferences = count;
+        }
+    }
+    if (source.reader.error) {
+        snprintf(stats.error, sizeof(stats.error), "%s", source.reader.error);
+    }
+
+    stageDecoder = savedDecoder;
+    lastDecoderUpdate = savedDecoderUpdate;
+    changeDetector = savedDetector;
+    lastMLResult = savedResult;
+    lastMLResultValid = savedResultValid;
+    free(source.fb.buf);
+    if (pipeline) {
+        startMLPipeline();
+    }
+    return source.reader.error == nullptr;
+}
+
+// Tarefa web: agenda o replay para o loop(). false se já há um pedido ou replay
+bool requestFrameReplay(const char* url) {
+    if (replayRequested || replayStats.running || strlen(url) >= sizeof(replayUrl)) {
+        return false;
+    }
+    strcpy(replayUrl, url);
+    replayRequested = true;
+    return true;
+}
+
+// Chamado pelo loop(): baixa e roda a gravação pedida pela web
+void runRequestedFrameReplay() {
+    if (!replayRequested || !replayStatsLock) {
+        return;
+    }
+    ReplayStats stats = {};
+    stats.running = true;
+    stats.stage = -1;
+    xSemaphoreTake(replayStatsLock, portMAX_DELAY);
+    replayStats = stats;
+    xSemaphoreGive(replayStatsLock);
+
+    Serial.printf("Replay: %s\n", replayUrl);
+    int fd = replayOpenUrl(replayUrl, stats.error, sizeof(stats.error));
+    if (fd >= 0) {
+        runFrameReplay(replaySocketRead, &fd, stats);
+        close(fd);
+    }
+    stats.running = false;
+    replayRequested = false;
+
+    if (stats.error[0]) {
+        Serial.printf("ERRO: Replay interrompido: %s\n", stats.error);
+    }
+    Serial.printf("Replay: %lu frames em %lu ms (%.1f fps), %lu inferencias, %lu pulados, %lu erros\n",
+                 (unsigned long)stats.frames, (unsigned long)(stats.elapsedUs / 1000),
+                 stats.elapsedUs ? stats.frames * 1e6 / stats.elapsedUs : 0.0,
+                 (unsigned long)stats.inferences, (unsigned long)stats.skipped, (unsigned long)stats.errors);
+
+    xSemaphoreTake(replayStatsLock, portMAX_DELAY);
+    replayStats = stats;
+    xSemaphoreGive(replayStatsLock);
+}
+
+void writeFrameReplayJSON(JsonWriter& json) {
+    ReplayStats stats;
+    xSemaphoreTake(replayStatsLock, portMAX_DELAY);
+    stats = replayStats;
+    xSemaphoreGive(replayStatsLock);
+
+    json.beginObject()
+        .field("running", stats.running || replayRequested)
+        .field("frames", stats.frames)
+        .field("inferences", stats.inferences)
+        .field("skipped", stats.skipped)
+        .field("errors", stats.errors)
+        .field("stage_changes", stats.stageChanges)
+        .field("stage", stats.stage >= 0 ? washStageLabel(stats.stage) : "")
+        .field("elapsed_ms", stats.elapsedUs / 1000)
+        .field("recorded_ms", stats.recordedMs)
+        .field("fps", stats.elapsedUs ? stats.frames * 1e6 / stats.elapsedUs : 0.0, 1)
+        .field("source_us", stats.frames ? stats.sourceUs / stats.frames : 0);
+    json.key("stage_us").beginObject();
+    static const char* const names[METRICS_STAGE_COUNT] = { "capture", "resize", "dsp", "invoke", "postprocess" };
+    for (int i = 0; i < METRICS_STAGE_COUNT; i++) {
+        json.field(names[i], stats.stageMeanUs[i]);
+    }
+    json.endObject();
+    if (stats.error[0]) {
+        json.field("error", stats.error);
+    }
+    json.endObject();
+}
+
+// GET http://host[:porta]/caminho. Devolve o socket posicionado no corpo, ou -1
+int replayOpenUrl(const char* url, char* error, size_t errorSize) {
+    if (strncmp(url, "http://", 7) != 0) {
+        snprintf(error, errorSize, "url precisa comecar com http://");
+        return -1;
+    }
+    const char* hostStart = url + 7;
+    const char* pathStart = strchr(hostStart, '/');
+    if (!pathStart) pathStart = hostStart + strlen(hostStart);
+    char host[64];
+    char port[8] = "80";
+    size_t hostLen = pathStart - hostStart;
+    const char* colon = (const char*)memchr(hostStart, ':', hostLen);
+    if (colon) {
+        size_t portLen = pathStart - colon - 1;
+        if (portLen == 0 || portLen >= sizeof(port)) {
+            snprintf(error, errorSize, "porta invalida");
+            return -1;
+        }
+        memcpy(port, colon + 1, portLen);
+        port[portLen] = '\0';
+        hostLen = colon - hostStart;
+    }
+    if (hostLen == 0 || hostLen >= sizeof(host)) {
+        snprintf(error, errorSize, "host invalido");
+        return -1;
+    }
+    memcpy(host, hostStart, hostLen);
+    host[hostLen] = '\0';
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addr = nullptr;
+    if (getaddrinfo(host, port, &hints, &addr) != 0 || !addr) {
+        snprintf(error, errorSize, "host nao encontrado: %s", host);
+        return -1;
+    }
+    int fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    if (fd < 0 || connect(fd, addr->ai_addr, addr->ai_addrlen) != 0) {
+        freeaddrinfo(addr);
+        if (fd >= 0) close(fd);
+        snprintf(error, errorSize, "falha ao conectar em %s:%s", host, port);
+        return -1;
+    }
+    freeaddrinfo(addr);
+
+    struct timeval timeout;
+    timeout.tv_sec = REPLAY_SOCKET_TIMEOUT / 1000;
+    timeout.tv_usec = (REPLAY_SOCKET_TIMEOUT % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    char request[REPLAY_URL_SIZE + 96];
+    int n = snprintf(request, sizeof(request), "GET %s HTTP/1.0\r\nHost: %s\r\nConnection: close\r\n\r\n",
+                     *pathStart ? pathStart : "/", host);
+    if (send(fd, request, n, 0) != n) {
+        close(fd);
+        snprintf(error, errorSize, "falha ao enviar pedido");
+        return -1;
+    }
+
+    // Cabeçalhos da resposta, byte a byte até a linha em branco
+    char status[48] = "";
+    size_t statusLen = 0;
+    uint32_t tail = 0;
+    bool statusDone = false;
+    while (tail != 0x0D0A0D0A) {
+        char c;
+        if (recv(fd, &c, 1, 0) != 1) {
+            close(fd);
+            snprintf(error, errorSize, "resposta HTTP incompleta");
+            return -1;
+        }
+        tail = (tail << 8) | (uint8_t)c;
+        if (!statusDone) {
+            if (c == '\r' || c == '\n' || statusLen + 1 >= sizeof(status)) {
+                statusDone = true;
+            } else {
+                status[statusLen++] = c;
+                status[statusLen] = '\0';
+            }
+        }
+    }
+    if (!strstr(status, " 200")) {
+        close(fd);
+        snprintf(error, errorSize, "servidor respondeu: %.24s", status);
+        return -1;
+    }
+    return fd;
+}
+
+size_t replaySocketRead(void* ctx, uint8_t* buf, size_t len) {
+    int fd = *(int*)ctx;
+    size_t total = 0;
+    while (total < len) {
+        int n = recv(fd, buf + total, len - total, 0);
+        if (n <= 0) {
+            break;
+        }
+        total += n;
+    }
+    return total;
+}
+
+#endif // FRAME_REPLAY_H
@@ -0,0 +1,86 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+// Fila circular sem locks para um produtor e um consumidor (SPSC).
+// O produtor escreve direto no slot devolvido por beginWrite() e publica com
+// commitWrite(); o consumidor lê com beginRead() e libera com endRead().
+// Não depende do Arduino nem do FreeRTOS para poder ser usada no host com std::thread.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+template <typename T, size_t N>
+struct FrameRing {
+    T* slots = nullptr;                 // N slots (memória do chamador, ex.: PSRAM)
+    std::atomic<uint32_t> head{0};      // escrito só pelo produtor
+    std::atomic<uint32_t> tail{0};      // escrito só pelo consumidor
+
+    // Estatísticas (cada contador tem um único escritor)
+    std::atomic<uint32_t> produced{0};
+    std::atomic<uint32_t> consumed{0};
+    std::atomic<uint32_t> dropped{0};
+    std::atomic<uint32_t> maxDepth{0};
+
+    void attach(T* storage) {
+        slots = storage;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        produced.store(0, std::memory_order_relaxed);
+        consumed.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        maxDepth.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const {
+        return N;
+    }
+
+    size_t depth() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    // =================== PRODUTOR ===================
+
+    // Slot livre para escrita, ou nullptr se a fila estiver cheia (conta descarte)
+    T* beginWrite() {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= N) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots[h % N];
+    }
+
+    // Publica o slot devolvido por beginWrite()
+    void commitWrite() {
+        uint32_t h = head.load(std::memory_order_relaxed) + 1;
+        head.store(h, std::memory_order_release);
+        produced.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t d = h - tail.load(std::memory_order_acquire);
+        if (d > maxDepth.load(std::memory_order_relaxed)) {
+            maxDepth.store(d, std::memory_order_relaxed);
+        }
+    }
+
+    // =================== CONSUMIDOR ===================
+
+    // Slot mais antigo pronto para leitura, ou nullptr se vazia
+    T* beginRead() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) {
+            return nullptr;
+        }
+        return &slots[t % N];
+    }
+
+    // Devolve o slot lido ao produtor
+    void endRead() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        consumed.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+#endif // FRAME_RING_H
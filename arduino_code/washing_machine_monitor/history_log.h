@@ -0,0 +1,353 @@
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+// Histórico das etapas em anel de registros fixos de 16 bytes numa região de
+// flash NOR (partição própria no ESP32, RAM no host). Cada registro é uma
+// sequência de amostras iguais (mesma etapa e crença quantizada em 4 bits a
+// até HISTORY_RUN_TOLERANCE níveis da primeira): guarda a crença e o instante
+// da primeira, o delta até a última e a contagem.
+// Registros fechados vão para um lote em RAM e são gravados juntos.
+//
+// O registro de número de sequência N fica sempre no slot N % capacidade,
+// então a leitura não precisa de índice: lê o slot e confere o número (um
+// setor já sobrescrito ou apagado simplesmente não confere). Ao montar,
+// basta o primeiro registro de cada setor para achar o mais novo.
+// Não depende do Arduino (usado no host).
+//
+// Storage: read(offset, buf, len), write(offset, buf, len), erase(offset)
+// (setor de HISTORY_SECTOR_SIZE) e size(), todos com bool de sucesso.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "json_writer.h"
+
+#ifndef HISTORY_SECTOR_SIZE
+#define HISTORY_SECTOR_SIZE         4096
+#endif
+
+#ifndef HISTORY_BATCH
+#define HISTORY_BATCH               16      // Registros em RAM antes de gravar (256 bytes)
+#endif
+
+#ifndef HISTORY_RUN_TOLERANCE
+#define HISTORY_RUN_TOLERANCE       1       // Níveis de crença (de 15) que ainda contam como "igual"
+#endif
+
+#define HISTORY_STAGES              6       // Crenças por registro (4 bits cada)
+#define HISTORY_FLAG_UPTIME         0x80    // time é uptime: relógio ainda sem NTP
+#define HISTORY_RECORDS_PER_SECTOR  (HISTORY_SECTOR_SIZE / sizeof(HistoryRecord))
+#define HISTORY_ERASED              0xFFFFFFFFu
+
+struct HistoryRecord {
+    uint32_t sequence;              // slot = sequence % capacidade
+    uint32_t time;                  // s: primeira amostra (epoch UTC, ou uptime)
+    uint16_t span;                  // s: da primeira à última amostra
+    uint8_t count;                  // amostras na sequência
+    uint8_t stage;                  // etapa decodificada | HISTORY_FLAG_UPTIME
+    uint8_t confidence[HISTORY_STAGES / 2];
+    uint8_t crc;                    // CRC-8 dos 15 bytes anteriores (gravação interrompida)
+};
+
+static_assert(sizeof(HistoryRecord) == 16, "registro do historico deve ter 16 bytes");
+
+inline uint8_t historyCrc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = crc & 0x80 ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+inline bool historyRecordValid(const HistoryRecord& r) {
+    return r.sequence != HISTORY_ERASED &&
+           r.crc == historyCrc8((const uint8_t*)&r, sizeof(r) - 1);
+}
+
+// Crença 0-1 -> 4 bits, duas etapas por byte
+inline void historyPackConfidence(const float* belief, int stages, uint8_t* packed) {
+    memset(packed, 0, HISTORY_STAGES / 2);
+    for (int i = 0; i < stages && i < HISTORY_STAGES; i++) {
+        float p = belief[i] < 0.0f ? 0.0f : (belief[i] > 1.0f ? 1.0f : belief[i]);
+        uint8_t q = (uint8_t)(p * 15.0f + 0.5f);
+        packed[i / 2] |= i % 2 ? q << 4 : q;
+    }
+}
+
+// Todas as crenças a até "tolerance" níveis das do registro
+inline bool historyConfidenceClose(const uint8_t* a, const uint8_t* b, int tolerance) {
+    for (int i = 0; i < HISTORY_STAGES / 2; i++) {
+        int lo = (a[i] & 0x0F) - (b[i] & 0x0F), hi = (a[i] >> 4) - (b[i] >> 4);
+        if (lo > tolerance || lo < -tolerance || hi > tolerance || hi < -tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline float historyConfidence(const HistoryRecord& r, int stage) {
+    uint8_t byte = r.confidence[stage / 2];
+    return (stage % 2 ? byte >> 4 : byte & 0x0F) / 15.0f;
+}
+
+template <typename Storage>
+struct HistoryLog {
+    Storage* storage = nullptr;
+    uint32_t capacity = 0;                      // registros
+    std::atomic<uint32_t> nextSequence{0};      // primeiro número ainda não gravado
+
+    HistoryRecord open;                         // sequência em andamento (RAM)
+    bool openValid = false;
+    HistoryRecord batch[HISTORY_BATCH];
+    int batchCount = 0;
+
+    // Estatísticas
+    uint32_t samples = 0;
+    uint32_t recordsWritten = 0;
+    uint32_t flushes = 0;
+    uint32_t sectorErases = 0;
+    uint32_t writeErrors = 0;
+
+    // Monta o anel: acha o setor com o registro mais novo e o fim dele
+    bool begin(Storage* s) {
+        storage = s;
+        capacity = (uint32_t)(s->size() / HISTORY_SECTOR_SIZE) * HISTORY_RECORDS_PER_SECTOR;
+        openValid = false;
+        batchCount = 0;
+        if (capacity == 0) {
+            return false;
+        }
+
+        uint32_t sectors = capacity / HISTORY_RECORDS_PER_SECTOR;
+        bool found = false;
+        uint32_t newest = 0;
+        for (uint32_t sector = 0; sector < sectors; sector++) {
+            HistoryRecord r;
+            if (readSlot(sector * HISTORY_RECORDS_PER_SECTOR, r) && historyRecordValid(r) &&
+                r.sequence % capacity == sector * HISTORY_RECORDS_PER_SECTOR &&
+                (!found || r.sequence > newest)) {
+                newest = r.sequence;
+                found = true;
+            }
+        }
+        if (!found) {
+            nextSequence = 0;
+            return true;
+        }
+
+        // Avança até o primeiro slot que não continua a sequência
+        uint32_t next = newest + 1;
+        while (next % HISTORY_RECORDS_PER_SECTOR != 0) {
+            HistoryRecord r;
+            if (!readSlot(next % capacity, r) || !historyRecordValid(r) || r.sequence != next) {
+                break;
+            }
+            next++;
+        }
+        // Slot com lixo (gravação interrompida) não pode ser regravado sem
+        // apagar: pula para o início do próximo setor
+        while (next % HISTORY_RECORDS_PER_SECTOR != 0 && !slotErased(next % capacity)) {
+            next++;
+        }
+        nextSequence = next;
+        return true;
+    }
+
+    // Uma amostra do decodificador; iguais à primeira da sequência (mesma etapa,
+    // crenças a até HISTORY_RUN_TOLERANCE níveis) só a estendem
+    void append(uint32_t time, uint8_t stage, const float* belief, int stages) {
+        uint8_t packed[HISTORY_STAGES / 2];
+        historyPackConfidence(belief, stages, packed);
+        samples++;
+
+        if (openValid && open.stage == stage && historyConfidenceClose(open.confidence, packed, HISTORY_RUN_TOLERANCE) &&
+            open.count < 255 && time >= open.time && time - open.time <= 0xFFFF) {
+            open.count++;
+            open.span = (uint16_t)(time - open.time);
+            return;
+        }
+
+        closeRun();
+        memset(&open, 0, sizeof(open));
+        open.time = time;
+        open.count = 1;
+        open.stage = stage;
+        memcpy(open.confidence, packed, sizeof(packed));
+        openValid = true;
+    }
+
+    // Fecha a sequência em andamento (ex.: troca de etapa); grava se o lote encheu
+    void closeRun() {
+        if (!openValid) {
+            return;
+        }
+        batch[batchCount++] = open;
+        openValid = false;
+        if (batchCount == HISTORY_BATCH) {
+            flush();
+        }
+    }
+
+    // Grava o lote: um write por trecho contíguo, apagando cada setor ao entrar nele
+    bool flush() {
+        if (batchCount == 0 || capacity == 0) {
+            return true;
+        }
+        uint32_t sequence = nextSequence;
+        for (int i = 0; i < batchCount; i++) {
+            batch[i].sequence = sequence + i;
+            batch[i].crc = historyCrc8((const uint8_t*)&batch[i], sizeof(HistoryRecord) - 1);
+        }
+
+        bool ok = true;
+        int i = 0;
+        while (i < batchCount) {
+            uint32_t slot = (sequence + i) % capacity;
+            uint32_t inSector = slot % HISTORY_RECORDS_PER_SECTOR;
+            if (inSector == 0) {
+                if (!storage->erase(slot * sizeof(HistoryRecord))) {
+                    ok = false;
+                    break;
+                }
+                sectorErases++;
+            }
+            int n = batchCount - i;
+            if ((uint32_t)n > HISTORY_RECORDS_PER_SECTOR - inSector) {
+                n = HISTORY_RECORDS_PER_SECTOR - inSector;
+            }
+            if (!storage->write(slot * sizeof(HistoryRecord), &batch[i], n * sizeof(HistoryRecord))) {
+                ok = false;
+                break;
+            }
+            i += n;
+        }
+
+        // Em falha o lote é descartado: os números pulados ficam como buracos
+        nextSequence = sequence + batchCount;
+        recordsWritten += ok ? batchCount : i;
+        if (!ok) writeErrors++;
+        flushes++;
+        batchCount = 0;
+        return ok;
+    }
+
+    // O setor atual foi apagado ao entrar nele: guarda só o que já foi escrito
+    uint32_t oldestSequence() const {
+        uint32_t next = nextSequence;
+        uint32_t inSector = next % HISTORY_RECORDS_PER_SECTOR;
+        uint32_t held = inSector == 0 ? capacity : capacity - HISTORY_RECORDS_PER_SECTOR + inSector;
+        return next > held ? next - held : 0;
+    }
+
+    // Registro de número "sequence", se ainda estiver na flash
+    bool read(uint32_t sequence, HistoryRecord& r) const {
+        return capacity > 0 && readSlot(sequence % capacity, r) &&
+               historyRecordValid(r) && r.sequence == sequence;
+    }
+
+    // =================== INTERNO ===================
+
+    bool readSlot(uint32_t slot, HistoryRecord& r) const {
+        return storage->read(slot * sizeof(HistoryRecord), &r, sizeof(r));
+    }
+
+    bool slotErased(uint32_t slot) const {
+        HistoryRecord r;
+        if (!readSlot(slot, r)) return false;
+        const uint8_t* bytes = (const uint8_t*)&r;
+        for (size_t i = 0; i < sizeof(r); i++) {
+            if (bytes[i] != 0xFF) return false;
+        }
+        return true;
+    }
+};
+
+// =================== CONSULTA ===================
+
+// Estado de uma consulta /history em andamento (cabe no estado da conexão)
+struct HistoryCursor {
+    uint32_t next;                  // próximo número de sequência a ler
+    uint32_t end;                   // primeiro número fora da consulta
+    uint32_t from;                  // intervalo [from, to] em segundos
+    uint32_t to;
+    uint8_t state;                  // 0 = antes do '[', 1 = registros, 2 = fim
+    bool first;
+};
+
+template <typename Storage>
+void historyQuery(const HistoryLog<Storage>& log, HistoryCursor& cursor, uint32_t from, uint32_t to) {
+    cursor.next = log.oldestSequence();
+    cursor.end = log.nextSequence;
+    cursor.from = from;
+    cursor.to = to;
+    cursor.state = 0;
+    cursor.first = true;
+}
+
+// Escreve o próximo pedaço do array JSON em buf; 0 quando terminou.
+// Só registros inteiros: o que não cabe fica para a próxima chamada
+template <typename Storage>
+size_t historyWriteJson(const HistoryLog<Storage>& log, HistoryCursor& cursor,
+                        const char* const* labels, int stages, char* buf, size_t size) {
+    size_t len = 0;
+    if (cursor.state == 0 && size > 1) {
+        buf[len++] = '[';
+        cursor.state = 1;
+    }
+
+    while (cursor.state == 1) {
+        if (cursor.next >= cursor.end) {
+            if (len + 1 >= size) break;
+            buf[len++] = ']';
+            cursor.state = 2;
+            break;
+        }
+
+        HistoryRecord r;
+        if (!log.read(cursor.next, r)) {
+            cursor.next++;          // sobrescrito ou apagado
+            continue;
+        }
+        bool synced = !(r.stage & HISTORY_FLAG_UPTIME);
+        if (synced && r.time > cursor.to) {
+            cursor.end = cursor.next;   // ordenado no tempo: nada depois serve
+            continue;
+        }
+        if (r.time > cursor.to || r.time + r.span < cursor.from) {
+            cursor.next++;
+            continue;
+        }
+
+        char item[200];
+        JsonWriter json(item, sizeof(item));
+        if (!cursor.first) json.raw(',');
+        int stage = r.stage & ~HISTORY_FLAG_UPTIME;
+        json.beginObject()
+            .field("seq", (unsigned long)r.sequence)
+            .field("time", (unsigned long)r.time)
+            .field("synced", synced)
+            .field("span", (unsigned)r.span)
+            .field("samples", (unsigned)r.count)
+            .field("stage", stage < stages ? labels[stage] : "?");
+        json.key("confidence").beginArray();
+        for (int i = 0; i < stages && i < HISTORY_STAGES; i++) {
+            json.number(historyConfidence(r, i), 2);
+        }
+        json.endArray().endObject();
+
+        if (!json.ok() || len + json.length() >= size) {
+            break;                  // não cabe: fica para o próximo pedaço
+        }
+        memcpy(buf + len, json.c_str(), json.length());
+        len += json.length();
+        cursor.first = false;
+        cursor.next++;
+    }
+    return len;
+}
+
+#endif // HISTORY_LOG_H
@@ -0,0 +1,975 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+// Servidor HTTP/1.1 orientado a eventos (select) sobre sockets não bloqueantes.
+// Roda em uma tarefa própria no ESP32 (lwIP) e em uma std::thread no host
+// (POSIX), com várias conexões simultâneas e keep-alive. Cada conexão tem
+// buffers próprios: um cliente lento só atrasa a si mesmo. Conexões de
+// streaming ficam abertas: Server-Sent Events recebem broadcastEvent() e
+// MJPEG recebe broadcastFrame() e a gravação crua recebe broadcastCapture(). Corpos grandes gerados sob demanda saem
+// em pedaços (chunked) à medida que o socket aceita, sem montar tudo em RAM.
+// Uma resposta também pode ser adiada (deferResponse) e sair depois, da
+// mesma tarefa, com answerDeferred().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#ifndef TCP_NODELAY
+#include <netinet/tcp.h>        // lwIP já define em sys/socket.h
+#endif
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+#ifndef HTTP_MAX_CLIENTS
+#define HTTP_MAX_CLIENTS            6       // Conexões simultâneas
+#endif
+
+#ifndef HTTP_REQUEST_BUFFER
+#define HTTP_REQUEST_BUFFER         1024    // Linha de requisição + cabeçalhos
+#endif
+
+#ifndef HTTP_OUTPUT_BUFFER
+#define HTTP_OUTPUT_BUFFER          2048    // Cabeçalhos + corpos pequenos (JSON)
+#endif
+
+static_assert(HTTP_OUTPUT_BUFFER <= 0xFFF + 7, "tamanho do pedaco chunked usa 3 digitos hex");
+
+#ifndef HTTP_MAX_ROUTES
+#define HTTP_MAX_ROUTES             24
+#endif
+
+#ifndef HTTP_KEEPALIVE_TIMEOUT
+#define HTTP_KEEPALIVE_TIMEOUT      10000   // ms sem requisições até fechar
+#endif
+
+#ifndef HTTP_SEND_TIMEOUT
+#define HTTP_SEND_TIMEOUT           5000    // ms sem progresso no envio até fechar
+#endif
+
+#ifndef HTTP_MAX_KEEPALIVE_REQUESTS
+#define HTTP_MAX_KEEPALIVE_REQUESTS 100
+#endif
+
+#ifndef HTTP_PRODUCER_STATE
+#define HTTP_PRODUCER_STATE         32      // Bytes de estado por conexão para corpo gerado
+#endif
+
+#ifndef HTTP_MJPEG_BOUNDARY
+#define HTTP_MJPEG_BOUNDARY         "frame"
+#endif
+
+// Tipos de conexão de streaming
+#define HTTP_STREAM_NONE            0
+#define HTTP_STREAM_EVENTS          1       // text/event-stream
+#define HTTP_STREAM_MJPEG           2       // multipart/x-mixed-replace
+#define HTTP_STREAM_CAPTURE         3       // application/octet-stream (frame_capture.h)
+#define HTTP_STREAM_DEFERRED        4       // resposta única adiada (answerDeferred)
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL                0
+#endif
+
+inline unsigned long httpMillis() {
+#ifdef ARDUINO
+    return millis();
+#else
+    using namespace std::chrono;
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline unsigned long httpMicros() {
+#ifdef ARDUINO
+    return micros();
+#else
+    using namespace std::chrono;
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline const char* httpStatusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 406: return "Not Acceptable";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
+
+inline int httpHexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// =================== REQUISIÇÃO ===================
+
+struct HttpRequest {
+    char method[8];
+    char path[64];
+    char query[256];
+    char ifNoneMatch[48];
+    bool acceptsGzip;
+    bool keepAlive;
+
+    // Valor decodificado (%XX e '+') do parâmetro da query string
+    bool arg(const char* name, char* out, size_t outSize) const {
+        size_t nameLen = strlen(name);
+        const char* p = query;
+        while (*p) {
+            const char* end = strchr(p, '&');
+            if (!end) end = p + strlen(p);
+
+            if ((size_t)(end - p) > nameLen && strncmp(p, name, nameLen) == 0 && p[nameLen] == '=') {
+                size_t n = 0;
+                for (const char* v = p + nameLen + 1; v < end && n + 1 < outSize; v++) {
+                    if (*v == '+') {
+                        out[n++] = ' ';
+                    } else if (*v == '%' && v + 2 < end && httpHexValue(v[1]) >= 0 && httpHexValue(v[2]) >= 0) {
+                        out[n++] = (char)(httpHexValue(v[1]) * 16 + httpHexValue(v[2]));
+                        v += 2;
+                    } else {
+                        out[n++] = *v;
+                    }
+                }
+                out[n] = '\0';
+                return true;
+            }
+            p = *end ? end + 1 : end;
+        }
+        if (outSize > 0) out[0] = '\0';
+        return false;
+    }
+
+    long argInt(const char* name, long defaultValue) const {
+        char value[16];
+        if (!arg(name, value, sizeof(value)) || !value[0]) {
+            return defaultValue;
+        }
+        return strtol(value, nullptr, 10);
+    }
+
+    bool hasArg(const char* name) const {
+        char value[2];
+        return arg(name, value, sizeof(value));
+    }
+};
+
+// =================== CORPO COMPARTILHADO ===================
+
+// Buffer enviado a várias conexões sem cópia (ex.: frame JPEG do /stream).
+// Contagem de referências só na tarefa do servidor; liberado com free().
+struct HttpSharedBody {
+    uint8_t* data;
+    size_t length;
+    int refs;
+};
+
+inline HttpSharedBody* httpSharedBodyCreate(uint8_t* data, size_t length) {
+    HttpSharedBody* body = (HttpSharedBody*)malloc(sizeof(HttpSharedBody));
+    if (!body) {
+        free(data);
+        return nullptr;
+    }
+    body->data = data;
+    body->length = length;
+    body->refs = 1;
+    return body;
+}
+
+inline void httpSharedBodyRelease(HttpSharedBody* body) {
+    if (body && --body->refs == 0) {
+        free(body->data);
+        free(body);
+    }
+}
+
+// Gera o próximo pedaço do corpo em buf (até size bytes); 0 = fim
+typedef size_t (*HttpBodyProducer)(void* state, char* buf, size_t size);
+
+// =================== CONEXÃO ===================
+
+struct HttpConnection {
+    int fd = -1;
+    unsigned long lastActivity = 0;
+    uint16_t requests = 0;
+    bool responding = false;        // resposta na fila, ainda sendo enviada
+    bool keepAlive = false;
+    uint8_t stream = HTTP_STREAM_NONE;  // streaming: aberta para push
+    unsigned long deferredAt = 0;       // quando a resposta foi adiada
+
+    char in[HTTP_REQUEST_BUFFER];
+    size_t inLen = 0;
+
+    char out[HTTP_OUTPUT_BUFFER];
+    size_t outLen = 0;
+    size_t outSent = 0;
+
+    // Corpo fora do buffer: estático (flash) ou alocado e liberado após o envio
+    const uint8_t* body = nullptr;
+    size_t bodyLen = 0;
+    size_t bodySent = 0;
+    void* ownedBody = nullptr;
+    HttpSharedBody* sharedBody = nullptr;
+
+    // Corpo gerado (Transfer-Encoding: chunked), com estado guardado na conexão
+    HttpBodyProducer producer = nullptr;
+    alignas(8) uint8_t producerState[HTTP_PRODUCER_STATE];
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // Cabeçalhos da resposta; extraHeaders já com "\r\n" no fim de cada linha.
+    // Se não couberem no buffer, a resposta vira um 500 sem corpo e a
+    // conexão fecha depois dele (false: o chamador não envia o corpo)
+    bool beginResponse(int status, const char* contentType, size_t contentLength, const char* extraHeaders) {
+        int n = snprintf(out, sizeof(out),
+                         "HTTP/1.1 %d %s\r\n"
+                         "Content-Type: %s\r\n"
+                         "Content-Length: %u\r\n"
+                         "Connection: %s\r\n"
+                         "%s"
+                         "\r\n",
+                         status, httpStatusText(status),
+                         contentType ? contentType : "text/plain",
+                         (unsigned)contentLength,
+                         keepAlive ? "keep-alive" : "close",
+                         extraHeaders ? extraHeaders : "");
+        bool fits = n >= 0 && (size_t)n < sizeof(out);
+        if (!fits) {
+            static const char overflow[] = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            keepAlive = false;
+            memcpy(out, overflow, sizeof(overflow) - 1);
+            n = sizeof(overflow) - 1;
+        }
+        outLen = n;
+        outSent = 0;
+        releaseBody();
+        responding = true;
+        return fits;
+    }
+
+    // Corpo copiado: no buffer da conexão se couber, senão em memória alocada
+    void send(int status, const char* contentType, const char* data, size_t len, const char* extraHeaders = nullptr) {
+        if (!beginResponse(status, contentType, len, extraHeaders)) {
+            return;
+        }
+        // Um único memcpy para os dois destinos
+        uint8_t* copy = (uint8_t*)out + outLen;
+        if (len <= sizeof(out) - outLen) {
+            outLen += len;
+        } else {
+            copy = (uint8_t*)malloc(len);
+            if (!copy) {
+                keepAlive = false;
+                beginResponse(503, "text/plain", 0, nullptr);
+                return;
+            }
+            ownedBody = copy;
+            body = copy;
+            bodyLen = len;
+        }
+        memcpy(copy, data, len);
+    }
+
+    void send(int status, const char* contentType, const char* text) {
+        send(status, contentType, text, strlen(text));
+    }
+
+    // Corpo estático (ex.: array em flash), enviado sem cópia
+    void sendStatic(int status, const char* contentType, const uint8_t* data, size_t len, const char* extraHeaders = nullptr) {
+        if (beginResponse(status, contentType, len, extraHeaders)) {
+            body = data;
+            bodyLen = len;
+        }
+    }
+
+    // Corpo alocado com malloc pelo chamador; liberado pela conexão após o envio
+    void sendOwned(int status, const char* contentType, void* data, size_t len, const char* extraHeaders = nullptr) {
+        if (beginResponse(status, contentType, len, extraHeaders)) {
+            ownedBody = data;
+            body = (const uint8_t*)data;
+            bodyLen = len;
+        } else {
+            free(data);
+        }
+    }
+
+    // Corpo compartilhado (ex.: último JPEG do /stream), enviado sem cópia
+    void sendShared(int status, const char* contentType, HttpSharedBody* shared, const char* extraHeaders = nullptr) {
+        if (beginResponse(status, contentType, shared->length, extraHeaders)) {
+            shared->refs++;
+            sharedBody = shared;
+            body = shared->data;
+            bodyLen = shared->length;
+        }
+    }
+
+    // Sem resposta por enquanto: a conexão espera answerDeferred() ou
+    // expireDeferred(). Requisições seguintes ficam no buffer até lá
+    void deferResponse() {
+        stream = HTTP_STREAM_DEFERRED;
+        deferredAt = httpMillis();
+    }
+
+    // Corpo de tamanho desconhecido, gerado pedaço a pedaço no buffer de saída.
+    // Retorna a área de estado do produtor (nullptr se stateSize não couber)
+    void* sendChunked(int status, const char* contentType, HttpBodyProducer bodyProducer, size_t stateSize) {
+        if (stateSize > sizeof(producerState)) {
+            return nullptr;
+        }
+        int n = snprintf(out, sizeof(out),
+                         "HTTP/1.1 %d %s\r\n"
+                         "Content-Type: %s\r\n"
+                         "Transfer-Encoding: chunked\r\n"
+                         "Cache-Control: no-cache\r\n"
+                         "Connection: %s\r\n"
+                         "\r\n",
+                         status, httpStatusText(status), contentType,
+                         keepAlive ? "keep-alive" : "close");
+        outLen = n;
+        outSent = 0;
+        releaseBody();
+        producer = bodyProducer;
+        responding = true;
+        return producerState;
+    }
+
+    // Próximo pedaço do corpo gerado: "XXX\r\n" + dados + "\r\n", ou o
+    // terminador "0\r\n\r\n". false se não há corpo gerado pendente
+    bool nextChunk() {
+        if (!producer) {
+            return false;
+        }
+        const size_t head = 5;          // até 3 dígitos hex + "\r\n"
+        size_t n = producer(producerState, out + head, sizeof(out) - head - 2);
+        if (n == 0) {
+            memcpy(out, "0\r\n\r\n", 5);
+            outLen = 5;
+            producer = nullptr;
+        } else {
+            static const char hex[] = "0123456789abcdef";
+            out[0] = hex[(n >> 8) & 15];
+            out[1] = hex[(n >> 4) & 15];
+            out[2] = hex[n & 15];
+            out[3] = '\r';
+            out[4] = '\n';
+            out[head + n] = '\r';
+            out[head + n + 1] = '\n';
+            outLen = head + n + 2;
+        }
+        outSent = 0;
+        return true;
+    }
+
+    // Resposta sem Content-Length que continua aberta para push
+    void beginStream(uint8_t kind, const char* contentType) {
+        int n = snprintf(out, sizeof(out),
+                         "HTTP/1.1 200 OK\r\n"
+                         "Content-Type: %s\r\n"
+                         "Cache-Control: no-cache\r\n"
+                         "Connection: keep-alive\r\n"
+                         "\r\n", contentType);
+        outLen = n;
+        outSent = 0;
+        releaseBody();
+        responding = true;
+        keepAlive = true;
+        stream = kind;
+    }
+
+    // Server-Sent Events: recebe os eventos de HttpServer::broadcastEvent()
+    void beginEventStream(unsigned int retryMs) {
+        beginStream(HTTP_STREAM_EVENTS, "text/event-stream");
+        outLen += snprintf(out + outLen, sizeof(out) - outLen, "retry: %u\n\n", retryMs);
+    }
+
+    // MJPEG: recebe os frames de HttpServer::broadcastFrame()
+    void beginMjpegStream() {
+        beginStream(HTTP_STREAM_MJPEG, "multipart/x-mixed-replace; boundary=" HTTP_MJPEG_BOUNDARY);
+    }
+
+    // Gravação crua: o cabeçalho do arquivo sai logo depois dos headers e
+    // os frames de HttpServer::broadcastCapture() vêm em seguida, sem moldura
+    void beginCaptureStream(const void* header, size_t length) {
+        beginStream(HTTP_STREAM_CAPTURE, "application/octet-stream");
+        memcpy(out + outLen, header, length);
+        outLen += length;
+    }
+
+    // Próxima parte do multipart apontando para o frame compartilhado (sem
+    // contentType o frame sai como está, na gravação crua).
+    // Falha se o frame anterior ainda está sendo enviado (cliente lento)
+    bool queueFrame(HttpSharedBody* frame, const char* contentType) {
+        if (responding) {
+            return false;
+        }
+        outLen = 0;
+        if (contentType) {
+            outLen = snprintf(out, sizeof(out),
+                              "\r\n--" HTTP_MJPEG_BOUNDARY "\r\n"
+                              "Content-Type: %s\r\n"
+                              "Content-Length: %u\r\n"
+                              "\r\n", contentType, (unsigned int)frame->length);
+        }
+        outSent = 0;
+        releaseBody();
+        frame->refs++;
+        sharedBody = frame;
+        body = frame->data;
+        bodyLen = frame->length;
+        responding = true;
+        return true;
+    }
+
+    // Acrescenta um evento à saída. Falha se o cliente ainda não consumiu
+    // os anteriores e não há espaço (cliente lento perde o evento)
+    bool queueEvent(const char* event, const char* data) {
+        if (outSent > 0) {
+            memmove(out, out + outSent, outLen - outSent);
+            outLen -= outSent;
+            outSent = 0;
+        }
+        size_t room = sizeof(out) - outLen;
+        int n = snprintf(out + outLen, room, "event: %s\ndata: %s\n\n", event, data);
+        if (n < 0 || (size_t)n >= room) {
+            return false;
+        }
+        outLen += n;
+        responding = true;
+        return true;
+    }
+
+    void releaseBody() {
+        if (ownedBody) {
+            free(ownedBody);
+            ownedBody = nullptr;
+        }
+        if (sharedBody) {
+            httpSharedBodyRelease(sharedBody);
+            sharedBody = nullptr;
+        }
+        body = nullptr;
+        bodyLen = 0;
+        bodySent = 0;
+        producer = nullptr;
+    }
+};
+
+typedef void (*HttpHandler)(HttpConnection& conn, const HttpRequest& req);
+
+// Chamado depois de cada handler com o índice da rota (-1 = não encontrada)
+// e o tempo gasto nele, em us (corpo chunked gerado depois não entra)
+typedef void (*HttpObserver)(int route, uint32_t us);
+
+// =================== SERVIDOR ===================
+
+struct HttpServer {
+    struct Route {
+        const char* path;
+        HttpHandler handler;
+    };
+
+    int listenFd = -1;
+    HttpConnection clients[HTTP_MAX_CLIENTS];
+    Route routes[HTTP_MAX_ROUTES];
+    int routeCount = 0;
+    HttpHandler notFoundHandler = nullptr;
+    HttpObserver observer = nullptr;
+
+    // Estatísticas
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;          // recusadas por falta de slot
+    uint32_t requests = 0;
+    uint32_t timeouts = 0;
+    uint32_t eventsDropped = 0;     // eventos não enfileirados (cliente SSE lento)
+    uint32_t framesSent = 0;
+    uint32_t framesDropped = 0;     // frames pulados (cliente MJPEG ainda no anterior)
+
+    void on(const char* path, HttpHandler handler) {
+        if (routeCount < HTTP_MAX_ROUTES) {
+            routes[routeCount].path = path;
+            routes[routeCount].handler = handler;
+            routeCount++;
+        }
+    }
+
+    void onNotFound(HttpHandler handler) {
+        notFoundHandler = handler;
+    }
+
+    bool begin(uint16_t port) {
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            return false;
+        }
+
+        int yes = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+
+        if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, HTTP_MAX_CLIENTS) < 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        setNonBlocking(listenFd);
+        return true;
+    }
+
+    void stop() {
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            closeClient(clients[i]);
+        }
+        if (listenFd >= 0) {
+            ::close(listenFd);
+            listenFd = -1;
+        }
+    }
+
+    int activeClients() const {
+        int count = 0;
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            if (clients[i].isOpen()) count++;
+        }
+        return count;
+    }
+
+    int streamCount(uint8_t kind) const {
+        int count = 0;
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            if (clients[i].isOpen() && clients[i].stream == kind) count++;
+        }
+        return count;
+    }
+
+    // Envia o evento a todas as conexões SSE. Chamar da mesma tarefa que poll()
+    int broadcastEvent(const char* event, const char* data) {
+        int sent = 0;
+        unsigned long now = httpMillis();
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            HttpConnection& c = clients[i];
+            if (!c.isOpen() || c.stream != HTTP_STREAM_EVENTS) continue;
+            if (!c.queueEvent(event, data)) {
+                eventsDropped++;
+                continue;
+            }
+            writeClient(c, now);
+            sent++;
+        }
+        return sent;
+    }
+
+    // Envia o frame às conexões MJPEG livres; quem ainda está no frame
+    // anterior pula este. Chamar da mesma tarefa que poll()
+    int broadcastFrame(HttpSharedBody* frame, const char* contentType) {
+        return broadcastShared(HTTP_STREAM_MJPEG, frame, contentType);
+    }
+
+    // Mesmo esquema para as conexões de gravação (/record): o frame já vem
+    // com o cabeçalho do formato de captura
+    int broadcastCapture(HttpSharedBody* frame) {
+        return broadcastShared(HTTP_STREAM_CAPTURE, frame, nullptr);
+    }
+
+    // Responde às conexões adiadas com o corpo compartilhado; elas voltam a
+    // ser conexões comuns (keep-alive). Chamar da mesma tarefa que poll()
+    int answerDeferred(HttpSharedBody* shared, const char* contentType, const char* extraHeaders = nullptr) {
+        int answered = 0;
+        unsigned long now = httpMillis();
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            HttpConnection& c = clients[i];
+            if (!c.isOpen() || c.stream != HTTP_STREAM_DEFERRED) continue;
+            c.stream = HTTP_STREAM_NONE;
+            c.sendShared(200, contentType, shared, extraHeaders);
+            writeClient(c, now);
+            answered++;
+        }
+        return answered;
+    }
+
+    // Conexões adiadas há mais de maxWaitMs recebem status/text
+    int expireDeferred(unsigned long maxWaitMs, int status, const char* text) {
+        int expired = 0;
+        unsigned long now = httpMillis();
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            HttpConnection& c = clients[i];
+            if (!c.isOpen() || c.stream != HTTP_STREAM_DEFERRED) continue;
+            if (now - c.deferredAt <= maxWaitMs) continue;
+            c.stream = HTTP_STREAM_NONE;
+            c.send(status, "text/plain", text);
+            writeClient(c, now);
+            expired++;
+        }
+        return expired;
+    }
+
+    int broadcastShared(uint8_t kind, HttpSharedBody* frame, const char* contentType) {
+        int sent = 0;
+        unsigned long now = httpMillis();
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            HttpConnection& c = clients[i];
+            if (!c.isOpen() || c.stream != kind) continue;
+            if (!c.queueFrame(frame, contentType)) {
+                framesDropped++;
+                continue;
+            }
+            writeClient(c, now);
+            framesSent++;
+            sent++;
+        }
+        return sent;
+    }
+
+    // Uma iteração do laço de eventos: espera até timeoutMs por atividade
+    void poll(int timeoutMs) {
+        if (listenFd < 0) {
+            return;
+        }
+
+        fd_set readSet, writeSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        FD_SET(listenFd, &readSet);
+        int maxFd = listenFd;
+
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            HttpConnection& c = clients[i];
+            if (!c.isOpen()) continue;
+            if (c.responding) {
+                FD_SET(c.fd, &writeSet);
+            } else if (c.stream != HTTP_STREAM_DEFERRED || c.inLen < sizeof(c.in)) {
+                FD_SET(c.fd, &readSet);     // adiada com o buffer cheio: espera a resposta
+            }
+            if (c.fd > maxFd) maxFd = c.fd;
+        }
+
+        struct timeval tv;
+        tv.tv_sec = timeoutMs / 1000;
+        tv.tv_usec = (timeoutMs % 1000) * 1000;
+        int ready = select(maxFd + 1, &readSet, &writeSet, nullptr, &tv);
+
+        unsigned long now = httpMillis();
+        if (ready > 0) {
+            if (FD_ISSET(listenFd, &readSet)) {
+                acceptClients(now);
+            }
+            for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+                HttpConnection& c = clients[i];
+                if (!c.isOpen()) continue;
+                if (FD_ISSET(c.fd, &writeSet)) {
+                    writeClient(c, now);
+                } else if (FD_ISSET(c.fd, &readSet)) {
+                    readClient(c, now);
+                }
+            }
+        }
+
+        // Keep-alive ocioso ou cliente que não consome a resposta
+        // (relógio relido: o envio acima pode ter atualizado lastActivity)
+        now = httpMillis();
+        for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+            HttpConnection& c = clients[i];
+            if (!c.isOpen()) continue;
+            if (c.stream && !c.responding) continue;    // ociosa por natureza
+            unsigned long limit = c.responding ? HTTP_SEND_TIMEOUT : HTTP_KEEPALIVE_TIMEOUT;
+            if (now - c.lastActivity > limit) {
+                timeouts++;
+                closeClient(c);
+            }
+        }
+    }
+
+    // =================== INTERNO ===================
+
+    static void setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    void acceptClients(unsigned long now) {
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+
+            HttpConnection* slot = nullptr;
+            for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+                if (!clients[i].isOpen()) {
+                    slot = &clients[i];
+                    break;
+                }
+            }
+            if (!slot) {
+                // Sem slot livre: resposta mínima e fecha sem bloquear os demais
+                static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+                ::send(fd, busy, sizeof(busy) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+                ::close(fd);
+                rejected++;
+                continue;
+            }
+
+            setNonBlocking(fd);
+            int yes = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+            slot->fd = fd;
+            slot->lastActivity = now;
+            slot->requests = 0;
+            slot->responding = false;
+            slot->stream = HTTP_STREAM_NONE;
+            slot->inLen = 0;
+            slot->outLen = 0;
+            slot->outSent = 0;
+            slot->releaseBody();
+            accepted++;
+        }
+    }
+
+    void closeClient(HttpConnection& c) {
+        if (c.fd >= 0) {
+            ::close(c.fd);
+        }
+        c.fd = -1;
+        c.responding = false;
+        c.stream = HTTP_STREAM_NONE;
+        c.inLen = 0;
+        c.outLen = 0;
+        c.outSent = 0;
+        c.releaseBody();
+    }
+
+    void readClient(HttpConnection& c, unsigned long now) {
+        ssize_t n = recv(c.fd, c.in + c.inLen, sizeof(c.in) - c.inLen, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            closeClient(c);
+            return;
+        }
+        if (n < 0) {
+            return;
+        }
+        c.lastActivity = now;
+        if (c.stream == HTTP_STREAM_DEFERRED) {
+            c.inLen += n;   // atendida depois de answerDeferred()
+            return;
+        }
+        if (c.stream) {
+            return;         // nada a ler em uma conexão de streaming: descarta
+        }
+        c.inLen += n;
+        processInput(c);
+    }
+
+    void writeClient(HttpConnection& c, unsigned long now) {
+        while (true) {
+            if (c.outSent >= c.outLen && c.bodySent >= c.bodyLen && !c.nextChunk()) {
+                break;
+            }
+            const uint8_t* data;
+            size_t len;
+            if (c.outSent < c.outLen) {
+                data = (const uint8_t*)c.out + c.outSent;
+                len = c.outLen - c.outSent;
+            } else {
+                data = c.body + c.bodySent;
+                len = c.bodyLen - c.bodySent;
+            }
+
+            ssize_t n = ::send(c.fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    closeClient(c);
+                }
+                return;
+            }
+            c.lastActivity = now;
+            if (c.outSent < c.outLen) {
+                c.outSent += n;
+            } else {
+                c.bodySent += n;
+            }
+        }
+
+        // Resposta completa
+        c.responding = false;
+        c.outLen = 0;
+        c.outSent = 0;
+        c.releaseBody();
+
+        if (!c.keepAlive) {
+            closeClient(c);
+            return;
+        }
+        processInput(c);    // requisição seguinte já recebida (pipelining)
+    }
+
+    void processInput(HttpConnection& c) {
+        if (c.responding || c.stream == HTTP_STREAM_DEFERRED || c.inLen == 0) {
+            return;
+        }
+
+        char* end = nullptr;
+        for (size_t i = 3; i < c.inLen; i++) {
+            if (c.in[i - 3] == '\r' && c.in[i - 2] == '\n' && c.in[i - 1] == '\r' && c.in[i] == '\n') {
+                end = c.in + i + 1;
+                break;
+            }
+        }
+
+        if (!end) {
+            if (c.inLen >= sizeof(c.in)) {
+                c.keepAlive = false;
+                c.send(431, "text/plain", "Cabecalhos muito grandes");
+                writeClient(c, httpMillis());
+            }
+            return;
+        }
+
+        HttpRequest req;
+        size_t contentLength = 0;
+        bool ok = parseRequest(c.in, end, req, contentLength);
+
+        // Corpo (POST) é ignorado: descarta junto com os cabeçalhos
+        size_t consumed = (end - c.in) + contentLength;
+        if (consumed > c.inLen) {
+            if (consumed > sizeof(c.in)) {
+                ok = false;
+                consumed = c.inLen;
+            } else {
+                return;     // espera o corpo chegar
+            }
+        }
+        memmove(c.in, c.in + consumed, c.inLen - consumed);
+        c.inLen -= consumed;
+
+        c.requests++;
+        requests++;
+        c.keepAlive = ok && req.keepAlive && c.requests < HTTP_MAX_KEEPALIVE_REQUESTS;
+
+        if (!ok) {
+            c.send(400, "text/plain", "Requisicao invalida");
+        } else {
+            dispatch(c, req);
+            if (c.stream == HTTP_STREAM_DEFERRED) {
+                return;
+            }
+            if (!c.responding) {
+                c.send(204, "text/plain", "", 0);
+            }
+        }
+
+        // Tenta enviar já; o restante segue quando o socket aceitar
+        writeClient(c, httpMillis());
+    }
+
+    void dispatch(HttpConnection& c, const HttpRequest& req) {
+        unsigned long start = httpMicros();
+        int route = -1;
+        for (int i = 0; i < routeCount; i++) {
+            if (strcmp(routes[i].path, req.path) == 0) {
+                route = i;
+                break;
+            }
+        }
+        if (route >= 0) {
+            routes[route].handler(c, req);
+        } else if (notFoundHandler) {
+            notFoundHandler(c, req);
+        } else {
+            c.send(404, "text/plain", "Pagina nao encontrada");
+        }
+        if (observer) {
+            observer(route, (uint32_t)(httpMicros() - start));
+        }
+    }
+
+    static void copyToken(char* out, size_t outSize, const char* start, const char* end) {
+        size_t n = end - start;
+        if (n >= outSize) n = outSize - 1;
+        memcpy(out, start, n);
+        out[n] = '\0';
+    }
+
+    static bool headerIs(const char* line, const char* name, const char** value) {
+        size_t n = strlen(name);
+        if (strncasecmp(line, name, n) != 0 || line[n] != ':') {
+            return false;
+        }
+        const char* v = line + n + 1;
+        while (*v == ' ') v++;
+        *value = v;
+        return true;
+    }
+
+    static bool parseRequest(char* start, char* end, HttpRequest& req, size_t& contentLength) {
+        req.method[0] = req.path[0] = req.query[0] = req.ifNoneMatch[0] = '\0';
+        req.acceptsGzip = false;
+        req.keepAlive = true;
+        contentLength = 0;
+
+        // Termina cada linha com '\0' para tratar como string
+        char* line = start;
+        char* lineEnd = strstr(line, "\r\n");
+        if (!lineEnd || lineEnd >= end) return false;
+        *lineEnd = '\0';
+
+        // Linha de requisição: METODO /caminho?query HTTP/1.x
+        char* sp1 = strchr(line, ' ');
+        if (!sp1) return false;
+        char* sp2 = strchr(sp1 + 1, ' ');
+        if (!sp2) return false;
+        copyToken(req.method, sizeof(req.method), line, sp1);
+
+        char* target = sp1 + 1;
+        char* q = (char*)memchr(target, '?', sp2 - target);
+        copyToken(req.path, sizeof(req.path), target, q ? q : sp2);
+        if (q) copyToken(req.query, sizeof(req.query), q + 1, sp2);
+        if (strncmp(sp2 + 1, "HTTP/1.0", 8) == 0) req.keepAlive = false;
+
+        line = lineEnd + 2;
+        while (line < end - 2) {
+            lineEnd = strstr(line, "\r\n");
+            if (!lineEnd) break;
+            *lineEnd = '\0';
+
+            const char* value;
+            if (headerIs(line, "Connection", &value)) {
+                if (strncasecmp(value, "close", 5) == 0) req.keepAlive = false;
+                if (strncasecmp(value, "keep-alive", 10) == 0) req.keepAlive = true;
+            } else if (headerIs(line, "If-None-Match", &value)) {
+                copyToken(req.ifNoneMatch, sizeof(req.ifNoneMatch), value, value + strlen(value));
+            } else if (headerIs(line, "Accept-Encoding", &value)) {
+                req.acceptsGzip = strstr(value, "gzip") != nullptr;
+            } else if (headerIs(line, "Content-Length", &value)) {
+                contentLength = strtoul(value, nullptr, 10);
+            }
+            line = lineEnd + 2;
+        }
+        return true;
+    }
+};
+
+#endif // HTTP_SERVER_H
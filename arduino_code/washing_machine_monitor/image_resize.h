@@ -0,0 +1,284 @@
+#ifndef IMAGE_RESIZE_H
+#define IMAGE_RESIZE_H
+
+// Redimensionamento bilinear em ponto fixo direto de frames RGB565 ou em
+// escala de cinza (PIXFORMAT_GRAYSCALE, 1 byte por pixel).
+// Não depende do Arduino para poder ser compilado e comparado no host
+// contra o resize_image do SDK (mesma aritmética de 14 bits de fração).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+// Mesmos valores de EI_CLASSIFIER_RESIZE_* do SDK
+#define IMAGE_RESIZE_FIT_SHORTEST   1
+#define IMAGE_RESIZE_FIT_LONGEST    2
+#define IMAGE_RESIZE_SQUASH         3
+
+#ifndef IMAGE_RESIZE_MAX_WIDTH
+#define IMAGE_RESIZE_MAX_WIDTH      320   // Largura máxima da imagem de saída
+#endif
+
+// Formato do frame de origem
+#define IMAGE_PIXEL_RGB565          0
+#define IMAGE_PIXEL_GRAY8           1
+
+#define IMAGE_RESIZE_FRAC_BITS      14
+#define IMAGE_RESIZE_FRAC_VAL       (1 << IMAGE_RESIZE_FRAC_BITS)
+#define IMAGE_RESIZE_FRAC_MASK      (IMAGE_RESIZE_FRAC_VAL - 1)
+
+// Região da origem usada e onde ela cai na imagem de saída
+struct ResizeGeometry {
+    int cropX, cropY, cropWidth, cropHeight;        // recorte na origem
+    int targetX, targetY, targetWidth, targetHeight; // área útil no destino
+};
+
+// Memória de trabalho: tabela horizontal e cache de linhas já interpoladas
+struct ResizeScratch {
+    uint16_t xIndex[IMAGE_RESIZE_MAX_WIDTH];
+    uint16_t xFrac[IMAGE_RESIZE_MAX_WIDTH];
+    uint8_t rows[2][IMAGE_RESIZE_MAX_WIDTH * 3];
+    int rowSource[2];
+    uint32_t rowHits;
+    uint32_t rowMisses;
+};
+
+// Saída RGB888 empacotada
+struct Rgb888Sink {
+    uint8_t* out;
+    inline void pixel(uint8_t r, uint8_t g, uint8_t b) {
+        *out++ = r;
+        *out++ = g;
+        *out++ = b;
+    }
+};
+
+// Saída quantizada direto no tensor int8 (RGB ou luma)
+struct QuantizedSink {
+    int8_t* out;
+    const int8_t* quant;
+    bool grayscale;
+    inline void pixel(uint8_t r, uint8_t g, uint8_t b) {
+        if (grayscale) {
+            // Luma ITU-R 601-2, mesma conta do bloco DSP do SDK
+            *out++ = quant[(r * 19595 + g * 38470 + b * 7471) >> 16];
+        } else {
+            *out++ = quant[r];
+            *out++ = quant[g];
+            *out++ = quant[b];
+        }
+    }
+};
+
+// =================== FUNÇÕES ===================
+
+// Tabela de quantização: valor 0-255 do canal -> int8 do tensor (entrada 0..1)
+inline void buildQuantizationTable(float scale, int32_t zeroPoint, int8_t* table) {
+    for (int v = 0; v < 256; v++) {
+        int32_t q = (int32_t)lroundf((v / 255.0f) / scale) + zeroPoint;
+        if (q < -128) q = -128;
+        if (q > 127) q = 127;
+        table[v] = (int8_t)q;
+    }
+}
+
+inline void expandRgb565(const uint8_t* px, uint8_t& r, uint8_t& g, uint8_t& b) {
+    // RGB565 little endian -> RGB888 replicando os bits mais altos
+    uint16_t pixel = (px[1] << 8) | px[0];
+    r = ((pixel >> 11) & 0x1F) << 3;
+    g = ((pixel >> 5) & 0x3F) << 2;
+    b = (pixel & 0x1F) << 3;
+    r |= (r >> 5);
+    g |= (g >> 6);
+    b |= (b >> 5);
+}
+
+// Equivalente inteiro de resize_image_using_mode (dsp/image/processing.cpp)
+inline bool calculateResizeGeometry(int srcWidth, int srcHeight, int dstWidth, int dstHeight,
+                                    int mode, ResizeGeometry& geom) {
+    if (srcWidth < 2 || srcHeight < 2 || dstWidth < 1 || dstHeight < 1) {
+        return false;
+    }
+
+    geom.cropX = 0;
+    geom.cropY = 0;
+    geom.cropWidth = srcWidth;
+    geom.cropHeight = srcHeight;
+    geom.targetX = 0;
+    geom.targetY = 0;
+    geom.targetWidth = dstWidth;
+    geom.targetHeight = dstHeight;
+
+    if (mode == IMAGE_RESIZE_FIT_SHORTEST) {
+        // Corta o eixo maior para a proporção do destino (calculate_crop_dims)
+        if (srcWidth > srcHeight) {
+            geom.cropWidth = (uint32_t)(dstWidth * srcHeight) / dstHeight;
+        } else {
+            geom.cropHeight = (uint32_t)(dstHeight * srcWidth) / dstWidth;
+        }
+        geom.cropX = (srcWidth - geom.cropWidth) / 2;
+        geom.cropY = (srcHeight - geom.cropHeight) / 2;
+    } else if (mode == IMAGE_RESIZE_FIT_LONGEST) {
+        // Imagem inteira, centralizada com faixas pretas
+        if (srcWidth * dstHeight > dstWidth * srcHeight) {
+            geom.targetHeight = (dstWidth * srcHeight) / srcWidth;
+        } else {
+            geom.targetWidth = (dstHeight * srcWidth) / srcHeight;
+        }
+        geom.targetX = (dstWidth - geom.targetWidth) / 2;
+        geom.targetY = (dstHeight - geom.targetHeight) / 2;
+    } else if (mode != IMAGE_RESIZE_SQUASH) {
+        return false;
+    }
+
+    return geom.cropWidth >= 2 && geom.cropHeight >= 2 &&
+           geom.targetWidth >= 1 && geom.targetHeight >= 1;
+}
+
+// Interpola horizontalmente uma linha da origem (uma vez por linha).
+// RGB565 vira RGB888; cinza fica com 1 byte por pixel
+inline const uint8_t* interpolateSourceRow(const uint8_t* src, int srcStride, int row, int format,
+                                           const ResizeGeometry& geom, ResizeScratch& scratch) {
+    for (int slot = 0; slot < 2; slot++) {
+        if (scratch.rowSource[slot] == row) {
+            scratch.rowHits++;
+            return scratch.rows[slot];
+        }
+    }
+
+    // Substitui a linha mais antiga (a de menor índice, já que descemos na imagem)
+    int slot = (scratch.rowSource[0] < scratch.rowSource[1]) ? 0 : 1;
+    scratch.rowSource[slot] = row;
+    scratch.rowMisses++;
+
+    uint8_t* d = scratch.rows[slot];
+    if (format == IMAGE_PIXEL_GRAY8) {
+        const uint8_t* line = src + (geom.cropY + row) * srcStride + geom.cropX;
+        for (int x = 0; x < geom.targetWidth; x++) {
+            const uint8_t* p = line + scratch.xIndex[x];
+            uint32_t frac = scratch.xFrac[x];
+            *d++ = (p[0] * (IMAGE_RESIZE_FRAC_VAL - frac) + p[1] * frac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+        }
+        return scratch.rows[slot];
+    }
+
+    const uint8_t* line = src + (geom.cropY + row) * srcStride + geom.cropX * 2;
+    for (int x = 0; x < geom.targetWidth; x++) {
+        const uint8_t* p = line + scratch.xIndex[x] * 2;
+        uint32_t frac = scratch.xFrac[x];
+        uint32_t nfrac = IMAGE_RESIZE_FRAC_VAL - frac;
+
+        uint8_t r0, g0, b0, r1, g1, b1;
+        expandRgb565(p, r0, g0, b0);
+        expandRgb565(p + 2, r1, g1, b1);
+
+        *d++ = (r0 * nfrac + r1 * frac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+        *d++ = (g0 * nfrac + g1 * frac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+        *d++ = (b0 * nfrac + b1 * frac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+    }
+
+    return scratch.rows[slot];
+}
+
+// Redimensiona um frame (IMAGE_PIXEL_*) para dstWidth x dstHeight usando o modo
+// escolhido. Os pixels são entregues em ordem para sink.pixel(r, g, b), o que
+// permite escrever RGB888, luma ou o tensor int8 na mesma passada. Em cinza
+// r = g = b (a luma do QuantizedSink devolve o próprio valor).
+template <typename Sink>
+bool resizeFrame(const uint8_t* src, int srcWidth, int srcHeight, int format,
+                 int dstWidth, int dstHeight, int mode,
+                 ResizeScratch& scratch, Sink& sink) {
+    ResizeGeometry geom;
+    if (!calculateResizeGeometry(srcWidth, srcHeight, dstWidth, dstHeight, mode, geom)) {
+        return false;
+    }
+    if (geom.targetWidth > IMAGE_RESIZE_MAX_WIDTH) {
+        return false;
+    }
+
+    // Tabela horizontal: coluna de origem e fração, calculada uma vez por chamada
+    const uint32_t srcXStep = (geom.cropWidth * IMAGE_RESIZE_FRAC_VAL) / geom.targetWidth;
+    const uint32_t srcYStep = (geom.cropHeight * IMAGE_RESIZE_FRAC_VAL) / geom.targetHeight;
+
+    uint32_t accum = 0;
+    for (int x = 0; x < geom.targetWidth; x++) {
+        uint32_t tx = accum >> IMAGE_RESIZE_FRAC_BITS;
+        uint32_t frac = accum & IMAGE_RESIZE_FRAC_MASK;
+        if (tx >= (uint32_t)(geom.cropWidth - 1)) {
+            tx = geom.cropWidth - 2;
+            frac = IMAGE_RESIZE_FRAC_VAL;
+        }
+        scratch.xIndex[x] = tx;
+        scratch.xFrac[x] = frac;
+        accum += srcXStep;
+    }
+
+    scratch.rowSource[0] = -1;
+    scratch.rowSource[1] = -1;
+
+    const int srcStride = srcWidth * (format == IMAGE_PIXEL_GRAY8 ? 1 : 2);
+
+    // Faixa preta superior (FIT_LONGEST)
+    for (int i = 0; i < geom.targetY * dstWidth; i++) {
+        sink.pixel(0, 0, 0);
+    }
+
+    accum = 0;
+    for (int y = 0; y < geom.targetHeight; y++) {
+        int ty = accum >> IMAGE_RESIZE_FRAC_BITS;
+        uint32_t yFrac = accum & IMAGE_RESIZE_FRAC_MASK;
+        if (ty >= geom.cropHeight - 1) {
+            ty = geom.cropHeight - 2;
+            yFrac = IMAGE_RESIZE_FRAC_VAL;
+        }
+        uint32_t nyFrac = IMAGE_RESIZE_FRAC_VAL - yFrac;
+        accum += srcYStep;
+
+        const uint8_t* top = interpolateSourceRow(src, srcStride, ty, format, geom, scratch);
+        const uint8_t* bottom = interpolateSourceRow(src, srcStride, ty + 1, format, geom, scratch);
+
+        for (int x = 0; x < geom.targetX; x++) {
+            sink.pixel(0, 0, 0);
+        }
+
+        if (format == IMAGE_PIXEL_GRAY8) {
+            for (int x = 0; x < geom.targetWidth; x++) {
+                uint8_t v = (top[x] * nyFrac + bottom[x] * yFrac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+                sink.pixel(v, v, v);
+            }
+        }
+        for (int x = 0; format != IMAGE_PIXEL_GRAY8 && x < geom.targetWidth * 3; x += 3) {
+            uint8_t r = (top[x] * nyFrac + bottom[x] * yFrac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+            uint8_t g = (top[x + 1] * nyFrac + bottom[x + 1] * yFrac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+            uint8_t b = (top[x + 2] * nyFrac + bottom[x + 2] * yFrac + IMAGE_RESIZE_FRAC_VAL / 2) >> IMAGE_RESIZE_FRAC_BITS;
+            sink.pixel(r, g, b);
+        }
+
+        for (int x = geom.targetX + geom.targetWidth; x < dstWidth; x++) {
+            sink.pixel(0, 0, 0);
+        }
+    }
+
+    // Faixa preta inferior (FIT_LONGEST)
+    for (int i = (geom.targetY + geom.targetHeight) * dstWidth; i < dstWidth * dstHeight; i++) {
+        sink.pixel(0, 0, 0);
+    }
+
+    return true;
+}
+
+template <typename Sink>
+bool resizeRgb565(const uint8_t* src, int srcWidth, int srcHeight,
+                  int dstWidth, int dstHeight, int mode,
+                  ResizeScratch& scratch, Sink& sink) {
+    return resizeFrame(src, srcWidth, srcHeight, IMAGE_PIXEL_RGB565, dstWidth, dstHeight, mode, scratch, sink);
+}
+
+template <typename Sink>
+bool resizeGray8(const uint8_t* src, int srcWidth, int srcHeight,
+                 int dstWidth, int dstHeight, int mode,
+                 ResizeScratch& scratch, Sink& sink) {
+    return resizeFrame(src, srcWidth, srcHeight, IMAGE_PIXEL_GRAY8, dstWidth, dstHeight, mode, scratch, sink);
+}
+
+#endif // IMAGE_RESIZE_H
@@ -0,0 +1,177 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+// Escritor de JSON em buffer fixo (pilha ou estático), sem alocação.
+// Vírgulas e aspas são colocadas automaticamente; se o buffer acabar, a
+// saída é marcada como estourada (ok() == false) e nada além do limite é escrito.
+// Não depende do Arduino (usado no host).
+//
+//   char body[256];
+//   JsonWriter json(body, sizeof(body));
+//   json.beginObject().field("stage", "Enxague").field("confidence", 0.87).endObject();
+//   if (json.ok()) conn.send(200, "application/json", json.c_str(), json.length());
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+struct JsonWriter {
+    char* buffer;
+    size_t size;
+    size_t len;
+    bool overflow;
+    bool comma;                     // próximo elemento precisa de vírgula
+
+    JsonWriter(char* buffer, size_t size) : buffer(buffer), size(size), len(0), overflow(false), comma(false) {
+        if (size > 0) buffer[0] = '\0';
+    }
+
+    bool ok() const { return !overflow; }
+    const char* c_str() const { return buffer; }
+    size_t length() const { return len; }
+
+    JsonWriter& beginObject() { separator(); raw('{'); comma = false; return *this; }
+    JsonWriter& endObject()   { raw('}'); comma = true; return *this; }
+    JsonWriter& beginArray()  { separator(); raw('['); comma = false; return *this; }
+    JsonWriter& endArray()    { raw(']'); comma = true; return *this; }
+
+    JsonWriter& key(const char* name) {
+        separator();
+        quoted(name);
+        raw(':');
+        comma = false;
+        return *this;
+    }
+
+    // Valores (em objeto, depois de key(); em array, direto)
+    JsonWriter& value(const char* text)     { separator(); quoted(text); comma = true; return *this; }
+    JsonWriter& value(bool v)               { separator(); raw(v ? "true" : "false"); comma = true; return *this; }
+    JsonWriter& value(int v)                { return integer(v < 0, v < 0 ? 0ULL - (unsigned long long)v : v); }
+    JsonWriter& value(unsigned int v)       { return integer(false, v); }
+    JsonWriter& value(long v)               { return integer(v < 0, v < 0 ? 0ULL - (unsigned long long)v : v); }
+    JsonWriter& value(unsigned long v)      { return integer(false, v); }
+    JsonWriter& value(long long v)          { return integer(v < 0, v < 0 ? 0ULL - (unsigned long long)v : v); }
+    JsonWriter& value(unsigned long long v) { return integer(false, v); }
+    JsonWriter& value(double v)             { return number(v, 2); }
+
+    // Ponto flutuante com casas decimais fixas (até 6); NaN/infinito viram null.
+    // Sem snprintf: arredonda metade para cima (difere de %.*f só em empates)
+    JsonWriter& number(double v, int decimals) {
+        separator();
+        comma = true;
+        if (isnan(v) || isinf(v)) {
+            raw("null", 4);
+            return *this;
+        }
+        if (decimals < 0) decimals = 0;
+        if (decimals > 6) decimals = 6;
+        if (fabs(v) >= 1e12) {
+            // Fora da faixa do caminho inteiro: snprintf
+            char text[48];
+            int n = snprintf(text, sizeof(text), "%.*f", decimals, v);
+            raw(text, n);
+            return *this;
+        }
+
+        static const uint32_t scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+        uint64_t scale = scales[decimals];
+        bool negative = v < 0;
+        uint64_t scaled = (uint64_t)((negative ? -v : v) * scale + 0.5);
+
+        char text[32];
+        char* end = text + sizeof(text);
+        char* p = end;
+        uint64_t fraction = scaled % scale;
+        for (int i = 0; i < decimals; i++) {
+            *--p = '0' + fraction % 10;
+            fraction /= 10;
+        }
+        if (decimals > 0) *--p = '.';
+        p = digits(p, scaled / scale);
+        if (negative && scaled != 0) *--p = '-';
+        raw(p, end - p);
+        return *this;
+    }
+
+    template <typename T>
+    JsonWriter& field(const char* name, T v) { return key(name).value(v); }
+
+    JsonWriter& field(const char* name, double v, int decimals) { return key(name).number(v, decimals); }
+
+    // =================== INTERNO ===================
+
+    void separator() {
+        if (comma) raw(',');
+    }
+
+    void raw(char c) {
+        raw(&c, 1);
+    }
+
+    void raw(const char* text) {
+        raw(text, strlen(text));
+    }
+
+    // Cópia em bloco; depois do primeiro estouro nada mais é escrito
+    void raw(const char* text, size_t n) {
+        if (!overflow && len + n < size) {
+            memcpy(buffer + len, text, n);
+            len += n;
+            buffer[len] = '\0';
+        } else {
+            overflow = true;
+        }
+    }
+
+    static char* digits(char* p, unsigned long long v) {
+        do {
+            *--p = '0' + v % 10;
+            v /= 10;
+        } while (v);
+        return p;
+    }
+
+    JsonWriter& integer(bool negative, unsigned long long magnitude) {
+        separator();
+        char text[24];
+        char* end = text + sizeof(text);
+        char* p = digits(end, magnitude);
+        if (negative) *--p = '-';
+        raw(p, end - p);
+        comma = true;
+        return *this;
+    }
+
+    void quoted(const char* text) {
+        raw('"');
+        const char* run = text;         // trecho sem escape, copiado em bloco
+        for (const char* p = text; ; p++) {
+            unsigned char c = *p;
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;               // UTF-8 passa direto
+            }
+            raw(run, p - run);
+            if (c == '\0') {
+                break;
+            }
+            switch (c) {
+                case '"':  raw("\\\"", 2); break;
+                case '\\': raw("\\\\", 2); break;
+                case '\n': raw("\\n", 2); break;
+                case '\r': raw("\\r", 2); break;
+                case '\t': raw("\\t", 2); break;
+                default: {
+                    static const char hex[] = "0123456789abcdef";
+                    char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+                    raw(escaped, 6);
+                }
+            }
+            run = p + 1;
+        }
+        raw('"');
+    }
+};
+
+#endif // JSON_WRITER_H
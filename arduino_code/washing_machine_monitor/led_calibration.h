@@ -0,0 +1,328 @@
+#ifndef LED_CALIBRATION_H
+#define LED_CALIBRATION_H
+
+// Calibração dos LEDs do painel (posições gravadas pela interface web, tabela
+// de decisão aprendida com a CNN) e caminho rápido por LED antes da CNN.
+
+#include <Preferences.h>
+#include <andreluiz-project-1_inferencing.h>
+#include "config.h"
+#include "camera_manager.h"
+#include "led_features.h"
+#include "json_writer.h"
+
+#ifndef LED_VERIFY_EVERY
+#define LED_VERIFY_EVERY            20    // A cada N acertos do caminho rápido, confere com a CNN
+#endif
+
+#ifndef LED_LEARN_CONFIDENCE
+#define LED_LEARN_CONFIDENCE        0.85  // Confiança mínima da CNN para aprender um padrão
+#endif
+
+// Resposta do caminho rápido
+enum LedDecision {
+    LED_DECISION_HIT,               // resultado preenchido pela tabela de decisão
+    LED_DECISION_UNSURE,            // leitura duvidosa ou padrão desconhecido: CNN (ou reuso)
+    LED_DECISION_VERIFY             // vez da conferência: a CNN roda mesmo com o painel parado
+};
+
+// =================== VARIÁVEIS GLOBAIS ===================
+LedCalibration ledCalibration;
+LedReading ledLastReading;
+SemaphoreHandle_t ledCalibrationLock = NULL;
+volatile bool ledCalibrationDirty = false;
+
+// Estatísticas do caminho rápido
+volatile uint32_t ledFastHits = 0;          // classificados só pelos LEDs
+volatile uint32_t ledFastFallbacks = 0;     // caminho rápido sem certeza -> CNN
+volatile uint32_t ledVerifications = 0;     // CNN rodada para conferir a tabela
+volatile uint32_t ledLastReadUs = 0;
+volatile uint32_t ledLastFastUs = 0;
+uint32_t ledHitsSinceVerify = 0;
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool initializeLedCalibration();
+bool saveLedCalibration();
+void saveLedCalibrationIfDirty();
+bool setLedSpots(const LedSpot* spots, int count);
+bool recordLedPattern(int label);
+void readLedsFromFrame(const CameraFrameSource* frame, LedReading& reading);
+LedDecision classifyWithLeds(const LedReading& reading, ei_impulse_result_t* result);
+void learnLedsFromResult(const LedReading& reading, const ei_impulse_result_t* result);
+void writeLedCalibrationJSON(JsonWriter& json);
+
+// =================== IMPLEMENTAÇÃO ===================
+
+bool initializeLedCalibration() {
+    if (!ledCalibrationLock) {
+        ledCalibrationLock = xSemaphoreCreateMutex();
+    }
+    resetLedCalibration(ledCalibration);
+    ledLastReading.valid = false;
+
+    Preferences prefs;
+    if (!prefs.begin("led_cal", true)) {
+        Serial.println("AVISO: Calibracao de LEDs nao encontrada");
+        return false;
+    }
+
+    LedCalibration stored;
+    size_t len = prefs.getBytes("cal", &stored, sizeof(stored));
+    prefs.end();
+
+    if (len != sizeof(stored) || stored.version != LED_CALIBRATION_VERSION || stored.spotCount > LED_MAX_SPOTS) {
+        Serial.println("Calibracao de LEDs ausente - caminho rapido desativado");
+        return false;
+    }
+
+    ledCalibration = stored;
+    Serial.printf("Calibracao de LEDs: %d LEDs, %d padroes%s\n",
+                 ledCalibration.spotCount, ledCalibration.patternCount,
+                 ledCalibration.drifted ? " (DERIVA - recalibrar)" : "");
+    return true;
+}
+
+bool saveLedCalibration() {
+    LedCalibration copy;
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    copy = ledCalibration;
+    ledCalibrationDirty = false;
+    xSemaphoreGive(ledCalibrationLock);
+
+    Preferences prefs;
+    if (!prefs.begin("led_cal", false)) {
+        Serial.println("ERRO: Falha ao abrir NVS para calibracao");
+        return false;
+    }
+    bool ok = prefs.putBytes("cal", &copy, sizeof(copy)) == sizeof(copy);
+    prefs.end();
+
+    if (!ok) {
+        Serial.println("ERRO: Falha ao gravar calibracao de LEDs");
+    }
+    return ok;
+}
+
+// Padrões aprendidos pela inferência são gravados pela manutenção (fora das tarefas ML)
+void saveLedCalibrationIfDirty() {
+    if (ledCalibrationDirty) {
+        saveLedCalibration();
+    }
+}
+
+bool setLedSpots(const LedSpot* spots, int count) {
+    if (count < 0 || count > LED_MAX_SPOTS) {
+        Serial.printf("ERRO: Numero de LEDs invalido: %d\n", count);
+        return false;
+    }
+
+    // Novas posições: tabela de decisão e deriva começam do zero
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    resetLedCalibration(ledCalibration);
+    for (int i = 0; i < count; i++) {
+        ledCalibration.spots[i] = spots[i];
+    }
+    ledCalibration.spotCount = count;
+    ledLastReading.valid = false;
+    xSemaphoreGive(ledCalibrationLock);
+
+    ledHitsSinceVerify = 0;
+    Serial.printf("Calibracao de LEDs: %d posicoes gravadas\n", count);
+    return saveLedCalibration();
+}
+
+// Gravação manual: padrão de LEDs atual -> etapa informada pelo usuário
+bool recordLedPattern(int label) {
+    if (label < 0 || label >= EI_CLASSIFIER_LABEL_COUNT) {
+        return false;
+    }
+
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    LedReading reading = ledLastReading;
+    bool ok = reading.valid && reading.sure;
+    if (ok) {
+        learnLedPattern(ledCalibration, reading, label);
+        LedPattern* pattern = findLedPattern(ledCalibration, reading.mask);
+        if (pattern && pattern->confirmations < LED_MIN_CONFIRMATIONS) {
+            pattern->confirmations = LED_MIN_CONFIRMATIONS;
+        }
+    }
+    xSemaphoreGive(ledCalibrationLock);
+
+    if (!ok) {
+        Serial.println("AVISO: Leitura dos LEDs duvidosa, padrao nao gravado");
+        return false;
+    }
+    Serial.printf("Padrao de LEDs 0x%02X gravado como %s\n", reading.mask, ei_classifier_inferencing_categories[label]);
+    return saveLedCalibration();
+}
+
+// Leitura dos LEDs no frame RGB565 ou cinza da câmera (alguns microssegundos)
+void readLedsFromFrame(const CameraFrameSource* frame, LedReading& reading) {
+    reading.valid = false;
+    if (!ledCalibrationLock) {
+        return;
+    }
+
+    unsigned long start = micros();
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    if (ledCalibration.spotCount > 0 && !frame->window.sensor) {
+        readLeds(ledCalibration, frame->buf, frame->width, frame->height, reading, frame->grayscale);
+        ledLastReading = reading;
+    } else if (ledCalibration.spotCount > 0) {
+        // Janela do sensor: posições (referência) -> pixels do frame. Um LED fora
+        // da janela, ou pequeno demais no frame, deixa a leitura inválida e a CNN decide
+        static LedCalibration windowed;
+        windowed = ledCalibration;
+        bool inside = cameraWindowScale(frame->window) <= LED_MAX_WINDOW_SCALE;
+        for (int i = 0; i < windowed.spotCount && inside; i++) {
+            int x, y;
+            inside = cameraReferenceToOutput(frame->window, ledCalibration.spots[i].x, ledCalibration.spots[i].y, x, y);
+            windowed.spots[i].x = (int16_t)x;
+            windowed.spots[i].y = (int16_t)y;
+        }
+        if (inside) {
+            readLeds(windowed, frame->buf, frame->width, frame->height, reading, frame->grayscale);
+            ledLastReading = reading;
+        }
+    }
+    xSemaphoreGive(ledCalibrationLock);
+    ledLastReadUs = micros() - start;
+}
+
+// Preenche o resultado pela tabela de decisão (LED_DECISION_HIT). Sem certeza
+// (leitura duvidosa, padrão desconhecido, deriva) a CNN pode ser trocada pelo
+// resultado reaproveitado; na conferência não, senão a tabela nunca é conferida
+LedDecision classifyWithLeds(const LedReading& reading, ei_impulse_result_t* result) {
+    if (!reading.valid || !ledCalibrationLock) {
+        return LED_DECISION_UNSURE;
+    }
+
+    unsigned long start = micros();
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    bool wasDrifted = ledCalibration.drifted;
+    int label = classifyLeds(ledCalibration, reading);
+    float confidence = ledReadingConfidence(ledCalibration, reading);
+    bool nowDrifted = ledCalibration.drifted;
+    if (nowDrifted != wasDrifted) {
+        ledCalibrationDirty = true;
+    }
+    xSemaphoreGive(ledCalibrationLock);
+
+    if (nowDrifted && !wasDrifted) {
+        Serial.println("AVISO: LEDs sempre em leitura duvidosa - caminho rapido desativado, recalibre");
+    }
+    if (label < 0) {
+        ledFastFallbacks++;
+        return LED_DECISION_UNSURE;
+    }
+
+    if (++ledHitsSinceVerify >= LED_VERIFY_EVERY) {
+        ledHitsSinceVerify = 0;
+        ledVerifications++;
+        return LED_DECISION_VERIFY;
+    }
+
+    memset(result, 0, sizeof(*result));
+    for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        result->classification[i].label = ei_classifier_inferencing_categories[i];
+        result->classification[i].value = (i == label) ? confidence : 0.0f;
+    }
+
+    ledFastHits++;
+    ledLastFastUs = micros() - start;
+    return LED_DECISION_HIT;
+}
+
+// Resultado confiável da CNN: aprende ou confere o padrão de LEDs lido no mesmo frame
+void learnLedsFromResult(const LedReading& reading, const ei_impulse_result_t* result) {
+    if (!reading.valid || !ledCalibrationLock) {
+        return;
+    }
+
+    int label = -1;
+    float best = 0;
+    for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        if (result->classification[i].value > best) {
+            best = result->classification[i].value;
+            label = i;
+        }
+    }
+    if (best < LED_LEARN_CONFIDENCE) {
+        return;
+    }
+
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    bool wasDrifted = ledCalibration.drifted;
+    uint8_t patternCount = ledCalibration.patternCount;
+    bool agreed = learnLedPattern(ledCalibration, reading, label);
+    bool nowDrifted = ledCalibration.drifted;
+    LedPattern* pattern = findLedPattern(ledCalibration, reading.mask);
+    
+    // Só grava na NVS quando a tabela muda de fato (evita desgaste da flash)
+    if (!agreed || nowDrifted != wasDrifted || patternCount != ledCalibration.patternCount ||
+        (pattern && pattern->confirmations == LED_MIN_CONFIRMATIONS)) {
+        ledCalibrationDirty = true;
+    }
+    xSemaphoreGive(ledCalibrationLock);
+
+    if (!agreed) {
+        Serial.printf("AVISO: Padrao de LEDs 0x%02X diverge da CNN (%s)\n",
+                     reading.mask, ei_classifier_inferencing_categories[label]);
+    }
+    if (nowDrifted && !wasDrifted) {
+        Serial.println("AVISO: Calibracao de LEDs em deriva - caminho rapido desativado, recalibre");
+    }
+}
+
+void writeLedCalibrationJSON(JsonWriter& json) {
+    LedCalibration cal;
+    LedReading reading;
+    xSemaphoreTake(ledCalibrationLock, portMAX_DELAY);
+    cal = ledCalibration;
+    reading = ledLastReading;
+    xSemaphoreGive(ledCalibrationLock);
+
+    json.beginObject();
+    json.field("max_spots", LED_MAX_SPOTS);
+    json.key("labels").beginArray();
+    for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        json.value(ei_classifier_inferencing_categories[i]);
+    }
+    json.endArray();
+    json.field("drifted", cal.drifted);
+    json.field("threshold", cal.threshold);
+
+    json.key("spots").beginArray();
+    for (int i = 0; i < cal.spotCount; i++) {
+        json.beginObject().field("x", cal.spots[i].x).field("y", cal.spots[i].y);
+        if (reading.valid) {
+            json.field("intensity", reading.intensity[i]);
+        }
+        json.endObject();
+    }
+    json.endArray();
+
+    json.key("patterns").beginArray();
+    for (int i = 0; i < cal.patternCount; i++) {
+        json.beginObject()
+            .field("mask", cal.patterns[i].mask)
+            .field("stage", ei_classifier_inferencing_categories[cal.patterns[i].label])
+            .field("confirmations", cal.patterns[i].confirmations)
+            .endObject();
+    }
+    json.endArray();
+
+    json.field("mask", reading.valid ? reading.mask : 0);
+    json.field("sure", reading.valid && reading.sure);
+    json.field("fast_hits", ledFastHits);
+    json.field("fast_fallbacks", ledFastFallbacks);
+    json.field("verifications", ledVerifications);
+    json.field("read_us", ledLastReadUs);
+    json.field("fast_us", ledLastFastUs);
+    json.key("window");
+    writeCameraWindowJSON(json, readCameraWindow());
+    json.endObject();
+}
+
+#endif // LED_CALIBRATION_H
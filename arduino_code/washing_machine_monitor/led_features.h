@@ -0,0 +1,223 @@
+#ifndef LED_FEATURES_H
+#define LED_FEATURES_H
+
+// Caminho rápido por LED: intensidade média de cada LED do painel (posições
+// calibradas pela interface web) -> máscara acesa/apagada -> tabela de decisão.
+// Custa alguns microssegundos por frame; a CNN só roda quando a leitura é
+// duvidosa, o padrão é desconhecido ou a calibração deixou de bater.
+// Não depende do Arduino (usado no host).
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef LED_MAX_SPOTS
+#define LED_MAX_SPOTS               8     // LEDs calibráveis no painel
+#endif
+
+#ifndef LED_MAX_PATTERNS
+#define LED_MAX_PATTERNS            16    // Entradas da tabela de decisão
+#endif
+
+#ifndef LED_SPOT_RADIUS
+#define LED_SPOT_RADIUS             2     // Janela (2r+1)x(2r+1) em volta do LED
+#endif
+
+#ifndef LED_MAX_WINDOW_SCALE
+#define LED_MAX_WINDOW_SCALE        2.0f  // Janela do sensor: px de referência por px do frame (LEDs somem acima)
+#endif
+
+#ifndef LED_ON_THRESHOLD
+#define LED_ON_THRESHOLD            140   // Luma média acima disso = LED aceso
+#endif
+
+#ifndef LED_UNSURE_BAND
+#define LED_UNSURE_BAND             25    // +/- em volta do limiar = leitura duvidosa
+#endif
+
+#ifndef LED_MIN_CONFIRMATIONS
+#define LED_MIN_CONFIRMATIONS       3     // Confirmações da CNN antes de confiar no padrão
+#endif
+
+#ifndef LED_MAX_CONFLICTS
+#define LED_MAX_CONFLICTS           3     // Divergências com a CNN até marcar deriva
+#endif
+
+#ifndef LED_DRIFT_UNSURE_STREAK
+#define LED_DRIFT_UNSURE_STREAK     30    // Leituras duvidosas seguidas até marcar deriva
+#endif
+
+#define LED_CALIBRATION_VERSION     1
+
+struct LedSpot {
+    int16_t x, y;                   // coordenadas no frame da câmera (vista inteira, QVGA)
+};
+
+struct LedPattern {
+    uint16_t mask;                  // bit i = LED i aceso
+    int8_t label;                   // índice da classe do modelo
+    uint8_t confirmations;
+};
+
+struct LedCalibration {
+    uint8_t version;
+    uint8_t spotCount;
+    uint8_t patternCount;
+    bool drifted;                   // calibração não bate mais com a CNN
+    uint8_t threshold;
+    uint8_t band;
+    uint8_t conflicts;
+    uint16_t unsureStreak;
+    LedSpot spots[LED_MAX_SPOTS];
+    LedPattern patterns[LED_MAX_PATTERNS];
+};
+
+struct LedReading {
+    uint8_t intensity[LED_MAX_SPOTS];
+    uint16_t mask;
+    uint8_t minMargin;              // menor distância ao limiar entre os LEDs
+    bool sure;                      // todos os LEDs fora da faixa de dúvida
+    bool valid;                     // havia calibração no momento da leitura
+};
+
+// =================== FUNÇÕES ===================
+
+inline void resetLedCalibration(LedCalibration& cal) {
+    cal.version = LED_CALIBRATION_VERSION;
+    cal.spotCount = 0;
+    cal.patternCount = 0;
+    cal.drifted = false;
+    cal.threshold = LED_ON_THRESHOLD;
+    cal.band = LED_UNSURE_BAND;
+    cal.conflicts = 0;
+    cal.unsureStreak = 0;
+}
+
+// Luma média da janela em volta do LED, direto do RGB565 (little endian)
+// ou do frame em escala de cinza
+inline uint8_t measureLedIntensity(const uint8_t* src, int width, int height, const LedSpot& spot,
+                                   bool grayscale = false) {
+    int x0 = spot.x - LED_SPOT_RADIUS, x1 = spot.x + LED_SPOT_RADIUS;
+    int y0 = spot.y - LED_SPOT_RADIUS, y1 = spot.y + LED_SPOT_RADIUS;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= width) x1 = width - 1;
+    if (y1 >= height) y1 = height - 1;
+
+    uint32_t sum = 0;
+    uint32_t count = 0;
+    for (int y = y0; y <= y1; y++) {
+        if (grayscale) {
+            const uint8_t* p = src + y * width + x0;
+            for (int x = x0; x <= x1; x++) {
+                sum += *p++;
+                count++;
+            }
+            continue;
+        }
+        const uint8_t* p = src + (y * width + x0) * 2;
+        for (int x = x0; x <= x1; x++, p += 2) {
+            uint16_t pixel = (p[1] << 8) | p[0];
+            // Canais em 8 bits (sem replicar bits: basta para comparar com o limiar)
+            uint32_t r = (pixel >> 8) & 0xF8;
+            uint32_t g = (pixel >> 3) & 0xFC;
+            uint32_t b = (pixel << 3) & 0xF8;
+            sum += (r * 19595 + g * 38470 + b * 7471) >> 16;
+            count++;
+        }
+    }
+    return count ? sum / count : 0;
+}
+
+// Lê todos os LEDs calibrados e monta a máscara acesa/apagada
+inline void readLeds(const LedCalibration& cal, const uint8_t* src, int width, int height, LedReading& reading,
+                     bool grayscale = false) {
+    reading.mask = 0;
+    reading.minMargin = 255;
+    reading.sure = cal.spotCount > 0;
+    reading.valid = cal.spotCount > 0;
+
+    for (int i = 0; i < cal.spotCount; i++) {
+        uint8_t v = measureLedIntensity(src, width, height, cal.spots[i], grayscale);
+        reading.intensity[i] = v;
+
+        int margin = (int)v - (int)cal.threshold;
+        if (margin > 0) {
+            reading.mask |= (1 << i);
+        }
+        if (margin < 0) margin = -margin;
+        if (margin < reading.minMargin) reading.minMargin = margin;
+        if (margin < cal.band) reading.sure = false;
+    }
+}
+
+inline LedPattern* findLedPattern(LedCalibration& cal, uint16_t mask) {
+    for (int i = 0; i < cal.patternCount; i++) {
+        if (cal.patterns[i].mask == mask) {
+            return &cal.patterns[i];
+        }
+    }
+    return nullptr;
+}
+
+// Classe pela tabela de decisão, ou -1 se o caminho rápido não tem certeza
+inline int classifyLeds(LedCalibration& cal, const LedReading& reading) {
+    if (!reading.valid || cal.drifted || cal.spotCount == 0) {
+        return -1;
+    }
+    if (!reading.sure) {
+        cal.unsureStreak++;
+        if (cal.unsureStreak >= LED_DRIFT_UNSURE_STREAK) {
+            cal.drifted = true;     // LEDs sempre na faixa de dúvida: câmera ou luz mudou
+        }
+        return -1;
+    }
+    cal.unsureStreak = 0;
+
+    LedPattern* pattern = findLedPattern(cal, reading.mask);
+    if (!pattern || pattern->confirmations < LED_MIN_CONFIRMATIONS) {
+        return -1;
+    }
+    return pattern->label;
+}
+
+// Confiança do caminho rápido a partir da margem ao limiar (0.5 - 1.0)
+inline float ledReadingConfidence(const LedCalibration& cal, const LedReading& reading) {
+    float confidence = 0.5f + reading.minMargin / (4.0f * cal.band);
+    return confidence > 1.0f ? 1.0f : confidence;
+}
+
+// Aprende/confirma o padrão com uma classificação confiável da CNN.
+// Retorna false quando a tabela discordava da CNN (conta para a deriva).
+inline bool learnLedPattern(LedCalibration& cal, const LedReading& reading, int label) {
+    if (!reading.valid || !reading.sure || label < 0) {
+        return true;
+    }
+
+    LedPattern* pattern = findLedPattern(cal, reading.mask);
+    if (!pattern) {
+        if (cal.patternCount >= LED_MAX_PATTERNS) {
+            return true;
+        }
+        pattern = &cal.patterns[cal.patternCount++];
+        pattern->mask = reading.mask;
+        pattern->label = label;
+        pattern->confirmations = 0;
+    }
+
+    if (pattern->label != label) {
+        // Padrão reaprendido do zero; deriva se isso se repetir
+        pattern->label = label;
+        pattern->confirmations = 1;
+        if (++cal.conflicts >= LED_MAX_CONFLICTS) {
+            cal.drifted = true;
+        }
+        return false;
+    }
+
+    if (pattern->confirmations < 255) {
+        pattern->confirmations++;
+    }
+    return true;
+}
+
+#endif // LED_FEATURES_H
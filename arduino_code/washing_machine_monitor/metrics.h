@@ -0,0 +1,184 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+// Métricas no formato texto do Prometheus (text/plain; version=0.0.4):
+// histogramas de latência com faixas fixas, contadores e medidores.
+// Cada histograma tem um único escritor (a tarefa que executa a etapa) e é
+// atualizado sem locks por um seqlock: o escritor nunca espera, e o leitor
+// (/metrics) repete a cópia se pegar uma escrita no meio. Contadores são
+// atômicos de 32 bits (fetch_add, vários escritores).
+// Não depende do Arduino (usado no host).
+//
+//   LatencyHistogram invoke;
+//   invoke.observe(152000);                 // microssegundos
+//   HistogramSnapshot s;
+//   invoke.snapshot(s);
+//   writeHistogram(text, "washer_stage_duration_seconds", "stage=\"invoke\"", s);
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <atomic>
+
+#ifndef METRICS_SNAPSHOT_RETRIES
+#define METRICS_SNAPSHOT_RETRIES    64      // Cópias tentadas antes de aceitar uma leitura no meio da escrita
+#endif
+
+// Limites superiores das faixas (us), de 100 us a 2,5 s; a última faixa é +Inf
+#define METRICS_BUCKET_COUNT        14
+
+static const uint32_t METRICS_BUCKETS_US[METRICS_BUCKET_COUNT] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000,
+    100000, 250000, 500000, 1000000, 2500000
+};
+
+// Os mesmos limites em segundos, como o Prometheus espera no rótulo "le"
+static const char* const METRICS_BUCKET_LABELS[METRICS_BUCKET_COUNT] = {
+    "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.025", "0.05",
+    "0.1", "0.25", "0.5", "1", "2.5"
+};
+
+// Cópia consistente de um histograma (faixas não cumulativas)
+struct HistogramSnapshot {
+    uint32_t buckets[METRICS_BUCKET_COUNT + 1];
+    uint64_t sumUs;
+    uint32_t count;
+};
+
+struct LatencyHistogram {
+    std::atomic<uint32_t> sequence{0};      // ímpar = escrita em andamento
+    std::atomic<uint32_t> buckets[METRICS_BUCKET_COUNT + 1] = {};
+    std::atomic<uint32_t> sumLow{0};        // soma em us (64 bits em duas metades)
+    std::atomic<uint32_t> sumHigh{0};
+
+    static int bucketFor(uint32_t us) {
+        int b = 0;
+        while (b < METRICS_BUCKET_COUNT && us > METRICS_BUCKETS_US[b]) {
+            b++;
+        }
+        return b;
+    }
+
+    // Só o escritor do histograma chama
+    void observe(uint32_t us) {
+        int b = bucketFor(us);
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        buckets[b].store(buckets[b].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        uint32_t low = sumLow.load(std::memory_order_relaxed);
+        uint32_t next = low + us;
+        sumLow.store(next, std::memory_order_relaxed);
+        if (next < low) {
+            sumHigh.store(sumHigh.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Qualquer tarefa. false se todas as tentativas pegaram uma escrita no meio
+    // (a cópia fica com a última tentativa; count sai sempre da soma das faixas)
+    bool snapshot(HistogramSnapshot& out) const {
+        bool consistent = false;
+        for (int attempt = 0; attempt < METRICS_SNAPSHOT_RETRIES && !consistent; attempt++) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            for (int b = 0; b <= METRICS_BUCKET_COUNT; b++) {
+                out.buckets[b] = buckets[b].load(std::memory_order_relaxed);
+            }
+            out.sumUs = ((uint64_t)sumHigh.load(std::memory_order_relaxed) << 32) |
+                        sumLow.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            consistent = (before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before;
+        }
+
+        out.count = 0;
+        for (int b = 0; b <= METRICS_BUCKET_COUNT; b++) {
+            out.count += out.buckets[b];
+        }
+        return consistent;
+    }
+};
+
+typedef std::atomic<uint32_t> MetricsCounter;
+
+// Maior valor já visto (ex.: marca d'água da arena)
+inline void metricsRaise(MetricsCounter& gauge, uint32_t value) {
+    uint32_t current = gauge.load(std::memory_order_relaxed);
+    while (value > current && !gauge.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// =================== TEXTO ===================
+
+// Saída em buffer fixo, como o JsonWriter: se o buffer acabar, ok() == false
+// e o chamador descarta o pedaço (o /metrics manda um item por vez)
+struct MetricsWriter {
+    char* buffer;
+    size_t size;
+    size_t len;
+    bool overflow;
+
+    MetricsWriter(char* buffer, size_t size) : buffer(buffer), size(size), len(0), overflow(false) {
+        if (size > 0) buffer[0] = '\0';
+    }
+
+    bool ok() const { return !overflow; }
+    size_t length() const { return len; }
+
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (overflow) {
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buffer + len, size - len, format, args);
+        va_end(args);
+        if (n < 0 || (size_t)n >= size - len) {
+            overflow = true;
+            buffer[len] = '\0';
+            return;
+        }
+        len += n;
+    }
+};
+
+inline void writeMetricHeader(MetricsWriter& out, const char* name, const char* type, const char* help) {
+    out.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Amostra de contador ou medidor; labels sem chaves (ex.: "reason=\"leds\"") ou nullptr
+inline void writeMetricSample(MetricsWriter& out, const char* name, const char* labels, uint32_t value) {
+    if (labels && labels[0]) {
+        out.printf("%s{%s} %lu\n", name, labels, (unsigned long)value);
+    } else {
+        out.printf("%s %lu\n", name, (unsigned long)value);
+    }
+}
+
+// Linhas _bucket (cumulativas), _sum (s) e _count de um histograma
+inline void writeHistogram(MetricsWriter& out, const char* name, const char* labels, const HistogramSnapshot& s) {
+    const char* sep = labels && labels[0] ? "," : "";
+    if (!labels) labels = "";
+
+    uint32_t cumulative = 0;
+    for (int b = 0; b < METRICS_BUCKET_COUNT; b++) {
+        cumulative += s.buckets[b];
+        out.printf("%s_bucket{%s%sle=\"%s\"} %lu\n", name, labels, sep, METRICS_BUCKET_LABELS[b],
+                   (unsigned long)cumulative);
+    }
+    out.printf("%s_bucket{%s%sle=\"+Inf\"} %lu\n", name, labels, sep, (unsigned long)s.count);
+
+    if (labels[0]) {
+        out.printf("%s_sum{%s} %lu.%06lu\n%s_count{%s} %lu\n", name, labels,
+                   (unsigned long)(s.sumUs / 1000000), (unsigned long)(s.sumUs % 1000000),
+                   name, labels, (unsigned long)s.count);
+    } else {
+        out.printf("%s_sum %lu.%06lu\n%s_count %lu\n", name,
+                   (unsigned long)(s.sumUs / 1000000), (unsigned long)(s.sumUs % 1000000),
+                   name, (unsigned long)s.count);
+    }
+}
+
+#endif // METRICS_H
@@ -0,0 +1,170 @@
+#ifndef MJPEG_STREAM_H
+#define MJPEG_STREAM_H
+
+// Transmissão ao vivo (/stream, MJPEG) com os mesmos frames da inferência:
+//   captura (ML): copia o RGB565 para o buffer de preview, na taxa reduzida
+//                 e só se há cliente e o codificador está livre
+//   tarefa mjpeg: codifica o JPEG e entrega à tarefa do servidor web
+//   servidor web: envia o mesmo JPEG a todos os clientes; quem ainda está
+//                 no frame anterior pula este. O /snapshot à espera recebe
+//                 o mesmo JPEG, e o último fica guardado para o próximo
+// Nunca pede captura extra à câmera e nunca faz a captura esperar pela rede.
+
+#include <atomic>
+#include "esp_camera.h"
+#include "img_converters.h"
+#include "config.h"
+#include "http_server.h"
+
+#ifndef STREAM_INTERVAL
+#define STREAM_INTERVAL             200     // ms mínimos entre frames do /stream (5 fps)
+#endif
+
+#ifndef STREAM_JPEG_QUALITY
+#define STREAM_JPEG_QUALITY         60      // 0-100 (fmt2jpg)
+#endif
+
+#ifndef STREAM_MAX_CLIENTS
+#define STREAM_MAX_CLIENTS          2
+#endif
+
+#ifndef STREAM_ENCODER_CORE
+#define STREAM_ENCODER_CORE         0
+#endif
+
+#ifndef STREAM_ENCODER_STACK
+#define STREAM_ENCODER_STACK        4096
+#endif
+
+#define STREAM_RAW_EMPTY            0
+#define STREAM_RAW_FILLING          1
+#define STREAM_RAW_READY            2
+
+// =================== VARIÁVEIS GLOBAIS ===================
+uint8_t* streamRaw = nullptr;                   // cópia RGB565 do frame (PSRAM)
+size_t streamRawSize = 0;
+size_t streamRawLen = 0;
+uint16_t streamRawWidth = 0;
+uint16_t streamRawHeight = 0;
+pixformat_t streamRawFormat = PIXFORMAT_RGB565;
+std::atomic<uint8_t> streamRawState{STREAM_RAW_EMPTY};
+
+std::atomic<HttpSharedBody*> streamPending{nullptr};  // JPEG pronto para a tarefa web
+TaskHandle_t streamEncoderHandle = NULL;
+volatile int streamClients = 0;                 // /stream + /snapshot à espera (tarefa web)
+unsigned long streamLastOffer = 0;
+
+// Estatísticas
+volatile uint32_t streamFramesEncoded = 0;
+volatile uint32_t streamEncoderBusy = 0;        // frames não copiados: codificador ocupado
+volatile uint32_t streamEncodeErrors = 0;
+volatile uint32_t streamLastEncodeUs = 0;
+volatile uint32_t streamLastJpegSize = 0;
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool initializeStream(size_t maxFrameSize);
+void offerStreamFrame(const camera_fb_t* fb);
+HttpSharedBody* takeStreamFrame();
+void streamEncoderTask(void* param);
+void printStreamStatistics();
+
+// =================== IMPLEMENTAÇÃO ===================
+
+bool initializeStream(size_t maxFrameSize) {
+    // 150 KB (QVGA RGB565) só cabem na PSRAM
+    if (!psramFound()) {
+        Serial.println("AVISO: Sem PSRAM - /stream desativado");
+        return false;
+    }
+
+    streamRaw = (uint8_t*)ps_malloc(maxFrameSize);
+    if (!streamRaw) {
+        Serial.println("ERRO: Falha ao alocar buffer do /stream");
+        return false;
+    }
+    streamRawSize = maxFrameSize;
+
+    xTaskCreatePinnedToCore(streamEncoderTask, "mjpeg", STREAM_ENCODER_STACK, NULL, 1,
+                            &streamEncoderHandle, STREAM_ENCODER_CORE);
+    Serial.printf("Stream MJPEG: ate %d fps, qualidade %d\n", 1000 / STREAM_INTERVAL, STREAM_JPEG_QUALITY);
+    return true;
+}
+
+// Chamado no caminho de captura da inferência, antes de devolver o frame.
+// Custo fora da taxa do stream: duas comparações; dentro dela: um memcpy
+void offerStreamFrame(const camera_fb_t* fb) {
+    if (streamClients == 0 || !streamRaw || !fb) {
+        return;
+    }
+    unsigned long now = millis();
+    if (now - streamLastOffer < STREAM_INTERVAL) {
+        return;
+    }
+    if (fb->len > streamRawSize) {
+        return;
+    }
+
+    uint8_t expected = STREAM_RAW_EMPTY;
+    if (!streamRawState.compare_exchange_strong(expected, STREAM_RAW_FILLING)) {
+        streamEncoderBusy++;
+        return;
+    }
+
+    memcpy(streamRaw, fb->buf, fb->len);
+    streamRawLen = fb->len;
+    streamRawWidth = fb->width;
+    streamRawHeight = fb->height;
+    streamRawFormat = fb->format;
+    streamLastOffer = now;
+
+    streamRawState.store(STREAM_RAW_READY);
+    xTaskNotifyGive(streamEncoderHandle);
+}
+
+// Tarefa web: JPEG novo, ou nullptr. A referência passa para quem chamou
+HttpSharedBody* takeStreamFrame() {
+    return streamPending.exchange(nullptr);
+}
+
+void streamEncoderTask(void* param) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (streamRawState.load() != STREAM_RAW_READY) {
+            continue;
+        }
+
+        unsigned long start = micros();
+        uint8_t* jpg = nullptr;
+        size_t jpgLen = 0;
+        bool ok = fmt2jpg(streamRaw, streamRawLen, streamRawWidth, streamRawHeight,
+                          streamRawFormat, STREAM_JPEG_QUALITY, &jpg, &jpgLen);
+        streamRawState.store(STREAM_RAW_EMPTY);
+
+        if (!ok) {
+            streamEncodeErrors++;
+            continue;
+        }
+        streamLastEncodeUs = micros() - start;
+        streamLastJpegSize = jpgLen;
+        streamFramesEncoded++;
+
+        // A tarefa web ainda não pegou o anterior: fica só o mais novo
+        HttpSharedBody* frame = httpSharedBodyCreate(jpg, jpgLen);
+        HttpSharedBody* stale = streamPending.exchange(frame);
+        if (stale) {
+            httpSharedBodyRelease(stale);
+        }
+    }
+}
+
+void printStreamStatistics() {
+    extern HttpServer httpServer;
+    Serial.printf("Stream MJPEG: %d clientes, %lu frames codificados (%lu us, %lu bytes), "
+                 "%lu enviados, %lu pulados por clientes lentos, %lu com codificador ocupado\n",
+                 streamClients, (unsigned long)streamFramesEncoded,
+                 (unsigned long)streamLastEncodeUs, (unsigned long)streamLastJpegSize,
+                 (unsigned long)httpServer.framesSent, (unsigned long)httpServer.framesDropped,
+                 (unsigned long)streamEncoderBusy);
+}
+
+#endif // MJPEG_STREAM_H
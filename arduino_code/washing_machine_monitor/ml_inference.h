@@ -4,23 +4,67 @@
 #include <andreluiz-project-1_inferencing.h>
 #include "config.h"
 #include "camera_manager.h"
+#include "led_calibration.h"
+#include "wash_cycle.h"
+#include "wash_stage.h"
+#include "prediction_scheduler.h"
+#include "cycle_history.h"
+#include "system_metrics.h"
+
+#ifndef PREDICTION_SCHEDULER
+#define PREDICTION_SCHEDULER        1       // 0 = intervalo fixo PREDICTION_INTERVAL
+#endif
 
 // =================== VARIÁVEIS GLOBAIS ===================
-extern String currentWashingStage;
-extern String lastWashingStage;
+extern WashStage currentWashingStage;
+extern WashStage lastWashingStage;
+
+static_assert(WASH_STAGE_COUNT == EI_CLASSIFIER_LABEL_COUNT, "WASH_STAGES precisa de uma etapa por classe do modelo");
 extern float lastConfidence;
 
-// Buffer para imagem redimensionada
-uint8_t resized_image[EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME];
+// Detector de mudança: reaproveita o último resultado quando o painel não mudou
+ChangeDetector changeDetector;
+ei_impulse_result_t lastMLResult;
+bool lastMLResultValid = false;
+
+// Contadores do detector no início do ciclo de lavagem atual
+uint32_t cycleStartGateHits = 0;
+uint32_t cycleStartGateMisses = 0;
+bool washCycleActive = false;
+
+// Decodificador temporal: ordem do ciclo e duração típica de cada etapa
+StageDecoderConfig stageDecoderConfig;
+StageDecoder stageDecoder;
+unsigned long lastDecoderUpdate = 0;
+
+// Agendador: intervalo até a próxima captura (lido pela tarefa de captura)
+PredictionScheduler predictionScheduler;
+volatile uint32_t predictionIntervalMs = PREDICTION_INTERVAL;
+
+// Replay de gravação (frame_replay.h): o decodificador anda no relógio da
+// gravação e o resultado fica nele (sem histórico, Sinric, LED nem aprendizado
+// dos LEDs)
+bool mlReplayActive = false;
+unsigned long mlReplayClockMs = 0;
+
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 0
+// Buffer para imagem redimensionada (RGB888), usado apenas por modelos float
+uint8_t resized_image[EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT * 3];
+#endif
 
 // =================== DECLARAÇÕES DE FUNÇÕES ===================
 bool initializeMLModel();
-String performMLPrediction();
-void processMLResult(ei_impulse_result_t* result);
+void deinitializeMLModel();
+int performMLPrediction();
+void processMLResult(ei_impulse_result_t* result, bool panelChanged);
+void configureStageDecoder();
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 0
 int getSignalData(size_t offset, size_t length, float *out_ptr);
+#endif
 void printDetailedPrediction(ei_impulse_result_t* result);
-void onStageChanged(String newStage, float confidence);
-void logStageChange(String stage, float confidence);
+void onStageChanged(WashStage newStage, float confidence);
+void logStageChange(WashStage stage, float confidence);
+void updateCycleGateStats(WashStage newStage);
 void printMLStatistics();
 bool validateModel();
 
@@ -33,7 +77,7 @@ bool initializeMLModel() {
     Serial.printf("Classes detectadas: %d\n", EI_CLASSIFIER_LABEL_COUNT);
     Serial.printf("Tamanho entrada: %dx%d\n", EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT);
     Serial.printf("Samples por frame: %d\n", EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME);
-    Serial.printf("Frequencia: %.1f Hz\n", EI_CLASSIFIER_FREQUENCY);
+    Serial.printf("Frequencia: %.1f Hz\n", (double)EI_CLASSIFIER_FREQUENCY);
     
     // Listar todas as classes disponíveis
     Serial.println("Classes disponíveis:");
@@ -52,11 +96,43 @@ bool initializeMLModel() {
         return false;
     }
     
+    // IDs de etapa (wash_stage.h) são os índices das classes
+    if (!washStagesMatchModel(ei_classifier_inferencing_categories, EI_CLASSIFIER_LABEL_COUNT)) {
+        Serial.println("ERRO: Classes do modelo diferentes de WASH_STAGES (wash_stage.h)");
+        return false;
+    }
+    
+    changeDetector.reset();
+    lastMLResultValid = false;
+    configureStageDecoder();
+    
+    // Sessão persistente: arena, interpretador e tensores alocados uma única vez
+    EI_IMPULSE_ERROR session_error = run_classifier_session_init();
+    if (session_error != EI_IMPULSE_OK) {
+        Serial.printf("ERRO: Falha ao iniciar sessao TFLite: %d\n", session_error);
+        return false;
+    }
+    
+    const ei_tflite_timing_t* setup = &ei_tflite_get_session()->setup_timing;
+    Serial.printf("Sessao TFLite: arena %lu us, interpretador %lu us, tensores %lu us\n",
+                 (unsigned long)setup->arena_alloc_us,
+                 (unsigned long)setup->interpreter_us,
+                 (unsigned long)setup->allocate_tensors_us);
+    Serial.printf("Arena utilizada: %u de %u bytes\n",
+                 (unsigned)setup->arena_used_bytes, (unsigned)EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE);
+    metricsObserveArena();
+    
     Serial.println("Modelo carregado e validado com sucesso!");
     return true;
 }
 
-String performMLPrediction() {
+void deinitializeMLModel() {
+    run_classifier_session_deinit();
+    Serial.println("Sessao TFLite liberada");
+}
+
+// Etapa decodificada depois deste frame, ou WASH_STAGE_ERROR
+int performMLPrediction() {
     static int predictionCount = 0;
     predictionCount++;
     
@@ -65,57 +141,133 @@ String performMLPrediction() {
     }
     
     // 1. Capturar imagem da câmera
+    unsigned long capture_start = micros();
     camera_fb_t* fb = captureImage();
     if (!fb) {
         Serial.println("Erro ao capturar imagem para ML");
-        return "erro";
+        metricsCountError(METRICS_ERROR_CAPTURE);
+        return WASH_STAGE_ERROR;
     }
+    metricsObserve(METRICS_CAPTURE, micros() - capture_start);
+    metricsCountFrame();
+    offerStreamFrame(fb);   // /stream reaproveita o frame da inferência
+    offerRecordFrame(fb);   // e o /record grava o mesmo frame cru
+    
+    ei_impulse_result_t result = {0};
+    
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
+    // 2-4. Frame RGB565 escrito direto no tensor int8 e inferência
+    CameraFrameSource frame;
+    makeCameraFrame(fb, frame);
+    
+    // Caminho rápido: LEDs calibrados e tabela de decisão (microssegundos)
+    LedReading leds;
+    readLedsFromFrame(&frame, leds);
+    LedDecision ledDecision = classifyWithLeds(leds, &result);
+    if (ledDecision == LED_DECISION_HIT) {
+        releaseCameraBuffer(fb);
+        metricsCountSkip(METRICS_SKIP_LEDS);
+        processMLResult(&result, false);
+        return currentWashingStage;
+    }
+    
+    // Painel igual ao do último frame classificado: reaproveitar o resultado
+    // (menos na conferência dos LEDs, que precisa da CNN neste frame)
+    FrameSignature signature;
+    computeFrameSignature(&frame, signature);
+    if (changeDetector.shouldReuse(signature, ledDecision == LED_DECISION_VERIFY) && lastMLResultValid) {
+        releaseCameraBuffer(fb);
+        metricsCountSkip(METRICS_SKIP_UNCHANGED);
+        result = lastMLResult;
+        processMLResult(&result, false);
+        return currentWashingStage;
+    }
+    
+    unsigned long inference_start = millis();
+    EI_IMPULSE_ERROR ei_error = run_classifier_image_quantized_direct(
+        &fillQuantizedInputFromFrame, &frame, &result, DEBUG_PREDICTIONS);
+    unsigned long inference_time = millis() - inference_start;
+    
+    releaseCameraBuffer(fb);
     
+    if (ei_error == EI_IMPULSE_OK) {
+        lastMLResult = result;
+        lastMLResultValid = true;
+        changeDetector.accept(signature);
+        if (!mlReplayActive) {
+            learnLedsFromResult(leds, &result);
+        }
+        // Caminho direto: o "DSP" é o redimensionamento + quantização no tensor
+        metricsObserve(METRICS_RESIZE, (uint32_t)result.timing.dsp_us);
+    }
+#else
     // 2. Redimensionar imagem para entrada do modelo
-    if (!resizeImageForML(fb->buf, fb->len, resized_image)) {
+    CameraFrameSource frame;
+    makeCameraFrame(fb, frame);
+    unsigned long resize_start = micros();
+    if (!resizeImageForML(&frame, resized_image)) {
         Serial.println("Erro ao redimensionar imagem para ML");
         releaseCameraBuffer(fb);
-        return "erro";
+        metricsCountError(METRICS_ERROR_CONVERT);
+        return WASH_STAGE_ERROR;
     }
+    metricsObserve(METRICS_RESIZE, micros() - resize_start);
     
     releaseCameraBuffer(fb);
     
     // 3. Preparar dados para inferência
-    ei_impulse_result_t result = {0};
     signal_t features_signal;
-    features_signal.total_length = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+    features_signal.total_length = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT;
     features_signal.get_data = &getSignalData;
     
     // 4. Executar inferência
     unsigned long inference_start = millis();
     EI_IMPULSE_ERROR ei_error = run_classifier(&features_signal, &result, DEBUG_PREDICTIONS);
     unsigned long inference_time = millis() - inference_start;
+    if (ei_error == EI_IMPULSE_OK) {
+        metricsObserve(METRICS_DSP, (uint32_t)result.timing.dsp_us);
+    }
+#endif
     
     if (ei_error != EI_IMPULSE_OK) {
         Serial.printf("Erro na inferencia: %d\n", ei_error);
-        return "erro";
+        metricsCountError(METRICS_ERROR_INFERENCE);
+        return WASH_STAGE_ERROR;
     }
+    metricsObserve(METRICS_INVOKE, (uint32_t)ei_tflite_get_last_timing()->invoke_us);
+    metricsObserveArena();
     
     if (DEBUG_PREDICTIONS && predictionCount % 5 == 0) {
+        const ei_tflite_timing_t* timing = ei_tflite_get_last_timing();
         Serial.printf("Tempo de inferencia: %lu ms\n", inference_time);
+        Serial.printf("  DSP: %lu us | setup: %lu us | invoke: %lu us | sessao: %s\n",
+                     (unsigned long)result.timing.dsp_us,
+                     (unsigned long)(timing->arena_alloc_us + timing->interpreter_us + timing->allocate_tensors_us),
+                     (unsigned long)timing->invoke_us,
+                     timing->reused_session ? "reutilizada" : "nova");
     }
     
     // 5. Processar resultado
-    processMLResult(&result);
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
+    processMLResult(&result, changeDetector.panelChanged());
+#else
+    processMLResult(&result, true);
+#endif
     
     return currentWashingStage;
 }
 
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 0
 int getSignalData(size_t offset, size_t length, float *out_ptr) {
-    // Converter uint8 para float normalizado (0-1)
-    size_t total_samples = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+    // Um sample por pixel, no formato esperado pelo SDK (0xRRGGBB)
+    size_t total_pixels = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT;
     
     for (size_t i = 0; i < length; i++) {
-        size_t sample_index = offset + i;
+        size_t pixel_index = offset + i;
         
-        if (sample_index < total_samples) {
-            // Normalizar de 0-255 para 0.0-1.0
-            out_ptr[i] = (float)resized_image[sample_index] / 255.0f;
+        if (pixel_index < total_pixels) {
+            const uint8_t* px = &resized_image[pixel_index * 3];
+            out_ptr[i] = (float)((px[0] << 16) | (px[1] << 8) | px[2]);
         } else {
             // Preencher com zeros se ultrapassar o buffer
             out_ptr[i] = 0.0f;
@@ -124,63 +276,77 @@ int getSignalData(size_t offset, size_t length, float *out_ptr) {
     
     return 0;
 }
+#endif
+
+// Priors do ciclo (wash_cycle.h) sobre os rótulos do modelo
+void configureStageDecoder() {
+    configureWashCycle(stageDecoderConfig, ei_classifier_inferencing_categories, EI_CLASSIFIER_LABEL_COUNT);
+    stageDecoder.begin(&stageDecoderConfig, currentWashingStage);
+    lastDecoderUpdate = millis();
+    predictionScheduler.begin();
+    predictionIntervalMs = PREDICTION_SCHEDULER ? predictionScheduler.interval : PREDICTION_INTERVAL;
+}
 
-void processMLResult(ei_impulse_result_t* result) {
-    // Encontrar classe com maior confiança
-    float max_confidence = 0;
-    int predicted_class = 0;
+// panelChanged: o detector de mudança viu o painel diferente do último frame classificado
+void processMLResult(ei_impulse_result_t* result, bool panelChanged) {
+    unsigned long postprocess_start = micros();
     
+    // Vetor completo de probabilidades vai para o decodificador temporal
+    float probs[EI_CLASSIFIER_LABEL_COUNT];
     for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
-        if (result->classification[i].value > max_confidence) {
-            max_confidence = result->classification[i].value;
-            predicted_class = i;
-        }
+        probs[i] = result->classification[i].value;
     }
     
-    // Usar as classes reais do modelo
-    String newStage = String(ei_classifier_inferencing_categories[predicted_class]);
-    
-    // Verificar se a confiança é suficiente
-    if (max_confidence >= MIN_CONFIDENCE) {
-        // Só atualizar se mudou de estado
-        if (newStage != lastWashingStage) {
-            // Validar mudança de estado (evitar oscilações)
-            static String pendingStage = "";
-            static int pendingCount = 0;
-            
-            if (newStage == pendingStage) {
-                pendingCount++;
-                if (pendingCount >= 2) { // Confirmar com 2 predições consecutivas
-                    currentWashingStage = newStage;
-                    lastWashingStage = newStage;
-                    lastConfidence = max_confidence;
-                    pendingCount = 0;
-                    
-                    // Log da mudança
-                    Serial.println("=======================================");
-                    Serial.printf("  NOVA ETAPA: %-19s\n", newStage.c_str());
-                    Serial.printf("  Confianca: %.1f%%\n", max_confidence * 100);
-                    Serial.printf("  Timestamp: %-18lu\n", millis());
-                    Serial.println("=======================================");
-                    
-                    // Notificar outros módulos
-                    onStageChanged(newStage, max_confidence);
-                }
-            } else {
-                pendingStage = newStage;
-                pendingCount = 1;
-            }
-        } else {
-            // Atualizar confiança mesmo se for a mesma etapa
-            lastConfidence = max_confidence;
+    unsigned long now = mlReplayActive ? mlReplayClockMs : millis();
+    bool changed = stageDecoder.update(probs, (now - lastDecoderUpdate) / 1000.0f);
+    lastDecoderUpdate = now;
+    if (mlReplayActive) {
+        metricsObserve(METRICS_POSTPROCESS, micros() - postprocess_start);
+        return;
+    }
+    metricsMarkBoot(METRICS_BOOT_FIRST_PREDICTION);
+    recordHistorySample(stageDecoder.label, stageDecoder.belief, EI_CLASSIFIER_LABEL_COUNT, changed);
+    
+    // Confiança publicada: crença do decodificador na etapa atual
+    float confidence = stageDecoder.confidence();
+    
+    // Próxima captura: densa perto de uma transição provável
+    if (PREDICTION_SCHEDULER) {
+        uint32_t previousInterval = predictionIntervalMs;
+        predictionIntervalMs = predictionScheduler.update(stageDecoder, panelChanged);
+        if (predictionIntervalMs < previousInterval) {
+            extern void reschedulePipelineCapture();
+            reschedulePipelineCapture();
         }
     }
     
+    if (changed) {
+        WashStage newStage = stageDecoder.label;
+        currentWashingStage = newStage;
+        lastWashingStage = newStage;
+        lastConfidence = confidence;
+        
+        // Log da mudança
+        Serial.println("=======================================");
+        Serial.printf("  NOVA ETAPA: %-19s\n", washStageLabel(newStage));
+        Serial.printf("  Confianca: %.1f%%\n", confidence * 100);
+        Serial.printf("  Timestamp: %-18lu\n", now);
+        Serial.println("=======================================");
+        
+        // Notificar outros módulos
+        onStageChanged(newStage, confidence);
+    } else {
+        // Atualizar confiança mesmo se for a mesma etapa
+        lastConfidence = confidence;
+    }
+    
     // Debug detalhado a cada 10 predições
     static int debug_counter = 0;
     if (DEBUG_PREDICTIONS && ++debug_counter % 10 == 0) {
         printDetailedPrediction(result);
     }
+    
+    metricsObserve(METRICS_POSTPROCESS, micros() - postprocess_start);
 }
 
 void printDetailedPrediction(ei_impulse_result_t* result) {
@@ -191,7 +357,7 @@ void printDetailedPrediction(ei_impulse_result_t* result) {
         const char* className = ei_classifier_inferencing_categories[i];
         
         // Destacar a classe atual
-        if (String(className) == currentWashingStage) {
+        if (i == currentWashingStage) {
             Serial.printf("│ > %-12s: %5.1f%% < │\n", className, confidence);
         } else {
             Serial.printf("│   %-12s: %5.1f%%   │\n", className, confidence);
@@ -199,31 +365,52 @@ void printDetailedPrediction(ei_impulse_result_t* result) {
     }
     
     Serial.println("├─────────────────────────────┤");
-    Serial.printf("│ Atual: %-12s (%4.1f%%) │\n", currentWashingStage.c_str(), lastConfidence * 100);
+    Serial.printf("│ Atual: %-12s (%4.1f%%) │\n", washStageLabel(currentWashingStage), lastConfidence * 100);
     Serial.printf("│ Tempo: %-18lu │\n", millis());
     Serial.println("└─────────────────────────────┘");
 }
 
 // Callback para notificar mudança de etapa
-void onStageChanged(String newStage, float confidence) {
+void onStageChanged(WashStage newStage, float confidence) {
     // Notificar módulo Sinric Pro
-    extern void updateSinricProStatus(String stage, float confidence);
+    extern void updateSinricProStatus(WashStage stage, float confidence);
     updateSinricProStatus(newStage, confidence);
     
+    // Push imediato para os dashboards conectados em /events
+    extern void publishWebStatus();
+    publishWebStatus();
+    
     // Piscar LED para indicar mudança
     extern void indicateStageChange();
     indicateStageChange();
     
     // Log para análise posterior
     logStageChange(newStage, confidence);
+    updateCycleGateStats(newStage);
 }
 
-void logStageChange(String stage, float confidence) {
+// Inferências evitadas pelo detector de mudança em cada ciclo de lavagem
+void updateCycleGateStats(WashStage newStage) {
+    if (!washCycleActive && newStage != STAGE_OFF) {
+        washCycleActive = true;
+        cycleStartGateHits = changeDetector.hits.load(std::memory_order_relaxed);
+        cycleStartGateMisses = changeDetector.misses.load(std::memory_order_relaxed);
+    } else if (washCycleActive && newStage == STAGE_OFF) {
+        washCycleActive = false;
+        uint32_t hits = changeDetector.hits.load(std::memory_order_relaxed) - cycleStartGateHits;
+        uint32_t misses = changeDetector.misses.load(std::memory_order_relaxed) - cycleStartGateMisses;
+        Serial.printf("Ciclo concluido: %lu inferencias evitadas, %lu executadas (%.1f%% evitadas)\n",
+                     (unsigned long)hits, (unsigned long)misses,
+                     (hits + misses) ? hits * 100.0 / (hits + misses) : 0.0);
+    }
+}
+
+void logStageChange(WashStage stage, float confidence) {
     static unsigned long lastLogTime = 0;
     unsigned long now = millis();
     
     // Log a cada mudança com timestamp
-    Serial.printf("LOG: %lu,%s,%.3f\n", now, stage.c_str(), confidence);
+    Serial.printf("LOG: %lu,%s,%.3f\n", now, washStageKey(stage), confidence);
     
     // Estatísticas de tempo entre mudanças
     if (lastLogTime > 0) {
@@ -242,10 +429,33 @@ void printMLStatistics() {
     
     Serial.println("=== ESTATISTICAS ML ===");
     Serial.printf("Total de predicoes: %d\n", totalPredictions);
-    Serial.printf("Etapa atual: %s\n", currentWashingStage.c_str());
+    Serial.printf("Etapa atual: %s\n", washStageLabel(currentWashingStage));
     Serial.printf("Confianca atual: %.1f%%\n", lastConfidence * 100);
     Serial.printf("Classes do modelo: %d\n", EI_CLASSIFIER_LABEL_COUNT);
     Serial.printf("Resolucao: %dx%d\n", EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT);
+    
+    const ei_tflite_session_t* session = ei_tflite_get_session();
+    if (session->active) {
+        const ei_tflite_timing_t* setup = &session->setup_timing;
+        unsigned long setupTime = (unsigned long)(setup->arena_alloc_us + setup->interpreter_us + setup->allocate_tensors_us);
+        Serial.printf("Sessao TFLite: %lu inferencias reutilizando setup de %lu us\n",
+                     (unsigned long)session->invocations, setupTime);
+        Serial.printf("Setup economizado: %.1f ms\n", session->invocations * setupTime / 1000.0);
+    }
+    
+    uint32_t gateHits = changeDetector.hits.load(std::memory_order_relaxed);
+    uint32_t gateMisses = changeDetector.misses.load(std::memory_order_relaxed);
+    uint32_t gateTotal = gateHits + gateMisses;
+    Serial.printf("Detector de mudanca: %lu evitadas, %lu executadas (%.1f%%), distancia %d/%d\n",
+                 (unsigned long)gateHits, (unsigned long)gateMisses,
+                 gateTotal ? gateHits * 100.0 / gateTotal : 0.0,
+                 changeDetector.lastDistance, changeDetector.threshold);
+    Serial.printf("Decodificador: %lu observacoes, %lu trocas, %.0f s na etapa atual\n",
+                 (unsigned long)stageDecoder.updates, (unsigned long)stageDecoder.switches,
+                 stageDecoder.elapsed);
+    Serial.printf("Agendador: proxima captura em %lu ms, %lu de %lu no intervalo minimo, margem %.2f\n",
+                 (unsigned long)predictionIntervalMs, (unsigned long)predictionScheduler.dense,
+                 (unsigned long)predictionScheduler.decisions, predictionScheduler.margin);
     Serial.println("======================");
 }
 
@@ -271,16 +481,10 @@ bool validateModel() {
     
     // Verificar se as classes esperadas existem
     bool hasExpectedClasses = true;
-    for (int i = 0; i < 6; i++) {
-        bool found = false;
-        for (int j = 0; j < EI_CLASSIFIER_LABEL_COUNT; j++) {
-            if (String(CLASS_NAMES[i]) == String(ei_classifier_inferencing_categories[j])) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            Serial.printf("AVISO: Classe esperada '%s' nao encontrada no modelo\n", CLASS_NAMES[i]);
+    for (int i = 0; i < WASH_STAGE_COUNT; i++) {
+        if (washStageIndex(ei_classifier_inferencing_categories, EI_CLASSIFIER_LABEL_COUNT,
+                           WASH_STAGES[i].label) != i) {
+            Serial.printf("AVISO: Classe esperada '%s' nao encontrada no modelo\n", WASH_STAGES[i].label);
             hasExpectedClasses = false;
         }
     }
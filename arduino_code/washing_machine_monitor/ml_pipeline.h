@@ -0,0 +1,384 @@
+#ifndef ML_PIPELINE_H
+#define ML_PIPELINE_H
+
+// Pipeline de captura e inferência em dois núcleos:
+//   núcleo 0: captura + redimensionamento/quantização -> fila de frames
+//   núcleo 1: inferência -> fila de resultados
+//   loop():   processMLResult, servidor web, Sinric Pro e LED
+// Assim o frame N+1 é capturado e convertido enquanto o frame N é classificado,
+// e todo o estado compartilhado (etapa atual, Sinric Pro) continua no loop().
+// Cada frame segura o boost de energia (power_manager.h) da captura até o fim
+// da inferência.
+
+#include <andreluiz-project-1_inferencing.h>
+#include "config.h"
+#include "camera_manager.h"
+#include "ml_inference.h"
+#include "frame_ring.h"
+#include "power_manager.h"
+#include "system_metrics.h"
+
+#ifndef PIPELINE_RING_SLOTS
+#define PIPELINE_RING_SLOTS         2       // Frames pré-processados em espera
+#endif
+
+#ifndef PIPELINE_RESULT_SLOTS
+#define PIPELINE_RESULT_SLOTS       4       // Resultados aguardando o loop()
+#endif
+
+#ifndef PIPELINE_CONTINUOUS
+#define PIPELINE_CONTINUOUS         0       // 1 = captura sem pausa; 0 = segue o agendador
+#endif
+
+#ifndef PIPELINE_CAPTURE_CORE
+#define PIPELINE_CAPTURE_CORE       0
+#endif
+
+#ifndef PIPELINE_INFERENCE_CORE
+#define PIPELINE_INFERENCE_CORE     1
+#endif
+
+#ifndef PIPELINE_TASK_STACK
+#define PIPELINE_TASK_STACK         8192
+#endif
+
+// Frame já no formato do tensor de entrada (int8 quantizado)
+struct PipelineFrame {
+    int8_t input[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];
+    FrameSignature signature;
+    LedReading leds;
+    uint32_t sequence;
+    unsigned long capturedAt;
+    uint32_t convertUs;
+};
+
+struct PipelineResult {
+    ei_impulse_result_t result;
+    uint32_t sequence;
+    unsigned long capturedAt;
+    uint32_t convertUs;
+    uint32_t inferenceUs;
+    bool reused;                // resultado anterior reaproveitado (painel sem mudança)
+    bool fastPath;              // classificado só pelos LEDs calibrados
+    bool panelChanged;          // detector de mudança viu o painel diferente
+};
+
+// =================== VARIÁVEIS GLOBAIS ===================
+FrameRing<PipelineFrame, PIPELINE_RING_SLOTS> pipelineFrames;
+FrameRing<PipelineResult, PIPELINE_RESULT_SLOTS> pipelineResults;
+PipelineResult pipelineResultStorage[PIPELINE_RESULT_SLOTS];
+PipelineFrame* pipelineFrameStorage = nullptr;
+
+TaskHandle_t pipelineCaptureHandle = NULL;
+TaskHandle_t pipelineInferenceHandle = NULL;
+volatile bool pipelineRunning = false;
+volatile bool pipelineCaptureRequested = false;     // captura imediata pedida pelo loop()
+volatile unsigned long pipelineLastCaptureAt = 0;   // base do intervalo do agendador
+
+float pipelineInputScale = 1.0f;
+int32_t pipelineInputZeroPoint = 0;
+uint32_t pipelineSequence = 0;
+volatile uint32_t pipelineCaptureErrors = 0;
+volatile uint32_t pipelineInferenceErrors = 0;
+uint32_t pipelineLastConvertUs = 0;
+uint32_t pipelineLastInferenceUs = 0;
+unsigned long pipelineLastLatency = 0;
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool startMLPipeline();
+void stopMLPipeline();
+bool isMLPipelineRunning();
+void requestPipelineCapture();
+void reschedulePipelineCapture();
+int processPipelineResults();
+void printPipelineStatistics();
+
+// =================== IMPLEMENTAÇÃO ===================
+
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
+// Copia o frame pré-processado para o tensor de entrada do interpretador
+int copyPipelineFrameToInput(void* ctx, int8_t* input, size_t input_size, float scale, int32_t zero_point) {
+    const PipelineFrame* frame = (const PipelineFrame*)ctx;
+    if (input_size != sizeof(frame->input)) {
+        return -1;
+    }
+    memcpy(input, frame->input, input_size);
+    return 0;
+}
+
+void pipelineCaptureTask(void* param) {
+    while (pipelineRunning) {
+        // Modo contínuo: espera a inferência liberar um slot em vez de descartar
+        if (PIPELINE_CONTINUOUS && pipelineFrames.depth() >= pipelineFrames.capacity()) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
+
+        // Fila cheia no horário da captura: o frame é descartado (contador "dropped")
+        PipelineFrame* slot = pipelineFrames.beginWrite();
+        if (!slot) {
+            metricsCountSkip(METRICS_SKIP_QUEUE_FULL);
+        } else {
+            powerBeginWork();
+            unsigned long captureStart = micros();
+            camera_fb_t* fb = captureImage();
+            if (fb) {
+                unsigned long start = micros();
+                metricsObserve(METRICS_CAPTURE, start - captureStart);
+                metricsCountFrame();
+                CameraFrameSource frame;
+                makeCameraFrame(fb, frame);
+                readLedsFromFrame(&frame, slot->leds);
+                int error = quantizeFrame(&frame, slot->input, sizeof(slot->input),
+                                          pipelineInputScale, pipelineInputZeroPoint, &slot->signature);
+                offerStreamFrame(fb);
+                offerRecordFrame(fb);
+                releaseCameraBuffer(fb);
+
+                if (error == 0) {
+                    slot->sequence = ++pipelineSequence;
+                    slot->capturedAt = millis();
+                    slot->convertUs = micros() - start;
+                    metricsObserve(METRICS_RESIZE, slot->convertUs);
+                    pipelineFrames.commitWrite();
+                    xTaskNotifyGive(pipelineInferenceHandle);
+                } else {
+                    pipelineCaptureErrors++;
+                    metricsCountError(METRICS_ERROR_CONVERT);
+                    powerEndWork(false);
+                }
+            } else {
+                pipelineCaptureErrors++;
+                metricsCountError(METRICS_ERROR_CAPTURE);
+                powerEndWork(false);
+            }
+        }
+
+        // Próxima captura no intervalo do agendador, contado a partir desta.
+        // O loop() acorda a tarefa quando encurta o intervalo (reavalia a espera)
+        // ou quando pede captura imediata (requestPipelineCapture)
+        if (!PIPELINE_CONTINUOUS) {
+            unsigned long capturedAt = millis();
+            pipelineLastCaptureAt = capturedAt;
+            while (pipelineRunning && !pipelineCaptureRequested) {
+                unsigned long waited = millis() - capturedAt;
+                uint32_t interval = predictionIntervalMs;
+                if (waited >= interval) {
+                    break;
+                }
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(interval - waited));
+            }
+            pipelineCaptureRequested = false;
+        }
+    }
+
+    pipelineCaptureHandle = NULL;
+    vTaskDelete(NULL);
+}
+
+void pipelineInferenceTask(void* param) {
+    while (pipelineRunning) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        PipelineFrame* frame;
+        while (pipelineRunning && (frame = pipelineFrames.beginRead()) != nullptr) {
+            PipelineResult* out = pipelineResults.beginWrite();
+            if (!out) {
+                // loop() atrasado: descarta o frame sem classificar
+                metricsCountSkip(METRICS_SKIP_QUEUE_FULL);
+                pipelineFrames.endRead();
+                powerEndWork(false);
+                continue;
+            }
+
+            EI_IMPULSE_ERROR ei_error = EI_IMPULSE_OK;
+            unsigned long start = micros();
+            // Na conferência dos LEDs a CNN roda mesmo com o painel parado
+            LedDecision ledDecision = classifyWithLeds(frame->leds, &out->result);
+            out->fastPath = ledDecision == LED_DECISION_HIT;
+            out->reused = !out->fastPath &&
+                          changeDetector.shouldReuse(frame->signature, ledDecision == LED_DECISION_VERIFY) &&
+                          lastMLResultValid;
+            out->panelChanged = !out->fastPath && changeDetector.panelChanged();
+            if (out->fastPath) {
+                // Resultado já preenchido pela tabela de decisão dos LEDs
+                metricsCountSkip(METRICS_SKIP_LEDS);
+            } else if (out->reused) {
+                out->result = lastMLResult;
+                metricsCountSkip(METRICS_SKIP_UNCHANGED);
+            } else {
+                memset(&out->result, 0, sizeof(out->result));
+                ei_error = run_classifier_image_quantized_direct(
+                    &copyPipelineFrameToInput, frame, &out->result, false);
+                if (ei_error == EI_IMPULSE_OK) {
+                    lastMLResult = out->result;
+                    lastMLResultValid = true;
+                    changeDetector.accept(frame->signature);
+                    learnLedsFromResult(frame->leds, &out->result);
+                    metricsObserve(METRICS_DSP, (uint32_t)out->result.timing.dsp_us);
+                    metricsObserve(METRICS_INVOKE, (uint32_t)ei_tflite_get_last_timing()->invoke_us);
+                    metricsObserveArena();
+                }
+            }
+            out->inferenceUs = micros() - start;
+            out->sequence = frame->sequence;
+            out->capturedAt = frame->capturedAt;
+            out->convertUs = frame->convertUs;
+
+            pipelineFrames.endRead();
+            powerEndWork(ei_error == EI_IMPULSE_OK);
+            if (PIPELINE_CONTINUOUS) {
+                xTaskNotifyGive(pipelineCaptureHandle);
+            }
+
+            if (ei_error != EI_IMPULSE_OK) {
+                pipelineInferenceErrors++;
+                metricsCountError(METRICS_ERROR_INFERENCE);
+                continue;
+            }
+            pipelineResults.commitWrite();
+        }
+    }
+
+    pipelineInferenceHandle = NULL;
+    vTaskDelete(NULL);
+}
+#endif
+
+bool startMLPipeline() {
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
+    if (pipelineRunning) {
+        return true;
+    }
+
+    // Parâmetros de quantização do tensor de entrada (sessão persistente)
+    const ei_tflite_session_t* session = ei_tflite_get_session();
+    if (!session->active || !session->input) {
+        Serial.println("ERRO: Sessao TFLite inativa, pipeline nao iniciado");
+        return false;
+    }
+    pipelineInputScale = session->input->params.scale;
+    pipelineInputZeroPoint = session->input->params.zero_point;
+
+    // Frames pré-processados na PSRAM quando disponível
+    size_t storageSize = sizeof(PipelineFrame) * PIPELINE_RING_SLOTS;
+    if (!pipelineFrameStorage) {
+        pipelineFrameStorage = (PipelineFrame*)(psramFound() ? ps_malloc(storageSize) : malloc(storageSize));
+    }
+    if (!pipelineFrameStorage) {
+        Serial.printf("ERRO: Sem memoria para a fila de frames (%u bytes)\n", (unsigned)storageSize);
+        return false;
+    }
+
+    pipelineFrames.attach(pipelineFrameStorage);
+    pipelineResults.attach(pipelineResultStorage);
+    pipelineCaptureErrors = 0;
+    pipelineInferenceErrors = 0;
+    pipelineRunning = true;
+
+    if (xTaskCreatePinnedToCore(pipelineInferenceTask, "ml_inference", PIPELINE_TASK_STACK, NULL, 1,
+                                &pipelineInferenceHandle, PIPELINE_INFERENCE_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(pipelineCaptureTask, "ml_capture", PIPELINE_TASK_STACK, NULL, 2,
+                                &pipelineCaptureHandle, PIPELINE_CAPTURE_CORE) != pdPASS) {
+        Serial.println("ERRO: Falha ao criar tarefas do pipeline");
+        stopMLPipeline();
+        return false;
+    }
+
+    Serial.printf("Pipeline ML: captura no nucleo %d, inferencia no nucleo %d, %d slots (%u bytes)\n",
+                 PIPELINE_CAPTURE_CORE, PIPELINE_INFERENCE_CORE, PIPELINE_RING_SLOTS, (unsigned)storageSize);
+    return true;
+#else
+    Serial.println("AVISO: Pipeline requer modelo quantizado, usando predicao no loop");
+    return false;
+#endif
+}
+
+void stopMLPipeline() {
+    pipelineRunning = false;
+
+    // As tarefas terminam sozinhas ao ver pipelineRunning = false
+    if (pipelineCaptureHandle) xTaskNotifyGive(pipelineCaptureHandle);
+    if (pipelineInferenceHandle) xTaskNotifyGive(pipelineInferenceHandle);
+    while (pipelineCaptureHandle || pipelineInferenceHandle) {
+        delay(10);
+    }
+    // Frames que ficaram na fila ainda seguravam o boost
+    while (pipelineFrames.beginRead() != nullptr) {
+        pipelineFrames.endRead();
+        powerEndWork(false);
+    }
+}
+
+bool isMLPipelineRunning() {
+    return pipelineRunning;
+}
+
+void requestPipelineCapture() {
+    if (pipelineRunning && pipelineCaptureHandle) {
+        pipelineCaptureRequested = true;
+        xTaskNotifyGive(pipelineCaptureHandle);
+    }
+}
+
+// Intervalo do agendador encurtou: a tarefa de captura recalcula a espera
+void reschedulePipelineCapture() {
+    if (pipelineRunning && pipelineCaptureHandle) {
+        xTaskNotifyGive(pipelineCaptureHandle);
+    }
+}
+
+// Chamado pelo loop(): aplica os resultados prontos no estado do sistema
+int processPipelineResults() {
+    static int debugCounter = 0;
+    int processed = 0;
+
+    PipelineResult* r;
+    while ((r = pipelineResults.beginRead()) != nullptr) {
+        pipelineLastConvertUs = r->convertUs;
+        pipelineLastInferenceUs = r->inferenceUs;
+        pipelineLastLatency = millis() - r->capturedAt;
+
+        processMLResult(&r->result, r->panelChanged);
+
+        // Depois do endRead() o slot volta para a tarefa de inferência
+        uint32_t sequence = r->sequence;
+        bool fastPath = r->fastPath;
+        bool reused = r->reused;
+        pipelineResults.endRead();
+        processed++;
+
+        if (DEBUG_PREDICTIONS && ++debugCounter % 5 == 0) {
+            Serial.printf("--- Pipeline frame #%lu ---\n", (unsigned long)sequence);
+            Serial.printf("  conversao: %lu us | inferencia: %lu us%s | latencia: %lu ms | fila: %u\n",
+                         (unsigned long)pipelineLastConvertUs,
+                         (unsigned long)pipelineLastInferenceUs,
+                         fastPath ? " (LEDs)" : (reused ? " (reaproveitada)" : ""),
+                         pipelineLastLatency,
+                         (unsigned)pipelineFrames.depth());
+        }
+    }
+
+    return processed;
+}
+
+void printPipelineStatistics() {
+    Serial.println("=== PIPELINE ML ===");
+    Serial.printf("Estado: %s\n", pipelineRunning ? "ativo" : "parado");
+    Serial.printf("Frames: %lu capturados, %lu classificados, %lu descartados\n",
+                 (unsigned long)pipelineFrames.produced.load(),
+                 (unsigned long)pipelineFrames.consumed.load(),
+                 (unsigned long)pipelineFrames.dropped.load());
+    Serial.printf("Fila: %u/%u (max %lu)\n",
+                 (unsigned)pipelineFrames.depth(), (unsigned)pipelineFrames.capacity(),
+                 (unsigned long)pipelineFrames.maxDepth.load());
+    Serial.printf("Resultados descartados: %lu\n", (unsigned long)pipelineResults.dropped.load());
+    Serial.printf("Erros: captura %lu, inferencia %lu\n",
+                 (unsigned long)pipelineCaptureErrors, (unsigned long)pipelineInferenceErrors);
+    Serial.printf("Ultimo frame: conversao %lu us, inferencia %lu us, latencia %lu ms\n",
+                 (unsigned long)pipelineLastConvertUs, (unsigned long)pipelineLastInferenceUs,
+                 pipelineLastLatency);
+    Serial.println("===================");
+}
+
+#endif // ML_PIPELINE_H
@@ -0,0 +1,214 @@
+#ifndef MODEL_BLOB_H
+#define MODEL_BLOB_H
+
+// Formato do modelo TFLite gravado na partição "model" (model_store.h) e
+// gerado por tools/pack_model.py. Little-endian, como o ESP32 e o host:
+//   ModelBlobHeader                 cabeçalho, com folga até headerSize
+//   modelo .tflite                  modelSize bytes a partir de headerSize
+//                                   (alinhado para o TFLite ler direto da
+//                                   flash mapeada)
+// A partição tem MODEL_SLOTS slots; vale o de maior sequence com os dois
+// CRCs certos. Ao instalar, o slot é apagado, o modelo gravado e o
+// cabeçalho vem por último: uma gravação interrompida nunca vira modelo.
+// A sequence é do firmware (a do arquivo é ignorada); modelVersion é de
+// quem gerou o arquivo, só para exibir.
+// Não depende do Arduino (usado no host).
+//
+// Storage: read(offset, buf, len), write(offset, buf, len), erase(offset)
+// (setor de MODEL_BLOB_SECTOR_SIZE), todos com bool de sucesso.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "frame_capture.h"
+
+#ifndef MODEL_BLOB_SECTOR_SIZE
+#define MODEL_BLOB_SECTOR_SIZE      4096
+#endif
+
+#define MODEL_BLOB_MAGIC            0x4C4D4D57u     // "WMML"
+#define MODEL_BLOB_FORMAT           1
+#define MODEL_BLOB_HEADER_SIZE      256             // início do modelo (múltiplo de 16)
+#define MODEL_BLOB_LABELS           8
+#define MODEL_BLOB_LABEL_SIZE       24
+
+struct ModelBlobHeader {
+    uint32_t magic;
+    uint16_t format;
+    uint16_t headerSize;            // offset do modelo no slot
+    uint32_t sequence;              // ordem de instalação (maior = mais novo)
+    uint32_t modelVersion;          // versão dada por quem gerou o arquivo
+    uint32_t modelSize;
+    uint32_t modelCrc;              // CRC-32 dos modelSize bytes do modelo
+    uint32_t arenaSize;             // arena do TFLite pedida pelo modelo
+    uint16_t inputWidth;
+    uint16_t inputHeight;
+    uint8_t inputChannels;
+    uint8_t labelCount;
+    uint8_t reserved[2];
+    char labels[MODEL_BLOB_LABELS][MODEL_BLOB_LABEL_SIZE];    // UTF-8, com '\0'
+    uint32_t headerCrc;             // CRC-32 dos bytes anteriores
+};
+
+static_assert(sizeof(ModelBlobHeader) <= MODEL_BLOB_HEADER_SIZE, "cabecalho do modelo nao cabe no slot");
+static_assert(MODEL_BLOB_HEADER_SIZE % 16 == 0, "modelo TFLite precisa de alinhamento de 16 bytes");
+
+// O que o firmware aceita: mesma entrada e mesmas classes do modelo compilado
+struct ModelBlobShape {
+    uint16_t inputWidth;
+    uint16_t inputHeight;
+    uint8_t inputChannels;
+    uint32_t arenaMax;
+    const char* const* labels;
+    int labelCount;
+};
+
+// CRC-32 (IEEE, o de zlib); crc = resultado anterior para continuar
+inline uint32_t modelBlobCrc(const void* data, size_t len, uint32_t crc = 0) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+inline uint32_t modelBlobHeaderCrc(const ModelBlobHeader& header) {
+    return modelBlobCrc(&header, offsetof(ModelBlobHeader, headerCrc));
+}
+
+// Cabeçalho novo, sem o modelo (o CRC do modelo é de quem grava)
+inline void modelBlobHeaderInit(ModelBlobHeader& header, const ModelBlobShape& shape, uint32_t modelSize,
+                                uint32_t arenaSize, uint32_t modelVersion) {
+    memset(&header, 0, sizeof(header));
+    header.magic = MODEL_BLOB_MAGIC;
+    header.format = MODEL_BLOB_FORMAT;
+    header.headerSize = MODEL_BLOB_HEADER_SIZE;
+    header.modelVersion = modelVersion;
+    header.modelSize = modelSize;
+    header.arenaSize = arenaSize;
+    header.inputWidth = shape.inputWidth;
+    header.inputHeight = shape.inputHeight;
+    header.inputChannels = shape.inputChannels;
+    header.labelCount = shape.labelCount;
+    for (int i = 0; i < shape.labelCount && i < MODEL_BLOB_LABELS; i++) {
+        strncpy(header.labels[i], shape.labels[i], MODEL_BLOB_LABEL_SIZE - 1);
+    }
+}
+
+inline void modelBlobSeal(ModelBlobHeader& header, uint32_t sequence) {
+    header.sequence = sequence;
+    header.headerCrc = modelBlobHeaderCrc(header);
+}
+
+// Cabeçalho íntegro e compatível com o firmware. nullptr ou o motivo
+inline const char* modelBlobCheckHeader(const ModelBlobHeader& header, const ModelBlobShape& expected,
+                                        size_t slotSize) {
+    if (header.magic != MODEL_BLOB_MAGIC) {
+        return "sem modelo";
+    }
+    if (header.format != MODEL_BLOB_FORMAT || header.headerSize != MODEL_BLOB_HEADER_SIZE) {
+        return "formato de modelo desconhecido";
+    }
+    if (header.headerCrc != modelBlobHeaderCrc(header)) {
+        return "CRC do cabecalho nao confere";
+    }
+    if (header.modelSize == 0 || header.modelSize > slotSize - header.headerSize) {
+        return "modelo nao cabe no slot";
+    }
+    if (header.inputWidth != expected.inputWidth || header.inputHeight != expected.inputHeight ||
+        header.inputChannels != expected.inputChannels) {
+        return "entrada diferente do firmware";
+    }
+    if (header.arenaSize == 0 || header.arenaSize > expected.arenaMax) {
+        return "arena maior que o limite";
+    }
+    if (header.labelCount != expected.labelCount) {
+        return "classes diferentes do firmware";
+    }
+    for (int i = 0; i < expected.labelCount; i++) {
+        if (strncmp(header.labels[i], expected.labels[i], MODEL_BLOB_LABEL_SIZE) != 0) {
+            return "classes diferentes do firmware";
+        }
+    }
+    return nullptr;
+}
+
+// Slot mapeado na memória: cabeçalho e CRC do modelo, lidos de onde o
+// TFLite vai ler
+inline const char* modelBlobVerify(const uint8_t* slot, size_t slotSize, const ModelBlobShape& expected,
+                                   ModelBlobHeader& header) {
+    memcpy(&header, slot, sizeof(header));
+    const char* error = modelBlobCheckHeader(header, expected, slotSize);
+    if (error) {
+        return error;
+    }
+    if (modelBlobCrc(slot + header.headerSize, header.modelSize) != header.modelCrc) {
+        return "CRC do modelo nao confere";
+    }
+    return nullptr;
+}
+
+// Índice do slot com o modelo válido mais novo, ou -1
+inline int modelBlobNewest(const ModelBlobHeader* headers, const bool* valid, int slots) {
+    int newest = -1;
+    for (int i = 0; i < slots; i++) {
+        if (valid[i] && (newest < 0 || (int32_t)(headers[i].sequence - headers[newest].sequence) > 0)) {
+            newest = i;
+        }
+    }
+    return newest;
+}
+
+// Baixa um arquivo de tools/pack_model.py para o slot em [offset, offset +
+// slotSize) de storage, com a sequence dada. nullptr ou o motivo; em caso de
+// erro o slot fica sem cabeçalho válido
+template <typename Storage>
+const char* modelBlobInstall(Storage& storage, size_t offset, size_t slotSize, CaptureRead read, void* ctx,
+                             const ModelBlobShape& expected, uint32_t sequence, ModelBlobHeader& header) {
+    uint8_t buf[MODEL_BLOB_HEADER_SIZE];
+    if (read(ctx, buf, sizeof(buf)) != sizeof(buf)) {
+        return "cabecalho incompleto";
+    }
+    memcpy(&header, buf, sizeof(header));
+    const char* error = modelBlobCheckHeader(header, expected, slotSize);
+    if (error) {
+        return error;
+    }
+
+    // Apaga até o fim do modelo; o cabeçalho antigo some no primeiro setor
+    size_t used = header.headerSize + header.modelSize;
+    for (size_t sector = 0; sector < used; sector += MODEL_BLOB_SECTOR_SIZE) {
+        if (!storage.erase(offset + sector)) {
+            return "falha ao apagar o slot";
+        }
+    }
+
+    uint32_t crc = 0;
+    size_t written = 0;
+    while (written < header.modelSize) {
+        size_t chunk = header.modelSize - written < sizeof(buf) ? header.modelSize - written : sizeof(buf);
+        if (read(ctx, buf, chunk) != chunk) {
+            return "modelo incompleto";
+        }
+        if (!storage.write(offset + header.headerSize + written, buf, chunk)) {
+            return "falha ao gravar o modelo";
+        }
+        crc = modelBlobCrc(buf, chunk, crc);
+        written += chunk;
+    }
+    if (crc != header.modelCrc) {
+        return "CRC do modelo nao confere";
+    }
+
+    modelBlobSeal(header, sequence);
+    if (!storage.write(offset, &header, sizeof(header))) {
+        return "falha ao gravar o cabecalho";
+    }
+    return nullptr;
+}
+
+#endif // MODEL_BLOB_H
@@ -0,0 +1,423 @@
+#ifndef MODEL_STORE_H
+#define MODEL_STORE_H
+
+// Modelo TFLite lido direto da flash: a partição "model" de partitions.csv
+// tem MODEL_SLOTS slots no formato de model_blob.h, mapeados na memória
+// (esp_partition_mmap) - o interpretador lê o modelo da flash pelo cache,
+// sem cópia na RAM. No boot vale o slot válido mais novo; sem nenhum, o
+// modelo compilado no firmware (que continua como reserva de fábrica).
+// Um modelo novo é baixado por HTTP (o servidor não recebe corpos) para o
+// slot que não está em uso, conferido pelo mapeamento e trocado na sessão
+// TFLite sem reboot (run_classifier_session_swap: a arena é reaproveitada
+// quando o modelo novo cabe nela):
+//   curl "http://<ip>/model?url=http://<pc>:8000/modelo.wmml"
+//   curl http://<ip>/model              (modelo ativo e última troca)
+// O arquivo sai de tools/pack_model.py. O download, a gravação e a
+// conferência rodam numa tarefa própria (no núcleo da rede); o loop() só
+// faz a troca, com o pipeline parado por swap_us. Cada setor apagado ou
+// gravado ainda pausa as duas CPUs por alguns ms (cache da flash desligado,
+// e o modelo ativo é lido pelo cache). No host: host/model_swap.cpp.
+
+#include "esp_partition.h"
+#include "esp_idf_version.h"
+#include <andreluiz-project-1_inferencing.h>
+#include "config.h"
+#include "model_blob.h"
+#include "ml_pipeline.h"
+#include "frame_replay.h"
+#include "json_writer.h"
+
+#ifndef MODEL_PARTITION
+#define MODEL_PARTITION             "model"
+#endif
+
+#ifndef MODEL_SLOTS
+#define MODEL_SLOTS                 2       // A/B: o modelo ativo nunca é sobrescrito
+#endif
+
+#ifndef MODEL_ARENA_MAX
+#define MODEL_ARENA_MAX             (384 * 1024)    // bytes de arena aceitos de um modelo novo
+#endif
+
+#ifndef MODEL_UPDATE_CORE
+#define MODEL_UPDATE_CORE           0       // Núcleo da tarefa de download (o mesmo da rede)
+#endif
+
+#ifndef MODEL_UPDATE_STACK
+#define MODEL_UPDATE_STACK          6144
+#endif
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+typedef esp_partition_mmap_handle_t ModelMapHandle;
+#define MODEL_MMAP_DATA             ESP_PARTITION_MMAP_DATA
+#define modelUnmap(handle)          esp_partition_munmap(handle)
+#else
+typedef spi_flash_mmap_handle_t ModelMapHandle;
+#define MODEL_MMAP_DATA             SPI_FLASH_MMAP_DATA
+#define modelUnmap(handle)          spi_flash_munmap(handle)
+#endif
+
+// Slots da partição, escritos pela flash e lidos pelo mapeamento
+struct ModelSlotStorage {
+    const esp_partition_t* partition = nullptr;
+
+    bool read(size_t offset, void* buf, size_t len) const {
+        return esp_partition_read(partition, offset, buf, len) == ESP_OK;
+    }
+    bool write(size_t offset, const void* buf, size_t len) {
+        return esp_partition_write(partition, offset, buf, len) == ESP_OK;
+    }
+    bool erase(size_t offset) {
+        return esp_partition_erase_range(partition, offset, MODEL_BLOB_SECTOR_SIZE) == ESP_OK;
+    }
+    size_t slotSize() const {
+        return partition ? partition->size / MODEL_SLOTS / MODEL_BLOB_SECTOR_SIZE * MODEL_BLOB_SECTOR_SIZE : 0;
+    }
+};
+
+struct ModelSlot {
+    const uint8_t* mapped;          // nullptr = não mapeado
+    ModelMapHandle handle;
+    ModelBlobHeader header;
+    bool valid;
+    const char* error;              // por que não vale (nullptr se vale)
+};
+
+struct ModelUpdateStats {
+    bool running;
+    bool swapped;
+    int slot;
+    uint32_t sequence;
+    uint32_t version;
+    uint32_t downloadMs;            // download + gravação na flash
+    uint32_t verifyMs;              // CRC lido pelo mapeamento
+    uint32_t swapUs;                // pipeline parado
+    bool arenaReused;
+    char error[48];
+};
+
+// =================== VARIÁVEIS GLOBAIS ===================
+ModelSlotStorage modelStorage;
+ModelSlot modelSlots[MODEL_SLOTS] = {};
+ei_config_tflite_graph_t modelSlotGraphs[MODEL_SLOTS];     // modelo mapeado de cada slot
+int modelActiveSlot = -1;                                   // -1 = modelo compilado
+ModelUpdateStats modelUpdateStats = {};
+SemaphoreHandle_t modelStatsLock = NULL;
+volatile bool modelUpdateRequested = false;                 // do pedido até o fim da troca
+volatile int modelSwapSlot = -1;                            // baixado, esperando o loop()
+char modelUpdateUrl[REPLAY_URL_SIZE];
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool initializeModelStore();
+int downloadModel(CaptureRead read, void* ctx, ModelUpdateStats& stats);
+bool activateDownloadedModel(int slot, ModelUpdateStats& stats);
+bool installModel(CaptureRead read, void* ctx, ModelUpdateStats& stats);
+bool requestModelUpdate(const char* url);
+void runRequestedModelUpdate();
+void writeModelStoreJSON(JsonWriter& json);
+
+// =================== IMPLEMENTAÇÃO ===================
+
+// Entrada e classes do modelo compilado: um modelo da flash tem de ser igual
+ModelBlobShape modelFirmwareShape() {
+    ModelBlobShape shape;
+    shape.inputWidth = EI_CLASSIFIER_INPUT_WIDTH;
+    shape.inputHeight = EI_CLASSIFIER_INPUT_HEIGHT;
+    shape.inputChannels = EI_CLASSIFIER_GRAYSCALE_MODEL ? 1 : 3;
+#ifdef EI_CLASSIFIER_ALLOCATION_STATIC
+    shape.arenaMax = EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE;
+#else
+    shape.arenaMax = MODEL_ARENA_MAX;
+#endif
+    shape.labels = ei_classifier_inferencing_categories;
+    shape.labelCount = EI_CLASSIFIER_LABEL_COUNT;
+    return shape;
+}
+
+void unmapModelSlot(int slot) {
+    if (modelSlots[slot].mapped) {
+        modelUnmap(modelSlots[slot].handle);
+        modelSlots[slot].mapped = nullptr;
+    }
+    modelSlots[slot].valid = false;
+}
+
+// Mapeia o slot e confere cabeçalho e CRC pelo mapeamento (o que o TFLite lê)
+bool mapModelSlot(int slot) {
+    ModelSlot& s = modelSlots[slot];
+    unmapModelSlot(slot);
+    size_t slotSize = modelStorage.slotSize();
+    const void* ptr = nullptr;
+    esp_err_t err = esp_partition_mmap(modelStorage.partition, slot * slotSize, slotSize, MODEL_MMAP_DATA,
+                                       &ptr, &s.handle);
+    if (err != ESP_OK) {
+        s.error = "falha ao mapear o slot";
+        return false;
+    }
+    s.mapped = (const uint8_t*)ptr;
+    s.error = modelBlobVerify(s.mapped, slotSize, modelFirmwareShape(), s.header);
+    s.valid = s.error == nullptr;
+    if (s.valid) {
+        modelSlotGraphs[slot].implementation_version = 1;
+        modelSlotGraphs[slot].model = s.mapped + s.header.headerSize;
+        modelSlotGraphs[slot].model_size = s.header.modelSize;
+        modelSlotGraphs[slot].arena_size = s.header.arenaSize;
+    }
+    return s.valid;
+}
+
+// Chamar antes de initializeMLModel(): a sessão já sobe no modelo da flash
+bool initializeModelStore() {
+    if (!modelStatsLock) {
+        modelStatsLock = xSemaphoreCreateMutex();
+    }
+    modelUpdateStats.slot = -1;
+
+    modelStorage.partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                      MODEL_PARTITION);
+    if (!modelStorage.partition) {
+        Serial.println("AVISO: Particao 'model' nao encontrada (partitions.csv) - so o modelo compilado");
+        return false;
+    }
+
+    unsigned long start = micros();
+    bool valid[MODEL_SLOTS];
+    ModelBlobHeader headers[MODEL_SLOTS];
+    for (int i = 0; i < MODEL_SLOTS; i++) {
+        valid[i] = mapModelSlot(i);
+        headers[i] = modelSlots[i].header;
+        if (!valid[i] && modelSlots[i].header.magic == MODEL_BLOB_MAGIC) {
+            Serial.printf("AVISO: Slot %d do modelo ignorado: %s\n", i, modelSlots[i].error);
+        }
+    }
+    unsigned long verifyUs = micros() - start;
+
+    int newest = modelBlobNewest(headers, valid, MODEL_SLOTS);
+    if (newest < 0) {
+        Serial.println("Modelo: nenhum na flash, usando o compilado");
+        return true;
+    }
+    EI_IMPULSE_ERROR err = run_classifier_session_swap(&modelSlotGraphs[newest]);
+    if (err != EI_IMPULSE_OK) {
+        Serial.printf("ERRO: Modelo do slot %d recusado pelo TFLite (%d) - usando o compilado\n", newest, err);
+        return false;
+    }
+    modelActiveSlot = newest;
+    Serial.printf("Modelo: slot %d (versao %lu, instalacao %lu), %lu bytes mapeados da flash, "
+                 "arena %lu bytes, conferido em %lu us\n",
+                 newest, (unsigned long)headers[newest].modelVersion, (unsigned long)headers[newest].sequence,
+                 (unsigned long)headers[newest].modelSize, (unsigned long)headers[newest].arenaSize, verifyUs);
+    return true;
+}
+
+// Troca a sessão para o slot (já mapeado e válido), com o pipeline parado
+bool activateModelSlot(int slot, ModelUpdateStats& stats) {
+    const uint8_t* arena = ei_tflite_get_session()->tensor_arena;
+    bool pipeline = isMLPipelineRunning();
+    unsigned long start = micros();
+    if (pipeline) {
+        stopMLPipeline();
+    }
+    EI_IMPULSE_ERROR err = run_classifier_session_swap(&modelSlotGraphs[slot]);
+    if (err == EI_IMPULSE_OK) {
+        // Resultado e frame de referência eram do modelo anterior
+        changeDetector.reset();
+        lastMLResultValid = false;
+        modelActiveSlot = slot;
+    }
+    if (pipeline) {
+        startMLPipeline();
+    }
+    stats.swapUs = micros() - start;
+    stats.arenaReused = err == EI_IMPULSE_OK && arena != nullptr && ei_tflite_get_session()->tensor_arena == arena;
+    if (err != EI_IMPULSE_OK) {
+        snprintf(stats.error, sizeof(stats.error), "TFLite recusou o modelo (%d)", err);
+        return false;
+    }
+    metricsObserveArena();
+    return true;
+}
+
+// Grava o modelo lido de read() no slot livre e confere pelo mapeamento.
+// Não mexe na sessão nem no slot ativo: roda fora do loop() (uma instalação
+// por vez). Slot pronto para activateDownloadedModel(), ou -1
+int downloadModel(CaptureRead read, void* ctx, ModelUpdateStats& stats) {
+    if (!modelStorage.partition) {
+        snprintf(stats.error, sizeof(stats.error), "particao 'model' ausente");
+        return -1;
+    }
+
+    // Slot livre: fora o ativo, um vazio ou o de modelo mais antigo
+    int slot = -1;
+    uint32_t sequence = 0;
+    for (int i = 0; i < MODEL_SLOTS; i++) {
+        const ModelSlot& s = modelSlots[i];
+        if (s.valid && (int32_t)(s.header.sequence - sequence) > 0) {
+            sequence = s.header.sequence;
+        }
+        if (i == modelActiveSlot || (slot >= 0 && !modelSlots[slot].valid)) {
+            continue;
+        }
+        if (slot < 0 || !s.valid || (int32_t)(s.header.sequence - modelSlots[slot].header.sequence) < 0) {
+            slot = i;
+        }
+    }
+    sequence++;
+    stats.slot = slot;
+
+    unsigned long start = millis();
+    unmapModelSlot(slot);
+    const char* error = modelBlobInstall(modelStorage, slot * modelStorage.slotSize(), modelStorage.slotSize(),
+                                         read, ctx, modelFirmwareShape(), sequence, modelSlots[slot].header);
+    stats.downloadMs = millis() - start;
+    if (error) {
+        snprintf(stats.error, sizeof(stats.error), "%s", error);
+        return -1;
+    }
+
+    start = millis();
+    bool mapped = mapModelSlot(slot);
+    stats.verifyMs = millis() - start;
+    if (!mapped) {
+        snprintf(stats.error, sizeof(stats.error), "%s", modelSlots[slot].error);
+        return -1;
+    }
+    stats.sequence = modelSlots[slot].header.sequence;
+    stats.version = modelSlots[slot].header.modelVersion;
+    return slot;
+}
+
+// Troca para o slot baixado por downloadModel(). Chamar do loop()
+bool activateDownloadedModel(int slot, ModelUpdateStats& stats) {
+    if (!activateModelSlot(slot, stats)) {
+        // Não volta no próximo boot: o cabeçalho deixa de valer
+        uint32_t zero = 0;
+        unmapModelSlot(slot);
+        modelStorage.write(slot * modelStorage.slotSize(), &zero, sizeof(zero));
+        return false;
+    }
+    stats.swapped = true;
+    return true;
+}
+
+// Download e troca em sequência (host/model_swap.cpp)
+bool installModel(CaptureRead read, void* ctx, ModelUpdateStats& stats) {
+    int slot = downloadModel(read, ctx, stats);
+    return slot >= 0 && activateDownloadedModel(slot, stats);
+}
+
+// Baixa, grava e confere o modelo pedido pela web; a troca fica para o loop()
+void modelUpdateTask(void* param) {
+    ModelUpdateStats stats = {};
+    stats.running = true;
+    stats.slot = -1;
+    xSemaphoreTake(modelStatsLock, portMAX_DELAY);
+    modelUpdateStats = stats;
+    xSemaphoreGive(modelStatsLock);
+
+    Serial.printf("Modelo: baixando %s\n", modelUpdateUrl);
+    int slot = -1;
+    int fd = replayOpenUrl(modelUpdateUrl, stats.error, sizeof(stats.error));
+    if (fd >= 0) {
+        slot = downloadModel(replaySocketRead, &fd, stats);
+        close(fd);
+    }
+    if (slot < 0) {
+        stats.running = false;
+        Serial.printf("ERRO: Modelo nao instalado: %s\n", stats.error);
+    }
+
+    xSemaphoreTake(modelStatsLock, portMAX_DELAY);
+    modelUpdateStats = stats;
+    xSemaphoreGive(modelStatsLock);
+    if (slot >= 0) {
+        modelSwapSlot = slot;
+    } else {
+        modelUpdateRequested = false;
+    }
+    vTaskDelete(NULL);
+}
+
+// Tarefa web: inicia o download. false se já há um pedido
+bool requestModelUpdate(const char* url) {
+    if (modelUpdateRequested || !modelStatsLock || strlen(url) >= sizeof(modelUpdateUrl)) {
+        return false;
+    }
+    strcpy(modelUpdateUrl, url);
+    modelUpdateRequested = true;
+    if (xTaskCreatePinnedToCore(modelUpdateTask, "model_update", MODEL_UPDATE_STACK, NULL, 1,
+                                NULL, MODEL_UPDATE_CORE) != pdPASS) {
+        modelUpdateRequested = false;
+        return false;
+    }
+    return true;
+}
+
+// Chamado pelo loop(): troca para o modelo que a tarefa terminou de baixar
+void runRequestedModelUpdate() {
+    int slot = modelSwapSlot;
+    if (slot < 0) {
+        return;
+    }
+    ModelUpdateStats stats;
+    xSemaphoreTake(modelStatsLock, portMAX_DELAY);
+    stats = modelUpdateStats;
+    xSemaphoreGive(modelStatsLock);
+
+    activateDownloadedModel(slot, stats);
+    stats.running = false;
+
+    if (stats.swapped) {
+        Serial.printf("Modelo: versao %lu ativa no slot %d (download %lu ms, conferencia %lu ms, "
+                     "troca %lu us, arena %s)\n",
+                     (unsigned long)stats.version, stats.slot, (unsigned long)stats.downloadMs,
+                     (unsigned long)stats.verifyMs, (unsigned long)stats.swapUs,
+                     stats.arenaReused ? "reaproveitada" : "nova");
+    } else {
+        Serial.printf("ERRO: Modelo nao instalado: %s\n", stats.error);
+    }
+
+    xSemaphoreTake(modelStatsLock, portMAX_DELAY);
+    modelUpdateStats = stats;
+    xSemaphoreGive(modelStatsLock);
+    modelSwapSlot = -1;
+    modelUpdateRequested = false;
+}
+
+void writeModelStoreJSON(JsonWriter& json) {
+    ModelUpdateStats stats;
+    xSemaphoreTake(modelStatsLock, portMAX_DELAY);
+    stats = modelUpdateStats;
+    xSemaphoreGive(modelStatsLock);
+
+    int active = modelActiveSlot;
+    const ei_tflite_session_t* session = ei_tflite_get_session();
+    json.beginObject()
+        .field("source", active >= 0 ? "flash" : "compilado")
+        .field("slot", active);
+    if (active >= 0) {
+        const ModelBlobHeader& header = modelSlots[active].header;
+        json.field("version", header.modelVersion)
+            .field("sequence", header.sequence)
+            .field("model_bytes", header.modelSize)
+            .field("arena_bytes", header.arenaSize);
+    }
+    json.field("arena_capacity", (uint32_t)session->arena_capacity)
+        .field("arena_used", (uint32_t)session->setup_timing.arena_used_bytes);
+    json.key("update").beginObject()
+        .field("running", stats.running || modelUpdateRequested)
+        .field("swapped", stats.swapped)
+        .field("slot", stats.slot)
+        .field("version", stats.version)
+        .field("download_ms", stats.downloadMs)
+        .field("verify_ms", stats.verifyMs)
+        .field("swap_us", stats.swapUs)
+        .field("arena_reused", stats.arenaReused);
+    if (stats.error[0]) {
+        json.field("error", stats.error);
+    }
+    json.endObject();
+    json.endObject();
+}
+
+#endif // MODEL_STORE_H
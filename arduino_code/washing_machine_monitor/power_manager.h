@@ -0,0 +1,201 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+// Gerenciamento de energia: aplica as decisões do PowerPolicy (power_policy.h).
+// Com o esp_pm disponível (CONFIG_PM_ENABLE), a CPU fica entre 80 e 240 MHz
+// com light sleep automático, e dois locks seguram o que a política pedir:
+//   powerBoostLock (ESP_PM_CPU_FREQ_MAX)   estado boost
+//   powerAwakeLock (ESP_PM_NO_LIGHT_SLEEP) estados boost e awake
+// Os locks podem ser tomados de qualquer tarefa: a captura (núcleo 0) sobe o
+// clock na hora, sem esperar o loop(). Sem esp_pm, o loop() troca o clock com
+// setCpuFrequencyMhz e não há light sleep (o boost vem do POWER_WAKE_AHEAD).
+// O WiFi fica em modem sleep (exigido pelo light sleep), exceto com /stream aberto.
+
+#include "esp_pm.h"
+#include "esp_idf_version.h"
+#include "config.h"
+#include "power_policy.h"
+
+#ifndef POWER_MANAGEMENT
+#define POWER_MANAGEMENT            1       // 0 = CPU sempre a 240 MHz, loop() a cada POWER_LOOP_DELAY
+#endif
+
+#ifndef POWER_WIFI_TX_POWER
+#define POWER_WIFI_TX_POWER         WIFI_POWER_19_5dBm  // Reduzir com o roteador perto
+#endif
+
+// =================== VARIÁVEIS GLOBAIS ===================
+PowerPolicy powerPolicy;
+SemaphoreHandle_t powerLock = NULL;
+bool powerReady = false;
+bool powerPmActive = false;                 // esp_pm configurado (locks e light sleep)
+esp_pm_lock_handle_t powerBoostLock = NULL;
+esp_pm_lock_handle_t powerAwakeLock = NULL;
+bool powerBoostHeld = false;
+bool powerAwakeHeld = false;
+bool powerModemSleep = true;
+volatile uint16_t powerWantedMhz = POWER_BOOST_MHZ;
+
+// =================== FUNÇÕES PÚBLICAS ===================
+bool initializePowerManagement();
+void powerBeginWork();
+void powerEndWork(bool prediction);
+void powerWebRequest();
+uint32_t updatePowerManagement(int32_t msUntilCapture, int streamClients);
+float powerAverageCurrentMa();
+float powerEnergyPerPredictionMj();
+const char* powerStateName();
+void printPowerStatistics();
+
+// =================== IMPLEMENTAÇÃO ===================
+
+// Chamar depois de WiFi.mode(WIFI_STA) (o setSleep() precisa do driver já
+// iniciado); não é preciso esperar o WiFi associar
+bool initializePowerManagement() {
+    if (!POWER_MANAGEMENT) {
+        return false;
+    }
+    powerLock = xSemaphoreCreateMutex();
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t pm = {};
+#else
+    esp_pm_config_esp32_t pm = {};
+#endif
+    pm.max_freq_mhz = POWER_BOOST_MHZ;
+    pm.min_freq_mhz = POWER_IDLE_MHZ;
+    pm.light_sleep_enable = true;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err == ESP_OK &&
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "power_boost", &powerBoostLock) == ESP_OK &&
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "power_awake", &powerAwakeLock) == ESP_OK) {
+        powerPmActive = true;
+    } else {
+        Serial.printf("AVISO: esp_pm indisponivel (%s) - so troca de clock, sem light sleep\n",
+                     esp_err_to_name(err));
+    }
+
+    // Light sleep com WiFi conectado exige modem sleep
+    WiFi.setSleep(true);
+    powerModemSleep = true;
+
+    powerPolicy.begin(millis(), powerPmActive);
+    powerReady = true;
+    Serial.printf("Energia: %d-%d MHz, light sleep %s\n", POWER_IDLE_MHZ, POWER_BOOST_MHZ,
+                 powerPmActive ? "automatico" : "indisponivel");
+    return true;
+}
+
+void setPowerLock(esp_pm_lock_handle_t lock, bool& held, bool want) {
+    if (want == held) {
+        return;
+    }
+    if (want) {
+        esp_pm_lock_acquire(lock);
+    } else {
+        esp_pm_lock_release(lock);
+    }
+    held = want;
+}
+
+// Chamado com powerLock tomado
+void applyPowerDecision(const PowerDecision& d) {
+    powerWantedMhz = d.cpuMhz;
+    if (powerPmActive) {
+        setPowerLock(powerBoostLock, powerBoostHeld, d.state == POWER_BOOST);
+        setPowerLock(powerAwakeLock, powerAwakeHeld, !d.lightSleep);
+    }
+}
+
+// Tarefas do pipeline: início da captura e fim da inferência do mesmo frame
+void powerBeginWork() {
+    if (!powerReady) return;
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    applyPowerDecision(powerPolicy.beginWork(millis()));
+    xSemaphoreGive(powerLock);
+}
+
+void powerEndWork(bool prediction) {
+    if (!powerReady) return;
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    applyPowerDecision(powerPolicy.endWork(millis(), prediction));
+    xSemaphoreGive(powerLock);
+}
+
+// Tarefa web: a cada requisição atendida
+void powerWebRequest() {
+    if (!powerReady) return;
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    applyPowerDecision(powerPolicy.webRequest(millis()));
+    xSemaphoreGive(powerLock);
+}
+
+// Chamado pelo loop(): reavalia a política e devolve a espera até a próxima volta
+uint32_t updatePowerManagement(int32_t msUntilCapture, int streamClients) {
+    if (!powerReady) {
+        return POWER_LOOP_DELAY;
+    }
+
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    unsigned long now = millis();
+    powerPolicy.setStreamClients(now, streamClients);
+    PowerDecision d = powerPolicy.update(now, msUntilCapture);
+    applyPowerDecision(d);
+    xSemaphoreGive(powerLock);
+
+    // Sem esp_pm o clock só muda aqui (setCpuFrequencyMhz não pode rodar nas tarefas)
+    if (!powerPmActive && getCpuFrequencyMhz() != powerWantedMhz) {
+        setCpuFrequencyMhz(powerWantedMhz);
+    }
+
+    // /stream precisa do rádio sempre acordado para manter o frame rate
+    bool modemSleep = streamClients == 0;
+    if (modemSleep != powerModemSleep) {
+        WiFi.setSleep(modemSleep);
+        powerModemSleep = modemSleep;
+    }
+    return d.loopDelayMs;
+}
+
+float powerAverageCurrentMa() {
+    if (!powerReady) return 0.0f;
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    float ma = powerPolicy.averageCurrentMa(millis());
+    xSemaphoreGive(powerLock);
+    return ma;
+}
+
+float powerEnergyPerPredictionMj() {
+    if (!powerReady) return 0.0f;
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    float mj = powerPolicy.energyPerPredictionMj(millis());
+    xSemaphoreGive(powerLock);
+    return mj;
+}
+
+const char* powerStateName() {
+    return powerReady ? POWER_STATE_NAMES[powerPolicy.state] : "desativado";
+}
+
+void printPowerStatistics() {
+    if (!powerReady) {
+        return;
+    }
+    xSemaphoreTake(powerLock, portMAX_DELAY);
+    uint32_t now = millis();
+    uint64_t total = 0;
+    for (int i = 0; i < POWER_STATES; i++) {
+        total += powerPolicy.timeIn((PowerState)i, now);
+    }
+    Serial.printf("Energia: %s, %u MHz | boost %.1f%% awake %.1f%% sleep %.1f%% | %.1f mA medios, "
+                 "%.1f mJ/predicao, %lu trocas\n",
+                 POWER_STATE_NAMES[powerPolicy.state], (unsigned)getCpuFrequencyMhz(),
+                 100.0 * powerPolicy.timeIn(POWER_BOOST, now) / (total ? total : 1),
+                 100.0 * powerPolicy.timeIn(POWER_AWAKE, now) / (total ? total : 1),
+                 100.0 * powerPolicy.timeIn(POWER_SLEEP, now) / (total ? total : 1),
+                 powerPolicy.averageCurrentMa(now), powerPolicy.energyPerPredictionMj(now),
+                 (unsigned long)powerPolicy.transitions);
+    xSemaphoreGive(powerLock);
+}
+
+#endif // POWER_MANAGER_H
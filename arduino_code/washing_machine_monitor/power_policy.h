@@ -0,0 +1,204 @@
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+// Política de energia: a partir dos eventos do sistema (captura/inferência
+// em andamento, próxima captura agendada, pedidos web, clientes do /stream)
+// decide o estado de energia, e integra o tempo em cada estado numa
+// estimativa de corrente média e de energia por predição:
+//   POWER_BOOST  240 MHz, sem light sleep: captura/inferência em andamento
+//                ou captura agendada a menos de POWER_WAKE_AHEAD
+//   POWER_AWAKE  80 MHz, sem light sleep: /stream aberto ou pedido web
+//                há menos de POWER_WEB_HOLD (respostas sem a latência do DTIM)
+//   POWER_SLEEP  80 MHz com light sleep automático entre os eventos
+// Só decide: quem aplica (locks do esp_pm ou setCpuFrequencyMhz) é o
+// power_manager.h. Não depende do Arduino (usado no host); tempos em ms de
+// um relógio que pode dar a volta (millis()).
+
+#include <stdint.h>
+
+#ifndef POWER_BOOST_MHZ
+#define POWER_BOOST_MHZ             240
+#endif
+
+#ifndef POWER_IDLE_MHZ
+#define POWER_IDLE_MHZ              80      // Mínimo com APB a 80 MHz (XCLK da câmera e UART estáveis)
+#endif
+
+#ifndef POWER_WAKE_AHEAD
+#define POWER_WAKE_AHEAD            150     // ms antes da captura: sensor volta a entregar frames inteiros
+#endif
+
+#ifndef POWER_WEB_HOLD
+#define POWER_WEB_HOLD              3000    // ms sem light sleep depois de um pedido web
+#endif
+
+#ifndef POWER_LOOP_DELAY
+#define POWER_LOOP_DELAY            50      // ms entre voltas do loop() acordado
+#endif
+
+#ifndef POWER_LOOP_SLEEP_DELAY
+#define POWER_LOOP_SLEEP_DELAY      250     // ms entre voltas do loop() em light sleep
+#endif
+
+// Corrente estimada do ESP32-CAM em cada estado (mA na entrada de 5 V)
+#ifndef POWER_MA_BOOST
+#define POWER_MA_BOOST              170.0f  // 240 MHz, câmera e inferência
+#endif
+
+#ifndef POWER_MA_AWAKE
+#define POWER_MA_AWAKE              60.0f   // 80 MHz, WiFi em modem sleep
+#endif
+
+#ifndef POWER_MA_SLEEP
+#define POWER_MA_SLEEP              30.0f   // Média com light sleep, beacons DTIM e câmera em espera
+#endif
+
+#ifndef POWER_SUPPLY_VOLTS
+#define POWER_SUPPLY_VOLTS          5.0f
+#endif
+
+enum PowerState {
+    POWER_BOOST,
+    POWER_AWAKE,
+    POWER_SLEEP,
+    POWER_STATES
+};
+
+static const char* const POWER_STATE_NAMES[POWER_STATES] = { "boost", "awake", "sleep" };
+static const float POWER_STATE_MA[POWER_STATES] = { POWER_MA_BOOST, POWER_MA_AWAKE, POWER_MA_SLEEP };
+
+struct PowerDecision {
+    PowerState state;
+    uint16_t cpuMhz;
+    bool lightSleep;
+    uint32_t loopDelayMs;           // espera do loop() até reavaliar
+};
+
+struct PowerPolicy {
+    bool lightSleepAvailable;       // esp_pm com light sleep automático configurado
+    int work;                       // capturas/inferências em andamento (os dois núcleos)
+    bool captureKnown;              // há captura agendada em captureAt
+    uint32_t captureAt;
+    bool webSeen;
+    uint32_t lastWeb;
+    int streamClients;
+
+    PowerState state;
+    uint32_t stateSince;
+    uint64_t stateMs[POWER_STATES];
+    uint32_t predictions;
+    uint32_t transitions;
+
+    void begin(uint32_t now, bool lightSleep) {
+        lightSleepAvailable = lightSleep;
+        work = 0;
+        captureKnown = false;
+        captureAt = 0;
+        webSeen = false;
+        lastWeb = 0;
+        streamClients = 0;
+        state = POWER_BOOST;        // boot roda no máximo até a primeira decisão
+        stateSince = now;
+        for (int i = 0; i < POWER_STATES; i++) {
+            stateMs[i] = 0;
+        }
+        predictions = 0;
+        transitions = 0;
+    }
+
+    // Captura começou (a captura agendada deixa de estar pendente)
+    PowerDecision beginWork(uint32_t now) {
+        work++;
+        captureKnown = false;
+        return decide(now);
+    }
+
+    // Fim da captura/inferência; "prediction" conta para a energia por predição
+    PowerDecision endWork(uint32_t now, bool prediction) {
+        if (work > 0) {
+            work--;
+        }
+        if (prediction) {
+            predictions++;
+        }
+        return decide(now);
+    }
+
+    PowerDecision webRequest(uint32_t now) {
+        webSeen = true;
+        lastWeb = now;
+        return decide(now);
+    }
+
+    PowerDecision setStreamClients(uint32_t now, int clients) {
+        streamClients = clients;
+        return decide(now);
+    }
+
+    // Chamado pelo loop(): ms até a próxima captura do agendador (< 0: nenhuma)
+    PowerDecision update(uint32_t now, int32_t msUntilCapture) {
+        captureKnown = msUntilCapture >= 0;
+        captureAt = now + (uint32_t)(msUntilCapture < 0 ? 0 : msUntilCapture);
+        return decide(now);
+    }
+
+    PowerDecision decide(uint32_t now) {
+        int32_t untilCapture = (int32_t)(captureAt - now);
+        PowerState want = POWER_SLEEP;
+        if (work > 0 || (captureKnown && untilCapture <= POWER_WAKE_AHEAD)) {
+            want = POWER_BOOST;
+        } else if (streamClients > 0 || (webSeen && now - lastWeb < POWER_WEB_HOLD) || !lightSleepAvailable) {
+            want = POWER_AWAKE;
+        }
+        enter(now, want);
+
+        PowerDecision d;
+        d.state = state;
+        d.cpuMhz = state == POWER_BOOST ? POWER_BOOST_MHZ : POWER_IDLE_MHZ;
+        d.lightSleep = state == POWER_SLEEP;
+        d.loopDelayMs = POWER_LOOP_DELAY;
+        if (state == POWER_SLEEP) {
+            // Acorda a tempo de entrar em boost antes da captura
+            d.loopDelayMs = POWER_LOOP_SLEEP_DELAY;
+            if (captureKnown && (uint32_t)(untilCapture - POWER_WAKE_AHEAD) < d.loopDelayMs) {
+                d.loopDelayMs = (uint32_t)(untilCapture - POWER_WAKE_AHEAD);
+            }
+        }
+        return d;
+    }
+
+    void enter(uint32_t now, PowerState next) {
+        stateMs[state] += now - stateSince;
+        stateSince = now;
+        if (next != state) {
+            state = next;
+            transitions++;
+        }
+    }
+
+    // ms em cada estado até "now", sem mudar o estado
+    uint64_t timeIn(PowerState s, uint32_t now) const {
+        return stateMs[s] + (s == state ? now - stateSince : 0);
+    }
+
+    float averageCurrentMa(uint32_t now) const {
+        double total = 0, charge = 0;
+        for (int i = 0; i < POWER_STATES; i++) {
+            double ms = (double)timeIn((PowerState)i, now);
+            total += ms;
+            charge += ms * POWER_STATE_MA[i];
+        }
+        return total > 0 ? (float)(charge / total) : 0.0f;
+    }
+
+    // Energia do estado boost (captura + inferência) dividida pelas predições
+    float energyPerPredictionMj(uint32_t now) const {
+        if (predictions == 0) {
+            return 0.0f;
+        }
+        double ms = (double)timeIn(POWER_BOOST, now);
+        return (float)(ms * POWER_MA_BOOST * POWER_SUPPLY_VOLTS / 1000.0 / predictions);
+    }
+};
+
+#endif // POWER_POLICY_H
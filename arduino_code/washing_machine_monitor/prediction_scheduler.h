@@ -0,0 +1,84 @@
+#ifndef PREDICTION_SCHEDULER_H
+#define PREDICTION_SCHEDULER_H
+
+// Agendador de predições: decide quanto esperar até a próxima captura a
+// partir do estado do decodificador temporal. Denso perto de uma transição
+// provável, esparso no meio de uma etapa longa e estável:
+//   crença incerta (margem pequena) ou painel mudando -> SCHEDULER_MIN_INTERVAL
+//   senão: fração da distância até o fim típico da etapa, limitada a
+//          [SCHEDULER_MIN_INTERVAL, SCHEDULER_MAX_INTERVAL]
+// A distância é simétrica: uma etapa muito além da duração típica (lavadora
+// desligada há horas) volta a ser amostrada devagar.
+// Não depende do Arduino (usado no host).
+
+#include <stdint.h>
+#include <math.h>
+#include "stage_decoder.h"
+
+#ifndef SCHEDULER_MIN_INTERVAL
+#define SCHEDULER_MIN_INTERVAL      2000    // ms
+#endif
+
+#ifndef SCHEDULER_MAX_INTERVAL
+#define SCHEDULER_MAX_INTERVAL      30000   // ms
+#endif
+
+#ifndef SCHEDULER_DISTANCE_FRACTION
+#define SCHEDULER_DISTANCE_FRACTION 0.1f    // Intervalo = fração do tempo até o fim típico
+#endif
+
+#ifndef SCHEDULER_MIN_MARGIN
+#define SCHEDULER_MIN_MARGIN        0.8f    // Crença da etapa menos a segunda maior
+#endif
+
+#ifndef SCHEDULER_ACTIVITY_DECAY
+#define SCHEDULER_ACTIVITY_DECAY    0.5f    // Peso do histórico na atividade do painel
+#endif
+
+#ifndef SCHEDULER_ACTIVITY_LIMIT
+#define SCHEDULER_ACTIVITY_LIMIT    0.3f    // Acima disso o painel está mudando
+#endif
+
+struct PredictionScheduler {
+    float activity;                 // média móvel de frames com painel alterado (0-1)
+    float margin;                   // última margem de crença
+    uint32_t interval;              // ms até a próxima captura
+    uint32_t dense;                 // decisões no intervalo mínimo
+    uint32_t decisions;
+
+    void begin() {
+        activity = 0.0f;
+        margin = 1.0f;
+        interval = SCHEDULER_MIN_INTERVAL;
+        dense = 0;
+        decisions = 0;
+    }
+
+    // Chamado depois de cada observação do decodificador
+    uint32_t update(const StageDecoder& decoder, bool panelChanged) {
+        activity = activity * SCHEDULER_ACTIVITY_DECAY + (panelChanged ? 1.0f - SCHEDULER_ACTIVITY_DECAY : 0.0f);
+
+        float second = 0.0f;
+        for (int i = 0; i < decoder.config->stages; i++) {
+            if (i != decoder.label && decoder.belief[i] > second) {
+                second = decoder.belief[i];
+            }
+        }
+        margin = decoder.confidence() - second;
+
+        float ms = SCHEDULER_MIN_INTERVAL;
+        if (margin >= SCHEDULER_MIN_MARGIN && activity <= SCHEDULER_ACTIVITY_LIMIT) {
+            float distance = fabsf(decoder.config->typicalDwell[decoder.label] - decoder.elapsed);
+            ms = distance * SCHEDULER_DISTANCE_FRACTION * 1000.0f;
+        }
+        if (ms < SCHEDULER_MIN_INTERVAL) ms = SCHEDULER_MIN_INTERVAL;
+        if (ms > SCHEDULER_MAX_INTERVAL) ms = SCHEDULER_MAX_INTERVAL;
+
+        interval = (uint32_t)ms;
+        decisions++;
+        if (interval == SCHEDULER_MIN_INTERVAL) dense++;
+        return interval;
+    }
+};
+
+#endif // PREDICTION_SCHEDULER_H
@@ -0,0 +1,133 @@
+#ifndef PUBLISH_QUEUE_H
+#define PUBLISH_QUEUE_H
+
+// Fila de eventos para a nuvem (Sinric Pro) que nunca bloqueia quem publica.
+// Um slot por tipo de evento: publicar de novo antes do envio substitui o
+// valor pendente (só o estado mais novo sai), então a fila nunca passa de
+// Kinds eventos. O envio fica com uma única tarefa de rede, que pergunta a
+// nextDue() quando pode tentar:
+//   - no máximo um evento a cada minIntervalMs (limite de taxa do serviço)
+//   - desconectado ou com envio recusado: espera exponencial de backoffMinMs
+//     até backoffMaxMs, zerada no primeiro envio aceito
+// Não depende do Arduino nem do FreeRTOS (usado no host).
+//
+//   produtor:  queue.post(EVENTO, valor);            // qualquer tarefa
+//   rede:      if (queue.nextDue(now, connected, kind, value)) {
+//                  if (enviar(kind, value)) queue.sent(now);
+//                  else queue.failed(now, kind, value);
+//              }
+
+#include <stdint.h>
+#include <atomic>
+
+#define PUBLISH_PENDING     0x80000000u
+
+template <int Kinds>
+struct PublishQueue {
+    // Valor pendente de cada tipo (bit alto = pendente), escrito por qualquer tarefa
+    std::atomic<uint32_t> slots[Kinds] = {};
+
+    // Política de envio: só a tarefa de rede mexe
+    uint32_t minIntervalMs = 1000;
+    uint32_t backoffMinMs = 1000;
+    uint32_t backoffMaxMs = 60000;
+    uint32_t backoffMs = 0;             // 0 = sem falhas seguidas
+    uint32_t lastAttemptAt = 0;
+    uint32_t nextAttemptAt = 0;
+    bool attempted = false;
+
+    // Estatísticas
+    std::atomic<uint32_t> posted{0};
+    std::atomic<uint32_t> coalesced{0};  // substituídos antes de sair
+    uint32_t sentCount = 0;
+    uint32_t failedCount = 0;
+
+    void configure(uint32_t minInterval, uint32_t backoffMin, uint32_t backoffMax) {
+        minIntervalMs = minInterval;
+        backoffMinMs = backoffMin;
+        backoffMaxMs = backoffMax;
+    }
+
+    // =================== PRODUTORES ===================
+
+    // Nunca espera. true se substituiu um valor ainda não enviado
+    bool post(int kind, uint32_t value) {
+        uint32_t previous = slots[kind].exchange(PUBLISH_PENDING | (value & ~PUBLISH_PENDING),
+                                                 std::memory_order_acq_rel);
+        posted.fetch_add(1, std::memory_order_relaxed);
+        if (previous & PUBLISH_PENDING) {
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool pending(int kind) const {
+        return (slots[kind].load(std::memory_order_acquire) & PUBLISH_PENDING) != 0;
+    }
+
+    // =================== TAREFA DE REDE ===================
+
+    bool waiting(uint32_t now) const {
+        return attempted && (int32_t)(now - nextAttemptAt) < 0;
+    }
+
+    // ms até a próxima tentativa possível (0 = agora), para dormir até lá
+    uint32_t msUntilDue(uint32_t now) const {
+        return waiting(now) ? nextAttemptAt - now : 0;
+    }
+
+    // Próximo evento a enviar agora (o de menor tipo primeiro), já retirado da
+    // fila. Desconectado: conta como tentativa falha e mantém os pendentes
+    bool nextDue(uint32_t now, bool connected, int& kind, uint32_t& value) {
+        if (waiting(now)) {
+            return false;
+        }
+        for (int k = 0; k < Kinds; k++) {
+            if (!pending(k)) continue;
+            if (!connected) {
+                scheduleRetry(now);
+                return false;
+            }
+            uint32_t word = slots[k].exchange(0, std::memory_order_acq_rel);
+            if (!(word & PUBLISH_PENDING)) continue;
+            kind = k;
+            value = word & ~PUBLISH_PENDING;
+            return true;
+        }
+        return false;
+    }
+
+    void sent(uint32_t now) {
+        sentCount++;
+        backoffMs = 0;
+        lastAttemptAt = now;
+        nextAttemptAt = now + minIntervalMs;
+        attempted = true;
+    }
+
+    // Envio recusado: o valor volta para a fila, a menos que já haja um mais novo
+    void failed(uint32_t now, int kind, uint32_t value) {
+        failedCount++;
+        uint32_t empty = 0;
+        slots[kind].compare_exchange_strong(empty, PUBLISH_PENDING | value, std::memory_order_acq_rel);
+        scheduleRetry(now);
+    }
+
+    // Conexão restabelecida: tenta já, sem esperar o fim do backoff
+    void resume() {
+        backoffMs = 0;
+        attempted = false;
+    }
+
+    void scheduleRetry(uint32_t now) {
+        backoffMs = backoffMs == 0 ? backoffMinMs
+                  : backoffMs >= backoffMaxMs / 2 ? backoffMaxMs : backoffMs * 2;
+        uint32_t wait = backoffMs > minIntervalMs ? backoffMs : minIntervalMs;
+        lastAttemptAt = now;
+        nextAttemptAt = now + wait;
+        attempted = true;
+    }
+};
+
+#endif // PUBLISH_QUEUE_H
@@ -1,23 +1,67 @@
 #ifndef SINRIC_INTEGRATION_H
 #define SINRIC_INTEGRATION_H
 
+// Integração com a Alexa pelo Sinric Pro. O websocket e todos os envios
+// ficam numa tarefa própria ("sinric"); o caminho ML só publica na fila
+// (publish_queue.h) e nunca espera pela nuvem:
+//   - mudanças seguidas antes do envio viram uma só (sai o estado mais novo)
+//   - no máximo um evento a cada SINRIC_EVENT_INTERVAL
+//   - desconectado ou com envio recusado: nova tentativa com espera dobrando
+//     de SINRIC_BACKOFF_MIN até SINRIC_BACKOFF_MAX
+//   - ao reconectar, o estado atual é publicado de novo
+
 #include <SinricPro.h>
 #include <SinricProSwitch.h>
 #include "config.h"
+#include "wash_stage.h"
+#include "publish_queue.h"
+
+#ifndef SINRIC_TASK_CORE
+#define SINRIC_TASK_CORE        0       // Núcleo da tarefa do websocket (o mesmo da rede)
+#endif
+
+#ifndef SINRIC_TASK_STACK
+#define SINRIC_TASK_STACK       6144
+#endif
+
+#ifndef SINRIC_TASK_PERIOD
+#define SINRIC_TASK_PERIOD      50      // ms entre SinricPro.handle() sem eventos
+#endif
+
+#ifndef SINRIC_EVENT_INTERVAL
+#define SINRIC_EVENT_INTERVAL   1000    // ms mínimos entre eventos enviados
+#endif
+
+#ifndef SINRIC_BACKOFF_MIN
+#define SINRIC_BACKOFF_MIN      1000    // ms: primeira espera após falha
+#endif
+
+#ifndef SINRIC_BACKOFF_MAX
+#define SINRIC_BACKOFF_MAX      60000   // ms: espera máxima entre tentativas
+#endif
+
+// Tipos de evento (menor sai primeiro quando há vários pendentes)
+#define SINRIC_EVENT_PULSE      0       // estado avulso, depois volta ao atual (fim de ciclo, teste)
+#define SINRIC_EVENT_POWER      1       // etapa + confiança
+#define SINRIC_EVENT_KINDS      2
 
 // =================== VARIÁVEIS GLOBAIS ===================
-extern String currentWashingStage;
+extern WashStage currentWashingStage;
 extern float lastConfidence;
 
+PublishQueue<SINRIC_EVENT_KINDS> sinricQueue;
+TaskHandle_t sinricTaskHandle = NULL;
+volatile bool sinricConnected = false;          // atualizado pela tarefa sinric
+
 // =================== DECLARAÇÕES DE FUNÇÕES ===================
 bool setupSinricProIntegration();
-void updateSinricProStatus(String stage, float confidence);
-void handleSinricProRequests();
+void updateSinricProStatus(WashStage stage, float confidence);
+void sinricTask(void* param);
 bool onPowerState(const String &deviceId, bool &state);
-int mapStageToNumber(String stage);
-String mapNumberToStage(int number);
-void sendCustomWashingStageToAlexa(String stage);
-String generateAlexaResponse(String stage, float confidence);
+int mapStageToNumber(WashStage stage);
+WashStage mapNumberToStage(int number);
+void sendCustomWashingStageToAlexa(WashStage stage);
+String generateAlexaResponse(WashStage stage, float confidence);
 void printSinricProStatus();
 bool testSinricProConnection();
 void handleSinricProError(String error);
@@ -26,6 +70,11 @@ void onWashingCycleComplete();
 
 // =================== IMPLEMENTAÇÃO ===================
 
+// Evento de energia: etapa no byte baixo, confiança em milésimos acima
+static uint32_t sinricPowerValue(WashStage stage, float confidence) {
+    return stage | (uint32_t)(confidence * 1000) << 8;
+}
+
 bool setupSinricProIntegration() {
     Serial.println("Configurando integracao Sinric Pro...");
     
@@ -47,43 +96,85 @@ bool setupSinricProIntegration() {
     // Configurar callbacks de conexão
     SinricPro.onConnected([]() {
         Serial.println("Sinric Pro conectado com sucesso!");
+        sinricConnected = true;
+        // Ressincronizar: o que mudou enquanto desconectado sai agora
+        sinricQueue.resume();
+        sinricQueue.post(SINRIC_EVENT_POWER, sinricPowerValue(currentWashingStage, lastConfidence));
     });
     
     SinricPro.onDisconnected([]() {
         Serial.println("Sinric Pro desconectado!");
+        sinricConnected = false;
     });
     
-    // Inicializar conexão
+    // Inicializar conexão; a conexão completa na tarefa, sem segurar o boot
+    sinricQueue.configure(SINRIC_EVENT_INTERVAL, SINRIC_BACKOFF_MIN, SINRIC_BACKOFF_MAX);
     SinricPro.begin(SINRIC_APP_KEY, SINRIC_APP_SECRET);
+    if (xTaskCreatePinnedToCore(sinricTask, "sinric", SINRIC_TASK_STACK, NULL, 1,
+                                &sinricTaskHandle, SINRIC_TASK_CORE) != pdPASS) {
+        Serial.println("ERRO: Falha ao criar tarefa do Sinric Pro");
+        sinricTaskHandle = NULL;
+        return false;
+    }
     
     Serial.println("Sinric Pro inicializado!");
     Serial.println("Alexa pode agora controlar a lavadora");
     
-    // Aguardar conexão estabilizar
-    delay(2000);
-    
     return true;
 }
 
-void handleSinricProRequests() {
-    SinricPro.handle();
+// Chamado no caminho ML: só publica na fila, nunca espera pela rede
+void updateSinricProStatus(WashStage stage, float confidence) {
+    if (!sinricTaskHandle) {
+        return; // Sinric Pro não configurado
+    }
+    sinricQueue.post(SINRIC_EVENT_POWER, sinricPowerValue(stage, confidence));
+    xTaskNotifyGive(sinricTaskHandle);
 }
 
-void updateSinricProStatus(String stage, float confidence) {
-    if (!SinricPro.isConnected()) {
-        return; // Não fazer nada se não estiver conectado
-    }
-    
+// Envia um evento da fila; false se o Sinric Pro recusou
+static bool sinricSendEvent(int kind, uint32_t value) {
     SinricProSwitch &myWashingMachine = SinricPro[SINRIC_DEVICE_ID];
     
-    // Mapear etapa para estado de energia (ligado/desligado)
-    bool powerState = (stage != "desligado");
+    if (kind == SINRIC_EVENT_PULSE) {
+        if (!myWashingMachine.sendPowerStateEvent(value != 0)) {
+            return false;
+        }
+        // Voltar ao estado atual no próximo intervalo
+        sinricQueue.post(SINRIC_EVENT_POWER, sinricPowerValue(currentWashingStage, lastConfidence));
+        return true;
+    }
     
-    // Enviar estado de energia
-    myWashingMachine.sendPowerStateEvent(powerState);
+    // Mapear etapa para estado de energia (ligado/desligado)
+    WashStage stage = value & 0xFF;
+    if (!myWashingMachine.sendPowerStateEvent(stage != STAGE_OFF)) {
+        return false;
+    }
     
     // Log da atualização
-    Serial.printf("Sinric Pro atualizado: %s (%.1f%%)\n", stage.c_str(), confidence * 100);
+    Serial.printf("Sinric Pro atualizado: %s (%.1f%%)\n", washStageKey(stage), (value >> 8) / 10.0);
+    return true;
+}
+
+// Websocket (SinricPro.handle) e envio da fila, fora do loop() e da inferência
+void sinricTask(void* param) {
+    while (true) {
+        SinricPro.handle();
+        
+        int kind;
+        uint32_t value;
+        uint32_t now = millis();
+        if (sinricQueue.nextDue(now, sinricConnected, kind, value)) {
+            if (sinricSendEvent(kind, value)) {
+                sinricQueue.sent(now);
+            } else {
+                sinricQueue.failed(now, kind, value);
+            }
+        }
+        
+        // Acorda por um evento novo ou para manter o websocket
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SINRIC_TASK_PERIOD));
+    }
 }
 
 // =================== CALLBACKS DO SINRIC PRO ===================
@@ -92,12 +183,12 @@ bool onPowerState(const String &deviceId, bool &state) {
     Serial.printf("Alexa solicitou: %s\n", state ? "LIGAR" : "DESLIGAR");
     
     // Responder com estado atual real
-    state = (currentWashingStage != "desligado");
+    state = (currentWashingStage != STAGE_OFF);
     
     // Enviar resposta personalizada dependendo do estado
     if (state) {
         Serial.println("Resposta: Lavadora esta em operacao");
-        Serial.printf("Etapa atual: %s\n", currentWashingStage.c_str());
+        Serial.printf("Etapa atual: %s\n", washStageLabel(currentWashingStage));
     } else {
         Serial.println("Resposta: Lavadora esta desligada");
     }
@@ -107,51 +198,25 @@ bool onPowerState(const String &deviceId, bool &state) {
 
 // =================== FUNÇÕES AUXILIARES ===================
 
-int mapStageToNumber(String stage) {
-    // Mapear etapas para números para facilitar integração
-    if (stage == "desligado") return 0;
-    else if (stage == "molho_curto") return 1;
-    else if (stage == "molho_normal") return 2;
-    else if (stage == "molho_longo") return 3;
-    else if (stage == "enxague") return 4;
-    else if (stage == "centrifugacao") return 5;
-    else return 0; // Default para desligado
+// Números da integração: posição da etapa no ciclo (WashStageInfo::number)
+int mapStageToNumber(WashStage stage) {
+    return stage < WASH_STAGE_COUNT ? WASH_STAGES[stage].number : 0; // Default para desligado
 }
 
-String mapNumberToStage(int number) {
-    switch (number) {
-        case 0: return "desligado";
-        case 1: return "molho_curto";
-        case 2: return "molho_normal";
-        case 3: return "molho_longo";
-        case 4: return "enxague";
-        case 5: return "centrifugacao";
-        default: return "desligado";
-    }
+WashStage mapNumberToStage(int number) {
+    return washStageFromNumber(number);
 }
 
 // =================== FUNÇÕES AVANÇADAS ===================
 
-void sendCustomWashingStageToAlexa(String stage) {
+void sendCustomWashingStageToAlexa(WashStage stage) {
     // Funcionalidade simplificada para v3.5.1
     updateSinricProStatus(stage, lastConfidence);
-    Serial.printf("Enviando etapa para Alexa: %s\n", stage.c_str());
+    Serial.printf("Enviando etapa para Alexa: %s\n", washStageKey(stage));
 }
 
-String generateAlexaResponse(String stage, float confidence) {
-    String response = "";
-    
-    if (stage == "desligado") {
-        response = "A lavadora esta desligada";
-    } else if (stage == "centrifugacao") {
-        response = "A lavadora esta centrifugando as roupas";
-    } else if (stage == "enxague") {
-        response = "A lavadora esta enxaguando as roupas";
-    } else if (stage.startsWith("molho")) {
-        response = "A lavadora esta no ciclo de molho";
-    } else {
-        response = "A lavadora esta em operacao";
-    }
+String generateAlexaResponse(WashStage stage, float confidence) {
+    String response = stage < WASH_STAGE_COUNT ? WASH_STAGES[stage].phrase : "A lavadora esta em operacao";
     
     // Adicionar informação de confiança se for alta
     if (confidence > 0.9) {
@@ -167,34 +232,34 @@ String generateAlexaResponse(String stage, float confidence) {
 
 void printSinricProStatus() {
     Serial.println("=== STATUS SINRIC PRO ===");
-    Serial.printf("Conectado: %s\n", SinricPro.isConnected() ? "Sim" : "Nao");
+    Serial.printf("Conectado: %s\n", sinricConnected ? "Sim" : "Nao");
     Serial.printf("Device ID: %s\n", SINRIC_DEVICE_ID);
-    Serial.printf("Ultimo estado enviado: %s\n", currentWashingStage.c_str());
+    Serial.printf("Ultimo estado enviado: %s\n", washStageLabel(currentWashingStage));
     Serial.printf("Ultima confianca: %.1f%%\n", lastConfidence * 100);
+    Serial.printf("Eventos: %lu publicados, %lu agrupados, %lu enviados, %lu falhas\n",
+                 (unsigned long)sinricQueue.posted, (unsigned long)sinricQueue.coalesced,
+                 (unsigned long)sinricQueue.sentCount, (unsigned long)sinricQueue.failedCount);
+    if (sinricQueue.backoffMs > 0) {
+        Serial.printf("Nova tentativa em %lu ms\n", (unsigned long)sinricQueue.msUntilDue(millis()));
+    }
     Serial.println("========================");
 }
 
+// Publica "ligado" seguido do estado atual; o resultado aparece nas
+// estatísticas de printSinricProStatus()
 bool testSinricProConnection() {
     Serial.println("Testando conexao Sinric Pro...");
     
-    if (!SinricPro.isConnected()) {
+    if (!sinricTaskHandle || !sinricConnected) {
         Serial.println("Nao conectado ao Sinric Pro");
         return false;
     }
     
     // Enviar um estado de teste
-    SinricProSwitch &myWashingMachine = SinricPro[SINRIC_DEVICE_ID];
-    bool testResult = myWashingMachine.sendPowerStateEvent(true);
-    
-    if (testResult) {
-        Serial.println("Teste de envio bem-sucedido");
-        delay(1000);
-        myWashingMachine.sendPowerStateEvent(currentWashingStage != "desligado");
-        return true;
-    } else {
-        Serial.println("Falha no teste de envio");
-        return false;
-    }
+    sinricQueue.post(SINRIC_EVENT_PULSE, 1);
+    xTaskNotifyGive(sinricTaskHandle);
+    Serial.println("Teste de envio na fila");
+    return true;
 }
 
 // =================== TRATAMENTO DE ERROS ===================
@@ -218,12 +283,12 @@ void handleSinricProError(String error) {
 void trackUsageStatistics() {
     static unsigned long totalOnTime = 0;
     static unsigned long lastStateChange = 0;
-    static String lastState = "desligado";
+    static WashStage lastState = STAGE_OFF;
     
     unsigned long now = millis();
     
     if (currentWashingStage != lastState) {
-        if (lastState != "desligado") {
+        if (lastState != STAGE_OFF) {
             totalOnTime += (now - lastStateChange);
         }
         lastStateChange = now;
@@ -237,15 +302,16 @@ void trackUsageStatistics() {
 
 void onWashingCycleComplete() {
     // Função chamada quando um ciclo de lavagem é concluído
-    if (currentWashingStage == "centrifugacao") {
+    if (currentWashingStage == STAGE_SPIN) {
         // Assumir que centrifugação é a última etapa
         Serial.println("Ciclo de lavagem concluido!");
         
-        // Enviar notificação simples via mudança de estado
-        SinricProSwitch &myWashingMachine = SinricPro[SINRIC_DEVICE_ID];
-        myWashingMachine.sendPowerStateEvent(false); // Sinalizar conclusão
-        delay(1000);
-        myWashingMachine.sendPowerStateEvent(true);
+        // Enviar notificação simples via mudança de estado: desligado e de
+        // volta ao atual, espaçados pelo limite de taxa da fila
+        if (sinricTaskHandle) {
+            sinricQueue.post(SINRIC_EVENT_PULSE, 0); // Sinalizar conclusão
+            xTaskNotifyGive(sinricTaskHandle);
+        }
     }
 }
 
@@ -0,0 +1,190 @@
+#ifndef STAGE_DECODER_H
+#define STAGE_DECODER_H
+
+// Decodificador temporal das etapas (HMM, filtro forward online).
+// Cada inferência entra com o vetor completo de probabilidades da CNN; a
+// crença sobre a etapa real combina essa evidência com o que se sabe do
+// ciclo: a ordem das etapas (molho -> enxágue -> centrifugação -> desligado)
+// e quanto tempo cada uma costuma durar. Uma transição esperada confirma com
+// uma única predição confiante; uma fora de ordem, ou cedo demais, precisa
+// de mais evidência. Estado fixo: uma crença por etapa, sem alocação.
+// Não depende do Arduino (usado no host).
+//
+// A probabilidade de sair da etapa i em dt segundos é 1 - exp(-dt * taxa),
+// com taxa crescente com o tempo na etapa (semi-Markov aproximado):
+//   antes de minDwell:            1 / (DECODER_EARLY_FACTOR * typicalDwell)
+//   depois:                       1 / max(typicalDwell - tempo, DECODER_TAU_MIN)
+// O tempo só é conhecido para a etapa decodificada; as outras contam como
+// recém-iniciadas. O intervalo entre inferências pode variar à vontade.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#ifndef DECODER_MAX_STAGES
+#define DECODER_MAX_STAGES          8
+#endif
+
+#ifndef DECODER_SWITCH_POSTERIOR
+#define DECODER_SWITCH_POSTERIOR    0.80f   // Crença mínima para trocar de etapa
+#endif
+
+#ifndef DECODER_EMISSION_FLOOR
+#define DECODER_EMISSION_FLOOR      0.05f   // Piso da probabilidade da CNN (int8 satura em 0)
+#endif
+
+#ifndef DECODER_TAU_MIN
+#define DECODER_TAU_MIN             10.0f   // s: menor constante de tempo de saída
+#endif
+
+#ifndef DECODER_EARLY_FACTOR
+#define DECODER_EARLY_FACTOR        20.0f   // Saída antes de minDwell é N vezes mais rara
+#endif
+
+struct StageDecoderConfig {
+    int stages;
+    float transition[DECODER_MAX_STAGES][DECODER_MAX_STAGES];  // [de][para] ao sair; diagonal 0
+    float minDwell[DECODER_MAX_STAGES];                         // s
+    float typicalDwell[DECODER_MAX_STAGES];                     // s
+
+    void begin(int count) {
+        stages = count < DECODER_MAX_STAGES ? count : DECODER_MAX_STAGES;
+        for (int i = 0; i < DECODER_MAX_STAGES; i++) {
+            for (int j = 0; j < DECODER_MAX_STAGES; j++) {
+                transition[i][j] = 0.0f;
+            }
+            minDwell[i] = 0.0f;
+            typicalDwell[i] = 600.0f;
+        }
+    }
+
+    // Pesos relativos; normalize() converte cada linha em distribuição
+    void allow(int from, int to, float weight) {
+        if (from >= 0 && to >= 0 && from < stages && to < stages && from != to) {
+            transition[from][to] = weight;
+        }
+    }
+
+    void dwell(int stage, float minimum, float typical) {
+        if (stage >= 0 && stage < stages) {
+            minDwell[stage] = minimum;
+            typicalDwell[stage] = typical > minimum ? typical : minimum + DECODER_TAU_MIN;
+        }
+    }
+
+    // Linha sem nenhuma transição declarada vira uniforme (nunca fica presa)
+    void normalize() {
+        for (int i = 0; i < stages; i++) {
+            float sum = 0.0f;
+            for (int j = 0; j < stages; j++) {
+                if (j != i) sum += transition[i][j];
+            }
+            for (int j = 0; j < stages; j++) {
+                if (j == i) {
+                    transition[i][j] = 0.0f;
+                } else if (sum > 0.0f) {
+                    transition[i][j] /= sum;
+                } else {
+                    transition[i][j] = 1.0f / (stages - 1);
+                }
+            }
+        }
+    }
+};
+
+struct StageDecoder {
+    const StageDecoderConfig* config;
+    float belief[DECODER_MAX_STAGES];
+    int label;                      // etapa decodificada
+    float elapsed;                  // s na etapa decodificada
+    uint32_t updates;
+    uint32_t switches;
+
+    void begin(const StageDecoderConfig* cfg, int initialLabel) {
+        config = cfg;
+        label = initialLabel >= 0 && initialLabel < cfg->stages ? initialLabel : 0;
+        elapsed = 0.0f;
+        updates = 0;
+        switches = 0;
+        // Começa quase certo da etapa inicial, mas sem zerar as outras
+        float rest = cfg->stages > 1 ? 0.1f / (cfg->stages - 1) : 0.0f;
+        for (int i = 0; i < cfg->stages; i++) {
+            belief[i] = i == label ? (cfg->stages > 1 ? 0.9f : 1.0f) : rest;
+        }
+    }
+
+    float confidence() const { return belief[label]; }
+
+    float leaveProbability(int stage, float dt) const {
+        float t = stage == label ? elapsed : 0.0f;
+        float typical = config->typicalDwell[stage];
+        float rate;
+        if (t < config->minDwell[stage]) {
+            rate = 1.0f / (DECODER_EARLY_FACTOR * typical);
+        } else {
+            float remaining = typical - t;
+            rate = 1.0f / (remaining > DECODER_TAU_MIN ? remaining : DECODER_TAU_MIN);
+        }
+        return 1.0f - expf(-dt * rate);
+    }
+
+    // Uma observação (probabilidades da CNN, soma ~1) após dt segundos.
+    // Retorna true se a etapa decodificada mudou
+    bool update(const float* probs, float dt) {
+        const int n = config->stages;
+        if (dt < 0.0f) dt = 0.0f;
+
+        float leave[DECODER_MAX_STAGES];
+        for (int i = 0; i < n; i++) {
+            leave[i] = leaveProbability(i, dt);
+        }
+
+        // Predição: p(j) = p(i) * (ficar ou sair de i para j)
+        float next[DECODER_MAX_STAGES];
+        for (int j = 0; j < n; j++) {
+            next[j] = belief[j] * (1.0f - leave[j]);
+        }
+        for (int i = 0; i < n; i++) {
+            float out = belief[i] * leave[i];
+            if (out <= 0.0f) continue;
+            for (int j = 0; j < n; j++) {
+                next[j] += out * config->transition[i][j];
+            }
+        }
+
+        // Correção com a CNN (piso evita que um 0 quantizado zere a crença)
+        float sum = 0.0f;
+        for (int j = 0; j < n; j++) {
+            float p = probs[j] > DECODER_EMISSION_FLOOR ? probs[j] : DECODER_EMISSION_FLOOR;
+            next[j] *= p;
+            sum += next[j];
+        }
+        if (!(sum > 0.0f)) {
+            // Underflow ou NaN: recomeça só com a observação
+            sum = 0.0f;
+            for (int j = 0; j < n; j++) {
+                next[j] = probs[j] > DECODER_EMISSION_FLOOR ? probs[j] : DECODER_EMISSION_FLOOR;
+                sum += next[j];
+            }
+        }
+        for (int j = 0; j < n; j++) {
+            belief[j] = next[j] / sum;
+        }
+        updates++;
+
+        int best = label;
+        for (int j = 0; j < n; j++) {
+            if (belief[j] > belief[best]) best = j;
+        }
+        if (best != label && belief[best] >= DECODER_SWITCH_POSTERIOR) {
+            label = best;
+            elapsed = 0.0f;
+            switches++;
+            return true;
+        }
+        elapsed += dt;
+        return false;
+    }
+};
+
+#endif // STAGE_DECODER_H
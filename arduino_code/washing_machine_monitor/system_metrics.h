@@ -0,0 +1,262 @@
+#ifndef SYSTEM_METRICS_H
+#define SYSTEM_METRICS_H
+
+// Métricas do sistema servidas em /metrics (metrics.h): latência de cada
+// etapa do caminho ML e de cada rota HTTP, contadores de frames, frames
+// pulados e erros, e medidores de memória.
+// O caminho quente só chama metricsObserve()/metricsCount() (atômicos, sem
+// locks nem alocação); heap e PSRAM são lidos na hora da raspagem, na
+// tarefa web. Etapas:
+//   capture      captureImage() até o frame na mão
+//   resize       redimensionamento/conversão do frame para a entrada do modelo
+//   dsp          bloco DSP do SDK (no caminho direto, a cópia para o tensor)
+//   invoke       interpreter->Invoke()
+//   postprocess  processMLResult(): decodificador de etapas, histórico, publicação
+// Marcos do boot (ms desde o reset, gravados uma vez): câmera e modelo
+// prontos, primeira predição, WiFi com IP e serviços de rede no ar.
+
+#include <andreluiz-project-1_inferencing.h>
+#include "config.h"
+#include "metrics.h"
+#include "http_server.h"
+
+enum MetricsStage {
+    METRICS_CAPTURE,
+    METRICS_RESIZE,
+    METRICS_DSP,
+    METRICS_INVOKE,
+    METRICS_POSTPROCESS,
+    METRICS_STAGE_COUNT
+};
+
+enum MetricsSkip {
+    METRICS_SKIP_QUEUE_FULL,        // fila do pipeline cheia: frame descartado
+    METRICS_SKIP_UNCHANGED,         // painel sem mudança: resultado anterior reaproveitado
+    METRICS_SKIP_LEDS,              // classificado só pelos LEDs calibrados
+    METRICS_SKIP_COUNT
+};
+
+enum MetricsError {
+    METRICS_ERROR_CAPTURE,
+    METRICS_ERROR_CONVERT,
+    METRICS_ERROR_INFERENCE,
+    METRICS_ERROR_COUNT
+};
+
+enum MetricsBoot {
+    METRICS_BOOT_CAMERA,            // esp_camera_init concluído
+    METRICS_BOOT_MODEL,             // sessão TFLite persistente pronta
+    METRICS_BOOT_FIRST_PREDICTION,  // primeiro resultado no processMLResult()
+    METRICS_BOOT_WIFI,              // IP recebido
+    METRICS_BOOT_NETWORK,           // mDNS e Sinric Pro iniciados
+    METRICS_BOOT_COUNT
+};
+
+static const char* const METRICS_STAGE_LABELS[METRICS_STAGE_COUNT] = {
+    "stage=\"capture\"", "stage=\"resize\"", "stage=\"dsp\"", "stage=\"invoke\"", "stage=\"postprocess\""
+};
+
+static const char* const METRICS_SKIP_LABELS[METRICS_SKIP_COUNT] = {
+    "reason=\"queue_full\"", "reason=\"unchanged\"", "reason=\"leds\""
+};
+
+static const char* const METRICS_ERROR_LABELS[METRICS_ERROR_COUNT] = {
+    "source=\"capture\"", "source=\"convert\"", "source=\"inference\""
+};
+
+static const char* const METRICS_BOOT_LABELS[METRICS_BOOT_COUNT] = {
+    "milestone=\"camera\"", "milestone=\"model\"", "milestone=\"first_prediction\"",
+    "milestone=\"wifi\"", "milestone=\"network\""
+};
+
+// Estado do corpo chunked do /metrics (cabe em HTTP_PRODUCER_STATE)
+struct MetricsCursor {
+    uint16_t item;
+};
+
+// =================== VARIÁVEIS GLOBAIS ===================
+extern HttpServer httpServer;
+
+LatencyHistogram metricsStages[METRICS_STAGE_COUNT];
+LatencyHistogram metricsHttp[HTTP_MAX_ROUTES + 1];  // última posição: rota não encontrada
+MetricsCounter metricsFrames{0};
+MetricsCounter metricsSkipped[METRICS_SKIP_COUNT];
+MetricsCounter metricsErrors[METRICS_ERROR_COUNT];
+MetricsCounter metricsArenaHighWater{0};
+MetricsCounter metricsBoot[METRICS_BOOT_COUNT];   // ms desde o reset; 0 = ainda não
+
+// =================== FUNÇÕES PÚBLICAS ===================
+void metricsObserve(MetricsStage stage, uint32_t us);
+void metricsCountFrame();
+void metricsCountSkip(MetricsSkip reason);
+void metricsCountError(MetricsError source);
+void metricsObserveArena();
+void metricsObserveHttp(int route, uint32_t us);
+void metricsMarkBoot(MetricsBoot milestone);
+bool writeMetricsItem(int item, MetricsWriter& out);
+size_t metricsProducer(void* state, char* buf, size_t size);
+
+// =================== IMPLEMENTAÇÃO ===================
+
+void metricsObserve(MetricsStage stage, uint32_t us) {
+    metricsStages[stage].observe(us);
+}
+
+void metricsCountFrame() {
+    metricsFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void metricsCountSkip(MetricsSkip reason) {
+    metricsSkipped[reason].fetch_add(1, std::memory_order_relaxed);
+}
+
+void metricsCountError(MetricsError source) {
+    metricsErrors[source].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Marca d'água da arena: com sessão persistente o planejador só roda no
+// AllocateTensors da sessão; sem ela, a cada inferência
+void metricsObserveArena() {
+    const ei_tflite_session_t* session = ei_tflite_get_session();
+    size_t used = session->active ? session->setup_timing.arena_used_bytes
+                                  : ei_tflite_get_last_timing()->arena_used_bytes;
+    metricsRaise(metricsArenaHighWater, (uint32_t)used);
+}
+
+// Observador do HttpServer (tarefa web): tempo do handler por rota, -1 = 404
+void metricsObserveHttp(int route, uint32_t us) {
+    metricsHttp[route < 0 ? HTTP_MAX_ROUTES : route].observe(us);
+}
+
+// Só a primeira chamada de cada marco conta; qualquer tarefa
+void metricsMarkBoot(MetricsBoot milestone) {
+    uint32_t expected = 0;
+    uint32_t now = millis();
+    metricsBoot[milestone].compare_exchange_strong(expected, now > 0 ? now : 1, std::memory_order_relaxed);
+}
+
+// Um item do /metrics: cabeçalho de uma família, uma série de histograma ou
+// um grupo de amostras. false depois do último item
+bool writeMetricsItem(int item, MetricsWriter& out) {
+    HistogramSnapshot snapshot;
+
+    if (item == 0) {
+        writeMetricHeader(out, "washer_stage_duration_seconds", "histogram",
+                          "Latencia de cada etapa do caminho ML");
+        return true;
+    }
+    item--;
+    if (item < METRICS_STAGE_COUNT) {
+        metricsStages[item].snapshot(snapshot);
+        writeHistogram(out, "washer_stage_duration_seconds", METRICS_STAGE_LABELS[item], snapshot);
+        return true;
+    }
+    item -= METRICS_STAGE_COUNT;
+
+    if (item == 0) {
+        writeMetricHeader(out, "washer_http_handler_duration_seconds", "histogram",
+                          "Tempo do handler de cada rota HTTP");
+        return true;
+    }
+    item--;
+    if (item <= HTTP_MAX_ROUTES) {
+        // Só rotas registradas que já receberam pedidos ("*" = não encontrada)
+        bool notFound = item == HTTP_MAX_ROUTES;
+        if (!notFound && item >= httpServer.routeCount) {
+            return true;
+        }
+        metricsHttp[item].snapshot(snapshot);
+        if (snapshot.count > 0) {
+            char labels[64];
+            snprintf(labels, sizeof(labels), "path=\"%s\"", notFound ? "*" : httpServer.routes[item].path);
+            writeHistogram(out, "washer_http_handler_duration_seconds", labels, snapshot);
+        }
+        return true;
+    }
+    item -= HTTP_MAX_ROUTES + 1;
+
+    switch (item) {
+        case 0:
+            writeMetricHeader(out, "washer_frames_total", "counter", "Frames capturados para o caminho ML");
+            writeMetricSample(out, "washer_frames_total", nullptr, metricsFrames.load(std::memory_order_relaxed));
+            return true;
+        case 1:
+            writeMetricHeader(out, "washer_frames_skipped_total", "counter", "Frames sem inferencia da CNN");
+            for (int i = 0; i < METRICS_SKIP_COUNT; i++) {
+                writeMetricSample(out, "washer_frames_skipped_total", METRICS_SKIP_LABELS[i],
+                                  metricsSkipped[i].load(std::memory_order_relaxed));
+            }
+            return true;
+        case 2:
+            writeMetricHeader(out, "washer_errors_total", "counter", "Erros no caminho ML");
+            for (int i = 0; i < METRICS_ERROR_COUNT; i++) {
+                writeMetricSample(out, "washer_errors_total", METRICS_ERROR_LABELS[i],
+                                  metricsErrors[i].load(std::memory_order_relaxed));
+            }
+            return true;
+        case 3:
+            writeMetricHeader(out, "washer_heap_free_bytes", "gauge", "Heap interno livre");
+            writeMetricSample(out, "washer_heap_free_bytes", nullptr, ESP.getFreeHeap());
+            writeMetricHeader(out, "washer_heap_min_free_bytes", "gauge", "Menor heap livre desde o boot");
+            writeMetricSample(out, "washer_heap_min_free_bytes", nullptr, ESP.getMinFreeHeap());
+            writeMetricHeader(out, "washer_heap_largest_block_bytes", "gauge", "Maior bloco alocavel do heap");
+            writeMetricSample(out, "washer_heap_largest_block_bytes", nullptr, ESP.getMaxAllocHeap());
+            return true;
+        case 4:
+            writeMetricHeader(out, "washer_psram_free_bytes", "gauge", "PSRAM livre");
+            writeMetricSample(out, "washer_psram_free_bytes", nullptr, ESP.getFreePsram());
+            writeMetricHeader(out, "washer_psram_size_bytes", "gauge", "PSRAM total");
+            writeMetricSample(out, "washer_psram_size_bytes", nullptr, ESP.getPsramSize());
+            return true;
+        case 5:
+            writeMetricHeader(out, "washer_tflite_arena_used_bytes", "gauge",
+                              "Marca d'agua da arena do TFLite Micro");
+            writeMetricSample(out, "washer_tflite_arena_used_bytes", nullptr,
+                              metricsArenaHighWater.load(std::memory_order_relaxed));
+            writeMetricHeader(out, "washer_tflite_arena_size_bytes", "gauge", "Arena declarada pelo modelo");
+            writeMetricSample(out, "washer_tflite_arena_size_bytes", nullptr, EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE);
+            return true;
+        case 6:
+            writeMetricHeader(out, "washer_uptime_seconds", "gauge", "Tempo desde o boot");
+            writeMetricSample(out, "washer_uptime_seconds", nullptr, millis() / 1000);
+            return true;
+        case 7:
+            writeMetricHeader(out, "washer_boot_milestone_milliseconds", "gauge",
+                              "Tempo do reset ate cada marco do boot");
+            for (int i = 0; i < METRICS_BOOT_COUNT; i++) {
+                uint32_t at = metricsBoot[i].load(std::memory_order_relaxed);
+                if (at > 0) {
+                    writeMetricSample(out, "washer_boot_milestone_milliseconds", METRICS_BOOT_LABELS[i], at);
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Produtor do corpo chunked de /metrics (tarefa web): itens inteiros por
+// pedaço, cada histograma copiado na hora em que é escrito
+size_t metricsProducer(void* state, char* buf, size_t size) {
+    MetricsCursor* cursor = (MetricsCursor*)state;
+    size_t used = 0;
+
+    while (used < size) {
+        MetricsWriter out(buf + used, size - used);
+        if (!writeMetricsItem(cursor->item, out)) {
+            break;
+        }
+        if (!out.ok()) {
+            if (used > 0) {
+                break;              // fica para o próximo pedaço
+            }
+            // Item maior que o buffer inteiro: pulado para não travar o corpo
+        } else {
+            used += out.length();
+        }
+        cursor->item++;
+    }
+    return used;
+}
+
+#endif // SYSTEM_METRICS_H
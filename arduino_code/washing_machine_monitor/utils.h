@@ -2,13 +2,15 @@
 #define UTILS_H
 
 #include "config.h"
+#include "json_writer.h"
+#include "wash_stage.h"
 
 // =================== FUNÇÕES PÚBLICAS ===================
 void indicateStageChange();
 String formatUptime(unsigned long seconds);
 void printSystemDiagnostics();
 float getWiFiSignalQuality();
-String getSystemStatusJSON();
+void writeSystemStatusJSON(JsonWriter& json);
 void performSystemMaintenance();
 
 // =================== IMPLEMENTAÇÃO ===================
@@ -48,7 +50,7 @@ String formatUptime(unsigned long seconds) {
 }
 
 void printSystemDiagnostics() {
-    extern String currentWashingStage;
+    extern WashStage currentWashingStage;
     extern float lastConfidence;
     extern unsigned long getSystemUptime();
     
@@ -70,7 +72,7 @@ void printSystemDiagnostics() {
     Serial.printf("│ CPU Freq: %-27d │\n", ESP.getCpuFreqMHz());
     
     // Status do sistema (sem ML)
-    Serial.printf("│ Estado: %-29s │\n", currentWashingStage.c_str());
+    Serial.printf("│ Estado: %-29s │\n", washStageLabel(currentWashingStage));
     Serial.printf("│ Confianca: %-26.1f │\n", lastConfidence * 100);
     Serial.printf("│ Modo: %-31s │\n", "Demonstracao");
     
@@ -92,28 +94,27 @@ float getWiFiSignalQuality() {
     return quality;
 }
 
-String getSystemStatusJSON() {
-    extern String currentWashingStage;
+// Estado completo do sistema no buffer do chamador (sem String temporárias)
+void writeSystemStatusJSON(JsonWriter& json) {
+    extern WashStage currentWashingStage;
     extern float lastConfidence;
     extern unsigned long getSystemUptime();
     
-    String json = "{";
-    json += "\"stage\":\"" + currentWashingStage + "\",";
-    json += "\"confidence\":" + String(lastConfidence) + ",";
-    json += "\"uptime\":" + String(getSystemUptime()) + ",";
-    json += "\"heap_free\":" + String(ESP.getFreeHeap()) + ",";
-    json += "\"wifi_rssi\":" + String(WiFi.RSSI()) + ",";
-    json += "\"wifi_quality\":" + String(getWiFiSignalQuality()) + ",";
-    json += "\"cpu_freq\":" + String(ESP.getCpuFreqMHz()) + ",";
-    json += "\"mode\":\"demonstration\",";
-    json += "\"timestamp\":" + String(millis());
-    json += "}";
-    
-    return json;
+    json.beginObject()
+        .field("stage", washStageLabel(currentWashingStage))
+        .field("confidence", lastConfidence)
+        .field("uptime", getSystemUptime())
+        .field("heap_free", ESP.getFreeHeap())
+        .field("wifi_rssi", WiFi.RSSI())
+        .field("wifi_quality", getWiFiSignalQuality())
+        .field("cpu_freq", ESP.getCpuFreqMHz())
+        .field("mode", "demonstration")
+        .field("timestamp", millis())
+        .endObject();
 }
 
 void performSystemMaintenance() {
-    extern String currentWashingStage;
+    extern WashStage currentWashingStage;
     extern float lastConfidence;
     extern unsigned long getSystemUptime();
     
@@ -206,8 +207,8 @@ bool validateSystemState() {
     }
     
     // Verificar estado do sistema
-    extern String currentWashingStage;
-    if (currentWashingStage == "") {
+    extern WashStage currentWashingStage;
+    if (currentWashingStage >= WASH_STAGE_COUNT) {
         logError("Estado do sistema nao inicializado", "validateSystemState");
         isValid = false;
     }
@@ -0,0 +1,59 @@
+#ifndef WASH_CYCLE_H
+#define WASH_CYCLE_H
+
+// Conhecimento prévio do ciclo de lavagem usado pelo decodificador e pelo
+// agendador de predições: Desligado -> Molho_* -> Enxague -> Centrifugação
+// -> Desligado. As etapas são procuradas pelo nome nos rótulos do modelo;
+// as que o modelo não tiver são ignoradas. Não depende do Arduino (usado no host).
+
+#include <string.h>
+#include "stage_decoder.h"
+
+inline int washStageIndex(const char* const* labels, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(labels[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Pesos são relativos por etapa de origem; durações em segundos (mínima, típica)
+inline void configureWashCycle(StageDecoderConfig& cfg, const char* const* labels, int count) {
+    int off = washStageIndex(labels, count, "Desligado");
+    int rinse = washStageIndex(labels, count, "Enxague");
+    int spin = washStageIndex(labels, count, "Centrifugação");
+    int soaks[] = {
+        washStageIndex(labels, count, "Molho_curto"),
+        washStageIndex(labels, count, "Molho_normal"),
+        washStageIndex(labels, count, "Molho_longo"),
+    };
+
+    cfg.begin(count);
+
+    for (int soak : soaks) {
+        cfg.allow(off, soak, 0.3f);
+        cfg.allow(soak, rinse, 0.85f);
+        cfg.allow(soak, off, 0.05f);            // ciclo cancelado
+        for (int other : soaks) {
+            cfg.allow(soak, other, 0.05f);      // molhos se confundem
+        }
+        cfg.allow(rinse, soak, 0.05f);          // segunda lavagem
+    }
+    cfg.allow(off, rinse, 0.05f);               // programa só enxágue
+    cfg.allow(off, spin, 0.05f);                // programa só centrifugação
+    cfg.allow(rinse, spin, 0.75f);
+    cfg.allow(rinse, off, 0.1f);
+    cfg.allow(spin, off, 0.8f);
+    cfg.allow(spin, rinse, 0.2f);               // centrifugação intermediária
+    cfg.normalize();
+
+    cfg.dwell(off, 0, 300);
+    cfg.dwell(soaks[0], 120, 600);
+    cfg.dwell(soaks[1], 300, 1200);
+    cfg.dwell(soaks[2], 600, 2400);
+    cfg.dwell(rinse, 120, 600);
+    cfg.dwell(spin, 60, 480);
+}
+
+#endif // WASH_CYCLE_H
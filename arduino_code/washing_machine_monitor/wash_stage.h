@@ -0,0 +1,90 @@
+#ifndef WASH_STAGE_H
+#define WASH_STAGE_H
+
+// Etapas da lavadora como números pequenos: o ID é o índice da classe no
+// modelo (ei_classifier_inferencing_categories), o mesmo do decodificador
+// de etapas e do histórico. O caminho ML, o Sinric, a web e os logs trocam
+// só o ID; os textos saem da tabela na hora de formatar.
+// A tabela repete os rótulos de model-parameters/model_variables.h na mesma
+// ordem; initializeMLModel() confere com o modelo carregado. Ao retreinar
+// com outras classes, atualize WASH_STAGES.
+// Não depende do Arduino (usado no host).
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t WashStage;
+
+#define WASH_STAGE_ERROR        -1      // performMLPrediction() sem resultado
+
+struct WashStageInfo {
+    const char* label;              // rótulo do modelo (UTF-8)
+    const char* key;                // ASCII minúsculo: pasta de data_collection/, logs
+    uint8_t number;                 // posição no ciclo (mapStageToNumber do Sinric)
+    const char* phrase;             // resposta da Alexa
+};
+
+constexpr WashStageInfo WASH_STAGES[] = {
+    { "Centrifugação", "centrifugacao", 5, "A lavadora esta centrifugando as roupas" },
+    { "Desligado",     "desligado",     0, "A lavadora esta desligada" },
+    { "Enxague",       "enxague",       4, "A lavadora esta enxaguando as roupas" },
+    { "Molho_curto",   "molho_curto",   1, "A lavadora esta no ciclo de molho" },
+    { "Molho_longo",   "molho_longo",   3, "A lavadora esta no ciclo de molho" },
+    { "Molho_normal",  "molho_normal",  2, "A lavadora esta no ciclo de molho" },
+};
+
+constexpr int WASH_STAGE_COUNT = sizeof(WASH_STAGES) / sizeof(WASH_STAGES[0]);
+
+constexpr bool washStageTextEquals(const char* a, const char* b) {
+    return *a == *b && (*a == '\0' || washStageTextEquals(a + 1, b + 1));
+}
+
+// ID pelo rótulo do modelo em tempo de compilação; -1 se não existe
+constexpr int washStageFind(const char* label, int from = 0) {
+    return from >= WASH_STAGE_COUNT ? -1
+         : washStageTextEquals(WASH_STAGES[from].label, label) ? from
+         : washStageFind(label, from + 1);
+}
+
+constexpr WashStage STAGE_SPIN = washStageFind("Centrifugação");
+constexpr WashStage STAGE_OFF = washStageFind("Desligado");
+constexpr WashStage STAGE_RINSE = washStageFind("Enxague");
+constexpr WashStage STAGE_SOAK_SHORT = washStageFind("Molho_curto");
+constexpr WashStage STAGE_SOAK_LONG = washStageFind("Molho_longo");
+constexpr WashStage STAGE_SOAK_NORMAL = washStageFind("Molho_normal");
+
+static_assert(washStageFind("Desligado") >= 0 && washStageFind("Centrifugação") >= 0 &&
+              washStageFind("Enxague") >= 0, "tabela de etapas sem Desligado/Enxague/Centrifugacao");
+
+inline const char* washStageLabel(int stage) {
+    return stage >= 0 && stage < WASH_STAGE_COUNT ? WASH_STAGES[stage].label : "?";
+}
+
+inline const char* washStageKey(int stage) {
+    return stage >= 0 && stage < WASH_STAGE_COUNT ? WASH_STAGES[stage].key : "?";
+}
+
+// Etapa pela posição no ciclo (inverso de WashStageInfo::number); Desligado se não existe
+inline WashStage washStageFromNumber(int number) {
+    for (int i = 0; i < WASH_STAGE_COUNT; i++) {
+        if (WASH_STAGES[i].number == number) {
+            return i;
+        }
+    }
+    return STAGE_OFF;
+}
+
+// Tabela na mesma ordem e com os mesmos rótulos do modelo
+inline bool washStagesMatchModel(const char* const* labels, int count) {
+    if (count != WASH_STAGE_COUNT) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (strcmp(labels[i], WASH_STAGES[i].label) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // WASH_STAGE_H
@@ -2,12 +2,12 @@
 // ARQUIVO PRINCIPAL - ML ORIGINAL FUNCIONANDO
 
 #include "WiFi.h"
-#include "WebServer.h"
 #include <ESPmDNS.h>
 #include <SinricPro.h>
 #include <SinricProSwitch.h>
 
 // Edge Impulse
+// #define EI_CLASSIFIER_GRAYSCALE_MODEL 1  // Modelo de 1 canal + camera em escala de cinza
 #include <andreluiz-project-1_inferencing.h>
 
 // Módulos do projeto
@@ -16,15 +16,24 @@
 #include "web_server.h"
 #include "utils.h"
 #include "ml_inference.h"
+#include "ml_pipeline.h"
+#include "frame_replay.h"
+#include "model_store.h"
 #include "sinric_integration.h"
+#include "wifi_manager.h"
+
+#ifndef BOOT_NETWORK_POLL
+#define BOOT_NETWORK_POLL       100     // ms máximos de espera do loop() até a rede subir
+#endif
 
 // =================== VARIÁVEIS GLOBAIS ===================
-WebServer server(WEB_SERVER_PORT);
-String currentWashingStage = "Desligado";
-String lastWashingStage = "";
+HttpServer httpServer;
+WashStage currentWashingStage = STAGE_OFF;
+WashStage lastWashingStage = STAGE_OFF;
 float lastConfidence = 0.0;
 unsigned long lastPrediction = 0;
 unsigned long systemStartTime = 0;
+bool networkServicesStarted = false;
 
 // =================== SETUP PRINCIPAL ===================
 void setup() {
@@ -39,133 +48,159 @@ void setup() {
     pinMode(LED_BUILTIN_PIN, OUTPUT);
     digitalWrite(LED_BUILTIN_PIN, LOW);
     
-    // 1. Configurar câmera
-    Serial.println("1. Configurando camera ESP32-CAM...");
+    // 1. WiFi associa em segundo plano enquanto câmera e modelo sobem
+    Serial.println("1. Iniciando WiFi em segundo plano...");
+    initializeWiFiManagement();
+    initializePowerManagement();
+    
+    // 2. Configurar câmera
+    Serial.println("\n2. Configurando camera ESP32-CAM...");
     if (!initializeCamera()) {
         Serial.println("ERRO FATAL: Falha ao configurar camera!");
         blinkErrorLED();
         while(1) delay(1000);
     }
+    metricsMarkBoot(METRICS_BOOT_CAMERA);
     Serial.println("Camera configurada com sucesso!");
     
-    // 2. Conectar WiFi
-    Serial.println("\n2. Conectando ao WiFi...");
-    if (!connectToWiFi()) {
-        Serial.println("ERRO FATAL: Falha ao conectar WiFi!");
-        blinkErrorLED();
-        while(1) delay(1000);
-    }
-    Serial.println("WiFi conectado!");
-    
-    // 3. Configurar mDNS
-    Serial.println("\n3. Configurando mDNS...");
-    if (MDNS.begin(MDNS_NAME)) {
-        Serial.println("mDNS configurado! Acesso: http://" + String(MDNS_NAME) + ".local");
-    } else {
-        Serial.println("Falha ao configurar mDNS (nao critico)");
-    }
-    
-    // 4. Inicializar modelo ML
-    Serial.println("\n4. Inicializando modelo TinyML...");
+    // 3. Inicializar modelo ML (sessão persistente do interpretador), com o
+    //    modelo mais novo da partição "model" se houver
+    Serial.println("\n3. Inicializando modelo TinyML...");
+    initializeModelStore();
     if (!initializeMLModel()) {
         Serial.println("ERRO: Falha ao carregar modelo ML!");
         Serial.println("Sistema continuara sem deteccao automatica");
     } else {
+        metricsMarkBoot(METRICS_BOOT_MODEL);
         Serial.println("Modelo ML carregado com sucesso!");
     }
+    initializeLedCalibration();
+    initializeHistory();
     
-    // 5. Configurar integração Sinric Pro
-    Serial.println("\n5. Configurando integracao Sinric Pro...");
-    if (!setupSinricProIntegration()) {
-        Serial.println("Aviso: Sinric Pro nao configurado");
-    } else {
-        Serial.println("Sinric Pro configurado!");
+    // 4. Teste inicial do sistema (câmera ainda livre do pipeline)
+    Serial.println("\n4. Executando teste inicial...");
+    performSystemTest();
+    
+    // 5. Pipeline de captura/inferência nos dois núcleos: primeira predição já
+    Serial.println("\n5. Iniciando pipeline ML...");
+    if (!startMLPipeline()) {
+        Serial.println("Aviso: Pipeline inativo, predicao sera feita no loop");
     }
     
-    // 6. Configurar servidor web
+    // 6. Servidor web: escuta desde já, responde assim que o WiFi tiver IP
     Serial.println("\n6. Configurando servidor web...");
     setupWebServer();
+    initializeStream(CAMERA_FRAME_WIDTH * CAMERA_FRAME_HEIGHT * 2);
+    initializeFrameReplay();
     Serial.println("Servidor web ativo!");
     
-    // 7. Teste inicial do sistema
-    Serial.println("\n7. Executando teste inicial...");
-    performSystemTest();
-    
+    // mDNS e Sinric Pro sobem no loop(), quando o WiFi conectar
     digitalWrite(LED_BUILTIN_PIN, HIGH);
     Serial.println("\n==========================================");
-    Serial.println("        SISTEMA PRONTO!");
-    Serial.println("==========================================");
-    printSystemInfo();
-    Serial.println("Sistema funcionando com TinyML!");
-    Serial.println("Capturando imagens e detectando estados da lavadora!");
+    Serial.printf("   SISTEMA PRONTO em %lu ms (rede em segundo plano)\n", millis() - systemStartTime);
     Serial.println("==========================================\n");
     
-    lastPrediction = millis();
+    // Sem pipeline, a primeira predição sai na primeira volta do loop()
+    lastPrediction = millis() - predictionIntervalMs;
 }
 
 // =================== LOOP PRINCIPAL ===================
 void loop() {
     unsigned long now = millis();
     
-    // 1. Gerenciar servidor web
-    handleWebServerRequests();
+    // 1. Pedidos da interface web (o servidor HTTP roda em tarefa própria)
+    if (takeWebPredictionRequest()) {
+        forcePrediction();
+    }
+    runRequestedFrameReplay();      // /replay: bloqueia até o fim da gravação
+    runRequestedModelUpdate();      // /model: troca para o modelo já baixado e gravado
     
-    // 2. Gerenciar Sinric Pro
-    handleSinricProRequests();
+    // 2. WiFi (tempos da reconexão) e serviços de rede assim que conectar
+    updateWiFiManagement();
+    startNetworkServices();
     
-    // 3. Executar predição ML periodicamente
-    if (now - lastPrediction >= PREDICTION_INTERVAL) {
-        String prediction = performMLPrediction();
-        if (prediction != "erro") {
+    // 3. Aplicar resultados do pipeline ML (ou predição periódica sem pipeline)
+    if (isMLPipelineRunning()) {
+        if (processPipelineResults() > 0) {
+            lastPrediction = now;
+        }
+    } else if (now - lastPrediction >= predictionIntervalMs) {
+        powerBeginWork();
+        int prediction = performMLPrediction();
+        powerEndWork(prediction != WASH_STAGE_ERROR);
+        if (prediction != WASH_STAGE_ERROR) {
             lastPrediction = now;
         }
     }
     
-    // 4. Atualizar LED de status
+    // 4. Publicar estado atual para o servidor web
+    publishWebStatus();
+    
+    // 5. Atualizar LED de status
     updateStatusLED();
     
-    // 5. Manutenção do sistema
+    // 6. Manutenção do sistema
     static unsigned long lastMaintenance = 0;
     if (now - lastMaintenance > 60000) { // A cada minuto
         performBasicMaintenance();
         lastMaintenance = now;
     }
     
-    delay(50);
+    // 7. Energia: clock e light sleep até a próxima captura agendada
+    int32_t untilCapture = msUntilNextCapture(millis());
+    if (!networkServicesStarted && untilCapture > BOOT_NETWORK_POLL) {
+        untilCapture = BOOT_NETWORK_POLL;   // não atrasar a subida da rede
+    }
+    uint32_t untilWiFi = msUntilWiFiDue(millis());
+    if ((uint32_t)untilCapture > untilWiFi) {
+        untilCapture = untilWiFi;           // próxima tentativa de reconexão
+    }
+    delay(updatePowerManagement(untilCapture, streamClients));
 }
 
 // =================== FUNÇÕES AUXILIARES ===================
 
-bool connectToWiFi() {
-    #ifdef USE_STATIC_IP
-    if (USE_STATIC_IP) {
-        if (!WiFi.config(STATIC_IP, GATEWAY, SUBNET, DNS_PRIMARY, DNS_SECONDARY)) {
-            Serial.println("Falha ao configurar IP estatico, usando DHCP");
-        }
+// Chamado a cada volta do loop(): na primeira vez com IP, sobe mDNS e Sinric Pro
+void startNetworkServices() {
+    if (networkServicesStarted || WiFi.status() != WL_CONNECTED) {
+        return;
     }
-    #endif
-    
-    WiFi.setTxPower(WIFI_POWER_19_5dBm);
-    WiFi.mode(WIFI_STA);
-    WiFi.setAutoReconnect(true);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    
-    int attempts = 0;
-    Serial.print("Conectando");
-    while (WiFi.status() != WL_CONNECTED && attempts < 30) {
-        delay(1000);
-        Serial.print(".");
-        attempts++;
-        
-        if (attempts % 10 == 0) {
-            Serial.print("\nTentando reconectar...");
-            WiFi.disconnect();
-            delay(1000);
-            WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-        }
+    metricsMarkBoot(METRICS_BOOT_WIFI);
+    Serial.printf("WiFi conectado em %lu ms: %s\n", millis() - systemStartTime,
+                 WiFi.localIP().toString().c_str());
+    
+    if (MDNS.begin(MDNS_NAME)) {
+        Serial.println("mDNS configurado! Acesso: http://" + String(MDNS_NAME) + ".local");
+    } else {
+        Serial.println("Falha ao configurar mDNS (nao critico)");
     }
     
-    return (WiFi.status() == WL_CONNECTED);
+    if (!setupSinricProIntegration()) {
+        Serial.println("Aviso: Sinric Pro nao configurado");
+    } else {
+        Serial.println("Sinric Pro configurado!");
+    }
+    
+    networkServicesStarted = true;
+    metricsMarkBoot(METRICS_BOOT_NETWORK);
+    printSystemInfo();
+    printBootTimings();
+}
+
+void printBootTimings() {
+    static const char* const names[METRICS_BOOT_COUNT] = {
+        "camera", "modelo", "primeira predicao", "WiFi", "rede"
+    };
+    Serial.print("Boot (ms):");
+    for (int i = 0; i < METRICS_BOOT_COUNT; i++) {
+        uint32_t at = metricsBoot[i].load();
+        if (at > 0) {
+            Serial.printf(" %s %lu", names[i], (unsigned long)at);
+        } else {
+            Serial.printf(" %s -", names[i]);
+        }
+    }
+    Serial.println();
 }
 
 void performSystemTest() {
@@ -174,7 +209,7 @@ void performSystemTest() {
     Serial.print("- Teste de captura de imagem... ");
     camera_fb_t* fb = captureImage();
     if (fb) {
-        Serial.printf("OK (%d bytes)\n", fb->len);
+        Serial.printf("OK (%lu bytes)\n", (unsigned long)fb->len);
         releaseCameraBuffer(fb);
     } else {
         Serial.println("FALHOU");
@@ -195,7 +230,7 @@ void performSystemTest() {
     if (WiFi.status() == WL_CONNECTED) {
         Serial.println("OK");
     } else {
-        Serial.println("FALHOU");
+        Serial.println("conectando em segundo plano");
     }
     
     Serial.println("Testes concluidos!");
@@ -211,8 +246,8 @@ void printSystemInfo() {
     Serial.printf("│ Servidor: http://%-18s │\n", WiFi.localIP().toString().c_str());
     Serial.printf("│ Heap livre: %-25d │\n", ESP.getFreeHeap());
     Serial.printf("│ Modelo ML: %-26s │\n", validateModel() ? "Ativo" : "Inativo");
-    Serial.printf("│ Sinric Pro: %-24s │\n", SinricPro.isConnected() ? "Conectado" : "Desconectado");
-    Serial.printf("│ Chip ID: 0x%-25llX │\n", ESP.getEfuseMac());
+    Serial.printf("│ Sinric Pro: %-24s │\n", sinricConnected ? "Conectado" : "Desconectado");
+    Serial.printf("│ Chip ID: 0x%-25llX │\n", (unsigned long long)ESP.getEfuseMac());
     Serial.println("└─────────────────────────────────────┘");
 }
 
@@ -222,7 +257,7 @@ void updateStatusLED() {
     
     unsigned long now = millis();
     
-    if (currentWashingStage == "Desligado") {
+    if (currentWashingStage == STAGE_OFF) {
         if (now - lastLEDUpdate > 2000) {
             ledState = !ledState;
             digitalWrite(LED_BUILTIN_PIN, ledState);
@@ -244,8 +279,28 @@ void blinkErrorLED() {
 
 void forcePrediction() {
     Serial.println("Predicao forcada via web interface");
-    String result = performMLPrediction();
-    Serial.printf("Resultado da predicao forcada: %s\n", result.c_str());
+    if (isMLPipelineRunning()) {
+        // Câmera e interpretador pertencem às tarefas do pipeline
+        requestPipelineCapture();
+        return;
+    }
+    powerBeginWork();
+    int result = performMLPrediction();
+    powerEndWork(result != WASH_STAGE_ERROR);
+    Serial.printf("Resultado da predicao forcada: %s\n", result != WASH_STAGE_ERROR ? washStageLabel(result) : "erro");
+}
+
+// ms até a captura agendada (pipeline ou loop); 0 se já devida
+int32_t msUntilNextCapture(unsigned long now) {
+    if (PIPELINE_CONTINUOUS && isMLPipelineRunning()) {
+        return 0;
+    }
+    if (isMLPipelineRunning() && pipelineCaptureRequested) {
+        return 0;
+    }
+    unsigned long base = isMLPipelineRunning() ? pipelineLastCaptureAt : lastPrediction;
+    int32_t remaining = (int32_t)(base + predictionIntervalMs - now);
+    return remaining > 0 ? remaining : 0;
 }
 
 unsigned long getSystemUptime() {
@@ -257,23 +312,41 @@ void performBasicMaintenance() {
     
     Serial.printf("Manutencao: Heap=%d, Etapa=%s, Conf=%.1f%%, Uptime=%lus\n", 
                  freeHeap, 
-                 currentWashingStage.c_str(),
+                 washStageLabel(currentWashingStage),
                  lastConfidence * 100,
                  getSystemUptime());
     
-    // Verificar WiFi
-    if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("AVISO: WiFi desconectado - tentando reconectar");
-        WiFi.reconnect();
+    if (isMLPipelineRunning()) {
+        Serial.printf("Pipeline: %lu frames, %lu descartados, fila %u (max %lu), inferencia %lu ms\n",
+                     (unsigned long)pipelineFrames.consumed.load(),
+                     (unsigned long)pipelineFrames.dropped.load(),
+                     (unsigned)pipelineFrames.depth(),
+                     (unsigned long)pipelineFrames.maxDepth.load(),
+                     (unsigned long)(pipelineLastInferenceUs / 1000));
+    }
+    if (streamClients > 0) {
+        printStreamStatistics();
     }
     
+    // Padrões de LED aprendidos desde a última manutenção
+    saveLedCalibrationIfDirty();
+    
+    // Histórico: grava o lote pendente e mostra o uso da partição
+    flushHistory();
+    printHistoryStatistics();
+    printPowerStatistics();
+    
+    // WiFi: a reconexão é feita pelos eventos; aqui só o lease e o relatório
+    saveWiFiLeaseIfDirty();
+    printWiFiStatistics();
+    
     // Verificar memória crítica
     if (freeHeap < 50000) {
         Serial.printf("AVISO: Memoria baixa: %d bytes\n", freeHeap);
     }
     
     // Verificar Sinric Pro
-    if (!SinricPro.isConnected()) {
+    if (!sinricConnected) {
         Serial.println("AVISO: Sinric Pro desconectado");
     }
 }
\ No newline at end of file
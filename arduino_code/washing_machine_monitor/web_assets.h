@@ -0,0 +1,325 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+// GERADO por tools/embed_web_assets.py a partir de web/ - NAO EDITAR.
+// Para alterar o dashboard, edite web/*.html e rode:
+//   python3 tools/embed_web_assets.py
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct WebAsset {
+    const char* path;
+    const char* contentType;
+    const uint8_t* data;            // gzip
+    size_t length;
+    size_t originalLength;
+    const char* etag;               // ETag forte, já entre aspas
+};
+
+// index.html: 6774 -> 2563 bytes
+static const uint8_t WEB_INDEX_HTML_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x59, 0x5b, 0x6f, 0xdb, 0xc8,
+    0x15, 0x7e, 0xf7, 0xaf, 0x38, 0x41, 0x10, 0x90, 0xde, 0x8a, 0xd4, 0xcd, 0xf2, 0x45, 0xb6, 0xd5,
+    0x66, 0x6d, 0x6f, 0x91, 0xc2, 0x69, 0x82, 0xda, 0xd9, 0x62, 0x9f, 0x8a, 0x11, 0x39, 0x94, 0x66,
+    0x43, 0x71, 0xd8, 0xe1, 0x50, 0xb6, 0x93, 0x0d, 0xd0, 0x87, 0x3e, 0xf5, 0xa1, 0x79, 0x48, 0x9f,
+    0x02, 0x14, 0xd9, 0x45, 0x0b, 0xe4, 0xb1, 0x28, 0x16, 0x2d, 0x8a, 0xbe, 0xfa, 0x9f, 0xe4, 0x0f,
+    0x34, 0x3f, 0xa1, 0xe7, 0xcc, 0x90, 0x14, 0x45, 0xc9, 0x8e, 0x77, 0x81, 0x05, 0x02, 0x89, 0x1a,
+    0xce, 0x9c, 0xcb, 0x77, 0xbe, 0x73, 0x99, 0xf8, 0xe0, 0xde, 0xf1, 0x93, 0xa3, 0xf3, 0xaf, 0x9e,
+    0x9e, 0xc0, 0x54, 0xcf, 0xe2, 0xd1, 0xc6, 0x01, 0x7d, 0x41, 0xcc, 0x92, 0xc9, 0xa1, 0x93, 0x6a,
+    0xef, 0xf3, 0xdf, 0x38, 0xb4, 0xc6, 0x59, 0x88, 0x5f, 0x33, 0xae, 0x19, 0x04, 0x53, 0xa6, 0x32,
+    0xae, 0x0f, 0x9d, 0x67, 0xe7, 0x5f, 0x78, 0xbb, 0x4e, 0xb9, 0x9c, 0xb0, 0x19, 0x3f, 0x74, 0xe6,
+    0x82, 0x5f, 0xa4, 0x52, 0x69, 0x07, 0x02, 0x99, 0x68, 0x9e, 0xe0, 0xb6, 0x0b, 0x11, 0xea, 0xe9,
+    0x61, 0xc8, 0xe7, 0x22, 0xe0, 0x9e, 0xf9, 0xd1, 0x02, 0x91, 0x08, 0x2d, 0x58, 0xec, 0x65, 0x01,
+    0x8b, 0xf9, 0x61, 0xd7, 0xef, 0x90, 0x18, 0x2d, 0x74, 0xcc, 0x47, 0xa7, 0x6c, 0xce, 0x42, 0xa9,
+    0x18, 0x3c, 0xc2, 0xf3, 0xb1, 0x98, 0xa0, 0x0c, 0x0e, 0x1e, 0x3c, 0x96, 0x78, 0x44, 0x2a, 0x78,
+    0x24, 0xcf, 0x0f, 0xda, 0x76, 0xe7, 0xc6, 0x41, 0xa6, 0xaf, 0xe8, 0xfb, 0x33, 0x78, 0x09, 0x63,
+    0x79, 0xe9, 0x65, 0xe2, 0x85, 0x48, 0x26, 0x43, 0x7c, 0x56, 0x21, 0x57, 0x1e, 0x2e, 0xed, 0xc3,
+    0x8c, 0xa9, 0x89, 0x48, 0x86, 0xd0, 0xd9, 0x87, 0x94, 0x85, 0xa1, 0x79, 0x8f, 0xcf, 0xaf, 0x36,
+    0xc6, 0x32, 0xbc, 0xc2, 0x73, 0x11, 0x9a, 0xe9, 0x45, 0x6c, 0x26, 0xe2, 0xab, 0x21, 0x38, 0x67,
+    0x7c, 0x22, 0x39, 0x3c, 0x7b, 0xe4, 0xb4, 0xe0, 0x9c, 0x4d, 0xe5, 0x8c, 0xb5, 0xe0, 0x97, 0x3c,
+    0xe1, 0x73, 0xfc, 0xfe, 0x92, 0xab, 0x90, 0x25, 0xf8, 0x90, 0xb1, 0x24, 0xf3, 0x32, 0xae, 0x44,
+    0xb4, 0x0f, 0x63, 0x16, 0x3c, 0x9f, 0x28, 0x99, 0x27, 0xe1, 0x10, 0x62, 0x91, 0x70, 0xa6, 0xbc,
+    0x89, 0x62, 0xa1, 0x40, 0xa3, 0xdd, 0x6e, 0x7f, 0x10, 0xf2, 0x49, 0x0b, 0xee, 0x6f, 0x6f, 0xef,
+    0x70, 0xce, 0xa0, 0xf3, 0x00, 0x9f, 0x77, 0xb6, 0xb7, 0xc6, 0xac, 0x07, 0xdd, 0x4e, 0xe7, 0xc1,
+    0xe6, 0x3e, 0x62, 0x14, 0x4b, 0x35, 0x84, 0xfb, 0xfd, 0x7e, 0x1f, 0x2d, 0x15, 0x89, 0x37, 0xe5,
+    0x62, 0x32, 0xd5, 0x43, 0x7a, 0x3f, 0x9f, 0xd6, 0x2c, 0xee, 0x75, 0xd2, 0x4b, 0x32, 0xda, 0x27,
+    0x54, 0x19, 0x2a, 0x52, 0x68, 0xfa, 0x8c, 0x5d, 0x5a, 0x3c, 0x87, 0xb0, 0xdb, 0x31, 0x1b, 0x2a,
+    0x67, 0x81, 0xe5, 0x5a, 0x2e, 0x9b, 0xa7, 0x26, 0x63, 0xe6, 0xf6, 0x06, 0x83, 0x16, 0x2c, 0x3e,
+    0x3a, 0xfe, 0xde, 0x00, 0xcd, 0x28, 0xf0, 0x22, 0xc3, 0xf3, 0xac, 0x54, 0x66, 0x00, 0x9d, 0x62,
+    0x28, 0x2e, 0x48, 0x1e, 0xad, 0xc1, 0x16, 0x7d, 0x18, 0x39, 0x1d, 0x3c, 0x6b, 0xff, 0xf9, 0x5d,
+    0x14, 0x20, 0xe7, 0x5c, 0x45, 0x31, 0xed, 0x9c, 0x8a, 0x30, 0xe4, 0x89, 0x31, 0x95, 0x38, 0x63,
+    0xec, 0xbc, 0x13, 0x48, 0xbd, 0xa0, 0xcf, 0x07, 0x28, 0xf0, 0x7e, 0x7f, 0x6b, 0x6b, 0x6f, 0xc0,
+    0x17, 0xe0, 0x5c, 0x4c, 0x85, 0xe6, 0x35, 0x28, 0xfa, 0xc6, 0x3a, 0xcd, 0x2f, 0xb5, 0xc7, 0x90,
+    0x1e, 0xe8, 0x6d, 0x40, 0x14, 0x51, 0x75, 0x9d, 0xd3, 0x6e, 0x19, 0x59, 0xa4, 0x04, 0x47, 0x8f,
+    0xfc, 0x01, 0x9f, 0x95, 0xf0, 0x20, 0x2f, 0xb4, 0x96, 0x33, 0x02, 0x99, 0x24, 0x99, 0x6d, 0x17,
+    0x05, 0xee, 0xfd, 0x4e, 0xa7, 0x2e, 0x27, 0x45, 0x31, 0x32, 0x65, 0x81, 0xd0, 0x48, 0x0e, 0x04,
+    0x6b, 0xbf, 0x2e, 0xb4, 0xeb, 0x77, 0x49, 0x68, 0x11, 0x14, 0xb4, 0x01, 0x37, 0x57, 0x56, 0x6e,
+    0x95, 0x01, 0xcb, 0x34, 0xd3, 0x79, 0xe6, 0x05, 0x4c, 0x85, 0x0d, 0x28, 0xee, 0x47, 0xbb, 0xd1,
+    0x5e, 0xc4, 0x56, 0xe0, 0xef, 0x0e, 0xe8, 0x68, 0xc3, 0xdf, 0x86, 0xe9, 0xfd, 0x22, 0x44, 0xe6,
+    0x60, 0xcc, 0x23, 0x34, 0x1d, 0x4f, 0x41, 0x26, 0x63, 0x11, 0x12, 0x84, 0x7b, 0xbb, 0xe1, 0xb8,
+    0xae, 0x3e, 0x66, 0x63, 0x1e, 0x2f, 0x63, 0xd2, 0xf5, 0x7b, 0x64, 0x7e, 0x49, 0xc1, 0x9d, 0x68,
+    0x37, 0xd8, 0x0d, 0x57, 0x31, 0x1a, 0x54, 0x68, 0x6b, 0x85, 0xc4, 0x8f, 0xa4, 0xc2, 0xd5, 0x3c,
+    0x4d, 0xb9, 0x0a, 0x58, 0x86, 0x71, 0x89, 0xb9, 0x46, 0xf0, 0xbd, 0x8c, 0x50, 0x22, 0x73, 0xbb,
+    0x2b, 0x98, 0x6e, 0x17, 0x98, 0x06, 0xb9, 0x52, 0x9c, 0xd4, 0x6b, 0x36, 0xe1, 0xcb, 0xb6, 0xf4,
+    0xc9, 0x92, 0xa5, 0x43, 0x63, 0x19, 0x87, 0x0b, 0xe3, 0x2c, 0x39, 0xee, 0x68, 0x5c, 0xc0, 0x52,
+    0xa1, 0x91, 0x1a, 0x2f, 0x78, 0x19, 0x9c, 0x48, 0x20, 0x27, 0x03, 0xde, 0xf4, 0xbf, 0x5f, 0xf7,
+    0xbf, 0xb7, 0xc3, 0xf8, 0x76, 0xe7, 0x06, 0xd3, 0x45, 0x12, 0x49, 0xe4, 0xac, 0xa0, 0x10, 0x86,
+    0x22, 0x4b, 0x63, 0x86, 0x7c, 0xa0, 0xdf, 0xfb, 0xe6, 0xd3, 0xd3, 0x7c, 0x86, 0x6b, 0x9a, 0x7b,
+    0x28, 0x2d, 0x9f, 0x25, 0x18, 0x44, 0xc5, 0x53, 0xce, 0xb4, 0x4b, 0x69, 0xe8, 0x45, 0x42, 0xb7,
+    0x28, 0xbb, 0x31, 0x5f, 0xdd, 0x1e, 0x25, 0x6a, 0x0b, 0xba, 0x91, 0xda, 0x44, 0x8a, 0x4f, 0x58,
+    0x5a, 0xa6, 0xdb, 0xda, 0x00, 0x97, 0xaa, 0x31, 0x03, 0x66, 0x0d, 0xf6, 0x34, 0xd3, 0xa2, 0x57,
+    0x67, 0x44, 0x45, 0xa5, 0x1b, 0x73, 0x65, 0x39, 0xbb, 0x89, 0x3b, 0x04, 0xe6, 0x4a, 0x72, 0x77,
+    0x76, 0xab, 0xf2, 0x60, 0x42, 0x5b, 0x32, 0x8c, 0x07, 0x51, 0x27, 0xea, 0x36, 0x0c, 0x9c, 0xf6,
+    0xd1, 0xc6, 0xaa, 0xa4, 0x99, 0x34, 0xbe, 0x2d, 0xe7, 0x9a, 0x59, 0xb4, 0x10, 0xe4, 0xcf, 0x59,
+    0x9c, 0xaf, 0x84, 0x6b, 0xf0, 0x09, 0x92, 0xd4, 0x58, 0xcf, 0x02, 0x2d, 0x64, 0x92, 0xd5, 0xa3,
+    0x15, 0xc5, 0xfc, 0xb2, 0x00, 0xdc, 0xd2, 0x86, 0x16, 0xbc, 0x0b, 0x45, 0x0b, 0xf4, 0xb9, 0x0f,
+    0x5f, 0xe7, 0x99, 0x16, 0xd1, 0x95, 0x57, 0x64, 0xf3, 0x52, 0x5d, 0x19, 0xeb, 0xe4, 0xae, 0x85,
+    0xcc, 0x9a, 0x41, 0x15, 0x6d, 0x6f, 0xb7, 0x33, 0xde, 0x5b, 0x29, 0x64, 0x25, 0x9a, 0x89, 0x4c,
+    0xea, 0xf1, 0x33, 0xf0, 0xf7, 0xd7, 0x05, 0xb1, 0x37, 0x58, 0x0f, 0xd9, 0x2a, 0x53, 0x31, 0xc3,
+    0x32, 0xd2, 0x94, 0x4a, 0x61, 0x2d, 0x37, 0x59, 0x21, 0x08, 0x8b, 0x21, 0xb0, 0x38, 0xc6, 0x80,
+    0xf6, 0x33, 0xe0, 0x26, 0x6f, 0x0d, 0x29, 0x42, 0x1e, 0x60, 0xa7, 0xb5, 0xef, 0xad, 0x3d, 0x15,
+    0x5e, 0x22, 0x21, 0x0f, 0xbd, 0x71, 0x2c, 0x83, 0xe7, 0xb6, 0x37, 0x15, 0xad, 0xa6, 0x3b, 0x28,
+    0xa9, 0x89, 0xa0, 0x0c, 0xa7, 0x54, 0xfa, 0x11, 0x9a, 0x5a, 0xfe, 0x99, 0x47, 0xca, 0x86, 0xaf,
+    0x5c, 0xaf, 0x97, 0x5e, 0x6e, 0x36, 0xc9, 0x46, 0x14, 0x30, 0x4e, 0x59, 0xb6, 0x0d, 0x7a, 0x98,
+    0x0e, 0xf4, 0xd1, 0xeb, 0xee, 0x11, 0xe5, 0xfa, 0x9b, 0xa5, 0x70, 0x3f, 0x43, 0xf3, 0x92, 0x90,
+    0xa9, 0xab, 0xbb, 0x62, 0xbf, 0x37, 0x60, 0x03, 0xb6, 0xdd, 0x2a, 0xab, 0x99, 0x95, 0x14, 0x49,
+    0xa9, 0x57, 0xfa, 0x50, 0xc5, 0xe0, 0x46, 0x02, 0xad, 0xcb, 0x95, 0x66, 0x89, 0xac, 0x85, 0x02,
+    0x7b, 0x42, 0xc1, 0xde, 0xa2, 0xd0, 0x8a, 0x24, 0x14, 0x01, 0xa3, 0x41, 0xe5, 0xe5, 0x4d, 0x58,
+    0x96, 0x38, 0xf6, 0x48, 0x5f, 0xd5, 0xf0, 0x7b, 0x6b, 0x22, 0x3f, 0xe8, 0x3c, 0x58, 0xee, 0xe1,
+    0x55, 0x95, 0x2a, 0xb2, 0x4a, 0xd9, 0xc3, 0xbb, 0x74, 0x96, 0x25, 0x62, 0x56, 0x84, 0x32, 0xcd,
+    0xe3, 0x8c, 0x43, 0x2f, 0x43, 0xc5, 0x11, 0x4d, 0x5a, 0x7c, 0xad, 0x85, 0xbe, 0x8c, 0x22, 0xb2,
+    0x6b, 0x05, 0x99, 0x9d, 0xad, 0xa0, 0x1f, 0xd0, 0x91, 0x5f, 0x3c, 0xe7, 0x57, 0x91, 0xc2, 0xb9,
+    0x2e, 0x2b, 0x44, 0xbe, 0xc4, 0x21, 0x66, 0x39, 0xd8, 0x66, 0x80, 0x73, 0xcd, 0x0c, 0x50, 0xf6,
+    0x49, 0x2a, 0x0b, 0x64, 0xfa, 0xda, 0x8d, 0xfe, 0xd2, 0xd6, 0x8e, 0xbf, 0x43, 0x9b, 0x69, 0x1a,
+    0xba, 0x9b, 0x58, 0xb4, 0x69, 0xc6, 0x43, 0xc1, 0xc0, 0xad, 0x0d, 0x3f, 0xdb, 0x54, 0x53, 0x37,
+    0x51, 0x40, 0x63, 0x3a, 0xb2, 0xb3, 0x50, 0x77, 0x6d, 0x61, 0x34, 0x39, 0xf5, 0x0a, 0x16, 0x43,
+    0x4a, 0x73, 0xd4, 0x82, 0x1b, 0x67, 0x09, 0x13, 0x70, 0x58, 0xd7, 0xf4, 0xab, 0xa3, 0xb7, 0xb4,
+    0xba, 0xf2, 0xf8, 0xa2, 0x44, 0x99, 0x42, 0x14, 0x0a, 0xc5, 0x03, 0x1b, 0x3d, 0xdb, 0x43, 0xcc,
+    0x26, 0x5b, 0x76, 0x4a, 0xc2, 0x74, 0x88, 0x0e, 0x84, 0xc1, 0x41, 0xbb, 0x18, 0x7c, 0x0f, 0xda,
+    0xc5, 0x60, 0x4e, 0xc3, 0x2c, 0x7e, 0x85, 0x62, 0x0e, 0x41, 0xcc, 0xb2, 0xec, 0xd0, 0xa9, 0xa0,
+    0x70, 0x96, 0xd7, 0xad, 0x57, 0x66, 0xa6, 0xef, 0x8e, 0x3e, 0xbe, 0x7b, 0xfd, 0x2d, 0xac, 0x1b,
+    0xb8, 0x51, 0x70, 0x17, 0xb7, 0xa4, 0xa3, 0x62, 0xec, 0x46, 0x0e, 0x24, 0x5a, 0xd2, 0xf0, 0x0d,
+    0x58, 0x9f, 0xa9, 0xdd, 0x49, 0x6c, 0x71, 0x2c, 0x3e, 0x68, 0xa7, 0x64, 0x05, 0xca, 0x5f, 0xd5,
+    0x8e, 0x27, 0x1a, 0xba, 0x6b, 0xb3, 0xd0, 0xfa, 0x37, 0x66, 0x4c, 0x71, 0x46, 0x07, 0x38, 0x4d,
+    0x24, 0x8d, 0x57, 0x15, 0x6d, 0x1d, 0x10, 0x61, 0xb9, 0xfa, 0xa8, 0x5a, 0x1c, 0x21, 0x26, 0x78,
+    0x68, 0x74, 0x66, 0xd6, 0xe1, 0xa1, 0xce, 0xc9, 0xb8, 0x55, 0xbb, 0xea, 0x81, 0xb1, 0x92, 0x8a,
+    0xa5, 0x33, 0xb3, 0x32, 0x3a, 0x62, 0xf8, 0x6b, 0xc2, 0x92, 0x50, 0xfa, 0xbe, 0xbf, 0xde, 0xb1,
+    0x62, 0x9a, 0x28, 0x4e, 0x2f, 0x7e, 0x8f, 0x8e, 0xe8, 0x99, 0x25, 0x01, 0x1b, 0x82, 0xe7, 0x95,
+    0x67, 0x57, 0x45, 0x54, 0xc3, 0x84, 0xb3, 0x66, 0x9d, 0xfa, 0x1f, 0x3a, 0x33, 0xed, 0x8f, 0x3e,
+    0xbc, 0xfe, 0xe7, 0xff, 0xfe, 0xf3, 0x1a, 0xce, 0x0d, 0xd6, 0x4f, 0x4c, 0x05, 0xc1, 0xa8, 0xf4,
+    0x47, 0xf5, 0x23, 0xa6, 0x4f, 0x5a, 0x43, 0xf2, 0x54, 0x8b, 0x19, 0x1a, 0x51, 0x6a, 0xbe, 0x49,
+    0xf1, 0x42, 0xc1, 0xc7, 0x77, 0x7f, 0xf9, 0x23, 0x5c, 0xbf, 0x8d, 0xf1, 0x1c, 0xb3, 0x80, 0x89,
+    0x17, 0xec, 0xfa, 0xfd, 0xf5, 0xdf, 0xe4, 0x6d, 0x7a, 0x70, 0x41, 0x3f, 0x4b, 0x43, 0x2c, 0xef,
+    0x3f, 0x4c, 0xd7, 0x9b, 0x7f, 0x03, 0xe2, 0xc3, 0x2f, 0x3f, 0x21, 0x1e, 0xf1, 0x4c, 0x6c, 0x22,
+    0x38, 0xa3, 0xdf, 0x8a, 0x2f, 0xc4, 0xdd, 0x15, 0xbc, 0xff, 0x16, 0xef, 0x88, 0xe1, 0xad, 0xc2,
+    0x67, 0x32, 0x44, 0xab, 0x8f, 0xf9, 0x0c, 0x13, 0x0f, 0x8b, 0x4d, 0xe1, 0x6b, 0x5d, 0xc1, 0xaa,
+    0x9e, 0x22, 0x4f, 0x29, 0x56, 0xe3, 0x1c, 0x67, 0x98, 0x8a, 0x97, 0x98, 0x9b, 0x0e, 0xc8, 0x24,
+    0x88, 0x45, 0xf0, 0x9c, 0xe0, 0x27, 0x48, 0x2c, 0xfb, 0xdc, 0x4d, 0xc7, 0x82, 0x5b, 0x82, 0xaa,
+    0x0e, 0xda, 0xf6, 0xec, 0x3a, 0x21, 0x50, 0x75, 0xb9, 0x9a, 0x38, 0xac, 0x82, 0x01, 0x7f, 0xaa,
+    0xb0, 0xd4, 0x19, 0xf5, 0x24, 0xf1, 0xc3, 0xdb, 0xef, 0xe0, 0x4c, 0xcc, 0xf2, 0x98, 0x29, 0x78,
+    0x9c, 0xe3, 0x55, 0xf4, 0xfa, 0x3d, 0xab, 0xc9, 0x65, 0x37, 0x88, 0x9c, 0x2a, 0x1e, 0x1d, 0x3a,
+    0x6d, 0xac, 0xa7, 0x62, 0x6c, 0x5b, 0x3d, 0x19, 0xf7, 0xe7, 0x7f, 0xc0, 0x91, 0x5d, 0x51, 0x70,
+    0x7a, 0x72, 0x9c, 0x1d, 0xb4, 0xd9, 0xa7, 0x65, 0x20, 0x66, 0x9c, 0xcd, 0x1c, 0xd0, 0x58, 0x59,
+    0xe9, 0xfe, 0xff, 0xbb, 0x71, 0xcc, 0x92, 0xe7, 0x24, 0xee, 0xcd, 0x7f, 0xe1, 0xa1, 0x84, 0x2f,
+    0xc5, 0x5c, 0x5a, 0x41, 0x37, 0xa2, 0x69, 0x7b, 0xb1, 0x63, 0x4a, 0xcb, 0xc7, 0x77, 0x6f, 0xff,
+    0x00, 0x4f, 0xe5, 0x05, 0x47, 0x37, 0x61, 0x7c, 0x05, 0x27, 0x67, 0x4f, 0xfb, 0x3d, 0xef, 0xe8,
+    0xe1, 0x63, 0xf8, 0x06, 0x1d, 0xcd, 0x30, 0xb4, 0xcc, 0x76, 0x86, 0x93, 0x4c, 0x5f, 0x7f, 0x37,
+    0xc7, 0xfb, 0xcb, 0x37, 0x70, 0xcc, 0x33, 0x9e, 0xcc, 0x65, 0x3c, 0x17, 0xa1, 0xc4, 0x42, 0x39,
+    0x83, 0x0f, 0x7f, 0xfd, 0x3b, 0x66, 0xc9, 0x52, 0x19, 0x2a, 0xbe, 0xb2, 0x40, 0x89, 0x54, 0x8f,
+    0x36, 0xf0, 0x82, 0x02, 0x22, 0x33, 0x94, 0xc5, 0x22, 0x0d, 0x87, 0x10, 0x31, 0x6c, 0x65, 0xfb,
+    0x1b, 0x51, 0x9e, 0x18, 0x6c, 0x21, 0x9b, 0xca, 0x0b, 0x93, 0xfd, 0x2e, 0x6e, 0x61, 0xd8, 0x47,
+    0x36, 0x42, 0x19, 0xe4, 0x54, 0xf0, 0x7c, 0x74, 0xf3, 0x24, 0xe6, 0xf4, 0xf8, 0xf9, 0xd5, 0xa3,
+    0xd0, 0x5d, 0xae, 0x15, 0x9b, 0x3e, 0x0d, 0x0b, 0x47, 0x45, 0x1b, 0x38, 0x04, 0x3a, 0xed, 0x9b,
+    0xc2, 0xe2, 0xd3, 0x7f, 0x91, 0x3c, 0xd4, 0x6e, 0x07, 0xb7, 0xc8, 0x67, 0x74, 0x57, 0x3a, 0xc2,
+    0x99, 0xcb, 0xdd, 0x84, 0x9f, 0xd5, 0x37, 0x65, 0x18, 0x6a, 0xd3, 0xe3, 0x6e, 0xd1, 0xb7, 0xa8,
+    0x2e, 0x4d, 0x6d, 0x4e, 0x51, 0x6d, 0x90, 0x05, 0x43, 0x70, 0x50, 0xf2, 0x63, 0xa6, 0xa7, 0xbe,
+    0xe9, 0xe1, 0xc6, 0x8f, 0xfa, 0xbd, 0xe7, 0x33, 0xc2, 0x91, 0xb4, 0x3b, 0x0f, 0x9c, 0x5b, 0xb4,
+    0xd5, 0x52, 0xbb, 0xa9, 0x2d, 0xe1, 0x17, 0x70, 0x8c, 0x2f, 0x5c, 0xf2, 0xe8, 0x54, 0x52, 0x77,
+    0x3e, 0xc7, 0x72, 0x73, 0xa6, 0x15, 0x62, 0xea, 0xa2, 0x0b, 0xaf, 0x96, 0xf1, 0x7c, 0x66, 0xaa,
+    0x91, 0x6b, 0x8b, 0xd2, 0x99, 0x61, 0x52, 0x46, 0xc8, 0x06, 0x94, 0x79, 0x30, 0x95, 0x38, 0xa8,
+    0xa2, 0x54, 0x63, 0x72, 0x14, 0x4b, 0xa9, 0x96, 0x77, 0x42, 0x1b, 0xfa, 0xd8, 0xd4, 0x51, 0xac,
+    0xdd, 0x8f, 0xd3, 0x67, 0xae, 0x79, 0xe3, 0x44, 0xe3, 0xc8, 0x03, 0x7b, 0x04, 0x8f, 0x6e, 0x77,
+    0x6e, 0x83, 0xb4, 0xa8, 0x93, 0x4d, 0x07, 0xad, 0x49, 0x88, 0xd0, 0xd4, 0x80, 0x59, 0x6a, 0xc4,
+    0x85, 0x99, 0xb3, 0xec, 0x1d, 0xd7, 0xb6, 0x18, 0xbb, 0xd2, 0x7c, 0x2d, 0xbc, 0x5a, 0x8c, 0x7e,
+    0xc8, 0x85, 0x9b, 0xd4, 0x37, 0xfb, 0x16, 0x9a, 0xba, 0x18, 0xc8, 0x4c, 0x57, 0xf7, 0x17, 0xc3,
+    0x18, 0x0a, 0xb2, 0x4a, 0xe0, 0xe7, 0xe0, 0x14, 0xb3, 0x9f, 0x03, 0x18, 0xee, 0x62, 0x46, 0x73,
+    0xea, 0x87, 0x4d, 0x86, 0x9d, 0x62, 0xde, 0x60, 0x84, 0x26, 0x13, 0x9c, 0x9e, 0x9c, 0x62, 0xbe,
+    0x73, 0x5a, 0x70, 0xaf, 0xb0, 0x75, 0xc9, 0x93, 0xe5, 0x92, 0x85, 0x6e, 0x88, 0x08, 0xdc, 0x45,
+    0xa6, 0x6c, 0x62, 0x83, 0xd7, 0xb9, 0x4a, 0x50, 0x47, 0x3d, 0x7b, 0xb4, 0xca, 0xf9, 0xfe, 0x4f,
+    0xe9, 0xb1, 0x73, 0x3f, 0xea, 0xef, 0x05, 0xdd, 0x1e, 0x3a, 0x17, 0x71, 0x1d, 0x4c, 0x5d, 0x2a,
+    0x3c, 0x24, 0xc2, 0xd9, 0xdc, 0xf0, 0xf5, 0x94, 0x27, 0xae, 0xe2, 0x59, 0x8a, 0xfa, 0x39, 0x1c,
+    0x8e, 0xa0, 0x7c, 0xf6, 0xbf, 0xce, 0xa8, 0x4c, 0x96, 0x5b, 0x28, 0x03, 0xe8, 0xf5, 0xcb, 0x8d,
+    0x46, 0x76, 0xef, 0x6f, 0xd4, 0xe8, 0x69, 0xf2, 0xc4, 0x12, 0x82, 0x5e, 0x54, 0x91, 0x25, 0x1f,
+    0x09, 0x2b, 0x94, 0x86, 0x66, 0xa2, 0x09, 0x5c, 0x29, 0x72, 0x72, 0x54, 0xc4, 0x5a, 0xa2, 0xcd,
+    0x66, 0xc9, 0x75, 0x4e, 0xf0, 0x6b, 0x88, 0x08, 0x9b, 0x9f, 0xb7, 0xa6, 0xf2, 0x6d, 0xa5, 0xc3,
+    0x88, 0x81, 0x90, 0x57, 0x2d, 0xd2, 0xa9, 0x9b, 0x63, 0x0a, 0x56, 0x61, 0x0f, 0xce, 0xf3, 0x78,
+    0x91, 0xbb, 0x72, 0x31, 0x60, 0x64, 0xce, 0xba, 0xca, 0x06, 0xaf, 0x96, 0xe3, 0xbc, 0xd2, 0x4b,
+    0x2a, 0xc6, 0x52, 0x99, 0x3f, 0x04, 0x3e, 0x27, 0x7b, 0x6d, 0x51, 0x2f, 0x23, 0x2b, 0xf1, 0x66,
+    0x41, 0x9a, 0xce, 0xd1, 0x4c, 0xdc, 0x42, 0x97, 0xb1, 0x9a, 0xc5, 0xfb, 0x1b, 0x8d, 0x05, 0x72,
+    0xe1, 0xc3, 0xeb, 0xef, 0x8b, 0xfe, 0x64, 0x87, 0x27, 0xc7, 0xee, 0xc2, 0x4b, 0x10, 0x1b, 0xc7,
+    0x3c, 0xac, 0xa8, 0x53, 0x06, 0x35, 0xb5, 0x16, 0xfd, 0xa8, 0xa8, 0x02, 0xa1, 0x43, 0x05, 0x48,
+    0xe6, 0xba, 0x84, 0x62, 0x63, 0x99, 0xcf, 0xeb, 0x6c, 0xac, 0x7b, 0xb5, 0x62, 0x5d, 0xd1, 0x16,
+    0x5e, 0xb5, 0xa8, 0x58, 0x76, 0x7e, 0x40, 0xf8, 0x21, 0x61, 0x90, 0x19, 0xc7, 0xcd, 0x40, 0x51,
+    0x67, 0xc3, 0x8f, 0x34, 0x61, 0x39, 0x7e, 0x31, 0xf5, 0xc2, 0xe4, 0x84, 0xa2, 0x64, 0xf3, 0xb4,
+    0xdd, 0x86, 0xa7, 0x79, 0x36, 0xc5, 0x94, 0xb3, 0x3d, 0x73, 0x68, 0x43, 0x28, 0x21, 0xbb, 0xfe,
+    0x1e, 0x7e, 0x9f, 0x13, 0xfe, 0xc0, 0x80, 0x6b, 0x96, 0x32, 0x90, 0x39, 0x3e, 0x46, 0x4c, 0x5c,
+    0x32, 0xa2, 0x57, 0x50, 0xf5, 0x0c, 0x98, 0xe1, 0x08, 0xd1, 0xc2, 0x4b, 0x92, 0xc8, 0xf0, 0x0e,
+    0xca, 0x94, 0x1e, 0x73, 0xa6, 0x8b, 0xe0, 0x1b, 0x69, 0x59, 0x51, 0xf5, 0x8d, 0xde, 0x33, 0xac,
+    0x8e, 0xd8, 0xab, 0x9c, 0xb6, 0x7d, 0x45, 0x39, 0x6c, 0x9f, 0x7c, 0xbc, 0xfa, 0x98, 0x1d, 0xa7,
+    0xc6, 0x48, 0xae, 0xca, 0x7c, 0x27, 0x10, 0x6c, 0xa8, 0x16, 0x09, 0xf8, 0xab, 0xb3, 0x27, 0xbf,
+    0xf6, 0x53, 0xfa, 0xe3, 0x81, 0xcb, 0x7d, 0x93, 0x8d, 0x78, 0xbf, 0x6b, 0x66, 0x9d, 0x61, 0xef,
+    0x8d, 0xc2, 0x2b, 0x53, 0x97, 0xe5, 0x17, 0xf9, 0xbc, 0xaa, 0xa0, 0xca, 0xee, 0x5b, 0xf5, 0x60,
+    0xd2, 0xd9, 0x08, 0x83, 0xe5, 0xd2, 0x9a, 0xd4, 0x5b, 0x61, 0x17, 0x15, 0xcb, 0x0b, 0x2c, 0x64,
+    0xf2, 0xc2, 0xaf, 0x41, 0x44, 0xe1, 0x59, 0x8e, 0x17, 0x9e, 0x05, 0x6e, 0xee, 0xce, 0xc4, 0x59,
+    0xba, 0x62, 0x29, 0x9c, 0x48, 0xdd, 0xba, 0xb8, 0x16, 0xde, 0x96, 0x2d, 0xe3, 0x16, 0xe5, 0x63,
+    0xd5, 0xf5, 0xe3, 0x27, 0x8f, 0x0b, 0x1a, 0x9d, 0x4a, 0xbc, 0xc2, 0x85, 0x88, 0x40, 0x49, 0x91,
+    0x2a, 0xa5, 0x89, 0x99, 0xb1, 0x9c, 0xb8, 0xce, 0x8d, 0x17, 0x3b, 0xf0, 0xaa, 0xd9, 0xaa, 0xb8,
+    0xea, 0x84, 0xf2, 0x9e, 0x53, 0x74, 0xda, 0xda, 0xf1, 0x37, 0x7f, 0xaa, 0x5f, 0x09, 0xfe, 0x85,
+    0xad, 0x10, 0xe7, 0x2e, 0xc1, 0x42, 0x96, 0x41, 0xca, 0xe3, 0x82, 0x78, 0x48, 0xad, 0x00, 0x97,
+    0x0c, 0x97, 0x0c, 0xa9, 0x90, 0x62, 0x86, 0x76, 0xce, 0xa6, 0x65, 0x31, 0x5e, 0xca, 0x8a, 0x29,
+    0x0c, 0x27, 0x55, 0x7b, 0x45, 0x6d, 0xdb, 0xbf, 0x32, 0xfd, 0x1f, 0x52, 0xaf, 0xa4, 0xde, 0x76,
+    0x1a, 0x00, 0x00,
+};
+
+// calibration.html: 4858 -> 2060 bytes
+static const uint8_t WEB_CALIBRATION_HTML_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x58, 0x5b, 0x6f, 0xdc, 0xc6,
+    0x15, 0x7e, 0xd7, 0xaf, 0x98, 0x28, 0xa8, 0x49, 0xb6, 0xbb, 0xdc, 0xd5, 0xc5, 0x89, 0xab, 0x5d,
+    0xae, 0x50, 0x4b, 0x6e, 0xe2, 0x20, 0xb5, 0x53, 0xcb, 0x6e, 0x1a, 0x18, 0x41, 0x30, 0x22, 0x67,
+    0x97, 0x63, 0x93, 0x1c, 0x66, 0x38, 0x7b, 0x83, 0xa3, 0xc7, 0xbc, 0x36, 0xe8, 0x05, 0xed, 0x4b,
+    0x81, 0x14, 0xe8, 0x43, 0x81, 0xbe, 0x14, 0x28, 0x50, 0xb4, 0x0f, 0x45, 0x5f, 0xfc, 0x4f, 0xfa,
+    0x07, 0x9a, 0x9f, 0xd0, 0xef, 0xcc, 0x90, 0xbb, 0xe4, 0xda, 0xb2, 0x8c, 0xa2, 0x10, 0x24, 0x72,
+    0x2e, 0xe7, 0x9c, 0xef, 0xdc, 0x0f, 0x35, 0x7e, 0xe7, 0xfc, 0xe1, 0xd9, 0xe3, 0xcf, 0x3e, 0xb9,
+    0xc7, 0x52, 0x93, 0x67, 0x93, 0xbd, 0x31, 0x3d, 0x58, 0xc6, 0x8b, 0x59, 0xe4, 0x95, 0xa6, 0x7f,
+    0xf7, 0x91, 0x47, 0x7b, 0x82, 0x27, 0x78, 0xe4, 0xc2, 0x70, 0x16, 0xa7, 0x5c, 0x57, 0xc2, 0x44,
+    0xde, 0x93, 0xc7, 0x3f, 0xee, 0xdf, 0xf1, 0x9a, 0xed, 0x82, 0xe7, 0x22, 0xf2, 0x16, 0x52, 0x2c,
+    0x4b, 0xa5, 0x8d, 0xc7, 0x62, 0x55, 0x18, 0x51, 0xe0, 0xda, 0x52, 0x26, 0x26, 0x8d, 0x12, 0xb1,
+    0x90, 0xb1, 0xe8, 0xdb, 0x45, 0x8f, 0xc9, 0x42, 0x1a, 0xc9, 0xb3, 0x7e, 0x15, 0xf3, 0x4c, 0x44,
+    0x07, 0xe1, 0x90, 0xd8, 0x18, 0x69, 0x32, 0x31, 0x39, 0xe3, 0x99, 0xbc, 0xd4, 0x3c, 0xe6, 0x8a,
+    0x25, 0xaa, 0x62, 0x1f, 0xdf, 0x3b, 0xaf, 0xc6, 0x03, 0x77, 0xb4, 0x37, 0xae, 0xcc, 0x9a, 0x9e,
+    0x97, 0x2a, 0x59, 0xb3, 0x17, 0x6c, 0x0a, 0x11, 0xfd, 0x29, 0xcf, 0x65, 0xb6, 0x3e, 0x61, 0xde,
+    0x85, 0x98, 0x29, 0xc1, 0x9e, 0xdc, 0xf7, 0x7a, 0xec, 0x31, 0x4f, 0x55, 0xce, 0x7b, 0xac, 0xe2,
+    0x45, 0xd5, 0xaf, 0x84, 0x96, 0xd3, 0x11, 0xbb, 0xe4, 0xf1, 0xf3, 0x99, 0x56, 0xf3, 0x22, 0x39,
+    0x61, 0xef, 0x4e, 0x8f, 0xa7, 0xef, 0x4d, 0xef, 0x8c, 0x00, 0x32, 0x53, 0x1a, 0xeb, 0xc3, 0xf8,
+    0x48, 0xdc, 0x1e, 0x8e, 0x58, 0xc9, 0x93, 0x44, 0x16, 0xb3, 0x13, 0x76, 0x38, 0x2c, 0x57, 0x23,
+    0x76, 0xb5, 0x17, 0x4e, 0x35, 0xf4, 0x82, 0xac, 0x52, 0x55, 0x80, 0xac, 0x8a, 0x13, 0xa6, 0x45,
+    0xc6, 0x8d, 0x5c, 0x88, 0x11, 0x4b, 0x64, 0x55, 0x66, 0x1c, 0xb2, 0x65, 0x91, 0xc9, 0x42, 0xf4,
+    0x2f, 0x33, 0x15, 0x3f, 0x6f, 0x51, 0xc9, 0x7c, 0x06, 0x4a, 0xab, 0xf2, 0x09, 0x7b, 0xef, 0xd8,
+    0xb2, 0xcc, 0xf9, 0xaa, 0x5f, 0xef, 0x1c, 0x0c, 0x87, 0xdf, 0x03, 0x84, 0xb9, 0xae, 0x08, 0x43,
+    0xac, 0x55, 0x55, 0xa5, 0x5c, 0xea, 0x11, 0xe8, 0xf8, 0x4c, 0xf4, 0xb5, 0x28, 0x12, 0x40, 0x27,
+    0x34, 0xa5, 0x5c, 0x91, 0x50, 0x91, 0x40, 0x0d, 0xa5, 0xb1, 0xdb, 0xd7, 0x3c, 0x91, 0xf3, 0x8a,
+    0x78, 0xd4, 0x38, 0xab, 0x52, 0x99, 0x0e, 0x4c, 0x7e, 0x59, 0xa9, 0x6c, 0x6e, 0x00, 0xb3, 0x11,
+    0x77, 0x4c, 0x57, 0x53, 0x21, 0x67, 0xa9, 0x69, 0x56, 0x39, 0xd7, 0x33, 0x89, 0xcb, 0xfd, 0xf7,
+    0xcb, 0x15, 0x1b, 0xe2, 0x87, 0x5e, 0x1a, 0x21, 0xb0, 0x02, 0x76, 0xc1, 0x45, 0x26, 0xec, 0x5d,
+    0xf1, 0xfe, 0x71, 0x7c, 0x14, 0xbf, 0x22, 0xff, 0x36, 0xa9, 0x50, 0x2a, 0x09, 0x5f, 0xeb, 0xbe,
+    0x58, 0xc0, 0xe1, 0xd8, 0x2c, 0x54, 0x21, 0x2c, 0xa8, 0x4b, 0x53, 0x00, 0x53, 0xc7, 0xf2, 0x47,
+    0xc7, 0x3f, 0xbc, 0x93, 0x5c, 0x6e, 0x2c, 0xbf, 0x4c, 0x25, 0x41, 0x6c, 0x04, 0x3a, 0xca, 0x8d,
+    0x17, 0x48, 0xbb, 0xda, 0x15, 0x3b, 0x72, 0xdd, 0x66, 0x63, 0xbb, 0x1a, 0xc0, 0x56, 0x9f, 0xdb,
+    0xce, 0x2a, 0xa5, 0x16, 0x3b, 0xf2, 0x6b, 0x79, 0x5b, 0x09, 0xb7, 0x5f, 0xc3, 0xfc, 0x60, 0xd7,
+    0x53, 0xb5, 0xef, 0xd4, 0x42, 0xe8, 0x69, 0xa6, 0x96, 0x30, 0xee, 0xdc, 0x28, 0x12, 0x30, 0x1e,
+    0xd4, 0x11, 0x39, 0x1e, 0xd4, 0x29, 0x42, 0xa1, 0x49, 0x09, 0x73, 0x38, 0xf9, 0xee, 0xdb, 0x5f,
+    0xfc, 0x85, 0xbd, 0x26, 0x9a, 0xf1, 0x02, 0xf9, 0x88, 0x97, 0x0c, 0x44, 0x87, 0xb8, 0x5b, 0x4e,
+    0xce, 0x32, 0xf9, 0xe5, 0x5c, 0x40, 0x7b, 0x16, 0xc3, 0x82, 0x1a, 0x77, 0x05, 0x8b, 0x79, 0xc2,
+    0xe9, 0x3e, 0xf3, 0x01, 0x44, 0xe6, 0x8a, 0x8d, 0xab, 0x92, 0x17, 0x4c, 0x26, 0x91, 0x87, 0x8d,
+    0x0b, 0xb8, 0xbb, 0xf2, 0x26, 0xfd, 0x3e, 0x10, 0x60, 0x7b, 0x12, 0x30, 0x81, 0x68, 0xcf, 0x16,
+    0x22, 0x64, 0xe7, 0x02, 0xe6, 0xa8, 0x7a, 0xb0, 0x70, 0xce, 0x38, 0x12, 0x79, 0xc1, 0x13, 0xa5,
+    0x39, 0x13, 0x39, 0x9b, 0xe7, 0x78, 0x18, 0x5e, 0x72, 0x4a, 0xce, 0x54, 0xc4, 0x32, 0x41, 0x8e,
+    0xcc, 0x34, 0x5f, 0x08, 0x46, 0x90, 0x12, 0xcd, 0x55, 0x38, 0x1e, 0x94, 0x04, 0xc9, 0xca, 0x59,
+    0xca, 0x22, 0x51, 0xcb, 0x0f, 0x45, 0x56, 0x7a, 0xcc, 0xea, 0x19, 0x79, 0x4d, 0xc8, 0x93, 0xa3,
+    0xbc, 0xc9, 0x47, 0x1c, 0x5a, 0x70, 0x52, 0xa8, 0x12, 0x85, 0xf5, 0x04, 0xa4, 0xec, 0xff, 0x74,
+    0x0e, 0x56, 0x8a, 0x91, 0x4b, 0xa4, 0x56, 0xfb, 0x40, 0xe2, 0xd4, 0xa3, 0xb3, 0x73, 0x31, 0x45,
+    0xee, 0x6b, 0xf6, 0xcc, 0x52, 0xee, 0x03, 0x75, 0x62, 0xe1, 0x42, 0x77, 0x32, 0x0c, 0x5e, 0x62,
+    0x5e, 0x18, 0xd5, 0x32, 0x52, 0x8d, 0x28, 0x91, 0x0b, 0xf0, 0xe1, 0x55, 0x15, 0x79, 0x36, 0xb9,
+    0x3c, 0x8b, 0xd0, 0xbd, 0x4e, 0xc6, 0x94, 0x69, 0xb4, 0xae, 0x0a, 0x4e, 0x58, 0x75, 0x1c, 0x79,
+    0x03, 0x7a, 0xaf, 0x52, 0x85, 0x52, 0xa4, 0x0a, 0x20, 0x88, 0x9f, 0x47, 0x1e, 0xbc, 0x4e, 0x86,
+    0xf3, 0x6d, 0xa0, 0x06, 0xa0, 0x1b, 0x80, 0xad, 0x63, 0x4e, 0xae, 0x9b, 0x1b, 0xa3, 0x8a, 0x46,
+    0x0a, 0x62, 0xb7, 0x45, 0x89, 0xa4, 0x57, 0x3c, 0xb9, 0xa8, 0x59, 0xfa, 0xa0, 0xfd, 0xee, 0xdb,
+    0x5f, 0xff, 0x9d, 0x3d, 0x50, 0x0b, 0xee, 0xd2, 0x35, 0x1f, 0x0f, 0x1c, 0xfd, 0x0d, 0x8c, 0xe2,
+    0x4c, 0x70, 0x6d, 0xbd, 0xe7, 0x98, 0xfc, 0xee, 0x97, 0xff, 0xf9, 0xc7, 0x37, 0xec, 0x63, 0x99,
+    0x97, 0x5c, 0xbf, 0x25, 0x8b, 0x0a, 0x0e, 0x6b, 0x71, 0xf8, 0xd5, 0xbf, 0xd8, 0x05, 0x3c, 0xcf,
+    0xb5, 0x4d, 0xfe, 0x58, 0x89, 0xaa, 0xc5, 0x67, 0xab, 0x60, 0xcb, 0xa3, 0x77, 0xed, 0x69, 0x75,
+    0x8d, 0x53, 0x6f, 0x10, 0x6e, 0xb8, 0x36, 0x9f, 0x5a, 0x36, 0x4e, 0xfc, 0x6f, 0xfe, 0xca, 0xba,
+    0x4e, 0x7d, 0x5b, 0x2d, 0x44, 0xc3, 0x66, 0x7f, 0x3a, 0xcf, 0xb2, 0xe8, 0x60, 0xdf, 0xb2, 0xfb,
+    0xed, 0x3f, 0xc9, 0x1e, 0xdd, 0x10, 0x7a, 0xad, 0x3e, 0xd4, 0x0d, 0x44, 0x26, 0x62, 0xe3, 0x1c,
+    0x6f, 0xe0, 0x03, 0x72, 0xa8, 0xdb, 0xbb, 0xd1, 0x9b, 0x31, 0x32, 0xfe, 0x13, 0x6e, 0x50, 0x34,
+    0x0a, 0x52, 0xe3, 0xdf, 0xbf, 0xff, 0x9a, 0x7d, 0x80, 0x44, 0x20, 0x23, 0xda, 0x3c, 0x60, 0xdc,
+    0xcc, 0x79, 0xd6, 0x12, 0xcc, 0x3b, 0x9c, 0x52, 0x2d, 0xa6, 0x08, 0x31, 0x02, 0xfc, 0xcd, 0x1f,
+    0xd8, 0xcf, 0x54, 0x66, 0xc8, 0x7b, 0x7c, 0x0b, 0x90, 0x2a, 0x4f, 0x8d, 0xcb, 0xcc, 0x91, 0xa8,
+    0x67, 0x5c, 0x6b, 0x31, 0xe3, 0xd0, 0x37, 0x0c, 0x29, 0xa2, 0xb5, 0xed, 0x66, 0xb1, 0x96, 0x25,
+    0xb0, 0x66, 0xc2, 0x30, 0xaa, 0xdf, 0x15, 0x8b, 0xd8, 0xd3, 0xcf, 0x47, 0x76, 0xdd, 0xe4, 0x38,
+    0xb6, 0x86, 0xa3, 0xbd, 0xc1, 0x80, 0x3d, 0x12, 0x33, 0xf9, 0xf2, 0x8f, 0x28, 0x0d, 0x4d, 0xc0,
+    0x51, 0xb9, 0xf8, 0xd2, 0xd9, 0x09, 0xe5, 0x02, 0x80, 0x84, 0x7e, 0xf9, 0xe7, 0x22, 0x96, 0x9c,
+    0xf9, 0x47, 0x87, 0xc3, 0xd5, 0xe1, 0xf1, 0x30, 0x38, 0xb1, 0x21, 0xf1, 0xf2, 0x4f, 0x2f, 0xff,
+    0x26, 0x2a, 0xa4, 0x68, 0x4e, 0xa8, 0xe0, 0x22, 0x61, 0x25, 0x20, 0x16, 0xc0, 0xfc, 0x05, 0x5b,
+    0x9d, 0xb0, 0x61, 0x8f, 0xad, 0xed, 0x5f, 0x94, 0x36, 0xd0, 0xf6, 0x18, 0x6a, 0x1e, 0xe8, 0xd9,
+    0x95, 0xc3, 0x02, 0x63, 0x15, 0x42, 0x13, 0x94, 0x02, 0x9e, 0x1a, 0xed, 0x4d, 0xe7, 0x45, 0x4c,
+    0x4d, 0x86, 0xc1, 0x52, 0xcb, 0x3a, 0x12, 0xd9, 0x8b, 0x3d, 0x14, 0x95, 0xca, 0xd8, 0xa6, 0x17,
+    0x21, 0x7d, 0xe3, 0x79, 0x8e, 0x24, 0x0b, 0x67, 0xc2, 0xdc, 0xcb, 0x04, 0xbd, 0xde, 0x5d, 0xdf,
+    0x4f, 0x7c, 0x97, 0xa1, 0xc1, 0x68, 0x6f, 0x73, 0x01, 0x95, 0x41, 0xaf, 0x2f, 0xac, 0xd7, 0x94,
+    0xfe, 0x51, 0x96, 0xf9, 0x9e, 0xed, 0x65, 0x5e, 0x10, 0x4e, 0x95, 0xbe, 0xc7, 0xe3, 0xd4, 0x17,
+    0x2c, 0x9a, 0x30, 0x11, 0x6a, 0x91, 0xa3, 0x00, 0xfb, 0x01, 0x88, 0xad, 0xb1, 0x36, 0xe7, 0x15,
+    0x9d, 0x37, 0xe2, 0x93, 0xb6, 0xf0, 0x58, 0x0b, 0x74, 0xcd, 0x5a, 0xbe, 0x8f, 0x38, 0x5f, 0x58,
+    0xd1, 0xa1, 0x75, 0xe5, 0x03, 0x6a, 0xd1, 0x11, 0xf3, 0xac, 0x34, 0xda, 0xb5, 0xd9, 0x10, 0x66,
+    0x62, 0x6a, 0xb0, 0xed, 0xfb, 0x55, 0xb8, 0x62, 0x7d, 0xb2, 0x52, 0xb8, 0x0a, 0xd8, 0xf7, 0x49,
+    0x2f, 0xd0, 0x49, 0x30, 0xfa, 0x94, 0x9a, 0x02, 0x1b, 0xd8, 0xa3, 0x65, 0xc0, 0x7e, 0xc0, 0xbc,
+    0x72, 0xd5, 0x62, 0x60, 0x54, 0x59, 0xd3, 0xaf, 0x6b, 0xfa, 0x75, 0x97, 0xfe, 0x43, 0xdb, 0x82,
+    0x6b, 0x06, 0x69, 0x8b, 0xc1, 0x75, 0x36, 0x73, 0x55, 0x2e, 0x08, 0x79, 0x59, 0x62, 0x26, 0x38,
+    0x4b, 0x65, 0x96, 0xf8, 0x09, 0x14, 0xb9, 0xa2, 0xdf, 0xad, 0x37, 0x36, 0xd5, 0x6d, 0xd7, 0x19,
+    0xc0, 0x84, 0xbe, 0x28, 0xcc, 0xa8, 0xde, 0x2d, 0x1b, 0xbf, 0xff, 0x84, 0x9b, 0x34, 0xb4, 0x9d,
+    0xd1, 0xb7, 0x7a, 0x02, 0x8a, 0x08, 0xd5, 0x74, 0x8a, 0xdc, 0xfc, 0x39, 0x20, 0x5b, 0x05, 0x81,
+    0x73, 0x47, 0xf5, 0xc0, 0x46, 0xcb, 0x0e, 0xed, 0xba, 0x45, 0xfb, 0x59, 0x4d, 0x9b, 0x76, 0x68,
+    0x9d, 0xda, 0x01, 0x05, 0x95, 0x9c, 0x32, 0xbf, 0x0e, 0x2a, 0x87, 0xd5, 0xbe, 0x86, 0xe5, 0xbc,
+    0x4a, 0xfd, 0x32, 0xe8, 0x9c, 0xc3, 0x1f, 0xc5, 0x0c, 0xe6, 0x8e, 0x22, 0x76, 0xb8, 0xd5, 0x6b,
+    0x05, 0x0d, 0x2c, 0x80, 0x5c, 0x16, 0xcd, 0xcd, 0xa7, 0xc3, 0xcf, 0xc3, 0x55, 0xaf, 0x09, 0xd6,
+    0xa7, 0x07, 0x58, 0x11, 0xd2, 0x6b, 0x6e, 0xae, 0x3b, 0x37, 0xd7, 0x14, 0x54, 0x9b, 0x82, 0xe4,
+    0xad, 0x22, 0x0f, 0xea, 0x90, 0x39, 0xbc, 0x5b, 0x6b, 0xfb, 0xbe, 0xb6, 0xef, 0x4b, 0xfb, 0x6e,
+    0xd9, 0x61, 0xbc, 0xea, 0x08, 0x86, 0xab, 0x3b, 0x92, 0xed, 0xfd, 0xf4, 0xda, 0xfb, 0xeb, 0xee,
+    0xfd, 0x35, 0x45, 0xf5, 0x6e, 0x9a, 0x5d, 0xed, 0x69, 0x61, 0xe6, 0xba, 0xa0, 0x37, 0xb2, 0x88,
+    0x8b, 0xfa, 0xda, 0x1e, 0x93, 0x68, 0x53, 0x22, 0x02, 0xd6, 0xdc, 0x73, 0x37, 0x36, 0x66, 0x6c,
+    0xa5, 0x67, 0x27, 0x50, 0x3a, 0x35, 0x1c, 0x91, 0xb0, 0x15, 0x8c, 0xea, 0xc3, 0x30, 0x91, 0x6b,
+    0x24, 0xcb, 0xd9, 0xa6, 0x69, 0xb7, 0xdb, 0xb2, 0x42, 0x41, 0xe9, 0xb4, 0x67, 0x24, 0x14, 0x6b,
+    0xb3, 0xde, 0x18, 0xd1, 0xe6, 0x35, 0x79, 0x6c, 0x2a, 0x0c, 0x92, 0xd4, 0x1b, 0xc4, 0x08, 0x62,
+    0xcd, 0x07, 0xae, 0x05, 0x9d, 0x92, 0x61, 0xdc, 0x95, 0xd0, 0xa4, 0xa2, 0xf0, 0x35, 0x25, 0xb1,
+    0x0e, 0xd5, 0x73, 0x76, 0x8a, 0xc7, 0xb3, 0x4a, 0xa1, 0x2e, 0x33, 0x0c, 0xdb, 0xa1, 0x11, 0x2b,
+    0xf4, 0x5b, 0x77, 0xc9, 0xd8, 0x4c, 0x67, 0x26, 0xd5, 0x6a, 0xc9, 0x0c, 0x04, 0x07, 0xf5, 0xc1,
+    0xd2, 0x95, 0x80, 0x56, 0x49, 0x5b, 0x52, 0x2c, 0xac, 0xe9, 0xb9, 0xb6, 0x65, 0x6d, 0x19, 0x2e,
+    0x6d, 0x59, 0x5b, 0x22, 0x2a, 0x11, 0x81, 0xbb, 0xfd, 0x9c, 0x92, 0x29, 0x8c, 0x39, 0x21, 0xb5,
+    0x42, 0x9c, 0x11, 0x4c, 0xd0, 0x35, 0x5c, 0xbb, 0x79, 0x43, 0x4c, 0xab, 0x66, 0xb7, 0x4b, 0x61,
+    0xc7, 0x20, 0xbb, 0x82, 0x40, 0x76, 0x43, 0x6d, 0x0c, 0x31, 0xbe, 0x50, 0x5d, 0xda, 0x0c, 0x30,
+    0xa7, 0xc6, 0x86, 0xd1, 0x39, 0x4a, 0x59, 0x58, 0x90, 0xcb, 0xba, 0x16, 0xdf, 0x4e, 0x03, 0x9b,
+    0xf4, 0xc0, 0x2c, 0xc1, 0x73, 0xf0, 0x70, 0xf1, 0x90, 0xf3, 0xd2, 0xd5, 0xc8, 0xca, 0x66, 0xb8,
+    0xd7, 0x23, 0x6e, 0xa8, 0x4e, 0x41, 0xf8, 0x0c, 0x73, 0xb3, 0xef, 0x8d, 0xa8, 0x28, 0x6e, 0xbd,
+    0x64, 0x07, 0x56, 0x62, 0x3d, 0x20, 0xd6, 0xa7, 0x96, 0x87, 0x05, 0x20, 0x8a, 0x58, 0x25, 0xe2,
+    0xc9, 0xa3, 0xfb, 0x67, 0x2a, 0x2f, 0x31, 0x2a, 0xa0, 0xa4, 0x5a, 0x41, 0x41, 0xd7, 0x85, 0xce,
+    0x61, 0x5d, 0x8f, 0x35, 0xe6, 0x1c, 0x31, 0x6b, 0x0d, 0xdb, 0x14, 0xad, 0x1e, 0x5d, 0xfb, 0xee,
+    0xf4, 0xe5, 0x4e, 0xf0, 0x6c, 0x61, 0xb9, 0x5b, 0xa7, 0xb6, 0xe5, 0x5b, 0x60, 0xd7, 0x1b, 0xd4,
+    0x4e, 0x05, 0x41, 0xb8, 0xe0, 0xd9, 0x5c, 0xfc, 0xdf, 0x50, 0xb6, 0x0f, 0xaf, 0x81, 0x58, 0xb7,
+    0xfd, 0xae, 0x48, 0x17, 0xd4, 0xf5, 0x5e, 0xc2, 0xf1, 0xcd, 0x6c, 0x83, 0xf6, 0x4d, 0xe8, 0x6b,
+    0x26, 0xc0, 0x7a, 0xe6, 0x3e, 0xa7, 0xe1, 0xd4, 0x8f, 0x2e, 0x1e, 0x3e, 0x40, 0xab, 0xa1, 0x2f,
+    0x43, 0x39, 0x5d, 0x5b, 0x46, 0x3d, 0x5b, 0x31, 0x7a, 0xa8, 0x90, 0xae, 0x76, 0x6e, 0x87, 0x07,
+    0x4c, 0x0f, 0x84, 0xb1, 0x35, 0x4d, 0xd0, 0x7d, 0x84, 0xc4, 0xea, 0x0b, 0xeb, 0xd8, 0x37, 0x74,
+    0x9d, 0xcd, 0x57, 0xc6, 0x2e, 0x80, 0xe6, 0xa0, 0x69, 0x27, 0xf5, 0x18, 0x16, 0xdd, 0xe8, 0x07,
+    0x08, 0x23, 0xe1, 0x19, 0xbf, 0x14, 0xd9, 0xb6, 0x7d, 0xfb, 0x76, 0xdd, 0x63, 0x32, 0xb0, 0x31,
+    0x6a, 0x99, 0x85, 0xe8, 0x65, 0x7e, 0x21, 0x96, 0xec, 0x61, 0x49, 0xf6, 0xdc, 0x5e, 0x71, 0x09,
+    0x79, 0xad, 0xa0, 0xd6, 0x17, 0x4b, 0x50, 0xb7, 0xe3, 0x7a, 0xb8, 0x6d, 0x34, 0x77, 0x37, 0xd0,
+    0xb8, 0xe4, 0x17, 0x31, 0x2f, 0x51, 0x36, 0x05, 0x0a, 0x8e, 0xe7, 0xa1, 0xd4, 0x78, 0x76, 0xfc,
+    0x1d, 0xdd, 0xc4, 0xbc, 0x19, 0x9e, 0xff, 0x67, 0xfe, 0xce, 0x68, 0xcb, 0x2e, 0x81, 0xf3, 0x1b,
+    0x8a, 0x16, 0x7b, 0x27, 0x72, 0x33, 0x07, 0xfb, 0xea, 0x2b, 0x2a, 0x5e, 0xcd, 0x7a, 0xed, 0xd6,
+    0xcb, 0x66, 0xbd, 0x74, 0xeb, 0xb4, 0x59, 0xa7, 0x81, 0xfd, 0x57, 0xc3, 0x5b, 0xd6, 0xbf, 0xdd,
+    0x72, 0xf5, 0x4a, 0x7b, 0xa1, 0xc0, 0x61, 0xb7, 0x6e, 0x39, 0x88, 0xdd, 0xc6, 0x63, 0x23, 0x6a,
+    0x53, 0xfb, 0x5a, 0x17, 0x36, 0x75, 0xc6, 0xb7, 0x08, 0xaa, 0x1a, 0x01, 0xcd, 0x41, 0x28, 0xd4,
+    0xaf, 0xc8, 0xbc, 0x7a, 0xb3, 0x2b, 0xeb, 0x62, 0xa8, 0x0a, 0x4a, 0x37, 0x12, 0xd4, 0x50, 0x63,
+    0x26, 0x6d, 0x67, 0x27, 0xf5, 0xed, 0xfb, 0xf4, 0xf5, 0x8f, 0x24, 0xf7, 0xb7, 0x27, 0x3d, 0x76,
+    0x34, 0x1c, 0x0e, 0x71, 0x8c, 0x4f, 0x82, 0x7a, 0xcc, 0xc6, 0x34, 0xef, 0x3e, 0xce, 0x07, 0xee,
+    0x3f, 0x5d, 0xff, 0x05, 0x04, 0x1a, 0xa5, 0x23, 0xfa, 0x12, 0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+    { "/", "text/html; charset=utf-8", WEB_INDEX_HTML_GZ, sizeof(WEB_INDEX_HTML_GZ), 6774, "\"bc0de707d1c41129\"" },
+    { "/calibration", "text/html; charset=utf-8", WEB_CALIBRATION_HTML_GZ, sizeof(WEB_CALIBRATION_HTML_GZ), 4858, "\"5b333804315fee93\"" },
+};
+
+static const int WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
+
+#endif // WEB_ASSETS_H
@@ -1,199 +1,535 @@
 #ifndef WEB_SERVER_H
 #define WEB_SERVER_H
 
-#include "WebServer.h"
 #include "config.h"
+#include "http_server.h"
+#include "json_writer.h"
+#include "mjpeg_stream.h"
+#include "frame_recorder.h"
+#include "led_calibration.h"
+#include "cycle_history.h"
+#include "power_manager.h"
+#include "system_metrics.h"
+#include "web_assets.h"
+#include "wash_stage.h"
 
-extern WebServer server;
-extern String currentWashingStage;
+#ifndef WEB_SERVER_CORE
+#define WEB_SERVER_CORE         0       // Núcleo da tarefa do servidor HTTP
+#endif
+
+#ifndef WEB_SERVER_TASK_STACK
+#define WEB_SERVER_TASK_STACK   8192
+#endif
+
+#ifndef WEB_EVENTS_MAX_CLIENTS
+#define WEB_EVENTS_MAX_CLIENTS  4       // Conexões /events simultâneas (o resto fica para requisições)
+#endif
+
+#ifndef WEB_EVENTS_HEARTBEAT
+#define WEB_EVENTS_HEARTBEAT    15000   // ms entre heartbeats do /events
+#endif
+
+#ifndef WEB_CONFIDENCE_BUCKET
+#define WEB_CONFIDENCE_BUCKET   10      // Faixa de confiança (%) que gera novo evento
+#endif
+
+#ifndef WEB_SNAPSHOT_MAX_AGE
+#define WEB_SNAPSHOT_MAX_AGE    1000    // ms em que o último JPEG do /stream ainda serve de /snapshot
+#endif
+
+#ifndef WEB_SNAPSHOT_TIMEOUT
+#define WEB_SNAPSHOT_TIMEOUT    5000    // ms esperando o próximo frame antes de responder 503
+#endif
+
+extern HttpServer httpServer;
+extern WashStage currentWashingStage;
 extern float lastConfidence;
+extern ChangeDetector changeDetector;
+
+// Estado publicado pelo loop() para a tarefa do servidor. Os handlers nunca
+// tocam no caminho ML: leem esta cópia e pedem predições por flag.
+struct WebStatus {
+    WashStage stage;
+    float confidence;
+    unsigned long updatedAt;
+    int confidenceBucket;
+    uint32_t version;               // muda quando etapa ou faixa de confiança mudam
+};
+
+WebStatus webStatus = { STAGE_OFF, 0.0, 0, 0, 0 };
+SemaphoreHandle_t webStatusLock = NULL;
+TaskHandle_t webServerHandle = NULL;
+volatile bool webPredictionRequested = false;
+
+// Último JPEG do codificador do /stream, para o /snapshot (só a tarefa web)
+HttpSharedBody* snapshotFrame = nullptr;
+unsigned long snapshotFrameAt = 0;
 
 void setupWebServer();
-void handleWebServerRequests();
-void handleRoot();
-void handleStatus();
-void handlePredict();
-void handleNotFound();
+void publishWebStatus();
+WebStatus readWebStatus();
+bool takeWebPredictionRequest();
+void webServerTask(void* param);
+void formatWebStatusEvent(const WebStatus& status, char* out, size_t size);
+void broadcastWebStatus(const WebStatus& status);
+void handleEvents(HttpConnection& conn, const HttpRequest& req);
+void handleWebAsset(HttpConnection& conn, const HttpRequest& req);
+void handleStatus(HttpConnection& conn, const HttpRequest& req);
+void handlePredict(HttpConnection& conn, const HttpRequest& req);
+void handleNotFound(HttpConnection& conn, const HttpRequest& req);
+void handleCalibrationStatus(HttpConnection& conn, const HttpRequest& req);
+void handleCalibrationSave(HttpConnection& conn, const HttpRequest& req);
+void handleCalibrationRecord(HttpConnection& conn, const HttpRequest& req);
+void handleCameraWindow(HttpConnection& conn, const HttpRequest& req);
+void handleSnapshot(HttpConnection& conn, const HttpRequest& req);
+void handleStream(HttpConnection& conn, const HttpRequest& req);
+void handleRecord(HttpConnection& conn, const HttpRequest& req);
+void handleReplay(HttpConnection& conn, const HttpRequest& req);
+void handleModel(HttpConnection& conn, const HttpRequest& req);
+void handleHistory(HttpConnection& conn, const HttpRequest& req);
+void handleMetrics(HttpConnection& conn, const HttpRequest& req);
+void sendJson(HttpConnection& conn, const JsonWriter& json);
 
 void setupWebServer() {
-    server.on("/", handleRoot);
-    server.on("/status", handleStatus);
-    server.on("/predict", handlePredict);
-    server.onNotFound(handleNotFound);
+    webStatusLock = xSemaphoreCreateMutex();
+    publishWebStatus();
+    
+    // Páginas estáticas (web_assets.h): "/" e "/calibration"
+    for (int i = 0; i < WEB_ASSET_COUNT; i++) {
+        httpServer.on(WEB_ASSETS[i].path, handleWebAsset);
+    }
+    httpServer.on("/status", handleStatus);
+    httpServer.on("/predict", handlePredict);
+    httpServer.on("/events", handleEvents);
+    httpServer.on("/calibration/status", handleCalibrationStatus);
+    httpServer.on("/calibration/save", handleCalibrationSave);
+    httpServer.on("/calibration/record", handleCalibrationRecord);
+    httpServer.on("/camera/window", handleCameraWindow);
+    httpServer.on("/snapshot", handleSnapshot);
+    httpServer.on("/stream", handleStream);
+    httpServer.on("/record", handleRecord);
+    httpServer.on("/replay", handleReplay);
+    httpServer.on("/model", handleModel);
+    httpServer.on("/history", handleHistory);
+    httpServer.on("/metrics", handleMetrics);
+    httpServer.onNotFound(handleNotFound);
+    httpServer.observer = metricsObserveHttp;
+    
+    if (!httpServer.begin(WEB_SERVER_PORT)) {
+        Serial.println("ERRO: Falha ao abrir porta do servidor web");
+        return;
+    }
     
-    server.begin();
+    // Laço de eventos em tarefa própria: independente do loop() e da inferência
+    xTaskCreatePinnedToCore(webServerTask, "http", WEB_SERVER_TASK_STACK, NULL, 1,
+                            &webServerHandle, WEB_SERVER_CORE);
     Serial.println("Servidor web iniciado na porta " + String(WEB_SERVER_PORT));
 }
 
-void handleWebServerRequests() {
-    server.handleClient();
-}
-
-void handleRoot() {
-    String html = "<!DOCTYPE html>";
-    html += "<html lang='pt-BR'>";
-    html += "<head>";
-    html += "<meta charset='UTF-8'>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1.0'>";
-    html += "<title>Lavadora Inteligente - Monitor IoT</title>";
-    html += "<style>";
-    html += "* { box-sizing: border-box; margin: 0; padding: 0; }";
-    html += "body { font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif; background: linear-gradient(135deg, #667eea 0%, #764ba2 100%); color: #333; min-height: 100vh; padding: 20px; }";
-    html += ".container { max-width: 800px; margin: 0 auto; background: rgba(255, 255, 255, 0.95); border-radius: 20px; box-shadow: 0 20px 40px rgba(0, 0, 0, 0.1); overflow: hidden; }";
-    html += ".header { background: linear-gradient(135deg, #2c3e50, #34495e); color: white; padding: 30px; text-align: center; }";
-    html += ".header h1 { font-size: 2.5em; margin-bottom: 10px; font-weight: 300; }";
-    html += ".header p { opacity: 0.9; font-size: 1.1em; }";
-    html += ".content { padding: 40px; }";
-    html += ".status-card { background: #f8f9fa; border-radius: 15px; padding: 30px; margin-bottom: 30px; border-left: 5px solid #3498db; }";
-    html += ".status-label { font-size: 1.2em; color: #7f8c8d; margin-bottom: 15px; text-transform: uppercase; letter-spacing: 1px; font-weight: 600; }";
-    html += ".current-stage { font-size: 3em; font-weight: bold; color: #2c3e50; margin-bottom: 15px; text-transform: capitalize; }";
-    html += ".confidence { font-size: 1.3em; color: #27ae60; font-weight: 600; }";
-    html += ".info-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 20px; margin-bottom: 30px; }";
-    html += ".info-item { background: white; padding: 20px; border-radius: 10px; text-align: center; box-shadow: 0 5px 15px rgba(0, 0, 0, 0.08); border: 1px solid #ecf0f1; }";
-    html += ".info-item h3 { color: #34495e; margin-bottom: 10px; font-size: 1.1em; }";
-    html += ".info-item .value { font-size: 1.5em; font-weight: bold; color: #3498db; }";
-    html += ".actions { display: flex; gap: 15px; flex-wrap: wrap; justify-content: center; }";
-    html += ".btn { background: linear-gradient(135deg, #3498db, #2980b9); color: white; border: none; padding: 15px 30px; border-radius: 25px; font-size: 1.1em; font-weight: 600; cursor: pointer; transition: all 0.3s ease; text-decoration: none; display: inline-block; min-width: 150px; }";
-    html += ".btn:hover { transform: translateY(-2px); box-shadow: 0 10px 25px rgba(52, 152, 219, 0.3); }";
-    html += ".btn.secondary { background: linear-gradient(135deg, #95a5a6, #7f8c8d); }";
-    html += ".footer { background: #ecf0f1; padding: 20px; text-align: center; color: #7f8c8d; font-size: 0.9em; }";
-    html += ".status-indicator { display: inline-block; width: 12px; height: 12px; border-radius: 50%; background: #27ae60; margin-right: 8px; animation: pulse 2s infinite; }";
-    html += ".status-indicator.offline { background: #e74c3c; }";
-    html += "@keyframes pulse { 0% { transform: scale(1); opacity: 1; } 50% { transform: scale(1.1); opacity: 0.7; } 100% { transform: scale(1); opacity: 1; } }";
-    html += "@media (max-width: 600px) { .container { margin: 10px; border-radius: 15px; } .header { padding: 20px; } .header h1 { font-size: 2em; } .content { padding: 20px; } .current-stage { font-size: 2em; } .actions { flex-direction: column; } .btn { width: 100%; } }";
-    html += "</style>";
-    html += "</head>";
-    html += "<body>";
-    html += "<div class='container'>";
-    html += "<div class='header'>";
-    html += "<h1>🏠 Lavadora Inteligente</h1>";
-    html += "<p>Monitoramento IoT em tempo real</p>";
-    html += "</div>";
-    html += "<div class='content'>";
-    html += "<div class='status-card'>";
-    html += "<div class='status-label'><span class='status-indicator' id='statusIndicator'></span>Status Atual</div>";
-    html += "<div class='current-stage' id='currentStage'>Carregando...</div>";
-    html += "<div class='confidence' id='confidence'>Confianca: --</div>";
-    html += "</div>";
-    html += "<div class='info-grid'>";
-    html += "<div class='info-item'><h3>⏱️ Tempo Online</h3><div class='value' id='uptime'>--</div></div>";
-    html += "<div class='info-item'><h3>🔄 Última Atualização</h3><div class='value' id='lastUpdate'>--</div></div>";
-    html += "<div class='info-item'><h3>📶 Conexão</h3><div class='value' id='connection'>WiFi</div></div>";
-    html += "<div class='info-item'><h3>🧠 Modo</h3><div class='value' id='mode'>Demonstração</div></div>";
-    html += "</div>";
-    html += "<div class='actions'>";
-    html += "<button class='btn' onclick='updateStatus()'>🔄 Atualizar</button>";
-    html += "<button class='btn secondary' onclick='forcePrediction()'>⚡ Simular Mudança</button>";
-    html += "</div>";
-    html += "</div>";
-    html += "<div class='footer'>";
-    html += "<p>🚀 Powered by ESP32-CAM | Sistema 100% Estável | Desenvolvido com ❤️</p>";
-    html += "</div>";
-    html += "</div>";
-    html += "<script>";
-    html += "let isUpdating = false;";
-    html += "function updateStatus() {";
-    html += "if (isUpdating) return;";
-    html += "isUpdating = true;";
-    html += "const indicator = document.getElementById('statusIndicator');";
-    html += "indicator.style.background = '#f39c12';";
-    html += "fetch('/status')";
-    html += ".then(response => response.json())";
-    html += ".then(data => {";
-    html += "document.getElementById('currentStage').textContent = data.stage.charAt(0).toUpperCase() + data.stage.slice(1);";
-    html += "document.getElementById('confidence').textContent = 'Confiança: ' + Math.round(data.confidence * 100) + '%';";
-    html += "const uptimeSeconds = data.uptime;";
-    html += "const hours = Math.floor(uptimeSeconds / 3600);";
-    html += "const minutes = Math.floor((uptimeSeconds % 3600) / 60);";
-    html += "document.getElementById('uptime').textContent = hours + 'h ' + minutes + 'm';";
-    html += "document.getElementById('lastUpdate').textContent = new Date().toLocaleTimeString();";
-    html += "indicator.style.background = '#27ae60';";
-    html += "indicator.classList.remove('offline');";
-    html += "})";
-    html += ".catch(error => {";
-    html += "console.error('Erro:', error);";
-    html += "document.getElementById('currentStage').textContent = 'Erro de Conexão';";
-    html += "indicator.style.background = '#e74c3c';";
-    html += "indicator.classList.add('offline');";
-    html += "})";
-    html += ".finally(() => { isUpdating = false; });";
-    html += "}";
-    html += "function forcePrediction() {";
-    html += "const btn = event.target;";
-    html += "const originalText = btn.textContent;";
-    html += "btn.textContent = '⏳ Simulando...';";
-    html += "btn.disabled = true;";
-    html += "fetch('/predict')";
-    html += ".then(response => response.json())";
-    html += ".then(data => { ";
-    html += "setTimeout(() => {";
-    html += "updateStatus();";
-    html += "btn.textContent = originalText;";
-    html += "btn.disabled = false;";
-    html += "}, 1000);";
-    html += "})";
-    html += ".catch(error => {";
-    html += "console.error('Erro na simulação:', error);";
-    html += "btn.textContent = originalText;";
-    html += "btn.disabled = false;";
-    html += "});";
-    html += "}";
-    html += "updateStatus();";
-    html += "setInterval(updateStatus, 5000);";
-    html += "document.addEventListener('DOMContentLoaded', function() {";
-    html += "console.log('🏠 Lavadora Inteligente - Sistema Carregado!');";
-    html += "console.log('📊 Atualizações automáticas a cada 5 segundos');";
-    html += "});";
-    html += "</script>";
-    html += "</body>";
-    html += "</html>";
-    
-    server.send(200, "text/html", html);
-}
-
-void handleStatus() {
+// Laço do servidor. Os pushes saem daqui (mesma tarefa que poll()): frames
+// do /stream (e /snapshot à espera) assim que codificados, frames crus do /record assim que
+// copiados; eventos SSE só quando a versão do estado
+// muda, mais um heartbeat periódico
+void webServerTask(void* param) {
+    uint32_t sentVersion = 0;
+    uint32_t seenRequests = 0;
+    unsigned long lastHeartbeat = millis();
+    
+    while (true) {
+        // Com /stream ou /record aberto, volta mais cedo para entregar o frame pronto
+        httpServer.poll(streamClients > 0 || recordClients > 0 ? 20 : 100);
+        
+        // Pedido atendido: segura o light sleep por POWER_WEB_HOLD
+        if (httpServer.requests != seenRequests) {
+            seenRequests = httpServer.requests;
+            powerWebRequest();
+        }
+        
+        // /snapshot à espera também conta: faz a captura copiar o próximo frame
+        streamClients = httpServer.streamCount(HTTP_STREAM_MJPEG) + httpServer.streamCount(HTTP_STREAM_DEFERRED);
+        HttpSharedBody* frame = takeStreamFrame();
+        if (frame) {
+            httpServer.broadcastFrame(frame, "image/jpeg");
+            httpServer.answerDeferred(frame, "image/jpeg", "Cache-Control: no-cache\r\n");
+            httpSharedBodyRelease(snapshotFrame);
+            snapshotFrame = frame;          // a referência fica com o /snapshot
+            snapshotFrameAt = millis();
+        } else if (snapshotFrame && millis() - snapshotFrameAt > WEB_SNAPSHOT_MAX_AGE) {
+            httpSharedBodyRelease(snapshotFrame);
+            snapshotFrame = nullptr;
+        }
+        httpServer.expireDeferred(WEB_SNAPSHOT_TIMEOUT, 503, "Sem frame da camera");
+        
+        recordClients = httpServer.streamCount(HTTP_STREAM_CAPTURE);
+        frame = takeRecordFrame();
+        if (frame) {
+            httpServer.broadcastCapture(frame);
+            httpSharedBodyRelease(frame);
+        }
+        
+        if (httpServer.streamCount(HTTP_STREAM_EVENTS) == 0) {
+            continue;
+        }
+        
+        WebStatus status = readWebStatus();
+        if (status.version != sentVersion) {
+            sentVersion = status.version;
+            broadcastWebStatus(status);
+        }
+        
+        if (millis() - lastHeartbeat >= WEB_EVENTS_HEARTBEAT) {
+            extern unsigned long getSystemUptime();
+            char data[32];
+            JsonWriter json(data, sizeof(data));
+            json.beginObject().field("uptime", getSystemUptime()).endObject();
+            httpServer.broadcastEvent("heartbeat", data);
+            lastHeartbeat = millis();
+        }
+    }
+}
+
+// Evento compacto: só o que o dashboard mostra
+void formatWebStatusEvent(const WebStatus& status, char* out, size_t size) {
+    JsonWriter json(out, size);
+    json.beginObject().field("stage", washStageLabel(status.stage)).field("confidence", status.confidence).endObject();
+}
+
+void broadcastWebStatus(const WebStatus& status) {
+    char data[96];
+    formatWebStatusEvent(status, data, sizeof(data));
+    httpServer.broadcastEvent("status", data);
+}
+
+// Chamado pelo loop() e por onStageChanged(): copia o estado atual para os
+// handlers e marca nova versão se a etapa ou a faixa de confiança mudou
+void publishWebStatus() {
+    if (!webStatusLock) return;
+    int bucket = (int)(lastConfidence * 100) / WEB_CONFIDENCE_BUCKET;
+    
+    xSemaphoreTake(webStatusLock, portMAX_DELAY);
+    if (bucket != webStatus.confidenceBucket || webStatus.stage != currentWashingStage) {
+        webStatus.version++;
+    }
+    webStatus.stage = currentWashingStage;
+    webStatus.confidence = lastConfidence;
+    webStatus.confidenceBucket = bucket;
+    webStatus.updatedAt = millis();
+    xSemaphoreGive(webStatusLock);
+}
+
+WebStatus readWebStatus() {
+    WebStatus status;
+    xSemaphoreTake(webStatusLock, portMAX_DELAY);
+    status = webStatus;
+    xSemaphoreGive(webStatusLock);
+    return status;
+}
+
+// Pedido de predição feito pela web, atendido pelo loop()
+bool takeWebPredictionRequest() {
+    if (!webPredictionRequested) {
+        return false;
+    }
+    webPredictionRequested = false;
+    return true;
+}
+
+// Página pré-comprimida em flash: enviada sem cópia e sem alocação.
+// Não há cópia descomprimida: cliente sem Accept-Encoding: gzip recebe 406.
+void handleWebAsset(HttpConnection& conn, const HttpRequest& req) {
+    const WebAsset* asset = nullptr;
+    for (int i = 0; i < WEB_ASSET_COUNT; i++) {
+        if (strcmp(WEB_ASSETS[i].path, req.path) == 0) {
+            asset = &WEB_ASSETS[i];
+            break;
+        }
+    }
+    if (!asset) {
+        handleNotFound(conn, req);
+        return;
+    }
+    
+    // no-cache: o navegador revalida a cada visita e recebe 304 se nada mudou
+    char headers[128];
+    snprintf(headers, sizeof(headers),
+             "ETag: %s\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\n", asset->etag);
+    
+    if (!req.acceptsGzip) {
+        static const char message[] = "Pagina so em gzip (curl --compressed)";
+        conn.send(406, "text/plain", message, sizeof(message) - 1, headers);
+        return;
+    }
+    if (req.ifNoneMatch[0] && strstr(req.ifNoneMatch, asset->etag)) {
+        conn.send(304, asset->contentType, "", 0, headers);
+        return;
+    }
+    
+    strncat(headers, "Content-Encoding: gzip\r\n", sizeof(headers) - strlen(headers) - 1);
+    conn.sendStatic(200, asset->contentType, asset->data, asset->length, headers);
+}
+
+void handleStatus(HttpConnection& conn, const HttpRequest& req) {
     extern unsigned long getSystemUptime();
-    String json = "{";
-    json += "\"stage\":\"" + currentWashingStage + "\",";
-    json += "\"confidence\":" + String(lastConfidence) + ",";
-    json += "\"timestamp\":" + String(millis()) + ",";
-    json += "\"uptime\":" + String(getSystemUptime()) + ",";
-    json += "\"heap\":" + String(ESP.getFreeHeap()) + ",";
-    json += "\"wifi_rssi\":" + String(WiFi.RSSI()) + ",";
-    json += "\"mode\":\"demonstration\"";
-    json += "}";
+    WebStatus status = readWebStatus();
+    
+    char body[448];
+    JsonWriter json(body, sizeof(body));
+    json.beginObject()
+        .field("stage", washStageLabel(status.stage))
+        .field("confidence", status.confidence)
+        .field("timestamp", millis())
+        .field("uptime", getSystemUptime())
+        .field("heap", ESP.getFreeHeap())
+        .field("wifi_rssi", WiFi.RSSI())
+        .field("inferences_skipped", changeDetector.hits.load(std::memory_order_relaxed))
+        .field("inferences_run", changeDetector.misses.load(std::memory_order_relaxed))
+        .field("cpu_mhz", getCpuFrequencyMhz())
+        .field("power_state", powerStateName())
+        .field("current_ma", powerAverageCurrentMa(), 1)
+        .field("energy_mj_per_prediction", powerEnergyPerPredictionMj(), 2)
+        .field("mode", "demonstration")
+        .endObject();
+    
+    sendJson(conn, json);
+}
+
+// Server-Sent Events: estado atual na conexão e depois só as mudanças
+void handleEvents(HttpConnection& conn, const HttpRequest& req) {
+    if (httpServer.streamCount(HTTP_STREAM_EVENTS) >= WEB_EVENTS_MAX_CLIENTS) {
+        conn.send(503, "text/plain", "Muitos clientes em /events");
+        return;
+    }
+    conn.beginEventStream(3000);
+    
+    char data[96];
+    formatWebStatusEvent(readWebStatus(), data, sizeof(data));
+    conn.queueEvent("status", data);
+}
+
+void handlePredict(HttpConnection& conn, const HttpRequest& req) {
+    // Não espera a inferência: o loop() atende o pedido e /status mostra o resultado
+    webPredictionRequested = true;
+    WebStatus status = readWebStatus();
+    
+    char body[160];
+    JsonWriter json(body, sizeof(body));
+    json.beginObject()
+        .field("message", "Predicao solicitada")
+        .field("stage", washStageLabel(status.stage))
+        .field("confidence", status.confidence)
+        .field("mode", "demonstration")
+        .endObject();
+    
+    sendJson(conn, json);
+}
+
+void handleCalibrationStatus(HttpConnection& conn, const HttpRequest& req) {
+    char body[1792];
+    JsonWriter json(body, sizeof(body));
+    writeLedCalibrationJSON(json);
+    sendJson(conn, json);
+}
+
+void handleCalibrationSave(HttpConnection& conn, const HttpRequest& req) {
+    // Formato: spots=x,y;x,y;...
+    char param[128];
+    req.arg("spots", param, sizeof(param));
+    LedSpot spots[LED_MAX_SPOTS];
+    int count = 0;
+    
+    const char* p = param;
+    while (*p && count < LED_MAX_SPOTS) {
+        char* end;
+        long x = strtol(p, &end, 10);
+        if (end == p || *end != ',') break;
+        p = end + 1;
+        long y = strtol(p, &end, 10);
+        if (end == p) break;
+        p = (*end == ';') ? end + 1 : end;
+        
+        if (x < 0 || y < 0 || x >= CAMERA_FRAME_WIDTH || y >= CAMERA_FRAME_HEIGHT) {
+            conn.send(400, "text/plain", "Posicao fora da imagem");
+            return;
+        }
+        spots[count].x = x;
+        spots[count].y = y;
+        count++;
+    }
     
-    server.send(200, "application/json", json);
+    if (!setLedSpots(spots, count)) {
+        conn.send(500, "text/plain", "Falha ao gravar calibracao");
+        return;
+    }
+    char message[48];
+    snprintf(message, sizeof(message), "Calibracao salva: %d LEDs", count);
+    conn.send(200, "text/plain", message);
+}
+
+void handleCalibrationRecord(HttpConnection& conn, const HttpRequest& req) {
+    int label = req.argInt("stage", -1);
+    if (!recordLedPattern(label)) {
+        conn.send(400, "text/plain", "Leitura dos LEDs duvidosa ou etapa invalida - tente novamente");
+        return;
+    }
+    char message[64];
+    snprintf(message, sizeof(message), "Padrao gravado como %s", ei_classifier_inferencing_categories[label]);
+    conn.send(200, "text/plain", message);
+}
+
+// Sem argumentos: janela atual. x,y,w,h (referência 320x240): nova janela.
+// full=1: vista inteira
+void handleCameraWindow(HttpConnection& conn, const HttpRequest& req) {
+    CameraRect region = { (int)req.argInt("x", -1), (int)req.argInt("y", -1),
+                          (int)req.argInt("w", -1), (int)req.argInt("h", -1) };
+    if (req.argInt("full", 0)) {
+        region = { 0, 0, CAMERA_FRAME_WIDTH, CAMERA_FRAME_HEIGHT };
+    }
+    if (region.x >= 0 || region.width >= 0) {
+        if (!CAMERA_ROI_CAPTURE) {
+            conn.send(400, "text/plain", "Janela do sensor desativada (CAMERA_ROI_CAPTURE)");
+            return;
+        }
+        if (!setCameraWindow(region)) {
+            conn.send(400, "text/plain", "Janela invalida");
+            return;
+        }
+    }
+    
+    char body[320];
+    JsonWriter json(body, sizeof(body));
+    writeCameraWindowJSON(json, readCameraWindow());
+    sendJson(conn, json);
+}
+
+void handleSnapshot(HttpConnection& conn, const HttpRequest& req) {
+    // Durante um replay a "câmera" é a gravação, consumida só pelo loop()
+    if (cameraFrameFeed) {
+        conn.send(503, "text/plain", "Replay em andamento");
+        return;
+    }
+    // Câmera e codificador nunca rodam aqui: o JPEG vem do caminho do /stream
+    if (snapshotFrame && millis() - snapshotFrameAt <= WEB_SNAPSHOT_MAX_AGE) {
+        conn.sendShared(200, "image/jpeg", snapshotFrame, "Cache-Control: no-cache\r\n");
+        return;
+    }
+    if (!streamRaw) {
+        conn.send(503, "text/plain", "Snapshot indisponivel (sem PSRAM)");
+        return;
+    }
+    // Sem frame recente: pede uma captura ao loop() e responde quando a
+    // tarefa mjpeg entregar o JPEG (ou 503 depois de WEB_SNAPSHOT_TIMEOUT)
+    conn.deferResponse();
+    streamClients = httpServer.streamCount(HTTP_STREAM_MJPEG) + httpServer.streamCount(HTTP_STREAM_DEFERRED);
+    webPredictionRequested = true;
+}
+
+// MJPEG ao vivo com os frames da inferência (sem captura extra)
+void handleStream(HttpConnection& conn, const HttpRequest& req) {
+    if (!streamRaw) {
+        conn.send(503, "text/plain", "Stream indisponivel (sem PSRAM)");
+        return;
+    }
+    if (httpServer.streamCount(HTTP_STREAM_MJPEG) >= STREAM_MAX_CLIENTS) {
+        conn.send(503, "text/plain", "Muitos clientes em /stream");
+        return;
+    }
+    conn.beginMjpegStream();
+    streamClients = httpServer.streamCount(HTTP_STREAM_MJPEG);
+}
+
+// Gravação crua (frame_recorder.h): cabeçalho do arquivo agora, frames a cada inferência
+void handleRecord(HttpConnection& conn, const HttpRequest& req) {
+    if (httpServer.streamCount(HTTP_STREAM_CAPTURE) >= RECORD_MAX_CLIENTS) {
+        conn.send(503, "text/plain", "Gravacao ja em andamento");
+        return;
+    }
+    CaptureHeader header;
+    recordCaptureHeader(header);
+    conn.beginCaptureStream(&header, sizeof(header));
+    recordClients = httpServer.streamCount(HTTP_STREAM_CAPTURE);
 }
 
-void handlePredict() {
-    // Simular predição forçada
-    extern void forcePrediction();
-    forcePrediction();
+// ?url=http://... agenda o replay da gravação (frame_replay.h); sem url,
+// estatísticas do último replay
+void handleReplay(HttpConnection& conn, const HttpRequest& req) {
+    extern bool requestFrameReplay(const char* url);
+    extern void writeFrameReplayJSON(JsonWriter& json);
     
-    String response = "{";
-    response += "\"message\":\"Simulacao de predicao executada\",";
-    response += "\"stage\":\"" + currentWashingStage + "\",";
-    response += "\"confidence\":" + String(lastConfidence) + ",";
-    response += "\"mode\":\"demonstration\"";
-    response += "}";
+    char url[sizeof(req.query)];
+    if (req.arg("url", url, sizeof(url))) {
+        if (!requestFrameReplay(url)) {
+            conn.send(503, "text/plain", "Replay ja em andamento (ou url muito longa)");
+            return;
+        }
+        conn.send(200, "application/json", "{\"status\":\"Replay solicitado\"}");
+        return;
+    }
     
-    server.send(200, "application/json", response);
+    char body[448];
+    JsonWriter json(body, sizeof(body));
+    writeFrameReplayJSON(json);
+    sendJson(conn, json);
 }
 
-void handleNotFound() {
-    String message = "Pagina nao encontrada\\n\\n";
-    message += "URI: " + server.uri() + "\\n";
-    message += "Metodo: ";
-    message += (server.method() == HTTP_GET) ? "GET" : "POST";
-    message += "\\n";
-    message += "Argumentos: " + String(server.args()) + "\\n";
+// ?url=http://... inicia o download e a troca do modelo (model_store.h);
+// sem url, modelo ativo e resultado da última troca
+void handleModel(HttpConnection& conn, const HttpRequest& req) {
+    extern bool requestModelUpdate(const char* url);
+    extern void writeModelStoreJSON(JsonWriter& json);
     
-    for (uint8_t i = 0; i < server.args(); i++) {
-        message += " " + server.argName(i) + ": " + server.arg(i) + "\\n";
+    char url[sizeof(req.query)];
+    if (req.arg("url", url, sizeof(url))) {
+        if (!requestModelUpdate(url)) {
+            conn.send(503, "text/plain", "Troca de modelo ja em andamento (ou url muito longa)");
+            return;
+        }
+        conn.send(200, "application/json", "{\"status\":\"Troca de modelo solicitada\"}");
+        return;
     }
     
-    server.send(404, "text/plain", message);
+    char body[448];
+    JsonWriter json(body, sizeof(body));
+    writeModelStoreJSON(json);
+    sendJson(conn, json);
+}
+
+// Registros do histórico em [from, to] (segundos), lidos da flash em pedaços
+// enquanto o cliente consome: nunca mais que um buffer de saída em RAM
+void handleHistory(HttpConnection& conn, const HttpRequest& req) {
+    if (!historyReady) {
+        conn.send(503, "text/plain", "Historico indisponivel");
+        return;
+    }
+    uint32_t from = (uint32_t)req.argInt("from", 0);
+    uint32_t to = req.hasArg("to") ? (uint32_t)req.argInt("to", 0) : 0xFFFFFFFFu;
+    static_assert(sizeof(HistoryCursor) <= HTTP_PRODUCER_STATE, "cursor do historico nao cabe na conexao");
+    HistoryCursor* cursor = (HistoryCursor*)conn.sendChunked(200, "application/json", historyProducer,
+                                                             sizeof(HistoryCursor));
+    historyQuery(historyLog, *cursor, from, to);
+}
+
+// Formato texto do Prometheus, gerado item a item no buffer de saída
+void handleMetrics(HttpConnection& conn, const HttpRequest& req) {
+    static_assert(sizeof(MetricsCursor) <= HTTP_PRODUCER_STATE, "cursor do /metrics nao cabe na conexao");
+    MetricsCursor* cursor = (MetricsCursor*)conn.sendChunked(200, "text/plain; version=0.0.4", metricsProducer,
+                                                             sizeof(MetricsCursor));
+    cursor->item = 0;
+}
+
+// Corpo já formatado em buffer fixo; estouro vira 500 em vez de JSON truncado
+void sendJson(HttpConnection& conn, const JsonWriter& json) {
+    if (!json.ok()) {
+        conn.send(500, "application/json", "{\"error\":\"resposta muito grande\"}");
+        return;
+    }
+    conn.send(200, "application/json", json.c_str(), json.length());
+}
+
+void handleNotFound(HttpConnection& conn, const HttpRequest& req) {
+    char message[400];
+    snprintf(message, sizeof(message), "Pagina nao encontrada\n\nURI: %s\nMetodo: %s\nArgumentos: %s\n",
+             req.path, req.method, req.query);
+    conn.send(404, "text/plain", message);
 }
 
 #endif // WEB_SERVER_H
\ No newline at end of file
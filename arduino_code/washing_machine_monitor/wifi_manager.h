@@ -0,0 +1,238 @@
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+// Conexão WiFi do dispositivo: aplica a máquina de wifi_reconnect.h à pilha
+// do ESP32. A reconexão é dirigida por WiFi.onEvent (queda, IP recebido),
+// sem a reconexão automática do core e sem esperar pela manutenção; o
+// loop() só chama updateWiFiManagement() para os tempos esgotados.
+// O último lease bom fica na RTC (RTC_NOINIT_ATTR: sobrevive ao deep sleep
+// e ao reset por software) e na NVS, gravada pela manutenção quando muda.
+// O IP guardado só é usado sem DHCP dentro da primeira metade do lease do
+// roteador (relógio do NTP); depois de uma conexão assim o DHCP roda em
+// segundo plano e renova o lease no roteador.
+
+#include "WiFi.h"
+#include <Preferences.h>
+#include <time.h>
+#include "esp_netif.h"
+#include "esp_netif_net_stack.h"
+#include "lwip/dhcp.h"
+#include "config.h"
+#include "power_manager.h"
+#include "wifi_reconnect.h"
+
+// =================== VARIÁVEIS GLOBAIS ===================
+RTC_NOINIT_ATTR WifiLease wifiRtcLease;
+WifiReconnect wifiLink;
+SemaphoreHandle_t wifiLock = NULL;              // eventos (tarefa do core) x loop()
+volatile bool wifiLeaseDirty = false;
+
+// =================== FUNÇÕES PÚBLICAS ===================
+void initializeWiFiManagement();
+void updateWiFiManagement();
+uint32_t msUntilWiFiDue(uint32_t now);
+void saveWiFiLeaseIfDirty();
+void printWiFiStatistics();
+void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+void wifiDriverConnect(void* ctx, const WifiLease* lease);
+void wifiDriverDisconnect(void* ctx);
+void wifiDriverRenewDhcp(void* ctx);
+uint32_t wifiDriverClock(void* ctx);
+uint32_t wifiDhcpLeaseSeconds();
+
+// =================== IMPLEMENTAÇÃO ===================
+
+// Inicia a primeira tentativa e volta na hora; o resto chega por eventos
+void initializeWiFiManagement() {
+    wifiLock = xSemaphoreCreateMutex();
+
+    WifiLease cached = wifiRtcLease;
+    const char* source = "RTC";
+    if (!wifiLeaseValid(cached)) {
+        source = "NVS";
+        Preferences prefs;
+        if (!prefs.begin("wifi", true) || prefs.getBytes("lease", &cached, sizeof(cached)) != sizeof(cached)) {
+            memset(&cached, 0, sizeof(cached));
+        }
+        prefs.end();
+    }
+    bool leaseValid = wifiLeaseValid(cached);
+
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+    WiFi.setTxPower(POWER_WIFI_TX_POWER);
+    WiFi.setAutoReconnect(false);               // quem reconecta é a máquina
+    WiFi.onEvent(onWiFiEvent);
+
+    WifiDriver driver = { wifiDriverConnect, wifiDriverDisconnect, wifiDriverRenewDhcp, wifiDriverClock, NULL };
+    xSemaphoreTake(wifiLock, portMAX_DELAY);
+    wifiLink.begin(millis(), driver, leaseValid ? &cached : nullptr);
+    bool staticIp = wifiLink.staticIp;
+    xSemaphoreGive(wifiLock);
+
+    if (leaseValid) {
+        Serial.printf("WiFi: conexao direta (lease da %s, canal %d, %s)\n", source, cached.channel,
+                     staticIp ? "IP do lease" : "DHCP");
+    } else {
+        Serial.println("WiFi: sem lease guardado - varredura completa");
+    }
+}
+
+// Tempos esgotados, fim da espera entre rodadas e data do lease
+void updateWiFiManagement() {
+    if (!wifiLock) return;
+    xSemaphoreTake(wifiLock, portMAX_DELAY);
+    if (wifiLink.update(millis())) {
+        wifiRtcLease = wifiLink.lease;
+        wifiLeaseDirty = true;
+    }
+    xSemaphoreGive(wifiLock);
+}
+
+// Para o loop() não dormir além do próximo tempo da máquina
+uint32_t msUntilWiFiDue(uint32_t now) {
+    if (!wifiLock) return UINT32_MAX;
+    xSemaphoreTake(wifiLock, portMAX_DELAY);
+    uint32_t due = wifiLink.msUntilDue(now);
+    xSemaphoreGive(wifiLock);
+    return due;
+}
+
+// Lease novo vai para a NVS pela manutenção (fora da tarefa de eventos)
+void saveWiFiLeaseIfDirty() {
+    if (!wifiLeaseDirty) {
+        return;
+    }
+    xSemaphoreTake(wifiLock, portMAX_DELAY);
+    wifiLeaseDirty = false;
+    WifiLease copy = wifiRtcLease;
+    xSemaphoreGive(wifiLock);
+
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) {
+        Serial.println("ERRO: Falha ao abrir NVS para o lease WiFi");
+        return;
+    }
+    if (prefs.putBytes("lease", &copy, sizeof(copy)) != sizeof(copy)) {
+        Serial.println("ERRO: Falha ao gravar lease WiFi");
+    }
+    prefs.end();
+}
+
+void printWiFiStatistics() {
+    xSemaphoreTake(wifiLock, portMAX_DELAY);
+    WifiReconnect link = wifiLink;
+    xSemaphoreGive(wifiLock);
+    Serial.printf("WiFi: %s, %lu diretas (%lu com o IP do lease), %lu varreduras (%lu diretas falharam), "
+                 "%lu quedas, ultima reconexao %lu ms (pior %lu ms)\n",
+                 WIFI_LINK_STATE_NAMES[link.state], (unsigned long)link.fastConnects,
+                 (unsigned long)link.staticConnects, (unsigned long)link.scanConnects,
+                 (unsigned long)link.fastFallbacks, (unsigned long)link.drops,
+                 (unsigned long)link.lastReconnectMs, (unsigned long)link.worstReconnectMs);
+    Serial.printf("WiFi: lease de %lu s, %lu renovacoes do DHCP em segundo plano\n",
+                 (unsigned long)link.lease.leaseSecs, (unsigned long)link.dhcpRenewals);
+}
+
+// Tarefa de eventos do core: a próxima tentativa sai daqui mesmo
+void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    uint32_t now = millis();
+
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        WifiLease current = {};
+        memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+        current.channel = WiFi.channel();
+        current.ip = info.got_ip.ip_info.ip.addr;
+        current.gateway = info.got_ip.ip_info.gw.addr;
+        current.subnet = info.got_ip.ip_info.netmask.addr;
+        current.dns = (uint32_t)WiFi.dnsIP();
+        current.obtainedAt = wifiDriverClock(NULL);
+        current.leaseSecs = wifiDhcpLeaseSeconds();
+
+        xSemaphoreTake(wifiLock, portMAX_DELAY);
+        bool changed = wifiLink.onConnected(now, current);
+        if (changed) {
+            wifiRtcLease = wifiLink.lease;
+            wifiLeaseDirty = true;
+        }
+        uint32_t took = wifiLink.lastReconnectMs;
+        bool renewing = wifiLink.renewing;
+        xSemaphoreGive(wifiLock);
+        Serial.printf("WiFi: IP %s em %lu ms%s%s\n", WiFi.localIP().toString().c_str(),
+                     (unsigned long)took, changed ? " (lease novo)" : "",
+                     renewing ? " - renovando com o DHCP" : "");
+    } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        uint8_t reason = info.wifi_sta_disconnected.reason;
+        xSemaphoreTake(wifiLock, portMAX_DELAY);
+        bool wasUp = wifiLink.connected();
+        wifiLink.onDisconnected(now, reason == WIFI_REASON_ASSOC_LEAVE);
+        xSemaphoreGive(wifiLock);
+        if (wasUp) {
+            Serial.printf("AVISO: WiFi caiu (motivo %d) - reconectando\n", reason);
+        }
+    }
+}
+
+// Duração do lease que o DHCP acabou de dar (0 se não informou)
+uint32_t wifiDhcpLeaseSeconds() {
+    esp_netif_t* sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    struct netif* netif = sta ? (struct netif*)esp_netif_get_netif_impl(sta) : NULL;
+    struct dhcp* dhcp = netif ? netif_dhcp_data(netif) : NULL;
+    return dhcp ? dhcp->offered_t0_lease : 0;
+}
+
+// Direta: canal e BSSID do lease, e o IP do lease sem DHCP se a máquina
+// ainda o considera reservado (lease->ip != 0). Varredura: DHCP
+void wifiDriverConnect(void* ctx, const WifiLease* lease) {
+    bool configured = false;
+    #ifdef USE_STATIC_IP
+    if (USE_STATIC_IP) {
+        configured = WiFi.config(STATIC_IP, GATEWAY, SUBNET, DNS_PRIMARY, DNS_SECONDARY);
+        if (!configured) {
+            Serial.println("Falha ao configurar IP estatico, usando DHCP");
+        }
+    }
+    #endif
+    if (!configured) {
+        if (lease && lease->ip) {
+            WiFi.config(IPAddress(lease->ip), IPAddress(lease->gateway), IPAddress(lease->subnet),
+                        IPAddress(lease->dns));
+        } else {
+            WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+        }
+    }
+
+    if (lease) {
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD, lease->channel, lease->bssid);
+    } else {
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    }
+}
+
+void wifiDriverDisconnect(void* ctx) {
+    WiFi.disconnect();
+}
+
+// DHCP com a estação associada. Direto no esp_netif: o WiFi.config() troca o
+// IP por netif_set_addr(), que derruba os sockets TCP do IP antigo; aqui o
+// endereço só fica zerado até o DHCP responder (com o mesmo IP os sockets
+// seguem). O GOT_IP que vem depois renova a data do lease
+void wifiDriverRenewDhcp(void* ctx) {
+    esp_netif_t* sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    if (!sta || esp_netif_dhcpc_start(sta) != ESP_OK) {
+        Serial.println("AVISO: Falha ao iniciar o DHCP em segundo plano");
+    }
+}
+
+// Relógio de parede (NTP do histórico). Com IP fixo no config.h o lease
+// nunca vale: o endereço não vem do DHCP
+uint32_t wifiDriverClock(void* ctx) {
+    #ifdef USE_STATIC_IP
+    if (USE_STATIC_IP) {
+        return 0;
+    }
+    #endif
+    time_t now = time(nullptr);
+    return now >= WIFI_EPOCH_VALID ? (uint32_t)now : 0;
+}
+
+#endif // WIFI_MANAGER_H
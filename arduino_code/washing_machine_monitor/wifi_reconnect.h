@@ -0,0 +1,377 @@
+#ifndef WIFI_RECONNECT_H
+#define WIFI_RECONNECT_H
+
+// Máquina de estados da conexão WiFi, dirigida pelos eventos da pilha
+// (conectou com IP, caiu) e pelo relógio:
+//   WIFI_LINK_FAST   conexão direta no último AP bom (BSSID + canal, sem
+//                    varredura); com o IP do último lease (sem DHCP) só
+//                    enquanto o roteador ainda o reserva (wifiLeaseFresh),
+//                    senão com DHCP
+//   WIFI_LINK_SCAN   varredura completa + DHCP: sem lease, ou a direta
+//                    falhou (AP trocou de canal, lease recusado, tempo)
+//   WIFI_LINK_WAIT   as duas falharam: espera dobrando de retryMinMs a
+//                    retryMaxMs e volta para a direta
+//   WIFI_LINK_UP     com IP; ao cair tenta a direta na hora. Depois de uma
+//                    direta sem DHCP o DHCP roda em segundo plano
+//                    (renewDhcp), para o roteador renovar o lease
+// O lease (WifiLease) é guardado pelo wifi_manager.h na RTC (volta do deep
+// sleep e de reset por software) e na NVS (volta de falta de energia).
+// Quem conecta de fato é o WifiDriver: WiFi.begin() no dispositivo, uma
+// pilha simulada no host (host/replay_wifi.cpp). Não depende do Arduino;
+// tempos em ms de um relógio que pode dar a volta (millis()); a validade do
+// lease é medida no relógio de parede do driver (s, acertado pelo NTP), o
+// único que sobrevive a uma falta de energia sem voltar para trás.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef WIFI_FAST_TIMEOUT
+#define WIFI_FAST_TIMEOUT           2000    // ms para a conexão direta chegar ao IP
+#endif
+
+#ifndef WIFI_SCAN_TIMEOUT
+#define WIFI_SCAN_TIMEOUT           15000   // ms para varredura + associação + DHCP
+#endif
+
+#ifndef WIFI_RETRY_MIN
+#define WIFI_RETRY_MIN              500     // ms: primeira espera depois de falhar as duas
+#endif
+
+#ifndef WIFI_RETRY_MAX
+#define WIFI_RETRY_MAX              30000   // ms: espera máxima entre rodadas
+#endif
+
+#ifndef WIFI_DHCP_TIMEOUT
+#define WIFI_DHCP_TIMEOUT           3000    // ms a mais para a direta com DHCP
+#endif
+
+#ifndef WIFI_LEASE_DEFAULT
+#define WIFI_LEASE_DEFAULT          3600    // s de lease quando o DHCP não informa
+#endif
+
+#define WIFI_EPOCH_VALID            1600000000  // Antes disso o relógio não foi acertado
+#define WIFI_LEASE_MAGIC            0x57494C32u     // "WIL2"
+
+enum WifiLinkState {
+    WIFI_LINK_IDLE,
+    WIFI_LINK_FAST,
+    WIFI_LINK_SCAN,
+    WIFI_LINK_WAIT,
+    WIFI_LINK_UP,
+    WIFI_LINK_STATES
+};
+
+static const char* const WIFI_LINK_STATE_NAMES[WIFI_LINK_STATES] = {
+    "parado", "direta", "varredura", "espera", "conectado"
+};
+
+// Último AP e endereço bons (IPv4 em ordem de rede, como o lwIP)
+struct WifiLease {
+    uint32_t magic;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t obtainedAt;            // relógio de parede (s) do DHCP; 0 = desconhecido
+    uint32_t leaseSecs;             // duração dada pelo DHCP (s)
+    uint32_t checksum;
+};
+
+inline uint32_t wifiLeaseChecksum(const WifiLease& lease) {
+    const uint8_t* bytes = (const uint8_t*)&lease;
+    uint32_t hash = 2166136261u;                    // FNV-1a
+    for (size_t i = 0; i < offsetof(WifiLease, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+inline void wifiLeaseSeal(WifiLease& lease) {
+    lease.magic = WIFI_LEASE_MAGIC;
+    lease.reserved = 0;
+    lease.checksum = wifiLeaseChecksum(lease);
+}
+
+// RTC sem inicialização ou NVS: só vale com marca e checksum certos
+inline bool wifiLeaseValid(const WifiLease& lease) {
+    return lease.magic == WIFI_LEASE_MAGIC && lease.channel > 0 &&
+           lease.checksum == wifiLeaseChecksum(lease);
+}
+
+inline bool wifiLeaseSame(const WifiLease& a, const WifiLease& b) {
+    return memcmp(a.bssid, b.bssid, sizeof(a.bssid)) == 0 && a.channel == b.channel &&
+           a.ip == b.ip && a.gateway == b.gateway && a.subnet == b.subnet && a.dns == b.dns &&
+           a.obtainedAt == b.obtainedAt && a.leaseSecs == b.leaseSecs;
+}
+
+// O IP do lease pode ser usado sem DHCP: relógio acertado e ainda na primeira
+// metade do lease (T1, quando o próprio cliente DHCP renovaria). Relógio
+// desconhecido (boot depois de falta de energia, antes do NTP) não vale
+inline bool wifiLeaseFresh(const WifiLease& lease, uint32_t clock) {
+    return lease.ip != 0 && lease.obtainedAt >= WIFI_EPOCH_VALID && clock >= lease.obtainedAt &&
+           clock - lease.obtainedAt < lease.leaseSecs / 2;
+}
+
+// Pilha WiFi por trás da máquina. connect() só inicia a tentativa (o
+// resultado chega por onConnected()/onDisconnected()); lease == nullptr pede
+// varredura + DHCP, lease com ip == 0 pede a direta com DHCP. disconnect()
+// abandona a tentativa em andamento. renewDhcp() liga o DHCP sem largar a
+// associação (o IP novo chega por onConnected()). clock() é o relógio de
+// parede em s (0 ou menos que WIFI_EPOCH_VALID = não acertado)
+struct WifiDriver {
+    void (*connect)(void* ctx, const WifiLease* lease);
+    void (*disconnect)(void* ctx);
+    void (*renewDhcp)(void* ctx);
+    uint32_t (*clock)(void* ctx);
+    void* ctx;
+};
+
+struct WifiReconnect {
+    WifiDriver driver = {};
+    WifiLease lease = {};
+    bool leaseKnown = false;
+
+    WifiLinkState state = WIFI_LINK_IDLE;
+    bool staticIp = false;          // direta com o IP do lease, sem DHCP
+    bool renewing = false;          // DHCP em segundo plano depois da direta
+    bool stampPending = false;      // lease do DHCP antes do relógio acertar
+    uint32_t obtainedMs = 0;        // último lease do DHCP
+    uint32_t attemptAt = 0;         // início da tentativa atual (ou da renovação)
+    uint32_t downAt = 0;            // início da queda (ou do boot)
+    uint32_t retryAt = 0;
+    uint32_t retryMs = 0;           // 0 = sem rodadas falhas seguidas
+
+    uint32_t fastTimeoutMs = WIFI_FAST_TIMEOUT;
+    uint32_t dhcpTimeoutMs = WIFI_DHCP_TIMEOUT;
+    uint32_t scanTimeoutMs = WIFI_SCAN_TIMEOUT;
+    uint32_t retryMinMs = WIFI_RETRY_MIN;
+    uint32_t retryMaxMs = WIFI_RETRY_MAX;
+
+    // Estatísticas
+    uint32_t fastConnects = 0;
+    uint32_t scanConnects = 0;
+    uint32_t fastFallbacks = 0;     // diretas que caíram para a varredura
+    uint32_t staticConnects = 0;    // diretas com o IP do lease
+    uint32_t dhcpRenewals = 0;      // DHCP em segundo plano concluídos
+    uint32_t drops = 0;             // quedas com IP
+    uint32_t lastReconnectMs = 0;   // da queda (ou do boot) até o IP
+    uint32_t worstReconnectMs = 0;
+
+    // Primeira conexão; cached = lease da RTC/NVS, ou nullptr
+    void begin(uint32_t now, const WifiDriver& stackDriver, const WifiLease* cached) {
+        driver = stackDriver;
+        leaseKnown = cached && wifiLeaseValid(*cached);
+        if (leaseKnown) {
+            lease = *cached;
+        }
+        downAt = now;
+        startRound(now);
+    }
+
+    bool connected() const {
+        return state == WIFI_LINK_UP;
+    }
+
+    // =================== EVENTOS DA PILHA ===================
+
+    // Com IP. current.obtainedAt e leaseSecs vêm do DHCP (ignorados se o IP
+    // é o do lease). true se o lease mudou (quem chamou guarda o novo)
+    bool onConnected(uint32_t now, const WifiLease& current) {
+        bool fromLease = state == WIFI_LINK_FAST && staticIp;
+        if (state == WIFI_LINK_UP) {
+            // Fim do DHCP em segundo plano (ou IP trocado pelo DHCP)
+            if (renewing) {
+                dhcpRenewals++;
+            }
+        } else {
+            if (state == WIFI_LINK_FAST) {
+                fastConnects++;
+                staticConnects += staticIp ? 1 : 0;
+            } else {
+                scanConnects++;
+            }
+            state = WIFI_LINK_UP;
+            retryMs = 0;
+            lastReconnectMs = now - downAt;
+            if (lastReconnectMs > worstReconnectMs) {
+                worstReconnectMs = lastReconnectMs;
+            }
+        }
+        renewing = false;
+
+        WifiLease next = current;
+        if (fromLease) {
+            // Nada foi renovado: o lease continua valendo o mesmo tempo
+            next.obtainedAt = lease.obtainedAt;
+            next.leaseSecs = lease.leaseSecs;
+        } else {
+            next.obtainedAt = next.obtainedAt >= WIFI_EPOCH_VALID ? next.obtainedAt : 0;
+            next.leaseSecs = next.leaseSecs ? next.leaseSecs : WIFI_LEASE_DEFAULT;
+            obtainedMs = now;
+            stampPending = next.obtainedAt == 0;
+        }
+
+        bool changed = !leaseKnown || !wifiLeaseSame(lease, next);
+        if (changed) {
+            lease = next;
+            wifiLeaseSeal(lease);
+            leaseKnown = true;
+        }
+
+        if (fromLease) {
+            renewing = true;
+            attemptAt = now;
+            driver.renewDhcp(driver.ctx);
+        }
+        return changed;
+    }
+
+    // Caiu ou a tentativa falhou. local = desconexão pedida pelo próprio
+    // driver (troca de tentativa): ignorada
+    void onDisconnected(uint32_t now, bool local) {
+        if (local) {
+            return;
+        }
+        switch (state) {
+            case WIFI_LINK_UP:
+                // Queda do roteador: direta na hora, o lease ainda vale
+                drops++;
+                renewing = false;
+                downAt = now;
+                startRound(now);
+                break;
+            case WIFI_LINK_FAST:
+                fastFallback(now);
+                break;
+            case WIFI_LINK_SCAN:
+                roundFailed(now);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // =================== RELÓGIO ===================
+
+    // Tempos esgotados e fim da espera; chamar a cada volta do loop().
+    // true se o lease mudou (quem chamou guarda o novo)
+    bool update(uint32_t now) {
+        bool changed = false;
+
+        // Lease do DHCP anterior ao NTP: data calculada quando o relógio acerta
+        if (stampPending && leaseKnown) {
+            uint32_t clock = driver.clock(driver.ctx);
+            if (clock >= WIFI_EPOCH_VALID) {
+                lease.obtainedAt = clock - (now - obtainedMs) / 1000;
+                wifiLeaseSeal(lease);
+                stampPending = false;
+                changed = true;
+            }
+        }
+
+        switch (state) {
+            case WIFI_LINK_UP:
+                // DHCP em segundo plano sem resposta: o IP não foi renovado e
+                // deixa de ser usado sem DHCP; reconecta pela direta com DHCP
+                if (renewing && now - attemptAt >= scanTimeoutMs) {
+                    renewing = false;
+                    lease.obtainedAt = 0;
+                    wifiLeaseSeal(lease);
+                    changed = true;
+                    driver.disconnect(driver.ctx);
+                    drops++;
+                    downAt = now;
+                    startRound(now);
+                }
+                break;
+            case WIFI_LINK_FAST:
+                if (now - attemptAt >= fastTimeout()) {
+                    driver.disconnect(driver.ctx);
+                    fastFallback(now);
+                }
+                break;
+            case WIFI_LINK_SCAN:
+                if (now - attemptAt >= scanTimeoutMs) {
+                    driver.disconnect(driver.ctx);
+                    roundFailed(now);
+                }
+                break;
+            case WIFI_LINK_WAIT:
+                if ((int32_t)(now - retryAt) >= 0) {
+                    startRound(now);
+                }
+                break;
+            default:
+                break;
+        }
+        return changed;
+    }
+
+    // ms até update() ter algo a fazer (para o loop() não dormir além disso)
+    uint32_t msUntilDue(uint32_t now) const {
+        uint32_t due;
+        switch (state) {
+            case WIFI_LINK_UP:
+                if (!renewing) return UINT32_MAX;
+                due = attemptAt + scanTimeoutMs;
+                break;
+            case WIFI_LINK_FAST: due = attemptAt + fastTimeout(); break;
+            case WIFI_LINK_SCAN: due = attemptAt + scanTimeoutMs; break;
+            case WIFI_LINK_WAIT: due = retryAt; break;
+            default: return UINT32_MAX;
+        }
+        int32_t remaining = (int32_t)(due - now);
+        return remaining > 0 ? remaining : 0;
+    }
+
+    // =================== TRANSIÇÕES ===================
+
+    // Direta com DHCP também espera o DHCP
+    uint32_t fastTimeout() const {
+        return staticIp ? fastTimeoutMs : fastTimeoutMs + dhcpTimeoutMs;
+    }
+
+    void startRound(uint32_t now) {
+        if (leaseKnown) {
+            state = WIFI_LINK_FAST;
+            attemptAt = now;
+            staticIp = wifiLeaseFresh(lease, driver.clock(driver.ctx));
+            if (staticIp) {
+                driver.connect(driver.ctx, &lease);
+            } else {
+                WifiLease channelOnly = lease;
+                channelOnly.ip = 0;
+                driver.connect(driver.ctx, &channelOnly);
+            }
+        } else {
+            startScan(now);
+        }
+    }
+
+    void startScan(uint32_t now) {
+        state = WIFI_LINK_SCAN;
+        staticIp = false;
+        attemptAt = now;
+        driver.connect(driver.ctx, nullptr);
+    }
+
+    // O lease continua para a próxima rodada (queda curta do roteador); se o
+    // AP mudou de canal ou o endereço, a varredura traz o lease novo
+    void fastFallback(uint32_t now) {
+        fastFallbacks++;
+        startScan(now);
+    }
+
+    void roundFailed(uint32_t now) {
+        retryMs = retryMs == 0 ? retryMinMs
+                : retryMs >= retryMaxMs / 2 ? retryMaxMs : retryMs * 2;
+        state = WIFI_LINK_WAIT;
+        retryAt = now + retryMs;
+    }
+};
+
+#endif // WIFI_RECONNECT_H